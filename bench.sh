@@ -0,0 +1,10 @@
+BASE=`pwd`
+FILTER=${1:-.}
+
+cd build;
+mkdir -p bench_result;
+for bench in `find -maxdepth 1 -name '*_benchmark'`; do
+    name=`basename $bench`
+    $bench --benchmark_filter="$FILTER" --benchmark_out_format=json --benchmark_out=bench_result/$name.json --benchmark_format=console
+done
+cd $BASE
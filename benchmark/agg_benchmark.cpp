@@ -0,0 +1,167 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <algorithm>
+#include <memory>
+
+#include "benchmark_util.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/common/arena.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized::bench {
+
+namespace {
+
+struct Argument {
+    std::string name;
+    DataTypePtr type;
+    ColumnPtr column;
+};
+
+std::vector<Argument> arguments(size_t rows) {
+    return {
+            {"Int32", std::make_shared<DataTypeInt32>(), makeRandomColumnVector<Int32>(rows)},
+            {"Int64", std::make_shared<DataTypeInt64>(), makeRandomColumnVector<Int64>(rows)},
+            {"Float64", std::make_shared<DataTypeFloat64>(),
+             makeRandomColumnVector<Float64>(rows)},
+            {"Decimal64", createDecimal(18, 4), makeRandomColumnDecimal<Decimal64>(rows, 4)},
+            {"Decimal128", createDecimal(38, 4), makeRandomColumnDecimal<Decimal128>(rows, 4)},
+    };
+}
+
+/// Aggregation states for `groups` keys, allocated in one arena.
+class States {
+public:
+    States(const AggregateFunctionPtr& function_, size_t groups) : function(function_) {
+        for (size_t i = 0; i < groups; ++i) {
+            auto place = arena.alignedAlloc(function->sizeOfData(), function->alignOfData());
+            function->create(place);
+            places.push_back(place);
+        }
+    }
+
+    ~States() {
+        for (auto place : places) function->destroy(place);
+    }
+
+    AggregateFunctionPtr function;
+    Arena arena;
+    std::vector<AggregateDataPtr> places;
+};
+
+enum class Mode { PerRow, Batch, BatchSinglePlace };
+
+const char* modeName(Mode mode) {
+    switch (mode) {
+    case Mode::PerRow:
+        return "add";
+    case Mode::Batch:
+        return "addBatch";
+    case Mode::BatchSinglePlace:
+        return "addBatchSinglePlace";
+    }
+    return "";
+}
+
+/// Compares the virtual call per row against the batched entry points,
+/// for a single group and for `groups` groups with random keys.
+/// The states are recreated (untimed) for every iteration, so that the functions which keep
+/// all their input (quantileExact, uniq, ...) are measured on the same amount of data each time.
+void benchmarkAggregate(benchmark::State& state, AggregateFunctionPtr function, ColumnPtr column,
+                        Mode mode) {
+    const size_t groups = state.range(0);
+    const size_t rows = column->size();
+    const IColumn* columns[] = {column.get()};
+
+    std::unique_ptr<States> states;
+    std::vector<AggregateDataPtr> row_places(rows);
+    auto keys = generateKeys(KeyDistribution::Uniform, rows, groups, DEFAULT_SEED);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        states.reset();
+        states = std::make_unique<States>(function, groups);
+        for (size_t i = 0; i < rows; ++i) row_places[i] = states->places[keys[i]];
+        state.ResumeTiming();
+
+        switch (mode) {
+        case Mode::PerRow:
+            for (size_t i = 0; i < rows; ++i)
+                function->add(row_places[i], columns, i, &states->arena);
+            break;
+        case Mode::Batch:
+            function->addBatch(rows, row_places.data(), 0, columns, &states->arena);
+            break;
+        case Mode::BatchSinglePlace:
+            function->addBatchSinglePlace(rows, states->places[0], columns, &states->arena);
+            break;
+        }
+        benchmark::ClobberMemory();
+    }
+    setThroughput(state, rows, column->byteSize());
+}
+
+AggregateFunctionPtr tryCreate(const std::string& name, const DataTypePtr& type) {
+    try {
+        return AggregateFunctionSimpleFactory::instance().get(name, {type}, {});
+    } catch (const Exception&) {
+        return nullptr;
+    }
+}
+
+void registerAggregateBenchmarks() {
+    auto names = AggregateFunctionSimpleFactory::instance().getFunctionNames();
+    std::sort(names.begin(), names.end());
+    auto all_arguments = arguments(DEFAULT_ROWS);
+
+    for (const auto& name : names) {
+        for (const auto& argument : all_arguments) {
+            auto function = tryCreate(name, argument.type);
+            if (!function) continue;
+
+            for (auto mode : {Mode::PerRow, Mode::Batch}) {
+                auto benchmark_name = name + "/" + argument.name + "/" + modeName(mode);
+                benchmark::RegisterBenchmark(benchmark_name.c_str(), benchmarkAggregate, function,
+                                             argument.column, mode)
+                        ->ArgName("groups")
+                        ->Arg(1)
+                        ->Arg(1 << 10)
+                        ->Arg(1 << 16);
+            }
+            auto benchmark_name = name + "/" + argument.name + "/" +
+                                  modeName(Mode::BatchSinglePlace);
+            benchmark::RegisterBenchmark(benchmark_name.c_str(), benchmarkAggregate, function,
+                                         argument.column, Mode::BatchSinglePlace)
+                    ->ArgName("groups")
+                    ->Arg(1);
+        }
+    }
+}
+
+} // namespace
+
+} // namespace doris::vectorized::bench
+
+int main(int argc, char** argv) {
+    doris::vectorized::bench::registerAggregateBenchmarks();
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,180 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/columns/columns_number.h"
+
+namespace doris::vectorized::bench {
+
+/// All generators use a fixed seed, so that numbers are comparable between runs and versions.
+static constexpr UInt64 DEFAULT_SEED = 42;
+
+/// Rows per column in the column/function/aggregate benchmarks.
+static constexpr size_t DEFAULT_ROWS = 65536;
+
+enum class KeyDistribution {
+    Uniform,
+    Zipf,
+    Sequential,
+};
+
+inline const char* keyDistributionName(KeyDistribution distribution) {
+    switch (distribution) {
+    case KeyDistribution::Uniform:
+        return "uniform";
+    case KeyDistribution::Zipf:
+        return "zipf";
+    case KeyDistribution::Sequential:
+        return "sequential";
+    }
+    return "unknown";
+}
+
+/** Draws values from [0, cardinality) with P(k) ~ 1 / (k + 1)^skew.
+  * The CDF is precomputed, so sampling is a binary search.
+  */
+class ZipfGenerator {
+public:
+    ZipfGenerator(size_t cardinality, double skew, UInt64 seed = DEFAULT_SEED)
+            : cdf(cardinality), rng(seed) {
+        double sum = 0;
+        for (size_t i = 0; i < cardinality; ++i) {
+            sum += 1.0 / std::pow(double(i + 1), skew);
+            cdf[i] = sum;
+        }
+        for (auto& value : cdf) value /= sum;
+    }
+
+    UInt64 operator()() {
+        double x = std::uniform_real_distribution<double>(0, 1)(rng);
+        return std::lower_bound(cdf.begin(), cdf.end(), x) - cdf.begin();
+    }
+
+private:
+    std::vector<double> cdf;
+    std::mt19937_64 rng;
+};
+
+inline std::vector<UInt64> generateKeys(KeyDistribution distribution, size_t rows,
+                                        size_t cardinality, UInt64 seed = DEFAULT_SEED) {
+    std::vector<UInt64> keys(rows);
+    switch (distribution) {
+    case KeyDistribution::Uniform: {
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<UInt64> dist(0, cardinality - 1);
+        for (auto& key : keys) key = dist(rng);
+        break;
+    }
+    case KeyDistribution::Zipf: {
+        ZipfGenerator zipf(cardinality, 1.0, seed);
+        /// Scramble ranks so that hot keys are not also the small ones.
+        for (auto& key : keys) key = zipf() * 0x9E3779B97F4A7C15ULL;
+        break;
+    }
+    case KeyDistribution::Sequential:
+        for (size_t i = 0; i < rows; ++i) keys[i] = i % cardinality;
+        break;
+    }
+    return keys;
+}
+
+template <typename T>
+typename ColumnVector<T>::MutablePtr makeRandomColumnVector(size_t rows,
+                                                             UInt64 seed = DEFAULT_SEED) {
+    auto column = ColumnVector<T>::create(rows);
+    auto& data = column->getData();
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < rows; ++i) {
+        if constexpr (std::is_floating_point_v<T>)
+            data[i] = std::uniform_real_distribution<T>(-1e6, 1e6)(rng);
+        else
+            data[i] = static_cast<T>(rng());
+    }
+    return column;
+}
+
+template <typename T>
+typename ColumnDecimal<T>::MutablePtr makeRandomColumnDecimal(size_t rows, UInt32 scale,
+                                                               UInt64 seed = DEFAULT_SEED) {
+    auto column = ColumnDecimal<T>::create(rows, scale);
+    auto& data = column->getData();
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < rows; ++i)
+        data[i] = static_cast<typename T::NativeType>(rng() % 1000000000);
+    return column;
+}
+
+inline ColumnString::MutablePtr makeRandomColumnString(size_t rows, size_t max_length,
+                                                       UInt64 seed = DEFAULT_SEED) {
+    auto column = ColumnString::create();
+    std::mt19937_64 rng(seed);
+    std::string value;
+    for (size_t i = 0; i < rows; ++i) {
+        value.resize(rng() % (max_length + 1));
+        for (auto& c : value) c = 'a' + rng() % 26;
+        column->insertData(value.data(), value.size());
+    }
+    return column;
+}
+
+inline ColumnUInt8::MutablePtr makeRandomNullMap(size_t rows, double null_ratio,
+                                                 UInt64 seed = DEFAULT_SEED) {
+    auto column = ColumnUInt8::create(rows);
+    auto& data = column->getData();
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution dist(null_ratio);
+    for (size_t i = 0; i < rows; ++i) data[i] = dist(rng);
+    return column;
+}
+
+/// Filter that keeps about `selectivity` of rows.
+inline IColumn::Filter makeFilter(size_t rows, double selectivity, UInt64 seed = DEFAULT_SEED) {
+    IColumn::Filter filter(rows);
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution dist(selectivity);
+    for (size_t i = 0; i < rows; ++i) filter[i] = dist(rng);
+    return filter;
+}
+
+inline IColumn::Permutation makeShuffledPermutation(size_t rows, UInt64 seed = DEFAULT_SEED) {
+    IColumn::Permutation perm(rows);
+    for (size_t i = 0; i < rows; ++i) perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), std::mt19937_64(seed));
+    return perm;
+}
+
+/// Report throughput of one iteration over `rows` rows and `bytes` bytes of input.
+inline void setThroughput(benchmark::State& state, size_t rows, size_t bytes) {
+    state.SetItemsProcessed(int64_t(state.iterations()) * rows);
+    state.SetBytesProcessed(int64_t(state.iterations()) * bytes);
+    state.counters["rows"] = rows;
+}
+
+} // namespace doris::vectorized::bench
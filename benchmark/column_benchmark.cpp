@@ -0,0 +1,133 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <functional>
+
+#include "benchmark_util.h"
+
+namespace doris::vectorized::bench {
+
+namespace {
+
+using ColumnMaker = std::function<ColumnPtr(size_t)>;
+
+struct ColumnCase {
+    const char* name;
+    ColumnMaker make;
+};
+
+std::vector<ColumnCase> columnCases() {
+    return {
+            {"Int32", [](size_t rows) { return makeRandomColumnVector<Int32>(rows); }},
+            {"Int64", [](size_t rows) { return makeRandomColumnVector<Int64>(rows); }},
+            {"Float64", [](size_t rows) { return makeRandomColumnVector<Float64>(rows); }},
+            {"Decimal64",
+             [](size_t rows) { return makeRandomColumnDecimal<Decimal64>(rows, 4); }},
+            {"Decimal128",
+             [](size_t rows) { return makeRandomColumnDecimal<Decimal128>(rows, 9); }},
+            {"String", [](size_t rows) { return makeRandomColumnString(rows, 32); }},
+            {"Nullable(Int64)",
+             [](size_t rows) {
+                 return ColumnNullable::create(makeRandomColumnVector<Int64>(rows),
+                                               makeRandomNullMap(rows, 0.1));
+             }},
+            {"Nullable(String)",
+             [](size_t rows) {
+                 return ColumnNullable::create(makeRandomColumnString(rows, 32),
+                                               makeRandomNullMap(rows, 0.1));
+             }},
+    };
+}
+
+void benchmarkFilter(benchmark::State& state, const ColumnMaker& make, double selectivity) {
+    ColumnPtr column = make(DEFAULT_ROWS);
+    IColumn::Filter filter = makeFilter(column->size(), selectivity);
+    for (auto _ : state) {
+        ColumnPtr res = column->filter(filter, -1);
+        benchmark::DoNotOptimize(res);
+    }
+    setThroughput(state, column->size(), column->byteSize());
+}
+
+void benchmarkPermute(benchmark::State& state, const ColumnMaker& make) {
+    ColumnPtr column = make(DEFAULT_ROWS);
+    IColumn::Permutation perm = makeShuffledPermutation(column->size());
+    for (auto _ : state) {
+        ColumnPtr res = column->permute(perm, 0);
+        benchmark::DoNotOptimize(res);
+    }
+    setThroughput(state, column->size(), column->byteSize());
+}
+
+void benchmarkInsertRangeFrom(benchmark::State& state, const ColumnMaker& make,
+                              size_t range_rows) {
+    ColumnPtr column = make(DEFAULT_ROWS);
+    for (auto _ : state) {
+        MutableColumnPtr res = column->cloneEmpty();
+        for (size_t start = 0; start < column->size(); start += range_rows)
+            res->insertRangeFrom(*column, start, std::min(range_rows, column->size() - start));
+        benchmark::DoNotOptimize(res);
+    }
+    setThroughput(state, column->size(), column->byteSize());
+}
+
+void benchmarkGetPermutation(benchmark::State& state, const ColumnMaker& make, size_t limit) {
+    ColumnPtr column = make(DEFAULT_ROWS);
+    IColumn::Permutation perm;
+    for (auto _ : state) {
+        column->getPermutation(false, limit, 1, perm);
+        benchmark::DoNotOptimize(perm.data());
+    }
+    setThroughput(state, column->size(), column->byteSize());
+}
+
+void registerColumnBenchmarks() {
+    for (const auto& column_case : columnCases()) {
+        std::string name = column_case.name;
+        const auto& make = column_case.make;
+
+        for (double selectivity : {0.01, 0.5, 0.99})
+            benchmark::RegisterBenchmark(
+                    ("filter/" + name + "/selectivity:" + std::to_string(int(selectivity * 100)))
+                            .c_str(),
+                    benchmarkFilter, make, selectivity);
+
+        benchmark::RegisterBenchmark(("permute/" + name).c_str(), benchmarkPermute, make);
+
+        for (size_t range_rows : {16, 1024, 65536})
+            benchmark::RegisterBenchmark(
+                    ("insertRangeFrom/" + name + "/range:" + std::to_string(range_rows)).c_str(),
+                    benchmarkInsertRangeFrom, make, range_rows);
+
+        benchmark::RegisterBenchmark(("getPermutation/" + name + "/full").c_str(),
+                                     benchmarkGetPermutation, make, 0);
+        benchmark::RegisterBenchmark(("getPermutation/" + name + "/limit:100").c_str(),
+                                     benchmarkGetPermutation, make, 100);
+    }
+}
+
+} // namespace
+
+} // namespace doris::vectorized::bench
+
+int main(int argc, char** argv) {
+    doris::vectorized::bench::registerColumnBenchmarks();
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
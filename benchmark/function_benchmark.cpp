@@ -0,0 +1,171 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <algorithm>
+
+#include "benchmark_util.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized::bench {
+
+namespace {
+
+/// A set of argument columns a function may be called with.
+/// Every registered function is tried with every signature and benchmarked
+/// with those it accepts, so new functions are covered without touching this file.
+struct Signature {
+    std::string name;
+    ColumnsWithTypeAndName arguments;
+};
+
+ColumnWithTypeAndName argument(ColumnPtr column, DataTypePtr type, const std::string& name) {
+    return ColumnWithTypeAndName(std::move(column), std::move(type), name);
+}
+
+std::vector<Signature> signatures(size_t rows) {
+    auto int32 = std::make_shared<DataTypeInt32>();
+    auto int64 = std::make_shared<DataTypeInt64>();
+    auto uint8 = std::make_shared<DataTypeUInt8>();
+    auto float64 = std::make_shared<DataTypeFloat64>();
+    auto decimal64 = createDecimal(18, 4);
+    auto string = std::make_shared<DataTypeString>();
+
+    auto nullable_int64 = [&](UInt64 seed) {
+        return argument(ColumnNullable::create(makeRandomColumnVector<Int64>(rows, seed),
+                                               makeRandomNullMap(rows, 0.1, seed)),
+                        makeNullable(int64), "n" + std::to_string(seed));
+    };
+    auto bool_column = [&](UInt64 seed) {
+        auto column = makeRandomColumnVector<UInt8>(rows, seed);
+        for (auto& x : column->getData()) x &= 1;
+        return argument(std::move(column), uint8, "b" + std::to_string(seed));
+    };
+
+    return {
+            {"Int32,Int32",
+             {argument(makeRandomColumnVector<Int32>(rows, 1), int32, "a"),
+              argument(makeRandomColumnVector<Int32>(rows, 2), int32, "b")}},
+            {"Int64,Int64",
+             {argument(makeRandomColumnVector<Int64>(rows, 1), int64, "a"),
+              argument(makeRandomColumnVector<Int64>(rows, 2), int64, "b")}},
+            {"Float64,Float64",
+             {argument(makeRandomColumnVector<Float64>(rows, 1), float64, "a"),
+              argument(makeRandomColumnVector<Float64>(rows, 2), float64, "b")}},
+            {"Int64,Float64",
+             {argument(makeRandomColumnVector<Int64>(rows, 1), int64, "a"),
+              argument(makeRandomColumnVector<Float64>(rows, 2), float64, "b")}},
+            {"Int64,Const(Int64)",
+             {argument(makeRandomColumnVector<Int64>(rows, 1), int64, "a"),
+              argument(int64->createColumnConst(rows, Int64(7)), int64, "c")}},
+            {"Decimal64,Decimal64",
+             {argument(makeRandomColumnDecimal<Decimal64>(rows, 4, 1), decimal64, "a"),
+              argument(makeRandomColumnDecimal<Decimal64>(rows, 4, 2), decimal64, "b")}},
+            {"Nullable(Int64),Nullable(Int64)", {nullable_int64(1), nullable_int64(2)}},
+            {"UInt8,UInt8", {bool_column(1), bool_column(2)}},
+            {"String,String",
+             {argument(makeRandomColumnString(rows, 8, 1), string, "a"),
+              argument(makeRandomColumnString(rows, 8, 2), string, "b")}},
+            {"Int64", {argument(makeRandomColumnVector<Int64>(rows, 1), int64, "a")}},
+            {"Float64", {argument(makeRandomColumnVector<Float64>(rows, 1), float64, "a")}},
+            {"UInt8", {bool_column(1)}},
+            {"Nullable(Int64)", {nullable_int64(1)}},
+            {"Int32,Const(String)->Int64",
+             {argument(makeRandomColumnVector<Int32>(rows, 1), int32, "a"),
+              argument(string->createColumnConst(rows, Field(String("Int64"))), string, "t")}},
+            {"Int64,Const(String)->Float64",
+             {argument(makeRandomColumnVector<Int64>(rows, 1), int64, "a"),
+              argument(string->createColumnConst(rows, Field(String("Float64"))), string,
+                       "t")}},
+    };
+}
+
+Block makeBlock(const FunctionBasePtr& function, const ColumnsWithTypeAndName& arguments,
+                ColumnNumbers& argument_numbers, size_t& result) {
+    Block block(arguments);
+    argument_numbers.resize(arguments.size());
+    for (size_t i = 0; i < arguments.size(); ++i) argument_numbers[i] = i;
+    result = arguments.size();
+    block.insert({nullptr, function->getReturnType(), "result"});
+    return block;
+}
+
+size_t argumentBytes(const ColumnsWithTypeAndName& arguments) {
+    size_t bytes = 0;
+    for (const auto& argument : arguments) bytes += argument.column->byteSize();
+    return bytes;
+}
+
+void benchmarkFunction(benchmark::State& state, FunctionBasePtr function,
+                       ColumnsWithTypeAndName arguments) {
+    ColumnNumbers argument_numbers;
+    size_t result = 0;
+    Block block = makeBlock(function, arguments, argument_numbers, result);
+    size_t rows = block.rows();
+
+    for (auto _ : state) {
+        function->execute(block, argument_numbers, result, rows);
+        benchmark::DoNotOptimize(block.getByPosition(result).column);
+    }
+    setThroughput(state, rows, argumentBytes(arguments));
+}
+
+/// Returns nullptr if the function does not accept these arguments.
+FunctionBasePtr tryBuild(const std::string& name, const ColumnsWithTypeAndName& arguments) {
+    try {
+        auto function = SimpleFunctionFactory::instance().get_function(name, arguments);
+        if (!function) return nullptr;
+
+        /// Some functions accept the types, but fail at execution (e.g. int_divide by zero).
+        ColumnNumbers argument_numbers;
+        size_t result = 0;
+        Block block = makeBlock(function, arguments, argument_numbers, result);
+        function->execute(block, argument_numbers, result, block.rows());
+        return function;
+    } catch (const Exception&) {
+        return nullptr;
+    }
+}
+
+void registerFunctionBenchmarks() {
+    auto names = SimpleFunctionFactory::instance().get_function_names();
+    std::sort(names.begin(), names.end());
+    auto all_signatures = signatures(DEFAULT_ROWS);
+
+    for (const auto& name : names) {
+        for (const auto& signature : all_signatures) {
+            if (auto function = tryBuild(name, signature.arguments))
+                benchmark::RegisterBenchmark((name + "/" + signature.name).c_str(),
+                                             benchmarkFunction, function, signature.arguments);
+        }
+    }
+}
+
+} // namespace
+
+} // namespace doris::vectorized::bench
+
+int main(int argc, char** argv) {
+    doris::vectorized::bench::registerFunctionBenchmarks();
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "benchmark_util.h"
+#include "vec/common/hash_table/hash_map.h"
+
+namespace doris::vectorized::bench {
+
+namespace {
+
+static constexpr size_t HASH_TABLE_ROWS = 1 << 20;
+
+template <typename Map>
+void benchmarkInsert(benchmark::State& state, KeyDistribution distribution) {
+    size_t cardinality = state.range(0);
+    std::vector<UInt64> keys = generateKeys(distribution, HASH_TABLE_ROWS, cardinality);
+    for (auto _ : state) {
+        Map map;
+        for (auto key : keys) ++map[key];
+        benchmark::DoNotOptimize(map.size());
+    }
+    setThroughput(state, keys.size(), keys.size() * sizeof(UInt64));
+}
+
+template <typename Map>
+void benchmarkFind(benchmark::State& state, KeyDistribution distribution) {
+    size_t cardinality = state.range(0);
+    std::vector<UInt64> keys = generateKeys(distribution, HASH_TABLE_ROWS, cardinality);
+    /// Probe keys are drawn with another seed, so a part of them misses.
+    std::vector<UInt64> probes =
+            generateKeys(distribution, HASH_TABLE_ROWS, cardinality, DEFAULT_SEED + 1);
+    Map map;
+    for (auto key : keys) ++map[key];
+
+    for (auto _ : state) {
+        size_t found = 0;
+        for (auto key : probes) found += map.find(key) != nullptr;
+        benchmark::DoNotOptimize(found);
+    }
+    setThroughput(state, probes.size(), probes.size() * sizeof(UInt64));
+}
+
+using UInt64HashMap = HashMap<UInt64, UInt64, HashCRC32<UInt64>>;
+using UInt64HashMapWithSavedHash = HashMapWithSavedHash<UInt64, UInt64, HashCRC32<UInt64>>;
+
+void registerHashTableBenchmarks() {
+    for (auto distribution :
+         {KeyDistribution::Uniform, KeyDistribution::Zipf, KeyDistribution::Sequential}) {
+        std::string suffix = std::string("/") + keyDistributionName(distribution);
+
+        /// 1K keys fit into L1, 64K into L2, 1M (as many as the rows) are beyond LLC.
+        for (auto* b : {benchmark::RegisterBenchmark(("HashMap/insert" + suffix).c_str(),
+                                                     benchmarkInsert<UInt64HashMap>,
+                                                     distribution),
+                        benchmark::RegisterBenchmark(("HashMap/find" + suffix).c_str(),
+                                                     benchmarkFind<UInt64HashMap>, distribution),
+                        benchmark::RegisterBenchmark(
+                                ("HashMapWithSavedHash/insert" + suffix).c_str(),
+                                benchmarkInsert<UInt64HashMapWithSavedHash>, distribution),
+                        benchmark::RegisterBenchmark(("HashMapWithSavedHash/find" + suffix).c_str(),
+                                                     benchmarkFind<UInt64HashMapWithSavedHash>,
+                                                     distribution)})
+            b->ArgName("cardinality")->Arg(1 << 10)->Arg(1 << 16)->Arg(HASH_TABLE_ROWS);
+    }
+}
+
+} // namespace
+
+} // namespace doris::vectorized::bench
+
+int main(int argc, char** argv) {
+    doris::vectorized::bench::registerHashTableBenchmarks();
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
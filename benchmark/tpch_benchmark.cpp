@@ -0,0 +1,797 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+/** End-to-end query kernels over in-memory lineitem/orders-like Blocks.
+  *
+  * There is no planner yet, so each query is a hand-assembled pipeline
+  * of the existing building blocks: functions from SimpleFunctionFactory for
+  * comparisons, arithmetic and casts, Block::filter_block, aggregate functions from
+  * AggregateFunctionSimpleFactory and HashMap for GROUP BY and JOIN.
+  * They run in one thread, except q6_parallel, which runs Q6 with PipelineExecutor
+  * on all CPUs.
+  *
+  * Besides the wall time of the whole query, every benchmark reports the time spent
+  * in each stage (as <stage>_ms counters, averaged over iterations) and the peak RSS.
+  *
+  * With --profile, QueryProfile of every benchmark (all iterations together) is printed
+  * to stderr: stages are operators, and the functions executed in them are their children.
+  * Hardware counters of stages and functions are included where perf events are available.
+  *
+  * With --trace=<dir>, the timeline of every benchmark (its last iterations, if the ring
+  * buffer overflows) is written to <dir>/<query>.json in the Chrome trace format.
+  *
+  * Usage: tpch_benchmark [--scale_factor=0.1] [--profile] [--trace=<dir>]
+  *                       [google benchmark flags]
+  */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+
+#include "benchmark_util.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/common/arena.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/hash_table/hash_map.h"
+#include "vec/common/memory_tracker.h"
+#include "vec/common/perf_events.h"
+#include "vec/common/query_profile.h"
+#include "vec/common/query_trace.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/pipeline_executor.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+}
+
+namespace bench {
+
+namespace {
+
+/// Dates are stored as number of days since 1970-01-01.
+constexpr Int32 DATE_1992_01_01 = 8035;
+constexpr Int32 DATE_1994_01_01 = 8766;
+constexpr Int32 DATE_1995_01_01 = 9131;
+constexpr Int32 DATE_1995_03_15 = 9204;
+constexpr Int32 DATE_1995_06_17 = 9298;
+constexpr Int32 DATE_1998_08_02 = 10440;
+constexpr Int32 DATE_1998_09_02 = 10471;
+
+/// Money and quantities are Decimal(15, 2), as in TPC-H.
+constexpr UInt32 MONEY_SCALE = 2;
+
+DataTypePtr moneyType() {
+    return createDecimal(15, MONEY_SCALE);
+}
+
+Field money(Int64 cents) {
+    return DecimalField<Decimal64>(cents, MONEY_SCALE);
+}
+
+namespace Lineitem {
+enum Column : size_t {
+    orderkey,
+    quantity,
+    extendedprice,
+    discount,
+    tax,
+    returnflag,
+    linestatus,
+    shipdate,
+};
+}
+
+namespace Orders {
+enum Column : size_t {
+    orderkey,
+    custkey,
+    orderdate,
+    shippriority,
+};
+}
+
+struct Tables {
+    std::vector<Block> lineitem;
+    std::vector<Block> orders;
+    size_t lineitem_rows = 0;
+    size_t orders_rows = 0;
+};
+
+/// Accumulates rows into blocks of at most DEFAULT_ROWS rows.
+class BlockBuilder {
+public:
+    explicit BlockBuilder(Block header_) : header(std::move(header_)) { reset(); }
+
+    MutableColumns& columns() { return current; }
+
+    void rowAdded(std::vector<Block>& blocks) {
+        if (current[0]->size() == DEFAULT_ROWS) flush(blocks);
+    }
+
+    void flush(std::vector<Block>& blocks) {
+        if (current[0]->empty()) return;
+        blocks.push_back(header.cloneWithColumns(std::move(current)));
+        reset();
+    }
+
+private:
+    void reset() {
+        current = header.cloneEmptyColumns();
+        for (auto& column : current) column->reserve(DEFAULT_ROWS);
+    }
+
+    Block header;
+    MutableColumns current;
+};
+
+/** Deterministic generator roughly following the TPC-H dbgen distributions:
+  * 1.5M orders per unit of scale factor with 1..7 lines each.
+  */
+Tables generateTables(double scale_factor) {
+    auto int32 = std::make_shared<DataTypeInt32>();
+    auto int64 = std::make_shared<DataTypeInt64>();
+    auto string = std::make_shared<DataTypeString>();
+
+    BlockBuilder lineitem({{int64, "l_orderkey"},
+                           {moneyType(), "l_quantity"},
+                           {moneyType(), "l_extendedprice"},
+                           {moneyType(), "l_discount"},
+                           {moneyType(), "l_tax"},
+                           {string, "l_returnflag"},
+                           {string, "l_linestatus"},
+                           {int32, "l_shipdate"}});
+    BlockBuilder orders({{int64, "o_orderkey"},
+                         {int64, "o_custkey"},
+                         {int32, "o_orderdate"},
+                         {int32, "o_shippriority"}});
+
+    Tables tables;
+    std::mt19937_64 rng(DEFAULT_SEED);
+    auto uniform = [&](Int64 min, Int64 max) { return min + Int64(rng() % (max - min + 1)); };
+
+    const size_t orders_count = std::max<size_t>(1, 1500000 * scale_factor);
+    const size_t customers_count = std::max<size_t>(1, 150000 * scale_factor);
+
+    for (size_t order = 0; order < orders_count; ++order) {
+        const Int64 orderkey = order + 1;
+        const Int32 orderdate = uniform(DATE_1992_01_01, DATE_1998_08_02);
+
+        auto& o = orders.columns();
+        o[Orders::orderkey]->insert(orderkey);
+        o[Orders::custkey]->insert(Int64(rng() % customers_count + 1));
+        o[Orders::orderdate]->insert(Int64(orderdate));
+        o[Orders::shippriority]->insert(Int64(0));
+        orders.rowAdded(tables.orders);
+        ++tables.orders_rows;
+
+        const Int64 lines = uniform(1, 7);
+        for (Int64 line = 0; line < lines; ++line) {
+            const Int64 quantity = uniform(1, 50);
+            const Int64 part_price_cents = uniform(90000, 200000);
+            const Int32 shipdate = orderdate + uniform(1, 121);
+            const Int32 receiptdate = shipdate + uniform(1, 30);
+            const char* returnflag = receiptdate <= DATE_1995_06_17 ? (rng() % 2 ? "R" : "A")
+                                                                     : "N";
+            const char* linestatus = shipdate > DATE_1995_06_17 ? "O" : "F";
+
+            auto& l = lineitem.columns();
+            l[Lineitem::orderkey]->insert(orderkey);
+            l[Lineitem::quantity]->insert(money(quantity * 100));
+            l[Lineitem::extendedprice]->insert(money(quantity * part_price_cents));
+            l[Lineitem::discount]->insert(money(uniform(0, 10)));
+            l[Lineitem::tax]->insert(money(uniform(0, 8)));
+            l[Lineitem::returnflag]->insertData(returnflag, 1);
+            l[Lineitem::linestatus]->insertData(linestatus, 1);
+            l[Lineitem::shipdate]->insert(Int64(shipdate));
+            lineitem.rowAdded(tables.lineitem);
+            ++tables.lineitem_rows;
+        }
+    }
+    orders.flush(tables.orders);
+    lineitem.flush(tables.lineitem);
+    return tables;
+}
+
+double scale_factor = 0.1;
+bool profile_queries = false;
+std::string trace_dir;
+
+const Tables& tables() {
+    static Tables instance = generateTables(scale_factor);
+    return instance;
+}
+
+size_t bytes(const std::vector<Block>& blocks) {
+    size_t res = 0;
+    for (const auto& block : blocks) res += block.bytes();
+    return res;
+}
+
+/** The largest amount of memory a single iteration of a query held at once,
+  * counted from a baseline taken when the iteration starts, so tables loaded
+  * before and queries run earlier do not show up in it.
+  * Only the calling thread is tracked, allocations of pool threads are not seen.
+  */
+class QueryMemory {
+public:
+    void start() {
+        CurrentMemoryTracker::resetPeak();
+        baseline = CurrentMemoryTracker::currentBytes();
+    }
+
+    void stop() { peak = std::max(peak, CurrentMemoryTracker::peakBytes() - baseline); }
+
+    void report(benchmark::State& state) const {
+        state.counters["peak_memory_mb"] = double(peak) / (1 << 20);
+    }
+
+private:
+    Int64 baseline = 0;
+    Int64 peak = 0;
+};
+
+/// Wall time of every stage of a pipeline, accumulated over all iterations.
+class StageTimer {
+public:
+    class Scope {
+    public:
+        Scope(StageTimer& timer_, const char* name_)
+                : timer(timer_),
+                  name(name_),
+                  operator_scope(timer.nodes[name], name, 0),
+                  perf_events_scope(),
+                  trace_scope(name),
+                  start(std::chrono::steady_clock::now()) {}
+        ~Scope() { timer.elapsed[name] += std::chrono::steady_clock::now() - start; }
+
+    private:
+        StageTimer& timer;
+        const char* name;
+        QueryProfile::OperatorScope operator_scope;
+        PerfEventsScope perf_events_scope;
+        TraceScope trace_scope;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    Scope stage(const char* name) { return Scope(*this, name); }
+
+    void report(benchmark::State& state) const {
+        for (const auto& [name, duration] : elapsed) {
+            state.counters[std::string(name) + "_ms"] = benchmark::Counter(
+                    std::chrono::duration<double, std::milli>(duration).count(),
+                    benchmark::Counter::kAvgIterations);
+        }
+    }
+
+private:
+    std::map<std::string, std::chrono::steady_clock::duration> elapsed;
+    std::map<std::string, ProfileNodeHandle> nodes;
+};
+
+/// Profiles the benchmark if --profile is specified and traces it if --trace is specified.
+class OptionalProfile {
+public:
+    explicit OptionalProfile(const char* name_) : name(name_) {
+        if (profile_queries) {
+            profile = std::make_unique<QueryProfile>(name);
+            scope = std::make_unique<QueryProfile::Scope>(*profile);
+        }
+        if (!trace_dir.empty()) {
+            trace = std::make_unique<QueryTrace>(name);
+            trace_scope = std::make_unique<QueryTrace::Scope>(*trace);
+        }
+    }
+
+    ~OptionalProfile() {
+        if (profile) {
+            scope.reset();
+            std::cerr << profile->snapshot().toString();
+        }
+        if (trace) {
+            trace_scope.reset();
+            std::string path = trace_dir + "/" + name + ".json";
+            std::ofstream(path) << trace->toChromeTrace();
+            std::cerr << "trace of " << name << " is written to " << path << std::endl;
+        }
+    }
+
+private:
+    std::string name;
+    std::unique_ptr<QueryProfile> profile;
+    std::unique_ptr<QueryProfile::Scope> scope;
+    std::unique_ptr<QueryTrace> trace;
+    std::unique_ptr<QueryTrace::Scope> trace_scope;
+};
+
+/// Appends a constant column to the block and returns its position.
+size_t addConstant(Block& block, const DataTypePtr& type, const Field& value) {
+    block.insert({type->createColumnConst(block.rows(), value), type,
+                  "const_" + std::to_string(block.columns())});
+    return block.columns() - 1;
+}
+
+/// Appends result of the function to the block and returns its position.
+size_t execute(Block& block, const std::string& name, const ColumnNumbers& arguments) {
+    ColumnsWithTypeAndName columns;
+    for (auto position : arguments) columns.push_back(block.getByPosition(position));
+
+    auto function = SimpleFunctionFactory::instance().get_function(name, columns);
+    if (!function)
+        throw Exception("Unknown function " + name, ErrorCodes::LOGICAL_ERROR);
+
+    size_t result = block.columns();
+    block.insert({nullptr, function->getReturnType(), name + "_" + std::to_string(result)});
+    function->execute(block, arguments, result, block.rows());
+    return result;
+}
+
+/// Block with the given columns of the table block, in the given order.
+template <typename Column>
+Block project(const Block& block, std::initializer_list<Column> columns) {
+    Block res;
+    for (auto column : columns) res.insert(block.getByPosition(column));
+    return res;
+}
+
+/// Several aggregate functions computed together. States of one group
+/// are allocated as a single piece of memory in the arena.
+class AggregateStates {
+public:
+    AggregateStates(std::initializer_list<std::pair<std::string, DataTypes>> functions_) {
+        for (const auto& [name, arguments] : functions_) {
+            auto function = AggregateFunctionSimpleFactory::instance().get(name, arguments, {});
+            total_size = (total_size + function->alignOfData() - 1) / function->alignOfData() *
+                         function->alignOfData();
+            offsets.push_back(total_size);
+            total_size += function->sizeOfData();
+            align = std::max(align, function->alignOfData());
+            functions.push_back(function);
+        }
+    }
+
+    AggregateDataPtr create(Arena& arena) const {
+        auto place = arena.alignedAlloc(total_size, align);
+        for (size_t i = 0; i < functions.size(); ++i) functions[i]->create(place + offsets[i]);
+        places.push_back(place);
+        return place;
+    }
+
+    /// columns[i] is the argument of i-th function (nullptr if it has none).
+    void addBatch(size_t rows, AggregateDataPtr* row_places, const IColumn** columns,
+                  Arena& arena) const {
+        for (size_t i = 0; i < functions.size(); ++i)
+            functions[i]->addBatch(rows, row_places, offsets[i], &columns[i], &arena);
+    }
+
+    void addBatchSinglePlace(size_t rows, AggregateDataPtr place, const IColumn** columns,
+                             Arena& arena) const {
+        for (size_t i = 0; i < functions.size(); ++i)
+            functions[i]->addBatchSinglePlace(rows, place + offsets[i], &columns[i], &arena);
+    }
+
+    MutableColumns createResultColumns() const {
+        MutableColumns res;
+        for (const auto& function : functions) res.push_back(function->getReturnType()->createColumn());
+        return res;
+    }
+
+    void insertResultsInto(AggregateDataPtr place, MutableColumns& to) const {
+        for (size_t i = 0; i < functions.size(); ++i)
+            functions[i]->insertResultInto(place + offsets[i], *to[i]);
+    }
+
+    void destroyAll() {
+        for (auto place : places)
+            for (size_t i = 0; i < functions.size(); ++i) functions[i]->destroy(place + offsets[i]);
+        places.clear();
+    }
+
+    ~AggregateStates() { destroyAll(); }
+
+private:
+    std::vector<AggregateFunctionPtr> functions;
+    std::vector<size_t> offsets;
+    size_t total_size = 0;
+    size_t align = 1;
+    mutable std::vector<AggregateDataPtr> places;
+};
+
+void reportCommon(benchmark::State& state, const StageTimer& timer, size_t result_rows) {
+    const auto& data = tables();
+    timer.report(state);
+    state.SetItemsProcessed(int64_t(state.iterations()) * data.lineitem_rows);
+    state.SetBytesProcessed(int64_t(state.iterations()) * bytes(data.lineitem));
+    state.counters["result_rows"] = result_rows;
+}
+
+/** Q6, forecasting revenue change:
+  *   SELECT sum(l_extendedprice * l_discount) FROM lineitem
+  *   WHERE l_shipdate >= '1994-01-01' AND l_shipdate < '1995-01-01'
+  *     AND l_discount BETWEEN 0.05 AND 0.07 AND l_quantity < 24
+  */
+
+/// The columns of lineitem used by Q6.
+Block projectQ6(const Block& input) {
+    return project(input, {Lineitem::extendedprice, Lineitem::discount, Lineitem::quantity,
+                           Lineitem::shipdate});
+}
+
+/// Leaves (l_extendedprice, l_discount) of the rows that pass the WHERE of Q6.
+void filterQ6(Block& block) {
+    auto int32 = std::make_shared<DataTypeInt32>();
+    size_t date_from =
+            execute(block, "ge", {3, addConstant(block, int32, Int64(DATE_1994_01_01))});
+    size_t date_to = execute(block, "lt", {3, addConstant(block, int32, Int64(DATE_1995_01_01))});
+    size_t discount_from = execute(block, "ge", {1, addConstant(block, moneyType(), money(5))});
+    size_t discount_to = execute(block, "le", {1, addConstant(block, moneyType(), money(7))});
+    size_t quantity = execute(block, "lt", {2, addConstant(block, moneyType(), money(2400))});
+    size_t predicate = execute(block, "and", {date_from, date_to});
+    predicate = execute(block, "and", {predicate, discount_from});
+    predicate = execute(block, "and", {predicate, discount_to});
+    predicate = execute(block, "and", {predicate, quantity});
+    Block::filter_block(&block, predicate, 2);
+}
+
+void benchmarkQ6(benchmark::State& state) {
+    const auto& data = tables();
+    StageTimer timer;
+    OptionalProfile profile("q6");
+    size_t result_rows = 0;
+    QueryMemory memory;
+
+    for (auto _ : state) {
+        memory.start();
+        Arena arena;
+        AggregateStates aggregates({{"sum", {createDecimal(18, 4)}}});
+        AggregateDataPtr place = aggregates.create(arena);
+
+        for (const auto& input : data.lineitem) {
+            Block block;
+            {
+                auto scope = timer.stage("filter");
+                block = projectQ6(input);
+                filterQ6(block);
+            }
+            if (block.rows() == 0) continue;
+
+            size_t revenue;
+            {
+                auto scope = timer.stage("expression");
+                revenue = execute(block, "multiply", {0, 1});
+            }
+            {
+                auto scope = timer.stage("aggregate");
+                const IColumn* columns[] = {block.getByPosition(revenue).column.get()};
+                aggregates.addBatchSinglePlace(block.rows(), place, columns, arena);
+            }
+        }
+
+        auto result = aggregates.createResultColumns();
+        aggregates.insertResultsInto(place, result);
+        result_rows = result[0]->size();
+        benchmark::DoNotOptimize(result);
+        memory.stop();
+    }
+    reportCommon(state, timer, result_rows);
+    memory.report(state);
+}
+
+/// The WHERE of Q6 as a step of a pipeline.
+class FilterQ6Transform : public IBlockTransform {
+public:
+    String getName() const override { return "FilterQ6"; }
+    void transform(Block& block, size_t) override { filterQ6(block); }
+};
+
+/// Q6 on all CPUs: lineitem is cut into morsels processed by PipelineExecutor.
+void benchmarkQ6Parallel(benchmark::State& state) {
+    const auto& data = tables();
+    StageTimer timer;
+    OptionalProfile profile("q6_parallel");
+    size_t result_rows = 0;
+
+    WorkStealingThreadPool pool;
+    /// Every morsel resolves and prepares about ten functions in filterQ6(),
+    /// so morsels are larger than the default to keep that overhead small.
+    PipelineSettings settings;
+    settings.morsel_rows = 16384;
+    ColumnsWithTypeAndName money_arguments = {{nullptr, moneyType(), ""},
+                                              {nullptr, moneyType(), ""}};
+    auto multiply = SimpleFunctionFactory::instance().get_function("multiply", money_arguments);
+    auto sum =
+            AggregateFunctionSimpleFactory::instance().get("sum", {multiply->getReturnType()}, {});
+
+    for (auto _ : state) {
+        auto aggregate = std::make_shared<PartialAggregateTransform>(
+                std::vector<AggregateFunctionPtr> {sum}, std::vector<ColumnNumbers> {{2}},
+                pool.getNumberOfThreads());
+        size_t next_block = 0;
+        PipelineExecutor executor(
+                pool,
+                [&]() -> Block {
+                    if (next_block == data.lineitem.size()) return {};
+                    return projectQ6(data.lineitem[next_block++]);
+                },
+                {std::make_shared<FilterQ6Transform>(),
+                 std::make_shared<ExpressionTransform>(multiply, ColumnNumbers {0, 1}), aggregate},
+                settings);
+        executor.execute();
+
+        Block result = aggregate->finalize();
+        result_rows = result.rows();
+        benchmark::DoNotOptimize(result);
+    }
+    state.counters["threads"] = pool.getNumberOfThreads();
+    reportCommon(state, timer, result_rows);
+}
+
+/** Q1, pricing summary report:
+  *   SELECT l_returnflag, l_linestatus, sum(l_quantity), sum(l_extendedprice),
+  *          sum(l_extendedprice * (1 - l_discount)),
+  *          sum(l_extendedprice * (1 - l_discount) * (1 + l_tax)),
+  *          sum(CAST(l_discount AS Float64)), count(*)
+  *   FROM lineitem WHERE l_shipdate <= '1998-09-02'
+  *   GROUP BY l_returnflag, l_linestatus
+  */
+void benchmarkQ1(benchmark::State& state) {
+    const auto& data = tables();
+    StageTimer timer;
+    OptionalProfile profile("q1");
+    size_t result_rows = 0;
+    QueryMemory memory;
+
+    using Map = HashMap<UInt16, AggregateDataPtr>;
+
+    for (auto _ : state) {
+        memory.start();
+        Arena arena;
+        Map map;
+        std::vector<AggregateDataPtr> places;
+        AggregateStates aggregates({{"sum", {moneyType()}},
+                                    {"sum", {moneyType()}},
+                                    {"sum", {createDecimal(18, 4)}},
+                                    {"sum", {createDecimal(18, 6)}},
+                                    {"sum", {std::make_shared<DataTypeFloat64>()}},
+                                    {"count", {}}});
+
+        for (const auto& input : data.lineitem) {
+            Block block;
+            {
+                auto scope = timer.stage("filter");
+                block = project(input, {Lineitem::returnflag, Lineitem::linestatus,
+                                        Lineitem::quantity, Lineitem::extendedprice,
+                                        Lineitem::discount, Lineitem::tax, Lineitem::shipdate});
+                size_t predicate = execute(
+                        block, "le",
+                        {6, addConstant(block, std::make_shared<DataTypeInt32>(),
+                                        Int64(DATE_1998_09_02))});
+                Block::filter_block(&block, predicate, 6);
+            }
+            if (block.rows() == 0) continue;
+
+            size_t disc_price, charge, discount;
+            {
+                auto scope = timer.stage("expression");
+                size_t one = addConstant(block, moneyType(), money(100));
+                disc_price = execute(block, "multiply", {3, execute(block, "subtract", {one, 4})});
+                charge = execute(block, "multiply", {disc_price, execute(block, "add", {one, 5})});
+                size_t float64 = addConstant(block, std::make_shared<DataTypeString>(),
+                                             String("Float64"));
+                discount = execute(block, "CAST", {4, float64});
+            }
+            {
+                auto scope = timer.stage("aggregate");
+                const size_t rows = block.rows();
+                const auto& returnflag =
+                        assert_cast<const ColumnString&>(*block.getByPosition(0).column);
+                const auto& linestatus =
+                        assert_cast<const ColumnString&>(*block.getByPosition(1).column);
+
+                places.resize(rows);
+                for (size_t i = 0; i < rows; ++i) {
+                    UInt16 key = UInt16(UInt8(returnflag.getDataAt(i).data[0])) << 8 |
+                                 UInt8(linestatus.getDataAt(i).data[0]);
+                    Map::LookupResult it;
+                    bool inserted;
+                    map.emplace(key, it, inserted);
+                    if (inserted) it->getSecond() = aggregates.create(arena);
+                    places[i] = it->getSecond();
+                }
+
+                const IColumn* columns[] = {block.getByPosition(2).column.get(),
+                                            block.getByPosition(3).column.get(),
+                                            block.getByPosition(disc_price).column.get(),
+                                            block.getByPosition(charge).column.get(),
+                                            block.getByPosition(discount).column.get(),
+                                            nullptr};
+                aggregates.addBatch(rows, places.data(), columns, arena);
+            }
+        }
+
+        auto scope = timer.stage("finalize");
+        auto result = aggregates.createResultColumns();
+        map.forEachValue(
+                [&](const auto&, auto& place) { aggregates.insertResultsInto(place, result); });
+        result_rows = result[0]->size();
+        benchmark::DoNotOptimize(result);
+        memory.stop();
+    }
+    reportCommon(state, timer, result_rows);
+    memory.report(state);
+}
+
+/** Q3-like join, shipping priority without the customer table:
+  *   SELECT l_orderkey, sum(l_extendedprice * (1 - l_discount)) AS revenue
+  *   FROM orders JOIN lineitem ON l_orderkey = o_orderkey
+  *   WHERE o_orderdate < '1995-03-15' AND l_shipdate > '1995-03-15'
+  *   GROUP BY l_orderkey ORDER BY revenue DESC LIMIT 10
+  */
+void benchmarkQ3(benchmark::State& state) {
+    const auto& data = tables();
+    StageTimer timer;
+    OptionalProfile profile("q3");
+    size_t result_rows = 0;
+    QueryMemory memory;
+
+    using JoinMap = HashMap<Int64, Int32, HashCRC32<Int64>>;
+    using AggregateMap = HashMap<Int64, AggregateDataPtr, HashCRC32<Int64>>;
+    auto int32 = std::make_shared<DataTypeInt32>();
+
+    for (auto _ : state) {
+        memory.start();
+        Arena arena;
+        JoinMap join_map;
+        AggregateMap aggregate_map;
+        std::vector<AggregateDataPtr> places;
+        AggregateStates aggregates({{"sum", {createDecimal(18, 4)}}});
+
+        for (const auto& input : data.orders) {
+            auto scope = timer.stage("build");
+            Block block = project(input, {Orders::orderkey, Orders::orderdate});
+            size_t predicate =
+                    execute(block, "lt", {1, addConstant(block, int32, Int64(DATE_1995_03_15))});
+            Block::filter_block(&block, predicate, 2);
+
+            const auto& orderkey = assert_cast<const ColumnInt64&>(*block.getByPosition(0).column);
+            const auto& orderdate = assert_cast<const ColumnInt32&>(*block.getByPosition(1).column);
+            for (size_t i = 0; i < block.rows(); ++i) {
+                JoinMap::LookupResult it;
+                bool inserted;
+                join_map.emplace(orderkey.getData()[i], it, inserted);
+                it->getSecond() = orderdate.getData()[i];
+            }
+        }
+
+        for (const auto& input : data.lineitem) {
+            Block block;
+            {
+                auto scope = timer.stage("filter");
+                block = project(input, {Lineitem::orderkey, Lineitem::extendedprice,
+                                        Lineitem::discount, Lineitem::shipdate});
+                size_t predicate = execute(
+                        block, "gt", {3, addConstant(block, int32, Int64(DATE_1995_03_15))});
+                Block::filter_block(&block, predicate, 3);
+            }
+            if (block.rows() == 0) continue;
+            {
+                auto scope = timer.stage("probe");
+                const auto& orderkey =
+                        assert_cast<const ColumnInt64&>(*block.getByPosition(0).column);
+                auto matched = ColumnUInt8::create(block.rows());
+                for (size_t i = 0; i < block.rows(); ++i)
+                    matched->getData()[i] = join_map.find(orderkey.getData()[i]) != nullptr;
+                block.insert({std::move(matched), std::make_shared<DataTypeUInt8>(), "matched"});
+                Block::filter_block(&block, block.columns() - 1, 3);
+            }
+            if (block.rows() == 0) continue;
+
+            size_t revenue;
+            {
+                auto scope = timer.stage("expression");
+                size_t one = addConstant(block, moneyType(), money(100));
+                revenue = execute(block, "multiply", {1, execute(block, "subtract", {one, 2})});
+            }
+            {
+                auto scope = timer.stage("aggregate");
+                const size_t rows = block.rows();
+                const auto& orderkey =
+                        assert_cast<const ColumnInt64&>(*block.getByPosition(0).column);
+                places.resize(rows);
+                for (size_t i = 0; i < rows; ++i) {
+                    AggregateMap::LookupResult it;
+                    bool inserted;
+                    aggregate_map.emplace(orderkey.getData()[i], it, inserted);
+                    if (inserted) it->getSecond() = aggregates.create(arena);
+                    places[i] = it->getSecond();
+                }
+                const IColumn* columns[] = {block.getByPosition(revenue).column.get()};
+                aggregates.addBatch(rows, places.data(), columns, arena);
+            }
+        }
+
+        auto scope = timer.stage("sort");
+        auto keys = ColumnInt64::create();
+        auto result = aggregates.createResultColumns();
+        aggregate_map.forEachValue([&](const auto& key, auto& place) {
+            keys->insertValue(key);
+            aggregates.insertResultsInto(place, result);
+        });
+        IColumn::Permutation permutation;
+        result[0]->getPermutation(true, 10, 1, permutation);
+        auto top_keys = keys->permute(permutation, 10);
+        auto top_revenue = result[0]->permute(permutation, 10);
+        result_rows = top_keys->size();
+        benchmark::DoNotOptimize(top_revenue);
+        memory.stop();
+    }
+    reportCommon(state, timer, result_rows);
+    memory.report(state);
+}
+
+} // namespace
+
+} // namespace bench
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    using namespace doris::vectorized::bench;
+
+    /// Our own flags go first and are removed before google benchmark sees them.
+    int benchmark_argc = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--scale_factor=", 0) == 0)
+            scale_factor = std::stod(arg.substr(strlen("--scale_factor=")));
+        else if (arg == "--profile")
+            profile_queries = true;
+        else if (arg.rfind("--trace=", 0) == 0)
+            trace_dir = arg.substr(strlen("--trace="));
+        else
+            argv[benchmark_argc++] = argv[i];
+    }
+    argc = benchmark_argc;
+
+    const auto& data = tables();
+    std::cerr << "scale_factor=" << scale_factor << " lineitem=" << data.lineitem_rows
+              << " rows, " << bytes(data.lineitem) << " bytes; orders=" << data.orders_rows
+              << " rows, " << bytes(data.orders) << " bytes" << std::endl;
+
+    for (auto [name, function] : {std::pair{"tpch/q1", benchmarkQ1},
+                                  std::pair{"tpch/q3", benchmarkQ3},
+                                  std::pair{"tpch/q6", benchmarkQ6},
+                                  std::pair{"tpch/q6_parallel", benchmarkQ6Parallel}}) {
+        benchmark::RegisterBenchmark(name, function)
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+    }
+
+    ::benchmark::Initialize(&argc, argv);
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -31,8 +31,8 @@
 namespace doris::vectorized {
 
 class Arena;
-// class ReadBuffer;
-// class WriteBuffer;
+class BufferReadable;
+class BufferWritable;
 class IColumn;
 class IDataType;
 
@@ -100,10 +100,17 @@ public:
     virtual void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const = 0;
 
     /// Serializes state (to transmit it over the network, for example).
-    // virtual void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const = 0;
+    virtual void serialize(ConstAggregateDataPtr /* place */, BufferWritable& /* buf */) const {
+        throw Exception("Method serialize is not supported for " + getName(),
+                        ErrorCodes::NOT_IMPLEMENTED);
+    }
 
     /// Deserializes state. This function is called only for empty (just created) states.
-    // virtual void deserialize(AggregateDataPtr place, ReadBuffer & buf, Arena * arena) const = 0;
+    virtual void deserialize(AggregateDataPtr /* place */, BufferReadable& /* buf */,
+                             Arena* /* arena */) const {
+        throw Exception("Method deserialize is not supported for " + getName(),
+                        ErrorCodes::NOT_IMPLEMENTED);
+    }
 
     /// Returns true if a function requires Arena to handle own states (see add(), merge(), deserialize()).
     virtual bool allocatesMemoryInArena() const { return false; }
@@ -147,6 +154,19 @@ public:
     virtual void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place,
                                      const IColumn** columns, Arena* arena) const = 0;
 
+    /** The same for single place, skipping the rows where null_map is not 0.
+      * It is used by the Null combinator, so that the nested function reduces the batch at once.
+      */
+    virtual void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                            const IColumn** columns, const UInt8* null_map,
+                                            Arena* arena) const = 0;
+
+    /** Adds the row row_num of the columns count times, for a run of equal rows (see ColumnRLE).
+      * Functions like sum and count override it to add the whole run at once.
+      */
+    virtual void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+                         size_t count, Arena* arena) const = 0;
+
     /** This is used for runtime code generation to determine, which header files to include in generated source.
       * Always implement it as
       * const char * getHeaderFilePath() const override { return __FILE__; }
@@ -187,6 +207,19 @@ public:
         for (size_t i = 0; i < batch_size; ++i)
             static_cast<const Derived*>(this)->add(place, columns, i, arena);
     }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena* arena) const override {
+        for (size_t i = 0; i < batch_size; ++i)
+            if (!null_map[i]) static_cast<const Derived*>(this)->add(place, columns, i, arena);
+    }
+
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena* arena) const override {
+        for (size_t i = 0; i < count; ++i)
+            static_cast<const Derived*>(this)->add(place, columns, row_num, arena);
+    }
 };
 
 /// Implements several methods for manipulation with data. T - type of structure with data for aggregation.
@@ -0,0 +1,142 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+template <typename T>
+struct AggregateFunctionAvgData {
+    T sum {};
+    UInt64 count = 0;
+};
+
+/** Calculates the arithmetic mean of the numbers.
+  * The result is Float64 for numbers and Decimal128 with the scale of the argument for decimals.
+  * The batch loops only add up the values and count them, so that the compiler vectorizes them.
+  */
+template <typename T>
+class AggregateFunctionAvg final
+        : public IAggregateFunctionDataHelper<
+                  AggregateFunctionAvgData<std::conditional_t<IsDecimalNumber<T>, Int128,
+                                                              NearestFieldType<T>>>,
+                  AggregateFunctionAvg<T>> {
+public:
+    using SumType = std::conditional_t<IsDecimalNumber<T>, Int128, NearestFieldType<T>>;
+    using ResultType = std::conditional_t<IsDecimalNumber<T>, Decimal128, Float64>;
+    using ResultDataType = std::conditional_t<IsDecimalNumber<T>, DataTypeDecimal<ResultType>,
+                                              DataTypeNumber<ResultType>>;
+    using ColVecType = std::conditional_t<IsDecimalNumber<T>, ColumnDecimal<T>, ColumnVector<T>>;
+    using ColVecResult = std::conditional_t<IsDecimalNumber<T>, ColumnDecimal<ResultType>,
+                                            ColumnVector<ResultType>>;
+
+    AggregateFunctionAvg(const DataTypePtr& type)
+            : IAggregateFunctionDataHelper<AggregateFunctionAvgData<SumType>,
+                                           AggregateFunctionAvg<T>>({type}, {}),
+              scale(getDecimalScale(*type, 0)) {}
+
+    String getName() const override { return "avg"; }
+
+    DataTypePtr getReturnType() const override {
+        if constexpr (IsDecimalNumber<T>)
+            return std::make_shared<ResultDataType>(ResultDataType::maxPrecision(), scale);
+        else
+            return std::make_shared<ResultDataType>();
+    }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        const auto& column = assert_cast<const ColVecType&>(*columns[0]);
+        this->data(place).sum += static_cast<SumType>(column.getData()[row_num]);
+        ++this->data(place).count;
+    }
+
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena*) const override {
+        const auto& column = assert_cast<const ColVecType&>(*columns[0]);
+        this->data(place).sum += static_cast<SumType>(column.getData()[row_num]) * count;
+        this->data(place).count += count;
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena*) const override {
+        const T* data = assert_cast<const ColVecType&>(*columns[0]).getData().data();
+        SumType sum {};
+        for (size_t i = 0; i < batch_size; ++i) sum += static_cast<SumType>(data[i]);
+        this->data(place).sum += sum;
+        this->data(place).count += batch_size;
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena*) const override {
+        const T* data = assert_cast<const ColVecType&>(*columns[0]).getData().data();
+        SumType sum {};
+        UInt64 count = 0;
+        for (size_t i = 0; i < batch_size; ++i) {
+            /// GCC vectorizes the multiplication, but not the select. A NULL row may hold
+            /// any float, so it is not multiplied by 0 to not get NaN from infinity.
+            if constexpr (std::is_floating_point_v<SumType>)
+                sum += null_map[i] ? SumType() : static_cast<SumType>(data[i]);
+            else
+                sum += static_cast<SumType>(data[i]) * !null_map[i];
+            count += !null_map[i];
+        }
+        this->data(place).sum += sum;
+        this->data(place).count += count;
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).sum += this->data(rhs).sum;
+        this->data(place).count += this->data(rhs).count;
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        buf.write_binary(this->data(place).sum);
+        buf.write_binary(this->data(place).count);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        buf.read_binary(this->data(place).sum);
+        buf.read_binary(this->data(place).count);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        const auto& data = this->data(place);
+        auto& column = assert_cast<ColVecResult&>(to);
+        if constexpr (IsDecimalNumber<T>)
+            column.getData().push_back(ResultType(data.count ? data.sum / data.count : 0));
+        else
+            column.getData().push_back(static_cast<Float64>(data.sum) / data.count);
+    }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+
+private:
+    UInt32 scale;
+};
+
+} // namespace doris::vectorized
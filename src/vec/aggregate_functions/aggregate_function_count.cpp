@@ -15,27 +15,28 @@
 // specific language governing permissions and limitations
 // under the License.
 
-// #include <AggregateFunctions/AggregateFunctionFactory.h>
-#include <vec/aggregate_functions/aggregate_function_count.h>
-#include <vec/aggregate_functions/factory_helpers.h>
+#include "vec/aggregate_functions/aggregate_function_count.h"
 
-namespace DB {
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/aggregate_functions/factory_helpers.h"
+
+namespace doris::vectorized {
 
 namespace {
 
-// AggregateFunctionPtr createAggregateFunctionCount(const std::string & name, const DataTypes & argument_types, const Array & parameters)
-// {
-//     assertNoParameters(name, parameters);
-//     assertArityAtMost<1>(name, argument_types);
+AggregateFunctionPtr createAggregateFunctionCount(const std::string& name,
+                                                  const DataTypes& argument_types,
+                                                  const Array& parameters) {
+    assertNoParameters(name, parameters);
+    assertArityAtMost<1>(name, argument_types);
 
-//     return std::make_shared<AggregateFunctionCount>(argument_types);
-// }
+    return std::make_shared<AggregateFunctionCount>(argument_types);
+}
 
 } // namespace
 
-// void registerAggregateFunctionCount(AggregateFunctionFactory & factory)
-// {
-//     factory.registerFunction("count", createAggregateFunctionCount, AggregateFunctionFactory::CaseInsensitive);
-// }
+void registerAggregateFunctionCount(AggregateFunctionSimpleFactory& factory) {
+    factory.registerFunction("count", createAggregateFunctionCount);
+}
 
-} // namespace DB
+} // namespace doris::vectorized
@@ -17,12 +17,10 @@
 
 #pragma once
 
-// #include <IO/VarInt.h>
-// #include <IO/WriteHelpers.h>
-
 #include <vec/aggregate_functions/aggregate_function.h>
 #include <vec/columns/column_nullable.h>
 #include <vec/common/assert_cast.h>
+#include <vec/common/string_buffer.hpp>
 #include <vec/data_types/data_types_number.h>
 
 #include <array>
@@ -33,6 +31,13 @@ struct AggregateFunctionCountData {
     UInt64 count = 0;
 };
 
+/// The number of zeros in [data, data + size), the loop is vectorized by the compiler.
+inline UInt64 countZeros(const UInt8* data, size_t size) {
+    UInt64 count = 0;
+    for (size_t i = 0; i < size; ++i) count += !data[i];
+    return count;
+}
+
 namespace ErrorCodes {
 extern const int LOGICAL_ERROR;
 extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
@@ -53,19 +58,32 @@ public:
         ++data(place).count;
     }
 
+    void addMany(AggregateDataPtr place, const IColumn**, size_t, size_t count,
+                 Arena*) const override {
+        data(place).count += count;
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn**,
+                             Arena*) const override {
+        data(place).count += batch_size;
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place, const IColumn**,
+                                    const UInt8* null_map, Arena*) const override {
+        data(place).count += countZeros(null_map, batch_size);
+    }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
         data(place).count += data(rhs).count;
     }
 
-    // void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const override
-    // {
-    //     writeVarUInt(data(place).count, buf);
-    // }
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        buf.write_binary(data(place).count);
+    }
 
-    // void deserialize(AggregateDataPtr place, ReadBuffer & buf, Arena *) const override
-    // {
-    //     readVarUInt(data(place).count, buf);
-    // }
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        buf.read_binary(data(place).count);
+    }
 
     void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
         assert_cast<ColumnUInt64&>(to).getData().push_back(data(place).count);
@@ -98,19 +116,39 @@ public:
         data(place).count += !assert_cast<const ColumnNullable&>(*columns[0]).isNullAt(row_num);
     }
 
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena*) const override {
+        if (!assert_cast<const ColumnNullable&>(*columns[0]).isNullAt(row_num))
+            data(place).count += count;
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena*) const override {
+        const auto& column = assert_cast<const ColumnNullable&>(*columns[0]);
+        data(place).count += countZeros(column.getNullMapData().data(), batch_size);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena*) const override {
+        const UInt8* is_null =
+                assert_cast<const ColumnNullable&>(*columns[0]).getNullMapData().data();
+        UInt64 count = 0;
+        for (size_t i = 0; i < batch_size; ++i) count += !(null_map[i] | is_null[i]);
+        data(place).count += count;
+    }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
         data(place).count += data(rhs).count;
     }
 
-    // void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const override
-    // {
-    //     writeVarUInt(data(place).count, buf);
-    // }
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        buf.write_binary(data(place).count);
+    }
 
-    // void deserialize(AggregateDataPtr place, ReadBuffer & buf, Arena *) const override
-    // {
-    //     readVarUInt(data(place).count, buf);
-    // }
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        buf.read_binary(data(place).count);
+    }
 
     void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
         assert_cast<ColumnUInt64&>(to).getData().push_back(data(place).count);
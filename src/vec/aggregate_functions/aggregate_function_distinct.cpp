@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_distinct.h"
+
+#include "vec/aggregate_functions/aggregate_function_combinator.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+}
+
+void AggregateFunctionDistinct::insertResultInto(ConstAggregateDataPtr place, IColumn& to) const {
+    MutableColumns columns(num_arguments);
+    for (size_t i = 0; i < num_arguments; ++i) columns[i] = argument_types[i]->createColumn();
+    const auto& set = data(place).set;
+    for (auto it = set.begin(); it != set.end(); ++it) {
+        const char* pos = it->getValue().data;
+        for (auto& column : columns) pos = column->deserializeAndInsertFromArena(pos);
+    }
+
+    std::vector<const IColumn*> raw_columns;
+    for (const auto& column : columns) raw_columns.push_back(column.get());
+    Arena arena;
+    AggregateDataPtr nested_place =
+            arena.alignedAlloc(nested_func->sizeOfData(), nested_func->alignOfData());
+    nested_func->create(nested_place);
+    try {
+        nested_func->addBatchSinglePlace(set.size(), nested_place, raw_columns.data(), &arena);
+        nested_func->insertResultInto(nested_place, to);
+    } catch (...) {
+        nested_func->destroy(nested_place);
+        throw;
+    }
+    nested_func->destroy(nested_place);
+}
+
+namespace {
+
+class AggregateFunctionCombinatorDistinct final : public IAggregateFunctionCombinator {
+public:
+    String getName() const override { return "Distinct"; }
+
+    DataTypes transformArguments(const DataTypes& arguments) const override {
+        if (arguments.empty())
+            throw Exception(
+                    "Incorrect number of arguments for aggregate function with Distinct suffix",
+                    ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+        return arguments;
+    }
+
+    AggregateFunctionPtr transformAggregateFunction(const AggregateFunctionPtr& nested_function,
+                                                    const DataTypes& arguments,
+                                                    const Array&) const override {
+        return std::make_shared<AggregateFunctionDistinct>(nested_function, arguments);
+    }
+};
+
+} // namespace
+
+void registerAggregateFunctionCombinatorDistinct(AggregateFunctionSimpleFactory& factory) {
+    factory.registerCombinator(std::make_shared<AggregateFunctionCombinatorDistinct>());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,149 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/common/arena.h"
+#include "vec/common/hash_table/hash_table.h"
+#include "vec/common/hash_table/hash_table_allocator.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/common/string_ref.h"
+#include "vec/data_types/data_type.h"
+
+namespace doris::vectorized {
+
+/** The distinct rows of the arguments. A row is the values of all arguments serialized into
+  *  the Arena one after another (IColumn::serializeValueIntoArena), and the set holds
+  *  the references to them. The memory of a row that is already in the set is given back.
+  */
+struct AggregateFunctionDistinctData {
+    using Set = HashTable<StringRef, HashTableCell<StringRef, StringRefHash>, StringRefHash,
+                          HashTableGrower<4>, HashTableAllocator>;
+
+    Set set;
+
+    void add(const IColumn** columns, size_t num_arguments, size_t row_num, Arena* arena) {
+        const char* begin = nullptr;
+        StringRef key(begin, 0);
+        for (size_t i = 0; i < num_arguments; ++i) {
+            StringRef part = columns[i]->serializeValueIntoArena(row_num, *arena, begin);
+            key.data = part.data - key.size;
+            key.size += part.size;
+        }
+
+        Set::LookupResult it;
+        bool inserted;
+        set.emplace(key, it, inserted);
+        if (!inserted) arena->rollback(key.size);
+    }
+
+    void merge(const AggregateFunctionDistinctData& rhs, Arena* arena) {
+        for (auto it = rhs.set.begin(); it != rhs.set.end(); ++it) {
+            StringRef key = it->getValue();
+            if (set.find(key)) continue;
+            insertCopy(key, arena);
+        }
+    }
+
+    /// The number of rows, and the size and the bytes of every row.
+    void write(BufferWritable& buf) const {
+        buf.write_binary(UInt64(set.size()));
+        for (auto it = set.begin(); it != set.end(); ++it) {
+            StringRef key = it->getValue();
+            buf.write_binary(UInt64(key.size));
+            buf.write(key.data, key.size);
+        }
+    }
+
+    void read(BufferReadable& buf, Arena* arena) {
+        UInt64 size;
+        buf.read_binary(size);
+        for (UInt64 i = 0; i < size; ++i) {
+            UInt64 key_size;
+            buf.read_binary(key_size);
+            char* data = arena->alloc(key_size);
+            buf.read(data, key_size);
+            insertCopy(StringRef(data, key_size), nullptr);
+        }
+    }
+
+private:
+    /// Inserts the key that is not in the set. The key is copied into the arena, if any.
+    void insertCopy(StringRef key, Arena* arena) {
+        if (arena) key.data = arena->insert(key.data, key.size);
+        Set::LookupResult it;
+        bool inserted;
+        set.emplace(key, it, inserted);
+    }
+};
+
+/** Adaptor that makes the aggregate function `aggDistinct(x, ...)` of `agg(x, ...)`:
+  *  the nested function gets every distinct row of the arguments once.
+  * The state is the set of the distinct rows only. The nested function is run over the set
+  *  when the result is inserted, so the states are merged and serialized as sets.
+  */
+class AggregateFunctionDistinct final
+        : public IAggregateFunctionDataHelper<AggregateFunctionDistinctData,
+                                              AggregateFunctionDistinct> {
+private:
+    AggregateFunctionPtr nested_func;
+    size_t num_arguments;
+
+public:
+    AggregateFunctionDistinct(AggregateFunctionPtr nested, const DataTypes& arguments)
+            : IAggregateFunctionDataHelper<AggregateFunctionDistinctData,
+                                           AggregateFunctionDistinct>(arguments,
+                                                                      nested->getParameters()),
+              nested_func(nested),
+              num_arguments(arguments.size()) {}
+
+    String getName() const override { return nested_func->getName() + "Distinct"; }
+
+    DataTypePtr getReturnType() const override { return nested_func->getReturnType(); }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena* arena) const override {
+        data(place).add(columns, num_arguments, row_num, arena);
+    }
+
+    /// A run of equal rows is one distinct row.
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t,
+                 Arena* arena) const override {
+        data(place).add(columns, num_arguments, row_num, arena);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const override {
+        data(place).merge(data(rhs), arena);
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        data(place).read(buf, arena);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override;
+
+    bool allocatesMemoryInArena() const override { return true; }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,180 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/pod_array.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+} // namespace ErrorCodes
+
+/** Not an aggregate function, but an adapter of aggregate functions,
+  *  which any aggregate function `agg(x)` makes an aggregate function of the form `aggIf(x, cond)`.
+  * The adapted aggregate function takes one more argument - a condition (UInt8),
+  *  and the row is added to the nested function only if the condition is true.
+  * The nested function gets the same columns, it does not read the last one.
+  *
+  * A batch for a single place is not filtered row by row: the condition is turned into a mask
+  *  of the rows to skip, and the nested function adds the batch by addBatchSinglePlaceNotNull.
+  * A batch for many places (GROUP BY) is compacted: the arguments are filtered by the condition,
+  *  and the nested function adds the selected rows to their places by one addBatch.
+  */
+class AggregateFunctionIf final : public IAggregateFunctionHelper<AggregateFunctionIf> {
+private:
+    AggregateFunctionPtr nested_func;
+    size_t num_arguments;
+
+    const UInt8* getCondition(const IColumn** columns) const {
+        return assert_cast<const ColumnUInt8&>(*columns[num_arguments - 1]).getData().data();
+    }
+
+public:
+    AggregateFunctionIf(AggregateFunctionPtr nested, const DataTypes& types)
+            : IAggregateFunctionHelper<AggregateFunctionIf>(types, nested->getParameters()),
+              nested_func(nested),
+              num_arguments(types.size()) {
+        if (num_arguments == 0)
+            throw Exception("Aggregate function " + getName() + " require at least one argument",
+                            ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+
+        if (!WhichDataType(types.back()).isUInt8())
+            throw Exception("Last argument for aggregate function " + getName() + " must be UInt8",
+                            ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+    }
+
+    String getName() const override { return nested_func->getName() + "If"; }
+
+    DataTypePtr getReturnType() const override { return nested_func->getReturnType(); }
+
+    void create(AggregateDataPtr place) const override { nested_func->create(place); }
+
+    void destroy(AggregateDataPtr place) const noexcept override { nested_func->destroy(place); }
+
+    bool hasTrivialDestructor() const override { return nested_func->hasTrivialDestructor(); }
+
+    size_t sizeOfData() const override { return nested_func->sizeOfData(); }
+
+    size_t alignOfData() const override { return nested_func->alignOfData(); }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena* arena) const override {
+        if (getCondition(columns)[row_num]) nested_func->add(place, columns, row_num, arena);
+    }
+
+    void addBatch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                  const IColumn** columns, Arena* arena) const override {
+        const UInt8* cond = getCondition(columns);
+        PaddedPODArray<AggregateDataPtr> selected_places(batch_size);
+        size_t selected = 0;
+        for (size_t i = 0; i < batch_size; ++i) {
+            selected_places[selected] = places[i];
+            selected += cond[i] != 0;
+        }
+        if (selected == 0) return;
+        if (selected == batch_size) {
+            nested_func->addBatch(batch_size, places, place_offset, columns, arena);
+            return;
+        }
+
+        /// IColumn::filter() needs the filter and the column of the same size.
+        IColumn::Filter filter(cond, cond + batch_size);
+        Columns filtered(num_arguments - 1);
+        std::vector<const IColumn*> filtered_columns(num_arguments - 1);
+        for (size_t i = 0; i + 1 < num_arguments; ++i) {
+            ColumnPtr column = columns[i]->getPtr();
+            if (column->size() != batch_size) column = column->cut(0, batch_size);
+            filtered[i] = column->filter(filter, selected);
+            filtered_columns[i] = filtered[i].get();
+        }
+        nested_func->addBatch(selected, selected_places.data(), place_offset,
+                              filtered_columns.data(), arena);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena* arena) const override {
+        const UInt8* cond = getCondition(columns);
+        /// The batches where the condition is the same for all rows are common.
+        if (std::find(cond, cond + batch_size, 0) == cond + batch_size) {
+            nested_func->addBatchSinglePlace(batch_size, place, columns, arena);
+            return;
+        }
+        PaddedPODArray<UInt8> skip(batch_size);
+        size_t skipped = 0;
+        for (size_t i = 0; i < batch_size; ++i) {
+            skip[i] = !cond[i];
+            skipped += skip[i];
+        }
+        if (skipped != batch_size)
+            nested_func->addBatchSinglePlaceNotNull(batch_size, place, columns, skip.data(),
+                                                    arena);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena* arena) const override {
+        const UInt8* cond = getCondition(columns);
+        PaddedPODArray<UInt8> skip(batch_size);
+        size_t skipped = 0;
+        for (size_t i = 0; i < batch_size; ++i) {
+            skip[i] = null_map[i] | !cond[i];
+            skipped += skip[i];
+        }
+        if (skipped != batch_size)
+            nested_func->addBatchSinglePlaceNotNull(batch_size, place, columns, skip.data(),
+                                                    arena);
+    }
+
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena* arena) const override {
+        if (getCondition(columns)[row_num])
+            nested_func->addMany(place, columns, row_num, count, arena);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const override {
+        nested_func->merge(place, rhs, arena);
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        nested_func->serialize(place, buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        nested_func->deserialize(place, buf, arena);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        nested_func->insertResultInto(place, to);
+    }
+
+    bool allocatesMemoryInArena() const override { return nested_func->allocatesMemoryInArena(); }
+
+    bool isState() const override { return nested_func->isState(); }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+};
+
+} // namespace doris::vectorized
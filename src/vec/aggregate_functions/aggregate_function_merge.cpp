@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_merge.h"
+
+#include "vec/aggregate_functions/aggregate_function_combinator.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+}
+
+namespace {
+
+class AggregateFunctionCombinatorMerge final : public IAggregateFunctionCombinator {
+public:
+    String getName() const override { return "Merge"; }
+
+    /// The nested function is created with the arguments of the states.
+    DataTypes transformArguments(const DataTypes& arguments) const override {
+        if (arguments.size() != 1)
+            throw Exception(
+                    "Incorrect number of arguments for aggregate function with Merge suffix",
+                    ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+
+        const auto* data_type = typeid_cast<const DataTypeAggregateFunction*>(arguments[0].get());
+        if (!data_type)
+            throw Exception("Illegal type " + arguments[0]->getName() +
+                                    " of argument for aggregate function with Merge suffix"
+                                    " must be AggregateFunction(...)",
+                            ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+
+        return data_type->getArgumentsDataTypes();
+    }
+
+    AggregateFunctionPtr transformAggregateFunction(const AggregateFunctionPtr& nested_function,
+                                                    const DataTypes& arguments,
+                                                    const Array&) const override {
+        return std::make_shared<AggregateFunctionMerge>(nested_function, arguments[0]);
+    }
+};
+
+} // namespace
+
+void registerAggregateFunctionCombinatorMerge(AggregateFunctionSimpleFactory& factory) {
+    factory.registerCombinator(std::make_shared<AggregateFunctionCombinatorMerge>());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,154 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/arena.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/common/typeid_cast.h"
+#include "vec/data_types/data_type_aggregate_function.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int BAD_ARGUMENTS;
+extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+} // namespace ErrorCodes
+
+/** Not an aggregate function, but an adapter of aggregate functions.
+  * Aggregate functions with the `Merge` suffix accept `DataTypeAggregateFunction` as an argument
+  *  (the states written by the -State combinator) and combine them,
+  *  by reading every state into a temporary one and merging it into the place.
+  * A batch reuses one temporary state for all rows. It is allocated, with the data read into it,
+  *  in an arena of the batch, which is freed at the end: merge() copies the data it keeps.
+  */
+class AggregateFunctionMerge final : public IAggregateFunctionHelper<AggregateFunctionMerge> {
+private:
+    AggregateFunctionPtr nested_func;
+
+    /// Merges the states of the rows [begin, end), except those where null_map (if any)
+    /// is not 0, into get_place(row).
+    template <typename GetPlace>
+    void mergeRows(size_t begin, size_t end, const IColumn& column, const UInt8* null_map,
+                   Arena* arena, GetPlace&& get_place) const {
+        const auto& states = assert_cast<const ColumnString&>(column);
+        Arena tmp_arena;
+        AggregateDataPtr tmp =
+                tmp_arena.alignedAlloc(nested_func->sizeOfData(), nested_func->alignOfData());
+        for (size_t i = begin; i < end; ++i) {
+            if (null_map && null_map[i]) continue;
+            BufferReadable buf(states.getDataAt(i));
+            nested_func->create(tmp);
+            try {
+                nested_func->deserialize(tmp, buf, &tmp_arena);
+                nested_func->merge(get_place(i), tmp, arena);
+            } catch (...) {
+                nested_func->destroy(tmp);
+                throw;
+            }
+            nested_func->destroy(tmp);
+        }
+    }
+
+public:
+    AggregateFunctionMerge(const AggregateFunctionPtr& nested, const DataTypePtr& argument)
+            : IAggregateFunctionHelper<AggregateFunctionMerge>({argument},
+                                                               nested->getParameters()),
+              nested_func(nested) {
+        const auto* data_type = typeid_cast<const DataTypeAggregateFunction*>(argument.get());
+        if (!data_type)
+            throw Exception("Illegal type " + argument->getName() +
+                                    " of argument for aggregate function " + getName(),
+                            ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+
+        /// The states are read by the nested function, so they must be of the same function
+        /// of the same arguments with the same parameters.
+        const DataTypes& state_arguments = data_type->getArgumentsDataTypes();
+        const DataTypes& nested_arguments = nested_func->getArgumentTypes();
+        bool same_arguments = state_arguments.size() == nested_arguments.size();
+        for (size_t i = 0; same_arguments && i < state_arguments.size(); ++i)
+            same_arguments = state_arguments[i]->equals(*nested_arguments[i]);
+
+        if (data_type->getFunctionName() != nested_func->getName() || !same_arguments ||
+            data_type->getParameters() != nested_func->getParameters())
+            throw Exception("The states of " + data_type->getName() + " can not be merged by " +
+                                    getName(),
+                            ErrorCodes::BAD_ARGUMENTS);
+    }
+
+    String getName() const override { return nested_func->getName() + "Merge"; }
+
+    DataTypePtr getReturnType() const override { return nested_func->getReturnType(); }
+
+    void create(AggregateDataPtr place) const override { nested_func->create(place); }
+
+    void destroy(AggregateDataPtr place) const noexcept override { nested_func->destroy(place); }
+
+    bool hasTrivialDestructor() const override { return nested_func->hasTrivialDestructor(); }
+
+    size_t sizeOfData() const override { return nested_func->sizeOfData(); }
+
+    size_t alignOfData() const override { return nested_func->alignOfData(); }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena* arena) const override {
+        mergeRows(row_num, row_num + 1, *columns[0], nullptr, arena,
+                  [&](size_t) { return place; });
+    }
+
+    void addBatch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                  const IColumn** columns, Arena* arena) const override {
+        mergeRows(0, batch_size, *columns[0], nullptr, arena,
+                  [&](size_t i) { return places[i] + place_offset; });
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena* arena) const override {
+        mergeRows(0, batch_size, *columns[0], nullptr, arena, [&](size_t) { return place; });
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena* arena) const override {
+        mergeRows(0, batch_size, *columns[0], null_map, arena, [&](size_t) { return place; });
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const override {
+        nested_func->merge(place, rhs, arena);
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        nested_func->serialize(place, buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        nested_func->deserialize(place, buf, arena);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        nested_func->insertResultInto(place, to);
+    }
+
+    bool allocatesMemoryInArena() const override { return nested_func->allocatesMemoryInArena(); }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,71 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_min_max_any.h"
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/aggregate_functions/factory_helpers.h"
+#include "vec/aggregate_functions/helpers.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+}
+
+namespace {
+
+template <SingleValueKind kind>
+struct SingleValue {
+    template <typename T>
+    using Function = AggregateFunctionsSingleValue<SingleValueDataFixed<T>, kind>;
+};
+
+template <SingleValueKind kind>
+AggregateFunctionPtr createAggregateFunctionSingleValue(const std::string& name,
+                                                        const DataTypes& argument_types,
+                                                        const Array& parameters) {
+    assertNoParameters(name, parameters);
+    assertUnary(name, argument_types);
+
+    const DataTypePtr& type = argument_types[0];
+    AggregateFunctionPtr res;
+    if (isString(type))
+        res = std::make_shared<AggregateFunctionsSingleValue<SingleValueDataString, kind>>(type);
+    else if (isDecimal(type))
+        res.reset(createWithDecimalType<SingleValue<kind>::template Function>(*type, type));
+    else
+        res.reset(createWithNumericType<SingleValue<kind>::template Function>(*type, type));
+
+    if (!res)
+        throw Exception("Illegal type " + type->getName() + " of argument for aggregate function " +
+                                name,
+                        ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+    return res;
+}
+
+} // namespace
+
+void registerAggregateFunctionMinMaxAny(AggregateFunctionSimpleFactory& factory) {
+    factory.registerFunction("min", createAggregateFunctionSingleValue<SingleValueKind::Min>);
+    factory.registerFunction("max", createAggregateFunctionSingleValue<SingleValueKind::Max>);
+    factory.registerFunction("any", createAggregateFunctionSingleValue<SingleValueKind::Any>);
+    factory.registerFunction("anyLast",
+                             createAggregateFunctionSingleValue<SingleValueKind::AnyLast>);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,304 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/arena.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/bit_helpers.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/data_types/data_type.h"
+
+namespace doris::vectorized {
+
+/// Which value of the rows min, max, any and anyLast keep.
+enum class SingleValueKind { Min, Max, Any, AnyLast };
+
+/// Returns the first row of [0, batch_size) where null_map (if any) is 0,
+/// or the last one for anyLast. Returns batch_size if there is no such row.
+template <SingleValueKind kind>
+size_t findSingleValueRow(size_t batch_size, const UInt8* null_map) {
+    if constexpr (kind == SingleValueKind::AnyLast) {
+        for (size_t i = batch_size; i > 0; --i)
+            if (!null_map || !null_map[i - 1]) return i - 1;
+        return batch_size;
+    }
+    return null_map ? std::find(null_map, null_map + batch_size, 0) - null_map : 0;
+}
+
+/** The state of min, max, any and anyLast for numbers and decimals.
+  * addBatch() reduces the whole batch into a local before it touches the state. The loop is a
+  *  select and a compare per row without branches, so that the compiler vectorizes it.
+  */
+template <typename T>
+struct SingleValueDataFixed {
+    using ColVecType = std::conditional_t<IsDecimalNumber<T>, ColumnDecimal<T>, ColumnVector<T>>;
+
+    static constexpr bool allocates_memory_in_arena = false;
+
+    bool has_value = false;
+    T value {};
+
+    /// True if x must be kept instead of y.
+    template <SingleValueKind kind>
+    static bool isBetter(T x, T y) {
+        if constexpr (IsDecimalNumber<T>)
+            return kind == SingleValueKind::Min ? x.value < y.value : y.value < x.value;
+        else
+            return kind == SingleValueKind::Min ? x < y : y < x;
+    }
+
+    template <SingleValueKind kind>
+    void add(T x) {
+        bool change;
+        if constexpr (kind == SingleValueKind::Min || kind == SingleValueKind::Max)
+            change = !has_value || isBetter<kind>(x, value);
+        else
+            change = !has_value || kind == SingleValueKind::AnyLast;
+        if (change) {
+            has_value = true;
+            value = x;
+        }
+    }
+
+    template <SingleValueKind kind>
+    void add(const IColumn& column, size_t row_num, Arena*) {
+        add<kind>(assert_cast<const ColVecType&>(column).getData()[row_num]);
+    }
+
+    template <SingleValueKind kind>
+    void merge(const SingleValueDataFixed& rhs, Arena*) {
+        if (rhs.has_value) add<kind>(rhs.value);
+    }
+
+    /// Adds the rows [0, batch_size) of column except those where null_map (if any) is not 0.
+    template <SingleValueKind kind>
+    void addBatch(const IColumn& column, size_t batch_size, const UInt8* null_map, Arena*) {
+        if (kind == SingleValueKind::Any && has_value) return;
+        const T* data = assert_cast<const ColVecType&>(column).getData().data();
+        size_t first = findSingleValueRow<kind>(batch_size, null_map);
+        if (first == batch_size) return;
+
+        T res = data[first];
+        if constexpr (kind == SingleValueKind::Min || kind == SingleValueKind::Max) {
+            if (null_map) {
+                /// A NULL row is replaced by a value of the batch, that does not change the result.
+                const T fill = data[first];
+                for (size_t i = first + 1; i < batch_size; ++i) {
+                    T x = data[i];
+                    if constexpr (std::is_integral_v<T>) {
+                        /// GCC does not if-convert the select below for integers, the mask does.
+                        T mask = T(null_map[i]) - 1;
+                        x = (x & mask) | (fill & ~mask);
+                    } else {
+                        x = null_map[i] ? fill : x;
+                    }
+                    res = isBetter<kind>(x, res) ? x : res;
+                }
+            } else {
+                for (size_t i = first + 1; i < batch_size; ++i)
+                    res = isBetter<kind>(data[i], res) ? data[i] : res;
+            }
+        }
+        add<kind>(res);
+    }
+
+    void insertResultInto(IColumn& to) const {
+        assert_cast<ColVecType&>(to).getData().push_back(value);
+    }
+
+    void write(BufferWritable& buf) const {
+        buf.write_binary(has_value);
+        if (has_value) buf.write_binary(value);
+    }
+
+    void read(BufferReadable& buf, Arena*) {
+        buf.read_binary(has_value);
+        if (has_value) buf.read_binary(value);
+    }
+};
+
+/** The state of min, max, any and anyLast for strings. The value is copied into the Arena.
+  * When a longer value does not fit, the buffer is allocated again with the size rounded up
+  *  to a power of two, so the memory of the replaced buffers is at most the size of the last one.
+  */
+struct SingleValueDataString {
+    static constexpr bool allocates_memory_in_arena = true;
+
+    bool has_value = false;
+    size_t size = 0;
+    size_t capacity = 0;
+    char* data = nullptr;
+
+    StringRef getStringRef() const { return StringRef(data, size); }
+
+    template <SingleValueKind kind>
+    static bool isBetter(StringRef x, StringRef y) {
+        return kind == SingleValueKind::Min ? x < y : y < x;
+    }
+
+    template <SingleValueKind kind>
+    void add(StringRef x, Arena* arena) {
+        bool change;
+        if constexpr (kind == SingleValueKind::Min || kind == SingleValueKind::Max)
+            change = !has_value || isBetter<kind>(x, getStringRef());
+        else
+            change = !has_value || kind == SingleValueKind::AnyLast;
+        if (!change) return;
+
+        if (x.size > capacity) {
+            capacity = roundUpToPowerOfTwoOrZero(x.size);
+            data = arena->alloc(capacity);
+        }
+        if (x.size) memcpy(data, x.data, x.size);
+        size = x.size;
+        has_value = true;
+    }
+
+    template <SingleValueKind kind>
+    void add(const IColumn& column, size_t row_num, Arena* arena) {
+        add<kind>(assert_cast<const ColumnString&>(column).getDataAt(row_num), arena);
+    }
+
+    template <SingleValueKind kind>
+    void merge(const SingleValueDataString& rhs, Arena* arena) {
+        if (rhs.has_value) add<kind>(rhs.getStringRef(), arena);
+    }
+
+    /// Finds the best row of the batch first, so that only one value is copied.
+    template <SingleValueKind kind>
+    void addBatch(const IColumn& column, size_t batch_size, const UInt8* null_map, Arena* arena) {
+        if (kind == SingleValueKind::Any && has_value) return;
+        const auto& strings = assert_cast<const ColumnString&>(column);
+        size_t best = findSingleValueRow<kind>(batch_size, null_map);
+        if (best == batch_size) return;
+
+        StringRef res = strings.getDataAt(best);
+        if constexpr (kind == SingleValueKind::Min || kind == SingleValueKind::Max) {
+            for (size_t i = best + 1; i < batch_size; ++i) {
+                if (null_map && null_map[i]) continue;
+                StringRef x = strings.getDataAt(i);
+                if (isBetter<kind>(x, res)) res = x;
+            }
+        }
+        add<kind>(res, arena);
+    }
+
+    void insertResultInto(IColumn& to) const {
+        assert_cast<ColumnString&>(to).insertData(data, size);
+    }
+
+    void write(BufferWritable& buf) const {
+        buf.write_binary(has_value);
+        if (!has_value) return;
+        buf.write_binary(UInt64(size));
+        buf.write(data, size);
+    }
+
+    void read(BufferReadable& buf, Arena* arena) {
+        buf.read_binary(has_value);
+        if (!has_value) return;
+        UInt64 new_size;
+        buf.read_binary(new_size);
+        capacity = roundUpToPowerOfTwoOrZero(new_size);
+        data = arena->alloc(capacity);
+        buf.read(data, new_size);
+        size = new_size;
+    }
+};
+
+/// min, max, any and anyLast. Data is SingleValueDataFixed or SingleValueDataString.
+template <typename Data, SingleValueKind kind>
+class AggregateFunctionsSingleValue final
+        : public IAggregateFunctionDataHelper<Data, AggregateFunctionsSingleValue<Data, kind>> {
+private:
+    DataTypePtr type;
+
+public:
+    AggregateFunctionsSingleValue(const DataTypePtr& type_)
+            : IAggregateFunctionDataHelper<Data, AggregateFunctionsSingleValue<Data, kind>>(
+                      {type_}, {}),
+              type(type_) {}
+
+    String getName() const override {
+        switch (kind) {
+        case SingleValueKind::Min:
+            return "min";
+        case SingleValueKind::Max:
+            return "max";
+        case SingleValueKind::Any:
+            return "any";
+        case SingleValueKind::AnyLast:
+            return "anyLast";
+        }
+        __builtin_unreachable();
+    }
+
+    DataTypePtr getReturnType() const override { return type; }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena* arena) const override {
+        this->data(place).template add<kind>(*columns[0], row_num, arena);
+    }
+
+    /// A run of equal rows has the same effect as one of them.
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t,
+                 Arena* arena) const override {
+        this->data(place).template add<kind>(*columns[0], row_num, arena);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena* arena) const override {
+        this->data(place).template addBatch<kind>(*columns[0], batch_size, nullptr, arena);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena* arena) const override {
+        this->data(place).template addBatch<kind>(*columns[0], batch_size, null_map, arena);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const override {
+        this->data(place).template merge<kind>(this->data(rhs), arena);
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        this->data(place).read(buf, arena);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        this->data(place).insertResultInto(to);
+    }
+
+    bool allocatesMemoryInArena() const override { return Data::allocates_memory_in_arena; }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+};
+
+} // namespace doris::vectorized
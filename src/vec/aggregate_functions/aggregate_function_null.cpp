@@ -93,7 +93,7 @@ public:
 };
 
 void registerAggregateFunctionCombinatorNull(AggregateFunctionSimpleFactory& factory) {
-    // factory.registerCombinator(std::make_shared<AggregateFunctionCombinatorNull>());
+    factory.registerCombinator(std::make_shared<AggregateFunctionCombinatorNull>());
     AggregateFunctionCreator creator = [&](const std::string& name, const DataTypes& types,
                                            const Array& params) {
         auto function_combinator = std::make_shared<AggregateFunctionCombinatorNull>();
@@ -102,6 +102,12 @@ void registerAggregateFunctionCombinatorNull(AggregateFunctionSimpleFactory& fac
         return function_combinator->transformAggregateFunction(nested_function, types, params);
     };
     factory.registerFunction("sum", creator, true);
+    factory.registerFunction("count", creator, true);
+    for (const auto& name : {"min", "max", "any", "anyLast", "avg", "uniq", "uniqCombined"})
+        factory.registerFunction(name, creator, true);
+    for (const auto& name : {"quantileExact", "quantilesExact", "quantileTDigest",
+                             "quantilesTDigest", "quantile", "quantiles", "topK", "topKWeighted"})
+        factory.registerFunction(name, creator, true);
 }
 
 } // namespace doris::vectorized
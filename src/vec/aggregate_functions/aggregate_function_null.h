@@ -20,8 +20,10 @@
 #include <vec/aggregate_functions/aggregate_function.h>
 #include <vec/columns/column_nullable.h>
 #include <vec/common/assert_cast.h>
+#include <vec/common/string_buffer.hpp>
 #include <vec/data_types/data_type_nullable.h>
 
+#include <algorithm>
 #include <array>
 // #include <IO/ReadHelpers.h>
 // #include <IO/WriteHelpers.h>
@@ -116,26 +118,20 @@ public:
         nested_function->merge(nestedPlace(place), nestedPlace(rhs), arena);
     }
 
-    // void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const override
-    // {
-    //     bool flag = getFlag(place);
-    //     if (result_is_nullable)
-    //         writeBinary(flag, buf);
-    //     if (flag)
-    //         nested_function->serialize(nestedPlace(place), buf);
-    // }
-
-    // void deserialize(AggregateDataPtr place, ReadBuffer & buf, Arena * arena) const override
-    // {
-    //     bool flag = 1;
-    //     if (result_is_nullable)
-    //         readBinary(flag, buf);
-    //     if (flag)
-    //     {
-    //         setFlag(place);
-    //         nested_function->deserialize(nestedPlace(place), buf, arena);
-    //     }
-    // }
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        bool flag = getFlag(place);
+        if (result_is_nullable) buf.write_binary(flag);
+        if (flag) nested_function->serialize(nestedPlace(place), buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        bool flag = true;
+        if (result_is_nullable) buf.read_binary(flag);
+        if (flag) {
+            setFlag(place);
+            nested_function->deserialize(nestedPlace(place), buf, arena);
+        }
+    }
 
     void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
         if (result_is_nullable) {
@@ -184,6 +180,29 @@ public:
             this->nested_function->add(this->nestedPlace(place), &nested_column, row_num, arena);
         }
     }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena* arena) const override {
+        const ColumnNullable* column = assert_cast<const ColumnNullable*>(columns[0]);
+        const UInt8* null_map = column->getNullMapData().data();
+        if (std::find(null_map, null_map + batch_size, 0) == null_map + batch_size) return;
+
+        this->setFlag(place);
+        const IColumn* nested_column = &column->getNestedColumn();
+        this->nested_function->addBatchSinglePlaceNotNull(batch_size, this->nestedPlace(place),
+                                                          &nested_column, null_map, arena);
+    }
+
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena* arena) const override {
+        const ColumnNullable* column = assert_cast<const ColumnNullable*>(columns[0]);
+        if (!column->isNullAt(row_num)) {
+            this->setFlag(place);
+            const IColumn* nested_column = &column->getNestedColumn();
+            this->nested_function->addMany(this->nestedPlace(place), &nested_column, row_num,
+                                           count, arena);
+        }
+    }
 };
 
 template <bool result_is_nullable>
@@ -0,0 +1,97 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_quantile.h"
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/aggregate_functions/factory_helpers.h"
+#include "vec/aggregate_functions/helpers.h"
+#include "vec/common/field_visitors.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+extern const int PARAMETER_OUT_OF_BOUND;
+} // namespace ErrorCodes
+
+namespace {
+
+template <template <typename> class Data, bool returns_many>
+struct Quantile {
+    template <typename T>
+    using Function = AggregateFunctionQuantile<T, Data<T>, returns_many>;
+};
+
+/// The levels are the parameters: quantile(0.9)(x), quantiles(0.5, 0.95, 0.99)(x).
+std::vector<Float64> getLevels(const std::string& name, const Array& parameters,
+                               bool returns_many) {
+    if (returns_many ? parameters.empty() : parameters.size() > 1)
+        throw Exception("Aggregate function " + name +
+                                (returns_many ? " requires at least one level"
+                                              : " requires zero or one level"),
+                        ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+
+    std::vector<Float64> levels;
+    for (const auto& parameter : parameters) {
+        Float64 level = applyVisitor(FieldVisitorConvertToNumber<Float64>(), parameter);
+        if (!(level >= 0 && level <= 1))
+            throw Exception("Level of aggregate function " + name + " must be in [0, 1]",
+                            ErrorCodes::PARAMETER_OUT_OF_BOUND);
+        levels.push_back(level);
+    }
+    if (levels.empty()) levels.push_back(0.5);
+    return levels;
+}
+
+template <template <typename> class Data, bool returns_many>
+AggregateFunctionPtr createAggregateFunctionQuantile(const std::string& name,
+                                                     const DataTypes& argument_types,
+                                                     const Array& parameters) {
+    assertUnary(name, argument_types);
+    std::vector<Float64> levels = getLevels(name, parameters, returns_many);
+
+    const DataTypePtr& type = argument_types[0];
+    AggregateFunctionPtr res(
+            createWithNumericType<Quantile<Data, returns_many>::template Function>(
+                    *type, name, type, parameters, levels));
+    if (!res)
+        throw Exception("Illegal type " + type->getName() + " of argument for aggregate function " +
+                                name,
+                        ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+    return res;
+}
+
+} // namespace
+
+void registerAggregateFunctionQuantile(AggregateFunctionSimpleFactory& factory) {
+    factory.registerFunction("quantileExact",
+                             createAggregateFunctionQuantile<QuantileExact, false>);
+    factory.registerFunction("quantilesExact",
+                             createAggregateFunctionQuantile<QuantileExact, true>);
+    factory.registerFunction("quantileTDigest",
+                             createAggregateFunctionQuantile<QuantileTDigest, false>);
+    factory.registerFunction("quantilesTDigest",
+                             createAggregateFunctionQuantile<QuantileTDigest, true>);
+    factory.registerFunction("quantile",
+                             createAggregateFunctionQuantile<QuantileReservoirSampler, false>);
+    factory.registerFunction("quantiles",
+                             createAggregateFunctionQuantile<QuantileReservoirSampler, true>);
+}
+
+} // namespace doris::vectorized
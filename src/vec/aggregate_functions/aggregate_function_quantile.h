@@ -0,0 +1,480 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/arena_allocator.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/pod_array.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+/** The states of the quantile functions. Each of them has:
+  *  - add(x, arena) and addBatch(data, size, null_map, arena), that skips the rows where null_map
+  *    (if any) is not 0;
+  *  - merge(rhs, arena), write(buf) and read(buf, arena), that reads into an empty state;
+  *  - getMany(levels, indices, size, result), that calculates the quantiles of the levels
+  *    levels[indices[0]] <= levels[indices[1]] <= ... into result[indices[i]].
+  * getMany() may reorder or compress the values, that does not change the quantiles,
+  *  so the values are mutable.
+  */
+
+/// Keeps all the values in the Arena and finds the exact quantiles by nth_element.
+template <typename T>
+struct QuantileExact {
+    using ResultType = T;
+    using Array = PODArray<T, 64, AlignedArenaAllocator<alignof(T)>>;
+
+    mutable Array array;
+
+    void add(T x, Arena* arena) { array.push_back(x, arena); }
+
+    void addBatch(const T* data, size_t size, const UInt8* null_map, Arena* arena) {
+        if (!null_map) {
+            array.insert(data, data + size, arena);
+            return;
+        }
+        /// Every row is written and the position moves only past the rows that are not NULL.
+        size_t old_size = array.size();
+        array.resize(old_size + size, arena);
+        T* __restrict out = array.data() + old_size;
+        size_t count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            out[count] = data[i];
+            count += !null_map[i];
+        }
+        array.resize_assume_reserved(old_size + count);
+    }
+
+    void merge(const QuantileExact& rhs, Arena* arena) {
+        array.insert(rhs.array.data(), rhs.array.data() + rhs.array.size(), arena);
+    }
+
+    void write(BufferWritable& buf) const {
+        buf.write_binary(UInt64(array.size()));
+        buf.write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(T));
+    }
+
+    void read(BufferReadable& buf, Arena* arena) {
+        UInt64 size;
+        buf.read_binary(size);
+        array.resize(size, arena);
+        buf.read(reinterpret_cast<char*>(array.data()), size * sizeof(T));
+    }
+
+    /// Every nth_element() works only on the values after the previous quantile.
+    void getMany(const Float64* levels, const size_t* indices, size_t size,
+                 ResultType* result) const {
+        size_t prev_n = 0;
+        for (size_t i = 0; i < size; ++i) {
+            Float64 level = levels[indices[i]];
+            if (array.empty()) {
+                result[indices[i]] = T();
+                continue;
+            }
+            size_t n = level < 1 ? level * array.size() : array.size() - 1;
+            std::nth_element(array.begin() + prev_n, array.begin() + n, array.end());
+            result[indices[i]] = array[n];
+            prev_n = n;
+        }
+    }
+};
+
+/** t-digest: the values are grouped into centroids, that are small near the ends of the
+  *  distribution, so that the extreme quantiles are precise.
+  * The values are added as centroids of weight 1, and max_unmerged of them are compressed
+  *  at once: the centroids are sorted and the neighbours are merged while the weight allows.
+  * The compressed digest is several hundred centroids however many values are added.
+  */
+template <typename T>
+struct QuantileTDigest {
+    using ResultType = Float64;
+
+    struct Centroid {
+        Float64 mean;
+        Float64 count;
+    };
+    using Centroids = PODArray<Centroid, 64, ArenaAllocator>;
+
+    static constexpr size_t max_unmerged = 2048;
+    /// The compression: a centroid at the quantile q has at most 4 * count * q * (1 - q) * epsilon.
+    static constexpr Float64 epsilon = 0.01;
+
+    mutable Centroids centroids;
+    Float64 count = 0;
+    mutable size_t unmerged = 0;
+
+    void add(T x, Arena* arena) { addBatch(&x, 1, nullptr, arena); }
+
+    /// NaN is skipped as well as NULL, so that the centroids can be sorted.
+    void addBatch(const T* data, size_t size, const UInt8* null_map, Arena* arena) {
+        for (size_t begin = 0; begin < size; begin += max_unmerged) {
+            size_t end = std::min(size, begin + max_unmerged);
+            size_t old_size = centroids.size();
+            centroids.resize(old_size + end - begin, arena);
+            Centroid* __restrict out = centroids.data() + old_size;
+            size_t added = 0;
+            for (size_t i = begin; i < end; ++i) {
+                Float64 x = data[i];
+                out[added] = {x, 1};
+                added += (!null_map || !null_map[i]) & (x == x);
+            }
+            centroids.resize_assume_reserved(old_size + added);
+            count += added;
+            unmerged += added;
+            if (unmerged >= max_unmerged) compress();
+        }
+    }
+
+    void merge(const QuantileTDigest& rhs, Arena* arena) {
+        centroids.insert(rhs.centroids.data(), rhs.centroids.data() + rhs.centroids.size(),
+                         arena);
+        count += rhs.count;
+        unmerged += rhs.centroids.size();
+        if (unmerged >= max_unmerged) compress();
+    }
+
+    void compress() const {
+        if (!unmerged) return;
+        std::sort(centroids.begin(), centroids.end(),
+                  [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+        Centroid* l = centroids.data();
+        Centroid* end = centroids.data() + centroids.size();
+        Float64 sum = 0;
+        for (Centroid* r = l + 1; r < end; ++r) {
+            Float64 ql = (sum + l->count * 0.5) / count;
+            Float64 qr = (sum + l->count + r->count * 0.5) / count;
+            Float64 limit = 4 * count * std::min(ql * (1 - ql), qr * (1 - qr)) * epsilon;
+            if (l->count + r->count <= limit) {
+                l->count += r->count;
+                l->mean += (r->mean - l->mean) * r->count / l->count;
+            } else {
+                sum += l->count;
+                *++l = *r;
+            }
+        }
+        if (!centroids.empty()) centroids.resize_assume_reserved(l - centroids.data() + 1);
+        unmerged = 0;
+    }
+
+    void write(BufferWritable& buf) const {
+        compress();
+        buf.write_binary(count);
+        buf.write_binary(UInt64(centroids.size()));
+        buf.write(reinterpret_cast<const char*>(centroids.data()),
+                  centroids.size() * sizeof(Centroid));
+    }
+
+    void read(BufferReadable& buf, Arena* arena) {
+        UInt64 size;
+        buf.read_binary(count);
+        buf.read_binary(size);
+        centroids.resize(size, arena);
+        buf.read(reinterpret_cast<char*>(centroids.data()), size * sizeof(Centroid));
+    }
+
+    /// Interpolates between the means of the centroids, that are at the middles of them.
+    Float64 get(Float64 level) const {
+        if (centroids.empty()) return std::numeric_limits<Float64>::quiet_NaN();
+        Float64 x = level * count;
+        Float64 prev_x = 0;
+        Float64 prev_mean = centroids[0].mean;
+        Float64 sum = 0;
+        for (const Centroid& c : centroids) {
+            Float64 current_x = sum + c.count * 0.5;
+            if (current_x >= x) {
+                if (current_x == prev_x) return c.mean;
+                return prev_mean + (c.mean - prev_mean) * (x - prev_x) / (current_x - prev_x);
+            }
+            sum += c.count;
+            prev_x = current_x;
+            prev_mean = c.mean;
+        }
+        return centroids.back().mean;
+    }
+
+    void getMany(const Float64* levels, const size_t* indices, size_t size,
+                 ResultType* result) const {
+        compress();
+        for (size_t i = 0; i < size; ++i) result[indices[i]] = get(levels[indices[i]]);
+    }
+};
+
+/** A uniform sample of sample_count values (reservoir sampling), the quantiles are interpolated
+  *  between the sorted values of the sample.
+  * When the sample is full, the rows to take are chosen by Algorithm L: the number of rows to
+  *  skip is drawn at once, so that a batch does not need a random number for every row.
+  * The random numbers are deterministic, so the result of the same data is always the same.
+  */
+template <typename T>
+struct QuantileReservoirSampler {
+    using ResultType = Float64;
+    using Array = PODArray<T, 64, AlignedArenaAllocator<alignof(T)>>;
+
+    static constexpr size_t sample_count = 8192;
+
+    mutable Array samples;
+    mutable bool sorted = false;
+    /// The number of the values seen.
+    UInt64 total = 0;
+    /// When the sample is full: the number of the next value to take,
+    /// and the weight of Algorithm L.
+    UInt64 next = 0;
+    Float64 weight = 0;
+    UInt64 rng_state = 0;
+
+    void add(T x, Arena* arena) {
+        if constexpr (std::is_floating_point_v<T>)
+            if (std::isnan(x)) return;
+        if (samples.size() < sample_count) {
+            samples.push_back(x, arena);
+            sorted = false;
+            if (samples.size() == sample_count) startSkipping(samples.size());
+        } else if (total == next) {
+            take(x);
+        }
+        ++total;
+    }
+
+    void addBatch(const T* data, size_t size, const UInt8* null_map, Arena* arena) {
+        if (null_map || std::is_floating_point_v<T>) {
+            for (size_t i = 0; i < size; ++i)
+                if (!null_map || !null_map[i]) add(data[i], arena);
+            return;
+        }
+        size_t i = 0;
+        for (; i < size && samples.size() < sample_count; ++i) add(data[i], arena);
+        while (i < size) {
+            if (next - total >= size - i) {
+                total += size - i;
+                break;
+            }
+            i += next - total;
+            total = next;
+            take(data[i]);
+            ++i;
+            ++total;
+        }
+    }
+
+    /// If one of the states has all its values, they are added to the other one.
+    /// Otherwise every value of the sample is taken from rhs with the probability of the
+    /// share of rhs in the values.
+    void merge(const QuantileReservoirSampler& rhs, Arena* arena) {
+        if (rhs.total <= rhs.samples.size()) {
+            for (T x : rhs.samples) add(x, arena);
+            return;
+        }
+        if (total <= samples.size()) {
+            std::vector<T> values(samples.begin(), samples.end());
+            samples.resize(rhs.samples.size(), arena);
+            std::copy(rhs.samples.begin(), rhs.samples.end(), samples.begin());
+            total = rhs.total;
+            startSkipping(total);
+            for (T x : values) add(x, arena);
+            sorted = false;
+            return;
+        }
+        for (size_t i = 0; i < sample_count; ++i)
+            if (random(total + rhs.total) >= total) samples[i] = rhs.samples[i];
+        total += rhs.total;
+        startSkipping(total);
+        sorted = false;
+    }
+
+    void write(BufferWritable& buf) const {
+        buf.write_binary(total);
+        buf.write_binary(UInt64(samples.size()));
+        buf.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(T));
+    }
+
+    void read(BufferReadable& buf, Arena* arena) {
+        UInt64 size;
+        buf.read_binary(total);
+        buf.read_binary(size);
+        samples.resize(size, arena);
+        buf.read(reinterpret_cast<char*>(samples.data()), size * sizeof(T));
+        if (size == sample_count) startSkipping(total);
+        sorted = false;
+    }
+
+    void getMany(const Float64* levels, const size_t* indices, size_t size,
+                 ResultType* result) const {
+        if (!sorted) {
+            std::sort(samples.begin(), samples.end());
+            sorted = true;
+        }
+        for (size_t i = 0; i < size; ++i) {
+            Float64& res = result[indices[i]];
+            if (samples.empty()) {
+                res = std::numeric_limits<Float64>::quiet_NaN();
+                continue;
+            }
+            Float64 position = levels[indices[i]] * (samples.size() - 1);
+            size_t lo = position;
+            if (lo + 1 >= samples.size()) {
+                res = samples.back();
+                continue;
+            }
+            res = samples[lo] + (position - lo) * (Float64(samples[lo + 1]) - samples[lo]);
+        }
+    }
+
+private:
+    /// splitmix64.
+    UInt64 random() {
+        UInt64 z = (rng_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// A random number in [0, n).
+    UInt64 random(UInt64 n) { return (static_cast<unsigned __int128>(random()) * n) >> 64; }
+
+    /// A random number in (0, 1).
+    Float64 random01() { return (random() >> 11 | 1) * 0x1.0p-53; }
+
+    /// Draws the number of the next value to take after seen values. The weight of Algorithm L
+    /// is the largest of sample_count random numbers of seen values, that is
+    /// sample_count / (seen + 1) on average. It is also the probability to take the next value
+    /// in the simple reservoir sampling.
+    void startSkipping(UInt64 seen) {
+        weight = Float64(sample_count) / (seen + 1);
+        skip(seen);
+    }
+
+    void skip(UInt64 current) {
+        Float64 skipped = std::floor(std::log(random01()) / std::log1p(-weight));
+        next = current + std::min<Float64>(skipped, std::numeric_limits<UInt64>::max() / 2);
+    }
+
+    void take(T x) {
+        samples[random(sample_count)] = x;
+        sorted = false;
+        weight *= std::exp(std::log(random01()) / sample_count);
+        skip(total + 1);
+    }
+};
+
+/** quantileExact, quantileTDigest and quantile calculate one level (0.5 by default),
+  *  quantilesExact, quantilesTDigest and quantiles calculate several levels from one state.
+  * There are no arrays, so the several levels are returned as a string like "[1, 2.5, 10]".
+  * The result of quantileExact has the type of the argument, the others are Float64.
+  */
+template <typename T, typename Data, bool returns_many>
+class AggregateFunctionQuantile final
+        : public IAggregateFunctionDataHelper<Data,
+                                              AggregateFunctionQuantile<T, Data, returns_many>> {
+public:
+    using ResultType = typename Data::ResultType;
+    using ColVecType = ColumnVector<T>;
+    using ColVecResult = ColumnVector<ResultType>;
+
+    AggregateFunctionQuantile(const std::string& name_, const DataTypePtr& type,
+                              const Array& parameters, const std::vector<Float64>& levels_)
+            : IAggregateFunctionDataHelper<Data, AggregateFunctionQuantile<T, Data, returns_many>>(
+                      {type}, parameters),
+              name(name_),
+              levels(levels_),
+              indices(levels.size()) {
+        std::iota(indices.begin(), indices.end(), 0);
+        std::sort(indices.begin(), indices.end(),
+                  [&](size_t a, size_t b) { return levels[a] < levels[b]; });
+    }
+
+    String getName() const override { return name; }
+
+    DataTypePtr getReturnType() const override {
+        if constexpr (returns_many)
+            return std::make_shared<DataTypeString>();
+        else
+            return std::make_shared<DataTypeNumber<ResultType>>();
+    }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena* arena) const override {
+        this->data(place).add(assert_cast<const ColVecType&>(*columns[0]).getData()[row_num],
+                              arena);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena* arena) const override {
+        const T* data = assert_cast<const ColVecType&>(*columns[0]).getData().data();
+        this->data(place).addBatch(data, batch_size, nullptr, arena);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena* arena) const override {
+        const T* data = assert_cast<const ColVecType&>(*columns[0]).getData().data();
+        this->data(place).addBatch(data, batch_size, null_map, arena);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const override {
+        this->data(place).merge(this->data(rhs), arena);
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        this->data(place).read(buf, arena);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        std::vector<ResultType> result(levels.size());
+        this->data(place).getMany(levels.data(), indices.data(), levels.size(), result.data());
+        if constexpr (returns_many) {
+            std::string text = "[";
+            for (size_t i = 0; i < result.size(); ++i)
+                text += (i ? ", " : "") + fmt::format("{}", result[i]);
+            text += "]";
+            assert_cast<ColumnString&>(to).insertData(text.data(), text.size());
+        } else {
+            assert_cast<ColVecResult&>(to).getData().push_back(result[0]);
+        }
+    }
+
+    bool allocatesMemoryInArena() const override { return true; }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+
+private:
+    String name;
+    std::vector<Float64> levels;
+    /// The numbers of the levels in ascending order of the levels.
+    std::vector<size_t> indices;
+};
+
+} // namespace doris::vectorized
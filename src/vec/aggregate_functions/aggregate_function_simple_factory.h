@@ -22,16 +22,32 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/aggregate_functions/aggregate_function_combinator.h"
 #include "vec/core/field.h"
 #include "vec/data_types/data_type.h"
 
 namespace doris::vectorized {
 
+namespace ErrorCodes {
+extern const int UNKNOWN_AGGREGATE_FUNCTION;
+}
+
 class AggregateFunctionSimpleFactory;
 void registerAggregateFunctionSum(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionCount(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionMinMaxAny(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionAvg(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionUniq(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionQuantile(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionTopK(AggregateFunctionSimpleFactory& factory);
 void registerAggregateFunctionCombinatorNull(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionCombinatorIf(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionCombinatorDistinct(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionCombinatorState(AggregateFunctionSimpleFactory& factory);
+void registerAggregateFunctionCombinatorMerge(AggregateFunctionSimpleFactory& factory);
 
 using DataTypePtr = std::shared_ptr<const IDataType>;
 using DataTypes = std::vector<DataTypePtr>;
@@ -44,9 +60,36 @@ public:
 
 private:
     using AggregateFunctions = std::unordered_map<std::string, Creator>;
+    using AggregateFunctionCombinators =
+            std::unordered_map<std::string, AggregateFunctionCombinatorPtr>;
 
     AggregateFunctions aggregate_functions;
     AggregateFunctions nullable_aggregate_functions;
+    AggregateFunctionCombinators combinators;
+
+    /// The combinator whose name is a suffix of name, except the internal ones like Null.
+    /// The longest suffix wins, so that the result does not depend on the order of the map.
+    AggregateFunctionCombinatorPtr tryFindSuffix(const std::string& name) const {
+        AggregateFunctionCombinatorPtr res;
+        size_t res_size = 0;
+        for (const auto& [suffix, combinator] : combinators) {
+            if (!combinator->isForInternalUsageOnly() && name.size() > suffix.size() &&
+                suffix.size() > res_size &&
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                res = combinator;
+                res_size = suffix.size();
+            }
+        }
+        return res;
+    }
+
+    AggregateFunctionPtr getCombined(const IAggregateFunctionCombinator& combinator,
+                                     const std::string& nested_name,
+                                     const DataTypes& argument_types, const Array& parameters) {
+        auto nested_function = get(nested_name, combinator.transformArguments(argument_types),
+                                   combinator.transformParameters(parameters));
+        return combinator.transformAggregateFunction(nested_function, argument_types, parameters);
+    }
 
 public:
     void registerFunction(const std::string& name, Creator creator, bool nullable = false) {
@@ -57,6 +100,11 @@ public:
         }
     }
 
+    /// A combinator is used as a suffix of the name of the nested function, like sumIf.
+    void registerCombinator(const AggregateFunctionCombinatorPtr& combinator) {
+        combinators[combinator->getName()] = combinator;
+    }
+
     AggregateFunctionPtr get(const std::string& name, const DataTypes& argument_types,
                              const Array& parameters) {
         bool nullable = false;
@@ -65,11 +113,29 @@ public:
                 nullable = true;
             }
         }
-        if (nullable) {
-            return nullable_aggregate_functions[name](name, argument_types, parameters);
-        } else {
-            return aggregate_functions[name](name, argument_types, parameters);
+        const auto& functions = nullable ? nullable_aggregate_functions : aggregate_functions;
+        if (auto it = functions.find(name); it != functions.end())
+            return it->second(name, argument_types, parameters);
+
+        if (auto combinator = tryFindSuffix(name)) {
+            /// The Null combinator is applied first, so that the combined function like sumIf
+            ///  gets the arguments that are not Nullable.
+            if (nullable)
+                return getCombined(*combinators.at("Null"), name, argument_types, parameters);
+            std::string nested_name = name.substr(0, name.size() - combinator->getName().size());
+            return getCombined(*combinator, nested_name, argument_types, parameters);
         }
+
+        throw Exception("Unknown aggregate function " + name,
+                        ErrorCodes::UNKNOWN_AGGREGATE_FUNCTION);
+    }
+
+    /// Names of all registered (not nullable) aggregate functions.
+    std::vector<std::string> getFunctionNames() const {
+        std::vector<std::string> names;
+        names.reserve(aggregate_functions.size());
+        for (const auto& [name, creator] : aggregate_functions) names.push_back(name);
+        return names;
     }
 
 public:
@@ -78,7 +144,17 @@ public:
         static AggregateFunctionSimpleFactory instance;
         std::call_once(oc, [&]() {
             registerAggregateFunctionSum(instance);
+            registerAggregateFunctionCount(instance);
+            registerAggregateFunctionMinMaxAny(instance);
+            registerAggregateFunctionAvg(instance);
+            registerAggregateFunctionUniq(instance);
+            registerAggregateFunctionQuantile(instance);
+            registerAggregateFunctionTopK(instance);
             registerAggregateFunctionCombinatorNull(instance);
+            registerAggregateFunctionCombinatorIf(instance);
+            registerAggregateFunctionCombinatorDistinct(instance);
+            registerAggregateFunctionCombinatorState(instance);
+            registerAggregateFunctionCombinatorMerge(instance);
         });
         return instance;
     }
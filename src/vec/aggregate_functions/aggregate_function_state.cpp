@@ -0,0 +1,44 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_state.h"
+
+#include "vec/aggregate_functions/aggregate_function_combinator.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+class AggregateFunctionCombinatorState final : public IAggregateFunctionCombinator {
+public:
+    String getName() const override { return "State"; }
+
+    AggregateFunctionPtr transformAggregateFunction(const AggregateFunctionPtr& nested_function,
+                                                    const DataTypes& arguments,
+                                                    const Array& params) const override {
+        return std::make_shared<AggregateFunctionState>(nested_function, arguments, params);
+    }
+};
+
+} // namespace
+
+void registerAggregateFunctionCombinatorState(AggregateFunctionSimpleFactory& factory) {
+    factory.registerCombinator(std::make_shared<AggregateFunctionCombinatorState>());
+}
+
+} // namespace doris::vectorized
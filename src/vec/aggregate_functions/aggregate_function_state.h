@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/data_types/data_type_aggregate_function.h"
+
+namespace doris::vectorized {
+
+/** Not an aggregate function, but an adapter of aggregate functions.
+  * Aggregate functions with the `State` suffix differ from the corresponding ones in that their
+  *  states are not finalized. Return type - DataTypeAggregateFunction, a row is the state
+  *  written by serialize(), that the -Merge combinator reads back.
+  * The rows are added by the nested function, with its own batch paths.
+  */
+class AggregateFunctionState final : public IAggregateFunctionHelper<AggregateFunctionState> {
+private:
+    AggregateFunctionPtr nested_func;
+
+public:
+    AggregateFunctionState(AggregateFunctionPtr nested, const DataTypes& arguments,
+                           const Array& params)
+            : IAggregateFunctionHelper<AggregateFunctionState>(arguments, params),
+              nested_func(nested) {}
+
+    String getName() const override { return nested_func->getName() + "State"; }
+
+    DataTypePtr getReturnType() const override {
+        return std::make_shared<DataTypeAggregateFunction>(nested_func, argument_types,
+                                                           parameters);
+    }
+
+    void create(AggregateDataPtr place) const override { nested_func->create(place); }
+
+    void destroy(AggregateDataPtr place) const noexcept override { nested_func->destroy(place); }
+
+    bool hasTrivialDestructor() const override { return nested_func->hasTrivialDestructor(); }
+
+    size_t sizeOfData() const override { return nested_func->sizeOfData(); }
+
+    size_t alignOfData() const override { return nested_func->alignOfData(); }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena* arena) const override {
+        nested_func->add(place, columns, row_num, arena);
+    }
+
+    void addBatch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                  const IColumn** columns, Arena* arena) const override {
+        nested_func->addBatch(batch_size, places, place_offset, columns, arena);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena* arena) const override {
+        nested_func->addBatchSinglePlace(batch_size, place, columns, arena);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena* arena) const override {
+        nested_func->addBatchSinglePlaceNotNull(batch_size, place, columns, null_map, arena);
+    }
+
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena* arena) const override {
+        nested_func->addMany(place, columns, row_num, count, arena);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena* arena) const override {
+        nested_func->merge(place, rhs, arena);
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        nested_func->serialize(place, buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena* arena) const override {
+        nested_func->deserialize(place, buf, arena);
+    }
+
+    /// The state is written right into the chars of the column.
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        auto& column = assert_cast<ColumnString&>(to);
+        auto& chars = column.getChars();
+        size_t old_size = chars.size();
+        VectorBufferWriter<ColumnString::Chars> writer(chars);
+        try {
+            nested_func->serialize(place, writer);
+        } catch (...) {
+            chars.resize(old_size);
+            throw;
+        }
+        chars.push_back(0);
+        column.getOffsets().push_back(chars.size());
+    }
+
+    bool allocatesMemoryInArena() const override { return nested_func->allocatesMemoryInArena(); }
+
+    bool isState() const override { return true; }
+
+    AggregateFunctionPtr getNestedFunction() const { return nested_func; }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+};
+
+} // namespace doris::vectorized
@@ -19,11 +19,9 @@
 
 #include <type_traits>
 
-// #include <IO/WriteHelpers.h>
-// #include <IO/ReadHelpers.h>
-
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/column_vector.h"
+#include "vec/common/string_buffer.hpp"
 #include "vec/data_types/data_types_decimal.h"
 #include "vec/data_types/data_types_number.h"
 
@@ -35,11 +33,29 @@ struct AggregateFunctionSumData {
 
     void add(T value) { sum += value; }
 
+    void addMany(T value, size_t count) { sum += value * count; }
+
+    /// Adds the values except those where null_map (if any) is not 0. The values are added up
+    /// into a local without branches, so that the compiler vectorizes the loop.
+    template <typename Value>
+    void addBatch(const Value* values, size_t batch_size, const UInt8* null_map) {
+        T res {};
+        if (!null_map) {
+            for (size_t i = 0; i < batch_size; ++i) res += values[i];
+        } else if constexpr (std::is_integral_v<T>) {
+            for (size_t i = 0; i < batch_size; ++i) res += T(values[i]) * !null_map[i];
+        } else {
+            /// A NULL row may hold any value, it is not multiplied by 0 to not get NaN.
+            for (size_t i = 0; i < batch_size; ++i) res += null_map[i] ? T() : T(values[i]);
+        }
+        sum += res;
+    }
+
     void merge(const AggregateFunctionSumData& rhs) { sum += rhs.sum; }
 
-    void write(WriteBuffer& buf) const { writeBinary(sum, buf); }
+    void write(BufferWritable& buf) const { buf.write_binary(sum); }
 
-    void read(ReadBuffer& buf) { readBinary(sum, buf); }
+    void read(BufferReadable& buf) { buf.read_binary(sum); }
 
     T get() const { return sum; }
 };
@@ -60,6 +76,16 @@ struct AggregateFunctionSumKahanData {
         sum = new_sum;
     }
 
+    void addMany(T value, size_t count) {
+        for (size_t i = 0; i < count; ++i) add(value);
+    }
+
+    template <typename Value>
+    void addBatch(const Value* values, size_t batch_size, const UInt8* null_map) {
+        for (size_t i = 0; i < batch_size; ++i)
+            if (!null_map || !null_map[i]) add(values[i]);
+    }
+
     void merge(const AggregateFunctionSumKahanData& rhs) {
         auto raw_sum = sum + rhs.sum;
         auto rhs_compensated = raw_sum - sum;
@@ -69,14 +95,14 @@ struct AggregateFunctionSumKahanData {
         compensation = compensations - (sum - raw_sum);
     }
 
-    void write(WriteBuffer& buf) const {
-        writeBinary(sum, buf);
-        writeBinary(compensation, buf);
+    void write(BufferWritable& buf) const {
+        buf.write_binary(sum);
+        buf.write_binary(compensation);
     }
 
-    void read(ReadBuffer& buf) {
-        readBinary(sum, buf);
-        readBinary(compensation, buf);
+    void read(BufferReadable& buf) {
+        buf.read_binary(sum);
+        buf.read_binary(compensation);
     }
 
     T get() const { return sum; }
@@ -118,19 +144,36 @@ public:
         this->data(place).add(column.getData()[row_num]);
     }
 
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t count,
+                 Arena*) const override {
+        const auto& column = static_cast<const ColVecType&>(*columns[0]);
+        this->data(place).addMany(column.getData()[row_num], count);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena*) const override {
+        const auto& column = static_cast<const ColVecType&>(*columns[0]);
+        this->data(place).addBatch(column.getData().data(), batch_size, nullptr);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena*) const override {
+        const auto& column = static_cast<const ColVecType&>(*columns[0]);
+        this->data(place).addBatch(column.getData().data(), batch_size, null_map);
+    }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
         this->data(place).merge(this->data(rhs));
     }
 
-    // void serialize(ConstAggregateDataPtr place, WriteBuffer & buf) const override
-    // {
-    //     this->data(place).write(buf);
-    // }
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
 
-    // void deserialize(AggregateDataPtr place, ReadBuffer & buf, Arena *) const override
-    // {
-    //     this->data(place).read(buf);
-    // }
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
 
     void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
         auto& column = static_cast<ColVecResult&>(to);
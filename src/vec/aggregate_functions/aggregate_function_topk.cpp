@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_topk.h"
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/aggregate_functions/factory_helpers.h"
+#include "vec/aggregate_functions/helpers.h"
+#include "vec/common/field_visitors.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_TYPE_OF_ARGUMENT;
+extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+extern const int PARAMETER_OUT_OF_BOUND;
+} // namespace ErrorCodes
+
+namespace {
+
+constexpr UInt64 TOP_K_MAX_SIZE = 0xFFFFFF;
+constexpr UInt64 TOP_K_DEFAULT_SIZE = 10;
+
+template <bool is_weighted>
+struct TopK {
+    template <typename T>
+    using Function = AggregateFunctionTopK<T, is_weighted>;
+};
+
+template <bool is_weighted>
+AggregateFunctionPtr createAggregateFunctionTopK(const std::string& name,
+                                                 const DataTypes& argument_types,
+                                                 const Array& parameters) {
+    if constexpr (is_weighted) {
+        assertBinary(name, argument_types);
+        if (!isUnsignedInteger(argument_types[1]))
+            throw Exception("The weight of aggregate function " + name +
+                                    " must be an unsigned integer",
+                            ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+    } else {
+        assertUnary(name, argument_types);
+    }
+
+    if (parameters.size() > 1)
+        throw Exception("Aggregate function " + name + " requires zero or one parameter",
+                        ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+    UInt64 threshold = TOP_K_DEFAULT_SIZE;
+    if (!parameters.empty()) {
+        threshold = applyVisitor(FieldVisitorConvertToNumber<UInt64>(), parameters[0]);
+        if (threshold == 0 || threshold > TOP_K_MAX_SIZE)
+            throw Exception("Parameter of aggregate function " + name + " must be in [1, " +
+                                    std::to_string(TOP_K_MAX_SIZE) + "]",
+                            ErrorCodes::PARAMETER_OUT_OF_BOUND);
+    }
+
+    const DataTypePtr& type = argument_types[0];
+    AggregateFunctionPtr res;
+    if (isString(type))
+        res = std::make_shared<AggregateFunctionTopK<std::string, is_weighted>>(
+                name, argument_types, parameters, threshold);
+    else
+        res.reset(createWithNumericType<TopK<is_weighted>::template Function>(
+                *type, name, argument_types, parameters, threshold));
+
+    if (!res)
+        throw Exception("Illegal type " + type->getName() + " of argument for aggregate function " +
+                                name,
+                        ErrorCodes::ILLEGAL_TYPE_OF_ARGUMENT);
+    return res;
+}
+
+} // namespace
+
+void registerAggregateFunctionTopK(AggregateFunctionSimpleFactory& factory) {
+    factory.registerFunction("topK", createAggregateFunctionTopK<false>);
+    factory.registerFunction("topKWeighted", createAggregateFunctionTopK<true>);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,156 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <fmt/format.h>
+
+#include <string>
+#include <type_traits>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/space_saving.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+/** topK(N)(x) - the approximately most frequent N values of x, by the Space-Saving algorithm
+  *  with load_factor * N counters. topKWeighted(N)(x, weight) counts every row weight times,
+  *  the weight is an unsigned integer.
+  * There are no arrays, so the values are returned as a string like "[1, 2, 3]"
+  *  or "['a', 'b']", in the descending order of the count.
+  * A run of equal keys in a batch is counted by one insert.
+  */
+template <typename TKey, bool is_weighted>
+class AggregateFunctionTopK final
+        : public IAggregateFunctionDataHelper<SpaceSaving<TKey>,
+                                              AggregateFunctionTopK<TKey, is_weighted>> {
+public:
+    using Data = SpaceSaving<TKey>;
+    using ColVecType = std::conditional_t<std::is_same_v<TKey, std::string>, ColumnString,
+                                          ColumnVector<TKey>>;
+
+    /// The state has load_factor counters for every value of the result.
+    static constexpr size_t load_factor = 3;
+
+    AggregateFunctionTopK(const std::string& name_, const DataTypes& argument_types_,
+                          const Array& parameters_, size_t threshold_)
+            : IAggregateFunctionDataHelper<Data, AggregateFunctionTopK<TKey, is_weighted>>(
+                      argument_types_, parameters_),
+              name(name_),
+              threshold(threshold_) {}
+
+    String getName() const override { return name; }
+
+    DataTypePtr getReturnType() const override { return std::make_shared<DataTypeString>(); }
+
+    void create(AggregateDataPtr place) const override {
+        new (place) Data(threshold * load_factor);
+    }
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        this->data(place).insert(getKey(*columns[0], row_num), getWeight(columns, row_num));
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena*) const override {
+        addBatchImpl(batch_size, this->data(place), columns, nullptr);
+    }
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena*) const override {
+        addBatchImpl(batch_size, this->data(place), columns, null_map);
+    }
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override {
+        std::string text = "[";
+        this->data(place).forEachTop(threshold, [&](const typename Data::Counter& counter) {
+            if (text.size() > 1) text += ", ";
+            if constexpr (std::is_same_v<TKey, std::string>) {
+                text += '\'';
+                for (char c : counter.key) {
+                    if (c == '\'' || c == '\\') text += '\\';
+                    text += c;
+                }
+                text += '\'';
+            } else {
+                text += fmt::format("{}", counter.key);
+            }
+        });
+        text += "]";
+        assert_cast<ColumnString&>(to).insertData(text.data(), text.size());
+    }
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+
+private:
+    static typename Data::KeyRef getKey(const IColumn& column, size_t row_num) {
+        if constexpr (std::is_same_v<TKey, std::string>)
+            return assert_cast<const ColVecType&>(column).getDataAt(row_num);
+        else
+            return assert_cast<const ColVecType&>(column).getData()[row_num];
+    }
+
+    static UInt64 getWeight(const IColumn** columns, size_t row_num) {
+        if constexpr (is_weighted)
+            return columns[1]->getUInt(row_num);
+        else
+            return 1;
+    }
+
+    /// Skips the rows where null_map (if any) is not 0.
+    void addBatchImpl(size_t batch_size, Data& data, const IColumn** columns,
+                      const UInt8* null_map) const {
+        const auto& column = assert_cast<const ColVecType&>(*columns[0]);
+        size_t i = 0;
+        while (i < batch_size) {
+            if (null_map && null_map[i]) {
+                ++i;
+                continue;
+            }
+            auto key = getKey(column, i);
+            UInt64 weight = getWeight(columns, i);
+            for (++i; i < batch_size && (!null_map || !null_map[i]); ++i) {
+                if (!(getKey(column, i) == key)) break;
+                weight += getWeight(columns, i);
+            }
+            data.insert(key, weight);
+        }
+    }
+
+    String name;
+    size_t threshold;
+};
+
+} // namespace doris::vectorized
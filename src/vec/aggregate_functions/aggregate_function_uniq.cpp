@@ -0,0 +1,187 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_uniq.h"
+
+#include <cmath>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/aggregate_functions/factory_helpers.h"
+#include "vec/columns/columns_common.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int NUMBER_OF_ARGUMENTS_DOESNT_MATCH;
+extern const int INCORRECT_DATA;
+} // namespace ErrorCodes
+
+void AggregateFunctionUniqData::insert(UInt64 hash) {
+    if (registers) {
+        insertIntoRegisters(hash);
+        return;
+    }
+    if (!set) {
+        if (std::find(small, small + small_size, hash) != small + small_size) return;
+        if (small_size < small_capacity) {
+            small[small_size++] = hash;
+            return;
+        }
+        convertToSet();
+    }
+    set->insert(hash);
+    if (set->size() > set_capacity) convertToRegisters();
+}
+
+void AggregateFunctionUniqData::insertBatch(const UInt64* hashes, size_t size,
+                                            const UInt8* null_map) {
+    size_t i = 0;
+    for (; i < size && !registers; ++i)
+        if (!null_map || !null_map[i]) insert(hashes[i]);
+
+    /// A NULL row gets rank 0, that does not change the register.
+    for (; i < size; ++i) {
+        UInt64 hash = hashes[i];
+        size_t index = hash >> (64 - precision);
+        UInt8 rank = __builtin_clzll((hash << precision) | (1ULL << (precision - 1))) + 1;
+        if (null_map) rank *= !null_map[i];
+        registers[index] = std::max(registers[index], rank);
+    }
+}
+
+void AggregateFunctionUniqData::merge(const AggregateFunctionUniqData& rhs) {
+    if (!rhs.registers) {
+        rhs.forEachHash([&](UInt64 hash) { insert(hash); });
+        return;
+    }
+    if (!registers) convertToRegisters();
+    UInt8* __restrict dst = registers;
+    const UInt8* __restrict src = rhs.registers;
+    for (size_t i = 0; i < num_registers; ++i) dst[i] = std::max(dst[i], src[i]);
+}
+
+UInt64 AggregateFunctionUniqData::size() const {
+    if (!registers) return set ? set->size() : small_size;
+
+    double sum = 0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < num_registers; ++i) {
+        sum += std::ldexp(1.0, -registers[i]);
+        zeros += registers[i] == 0;
+    }
+    constexpr double m = num_registers;
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    /// Linear counting is more precise for small cardinalities.
+    if (estimate <= 2.5 * m && zeros) estimate = m * std::log(m / zeros);
+    return static_cast<UInt64>(estimate + 0.5);
+}
+
+void AggregateFunctionUniqData::convertToSet() {
+    set = std::make_unique<Set>();
+    for (size_t i = 0; i < small_size; ++i) set->insert(small[i]);
+}
+
+void AggregateFunctionUniqData::convertToRegisters() {
+    registers = static_cast<UInt8*>(Allocator<true>::alloc(num_registers));
+    forEachHash([&](UInt64 hash) { insertIntoRegisters(hash); });
+    set.reset();
+}
+
+/// The format is the kind of the state (0 - exact, 1 - HLL), then the number of hashes and
+/// the hashes for an exact state, or the registers.
+void AggregateFunctionUniqData::write(BufferWritable& buf) const {
+    buf.write_binary(UInt8(registers != nullptr));
+    if (registers) {
+        buf.write(reinterpret_cast<const char*>(registers), num_registers);
+        return;
+    }
+    buf.write_binary(UInt32(size()));
+    forEachHash([&](UInt64 hash) { buf.write_binary(hash); });
+}
+
+void AggregateFunctionUniqData::read(BufferReadable& buf) {
+    UInt8 is_hll;
+    buf.read_binary(is_hll);
+    if (is_hll) {
+        if (!registers) convertToRegisters();
+        buf.read(reinterpret_cast<char*>(registers), num_registers);
+        return;
+    }
+    UInt32 count;
+    buf.read_binary(count);
+    if (count > set_capacity)
+        throw Exception("Too many hashes in the state of uniq: " + std::to_string(count),
+                        ErrorCodes::INCORRECT_DATA);
+    for (size_t i = 0; i < count; ++i) {
+        UInt64 hash;
+        buf.read_binary(hash);
+        insert(hash);
+    }
+}
+
+DataTypePtr AggregateFunctionUniq::getReturnType() const {
+    return std::make_shared<DataTypeUInt64>();
+}
+
+void AggregateFunctionUniq::add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+                                Arena*) const {
+    UInt64 hash;
+    hashColumns(columns, argument_types.size(), row_num, row_num + 1, &hash);
+    this->data(place).insert(hash);
+}
+
+void AggregateFunctionUniq::addBatchSinglePlace(size_t batch_size, AggregateDataPtr place,
+                                                const IColumn** columns, Arena*) const {
+    PaddedPODArray<UInt64> hashes(batch_size);
+    hashColumns(columns, argument_types.size(), 0, batch_size, hashes.data());
+    this->data(place).insertBatch(hashes.data(), batch_size, nullptr);
+}
+
+void AggregateFunctionUniq::addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                                       const IColumn** columns,
+                                                       const UInt8* null_map, Arena*) const {
+    PaddedPODArray<UInt64> hashes(batch_size);
+    hashColumns(columns, argument_types.size(), 0, batch_size, hashes.data());
+    this->data(place).insertBatch(hashes.data(), batch_size, null_map);
+}
+
+void AggregateFunctionUniq::insertResultInto(ConstAggregateDataPtr place, IColumn& to) const {
+    assert_cast<ColumnUInt64&>(to).getData().push_back(this->data(place).size());
+}
+
+namespace {
+
+AggregateFunctionPtr createAggregateFunctionUniq(const std::string& name,
+                                                 const DataTypes& argument_types,
+                                                 const Array& parameters) {
+    assertNoParameters(name, parameters);
+    if (argument_types.empty())
+        throw Exception("Aggregate function " + name + " requires at least one argument",
+                        ErrorCodes::NUMBER_OF_ARGUMENTS_DOESNT_MATCH);
+    return std::make_shared<AggregateFunctionUniq>(name, argument_types);
+}
+
+} // namespace
+
+void registerAggregateFunctionUniq(AggregateFunctionSimpleFactory& factory) {
+    factory.registerFunction("uniq", createAggregateFunctionUniq);
+    factory.registerFunction("uniqCombined", createAggregateFunctionUniq);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,144 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <memory>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/common/allocator.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/hash_table/hash_table.h"
+#include "vec/common/string_buffer.hpp"
+
+namespace doris::vectorized {
+
+/** The state of uniq: the number of distinct values, exact while it is small and
+  *  estimated by HyperLogLog when it is large. The values are added by their 64-bit hashes.
+  *  - up to small_capacity hashes are kept in an array inside the state;
+  *  - then up to set_capacity hashes in a hash set, that does not grow over 256 cells (2 KiB);
+  *  - then there are 2^precision one-byte registers of HyperLogLog (4 KiB, error about 1.6%).
+  * One byte per register is more than HLL needs, but it lets the merge take the maximum
+  *  of the registers in a loop that the compiler vectorizes.
+  * The registers are allocated by Allocator (zeroed), so that they are seen by the memory tracker.
+  */
+class AggregateFunctionUniqData : private boost::noncopyable, private Allocator<true> {
+public:
+    static constexpr size_t small_capacity = 16;
+    static constexpr size_t set_capacity = 96;
+    static constexpr size_t precision = 12;
+    static constexpr size_t num_registers = 1ULL << precision;
+
+    AggregateFunctionUniqData() = default;
+    ~AggregateFunctionUniqData() {
+        if (registers) Allocator<true>::free(registers, num_registers);
+    }
+
+    void insert(UInt64 hash);
+
+    /// Adds the hashes except those where null_map (if any) is not 0.
+    void insertBatch(const UInt64* hashes, size_t size, const UInt8* null_map);
+
+    void merge(const AggregateFunctionUniqData& rhs);
+
+    /// The number of distinct values or its estimation.
+    UInt64 size() const;
+
+    void write(BufferWritable& buf) const;
+    void read(BufferReadable& buf);
+
+private:
+    using Set = HashTable<UInt64, HashTableCell<UInt64, TrivialHash>, TrivialHash,
+                          HashTableGrower<4>, HashTableAllocator>;
+
+    void convertToSet();
+    void convertToRegisters();
+
+    void insertIntoRegisters(UInt64 hash) {
+        size_t index = hash >> (64 - precision);
+        UInt8 rank = __builtin_clzll((hash << precision) | (1ULL << (precision - 1))) + 1;
+        registers[index] = std::max(registers[index], rank);
+    }
+
+    /// Calls f for every hash while the state is exact.
+    template <typename F>
+    void forEachHash(F&& f) const {
+        if (set)
+            for (const auto& cell : *set) f(cell.getValue());
+        else
+            for (size_t i = 0; i < small_size; ++i) f(small[i]);
+    }
+
+    UInt8 small_size = 0;
+    UInt64 small[small_capacity];
+    std::unique_ptr<Set> set;
+    UInt8* registers = nullptr;
+};
+
+/** uniq and uniqCombined: the approximate number of distinct values of the arguments.
+  * The batch methods hash the whole batch at once (hashColumns) before they touch the state.
+  */
+class AggregateFunctionUniq final
+        : public IAggregateFunctionDataHelper<AggregateFunctionUniqData, AggregateFunctionUniq> {
+public:
+    AggregateFunctionUniq(const std::string& name_, const DataTypes& argument_types_)
+            : IAggregateFunctionDataHelper<AggregateFunctionUniqData, AggregateFunctionUniq>(
+                      argument_types_, {}),
+              name(name_) {}
+
+    String getName() const override { return name; }
+
+    DataTypePtr getReturnType() const override;
+
+    void add(AggregateDataPtr place, const IColumn** columns, size_t row_num,
+             Arena*) const override;
+
+    /// A run of equal rows adds one value.
+    void addMany(AggregateDataPtr place, const IColumn** columns, size_t row_num, size_t,
+                 Arena* arena) const override {
+        add(place, columns, row_num, arena);
+    }
+
+    void addBatchSinglePlace(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                             Arena*) const override;
+
+    void addBatchSinglePlaceNotNull(size_t batch_size, AggregateDataPtr place,
+                                    const IColumn** columns, const UInt8* null_map,
+                                    Arena*) const override;
+
+    void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {
+        this->data(place).write(buf);
+    }
+
+    void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {
+        this->data(place).read(buf);
+    }
+
+    void insertResultInto(ConstAggregateDataPtr place, IColumn& to) const override;
+
+    const char* getHeaderFilePath() const override { return __FILE__; }
+
+private:
+    String name;
+};
+
+} // namespace doris::vectorized
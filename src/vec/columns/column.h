@@ -62,6 +62,14 @@ public:
       */
     virtual Ptr convertToFullColumnIfConst() const { return getPtr(); }
 
+    /// If column isn't ColumnSparse, return itself.
+    /// If column is ColumnSparse, transforms it to full column.
+    virtual Ptr convertToFullColumnIfSparse() const { return getPtr(); }
+
+    /// If column isn't ColumnRLE, return itself.
+    /// If column is ColumnRLE, transforms it to full column.
+    virtual Ptr convertToFullColumnIfRLE() const { return getPtr(); }
+
     /// If column isn't ColumnLowCardinality, return itself.
     /// If column is ColumnLowCardinality, transforms is to full column.
     virtual Ptr convertToFullColumnIfLowCardinality() const { return getPtr(); }
@@ -140,6 +148,9 @@ public:
 
     /// Removes all elements outside of specified range.
     /// Is used in LIMIT operation, for example.
+    /// Numeric and decimal columns return a view of a large range that shares the memory with
+    /// this column and keeps all of it alive; the view makes a private copy when it is changed.
+    /// A small range is copied, see ColumnVectorHelper::cutRawData().
     virtual Ptr cut(size_t start, size_t length) const {
         MutablePtr res = cloneEmpty();
         res->insertRangeFrom(*this, start, length);
@@ -217,6 +228,11 @@ public:
     using Permutation = PaddedPODArray<size_t>;
     virtual Ptr permute(const Permutation& perm, size_t limit) const = 0;
 
+    /// Same with 32-bit indexes. A block never has 2^32 rows, so sorting can use it
+    /// to move half as many bytes of indexes as with Permutation.
+    using Permutation32 = PaddedPODArray<UInt32>;
+    virtual Ptr permute(const Permutation32& perm, size_t limit) const = 0;
+
     /// Creates new column with values column[indexes[:limit]]. If limit is 0, all indexes are used.
     /// Indexes must be one of the ColumnUInt. For default implementation, see selectIndexImpl from ColumnsCommon.h
     //    virtual Ptr index(const IColumn & indexes, size_t limit) const = 0;
@@ -241,6 +257,8 @@ public:
       * nan_direction_hint - see above.
       */
     virtual void getPermutation(bool reverse, size_t limit, int nan_direction_hint, Permutation & res) const = 0;
+    virtual void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                                Permutation32& res) const = 0;
 
     /** Copies each element according offsets parameter.
       * (i-th element should be copied offsets[i] - offsets[i - 1] times.)
@@ -324,6 +342,12 @@ public:
     /// It's a special kind of column, that contain single value, but is not a ColumnConst.
     virtual bool isDummy() const { return false; }
 
+    /// Column stores only the rows that differ from a common value, see ColumnSparse.
+    virtual bool isSparse() const { return false; }
+
+    /// Column stores runs of equal values, see ColumnRLE.
+    virtual bool isRLE() const { return false; }
+
     /** Memory layout properties.
       *
       * Each value of a column can be placed in memory contiguously or not.
@@ -68,6 +68,15 @@ ColumnPtr ColumnConst::replicate(const Offsets& offsets) const {
 }
 
 ColumnPtr ColumnConst::permute(const Permutation& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+ColumnPtr ColumnConst::permute(const Permutation32& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+template <typename Index>
+ColumnPtr ColumnConst::permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const {
     if (limit == 0)
         limit = s;
     else
@@ -114,4 +123,11 @@ void ColumnConst::getPermutation(bool /*reverse*/, size_t /*limit*/, int /*nan_d
         res[i] = i;
 }
 
+void ColumnConst::getPermutation(bool /*reverse*/, size_t /*limit*/, int /*nan_direction_hint*/,
+                                 Permutation32& res) const {
+    checkPermutationSize<UInt32>(s);
+    res.resize(s);
+    for (size_t i = 0; i < s; ++i) res[i] = i;
+}
+
 } // namespace doris::vectorized
@@ -42,6 +42,9 @@ private:
     ColumnConst(const ColumnPtr& data, size_t s_);
     ColumnConst(const ColumnConst& src) = default;
 
+    template <typename Index>
+    ColumnPtr permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const;
+
 public:
     ColumnPtr convertToFullColumn() const;
 
@@ -81,6 +84,8 @@ public:
 
     bool isNullAt(size_t) const override { return data->isNullAt(0); }
 
+    bool isDefaultAt(size_t) const override { return data->isDefaultAt(0); }
+
     void insertRangeFrom(const IColumn&, size_t /*start*/, size_t length) override { s += length; }
 
     void insert(const Field&) override { ++s; }
@@ -111,8 +116,11 @@ public:
     ColumnPtr filter(const Filter& filt, ssize_t result_size_hint) const override;
     ColumnPtr replicate(const Offsets& offsets) const override;
     ColumnPtr permute(const Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const Permutation32& perm, size_t limit) const override;
     // ColumnPtr index(const IColumn & indexes, size_t limit) const override;
     void getPermutation(bool reverse, size_t limit, int nan_direction_hint, Permutation & res) const override;
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        Permutation32& res) const override;
 
     size_t byteSize() const override { return data->byteSize() + sizeof(s); }
 
@@ -60,6 +60,7 @@ StringRef ColumnDecimal<T>::serializeValueIntoArena(size_t n, Arena& arena,
 
 template <typename T>
 const char* ColumnDecimal<T>::deserializeAndInsertFromArena(const char* pos) {
+    ensureOwnership();
     data.push_back(unalignedLoad<T>(pos));
     return pos + sizeof(T);
 }
@@ -97,18 +98,20 @@ void ColumnDecimal<T>::getPermutation(bool reverse, size_t limit, int , IColumn:
 }
 
 template <typename T>
-ColumnPtr ColumnDecimal<T>::permute(const IColumn::Permutation& perm, size_t limit) const {
-    size_t size = limit ? std::min(data.size(), limit) : data.size();
-    if (perm.size() < size)
-        throw Exception("Size of permutation is less than required.",
-                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
-
-    auto res = this->create(size, scale);
-    typename Self::Container& res_data = res->getData();
+void ColumnDecimal<T>::getPermutation(bool reverse, size_t limit, int,
+                                      IColumn::Permutation32& res) const {
+    checkPermutationSize<UInt32>(data.size());
+    permutation(reverse, limit, res);
+}
 
-    for (size_t i = 0; i < size; ++i) res_data[i] = data[perm[i]];
+template <typename T>
+ColumnPtr ColumnDecimal<T>::permute(const IColumn::Permutation& perm, size_t limit) const {
+    return permuteImpl(*this, perm, limit);
+}
 
-    return res;
+template <typename T>
+ColumnPtr ColumnDecimal<T>::permute(const IColumn::Permutation32& perm, size_t limit) const {
+    return permuteImpl(*this, perm, limit);
 }
 
 template <typename T>
@@ -135,6 +138,7 @@ template <typename T>
 void ColumnDecimal<T>::insertData(const char* src, size_t /*length*/) {
     T tmp;
     memcpy(&tmp, src, sizeof(T));
+    ensureOwnership();
     data.emplace_back(tmp);
 }
 
@@ -150,11 +154,28 @@ void ColumnDecimal<T>::insertRangeFrom(const IColumn& src, size_t start, size_t
                                 std::to_string(src_vec.data.size()) + ").",
                         ErrorCodes::PARAMETER_OUT_OF_BOUND);
 
+    ensureOwnership();
     size_t old_size = data.size();
     data.resize(old_size + length);
     memcpy(data.data() + old_size, &src_vec.data[start], length * sizeof(data[0]));
 }
 
+template <typename T>
+ColumnPtr ColumnDecimal<T>::cut(size_t start, size_t length) const {
+    if (start + length > data.size())
+        throw Exception("Parameters start = " + std::to_string(start) +
+                                ", length = " + std::to_string(length) +
+                                " are out of bound in ColumnDecimal<T>::cut method "
+                                "(data.size() = " +
+                                std::to_string(data.size()) + ").",
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+
+    auto res = this->create(0, scale);
+    this->template cutRawData<sizeof(T)>(
+            *res, reinterpret_cast<const char*>(data.data() + start), length);
+    return res;
+}
+
 template <typename T>
 ColumnPtr ColumnDecimal<T>::filter(const IColumn::Filter& filt, ssize_t result_size_hint) const {
     size_t size = data.size();
@@ -78,6 +78,8 @@ private:
     ColumnDecimal(const ColumnDecimal& src) : data(src.data), scale(src.scale) {}
 
 public:
+    ~ColumnDecimal() override { this->template releaseBorrowedImpl<sizeof(T)>(); }
+
     const char* getFamilyName() const override { return TypeName<T>::get(); }
 
     bool isNumeric() const override { return false; }
@@ -88,33 +90,50 @@ public:
     size_t size() const override { return data.size(); }
     size_t byteSize() const override { return data.size() * sizeof(data[0]); }
     size_t allocatedBytes() const override { return data.allocated_bytes(); }
-    void protect() override { data.protect(); }
-    void reserve(size_t n) override { data.reserve(n); }
+    void protect() override {
+        ensureOwnership();
+        data.protect();
+    }
+    void reserve(size_t n) override {
+        ensureOwnership();
+        data.reserve(n);
+    }
 
     void insertFrom(const IColumn& src, size_t n) override {
+        ensureOwnership();
         data.push_back(static_cast<const Self&>(src).getData()[n]);
     }
     void insertData(const char* pos, size_t /*length*/) override;
-    void insertDefault() override { data.push_back(T()); }
+    void insertDefault() override {
+        ensureOwnership();
+        data.push_back(T());
+    }
     void insert(const Field& x) override {
+        ensureOwnership();
         data.push_back(doris::vectorized::get<NearestFieldType<T>>(x));
     }
     void insertRangeFrom(const IColumn& src, size_t start, size_t length) override;
+    ColumnPtr cut(size_t start, size_t length) const override;
 
-    void popBack(size_t n) override { data.resize_assume_reserved(data.size() - n); }
+    void popBack(size_t n) override {
+        ensureOwnership();
+        data.resize_assume_reserved(data.size() - n);
+    }
 
     StringRef serializeValueIntoArena(size_t n, Arena& arena, char const*& begin) const override;
     const char* deserializeAndInsertFromArena(const char* pos) override;
     void updateHashWithValue(size_t n, SipHash& hash) const override;
     int compareAt(size_t n, size_t m, const IColumn& rhs_, int nan_direction_hint) const override;
     void getPermutation(bool reverse, size_t limit, int nan_direction_hint, IColumn::Permutation & res) const override;
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        IColumn::Permutation32& res) const override;
 
     MutableColumnPtr cloneResized(size_t size) const override;
 
     Field operator[](size_t n) const override { return DecimalField(data[n], scale); }
 
     StringRef getRawData() const override {
-        return StringRef(reinterpret_cast<const char*>(data.data()), data.size());
+        return StringRef(reinterpret_cast<const char*>(data.data()), byteSize());
     }
     StringRef getDataAt(size_t n) const override {
         return StringRef(reinterpret_cast<const char*>(&data[n]), sizeof(data[n]));
@@ -127,6 +146,7 @@ public:
 
     ColumnPtr filter(const IColumn::Filter& filt, ssize_t result_size_hint) const override;
     ColumnPtr permute(const IColumn::Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const IColumn::Permutation32& perm, size_t limit) const override;
     //    ColumnPtr index(const IColumn & indexes, size_t limit) const override;
 
     template <typename Type>
@@ -148,11 +168,23 @@ public:
         return false;
     }
 
-    void insert(const T value) { data.push_back(value); }
-    Container& getData() { return data; }
+    void insert(const T value) {
+        ensureOwnership();
+        data.push_back(value);
+    }
+    Container& getData() {
+        ensureOwnership();
+        return data;
+    }
     const Container& getData() const { return data; }
     const T& getElement(size_t n) const { return data[n]; }
-    T& getElement(size_t n) { return data[n]; }
+    T& getElement(size_t n) {
+        ensureOwnership();
+        return data[n];
+    }
+
+    /// Makes a private copy of borrowed data, see ColumnVectorHelper::borrowRawData().
+    void ensureOwnership() { this->template ensureOwnershipImpl<sizeof(T)>(); }
 
 protected:
     Container data;
@@ -92,6 +92,14 @@ public:
         return cloneDummy(limit ? std::min(s, limit) : s);
     }
 
+    ColumnPtr permute(const Permutation32& perm, size_t limit) const override {
+        if (s != perm.size())
+            throw Exception("Size of permutation doesn't match size of column.",
+                            ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+        return cloneDummy(limit ? std::min(s, limit) : s);
+    }
+
     // ColumnPtr index(const IColumn & indexes, size_t limit) const override
     // {
     //     if (indexes.size() < limit)
@@ -107,6 +115,13 @@ public:
             res[i] = i;
     }
 
+    void getPermutation(bool /*reverse*/, size_t /*limit*/, int /*nan_direction_hint*/,
+                        Permutation32& res) const override {
+        checkPermutationSize<UInt32>(s);
+        res.resize(s);
+        for (size_t i = 0; i < s; ++i) res[i] = i;
+    }
+
     ColumnPtr replicate(const Offsets& offsets) const override {
         if (s != offsets.size())
             throw Exception("Size of offsets doesn't match size of column.",
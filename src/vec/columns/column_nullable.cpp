@@ -133,6 +133,10 @@ void ColumnNullable::insertRangeFrom(const IColumn& src, size_t start, size_t le
     getNestedColumn().insertRangeFrom(*nullable_col.nested_column, start, length);
 }
 
+ColumnPtr ColumnNullable::cut(size_t start, size_t length) const {
+    return ColumnNullable::create(nested_column->cut(start, length), null_map->cut(start, length));
+}
+
 void ColumnNullable::insert(const Field& x) {
     if (x.isNull()) {
         getNestedColumn().insertDefault();
@@ -180,6 +184,12 @@ ColumnPtr ColumnNullable::permute(const Permutation& perm, size_t limit) const {
     return ColumnNullable::create(permuted_data, permuted_null_map);
 }
 
+ColumnPtr ColumnNullable::permute(const Permutation32& perm, size_t limit) const {
+    ColumnPtr permuted_data = getNestedColumn().permute(perm, limit);
+    ColumnPtr permuted_null_map = getNullMapColumn().permute(perm, limit);
+    return ColumnNullable::create(permuted_data, permuted_null_map);
+}
+
 //ColumnPtr ColumnNullable::index(const IColumn & indexes, size_t limit) const
 //{
 //    ColumnPtr indexed_data = getNestedColumn().index(indexes, limit);
@@ -212,6 +222,18 @@ int ColumnNullable::compareAt(size_t n, size_t m, const IColumn& rhs_,
 }
 
 void ColumnNullable::getPermutation(bool reverse, size_t limit, int null_direction_hint, Permutation & res) const
+{
+    getPermutationImpl(reverse, limit, null_direction_hint, res);
+}
+
+void ColumnNullable::getPermutation(bool reverse, size_t limit, int null_direction_hint,
+                                    Permutation32& res) const {
+    getPermutationImpl(reverse, limit, null_direction_hint, res);
+}
+
+template <typename Index>
+void ColumnNullable::getPermutationImpl(bool reverse, size_t limit, int null_direction_hint,
+                                        PaddedPODArray<Index>& res) const
 {
     /// Cannot pass limit because of unknown amount of NULLs.
     getNestedColumn().getPermutation(reverse, 0, null_direction_hint, res);
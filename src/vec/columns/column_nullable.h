@@ -66,6 +66,7 @@ public:
     bool isNullAt(size_t n) const override {
         return assert_cast<const ColumnUInt8&>(*null_map).getData()[n] != 0;
     }
+    bool isDefaultAt(size_t n) const override { return isNullAt(n); }
     Field operator[](size_t n) const override;
     void get(size_t n, Field& res) const override;
     bool getBool(size_t n) const override { return isNullAt(n) ? 0 : nested_column->getBool(n); }
@@ -77,6 +78,7 @@ public:
     StringRef serializeValueIntoArena(size_t n, Arena& arena, char const*& begin) const override;
     const char* deserializeAndInsertFromArena(const char* pos) override;
     void insertRangeFrom(const IColumn& src, size_t start, size_t length) override;
+    ColumnPtr cut(size_t start, size_t length) const override;
     void insert(const Field& x) override;
     void insertFrom(const IColumn& src, size_t n) override;
 
@@ -92,9 +94,12 @@ public:
     void popBack(size_t n) override;
     ColumnPtr filter(const Filter& filt, ssize_t result_size_hint) const override;
     ColumnPtr permute(const Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const Permutation32& perm, size_t limit) const override;
     //    ColumnPtr index(const IColumn & indexes, size_t limit) const override;
     int compareAt(size_t n, size_t m, const IColumn& rhs_, int null_direction_hint) const override;
     void getPermutation(bool reverse, size_t limit, int null_direction_hint, Permutation & res) const override;
+    void getPermutation(bool reverse, size_t limit, int null_direction_hint,
+                        Permutation32& res) const override;
     void reserve(size_t n) override;
     size_t byteSize() const override;
     size_t allocatedBytes() const override;
@@ -163,6 +168,10 @@ private:
 
     template <bool negative>
     void applyNullMapImpl(const ColumnUInt8& map);
+
+    template <typename Index>
+    void getPermutationImpl(bool reverse, size_t limit, int null_direction_hint,
+                            PaddedPODArray<Index>& res) const;
 };
 
 ColumnPtr makeNullable(const ColumnPtr& column);
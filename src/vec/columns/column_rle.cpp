@@ -0,0 +1,327 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/columns/column_rle.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "vec/columns/column_impl.h"
+#include "vec/columns/columns_common.h"
+#include "vec/common/pod_array.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_COLUMN;
+extern const int LOGICAL_ERROR;
+extern const int PARAMETER_OUT_OF_BOUND;
+extern const int SIZES_OF_COLUMNS_DOESNT_MATCH;
+} // namespace ErrorCodes
+
+ColumnRLE::ColumnRLE(MutableColumnPtr&& values_)
+        : values(std::move(values_)), ends(ColumnUInt64::create()) {
+    if (!values->empty())
+        throw Exception("Values of an empty ColumnRLE must be empty", ErrorCodes::LOGICAL_ERROR);
+}
+
+ColumnRLE::ColumnRLE(MutableColumnPtr&& values_, MutableColumnPtr&& ends_)
+        : values(std::move(values_)), ends(std::move(ends_)) {
+    if (values->isRLE() || values->isSparse() || isColumnConst(*values))
+        throw Exception("ColumnRLE cannot have " + values->getName() + " values",
+                        ErrorCodes::ILLEGAL_COLUMN);
+    if (!typeid_cast<const ColumnUInt64*>(ends.get()))
+        throw Exception("Ends of ColumnRLE must be ColumnUInt64, got " + ends->getName(),
+                        ErrorCodes::ILLEGAL_COLUMN);
+    if (values->size() != ends->size())
+        throw Exception("Size of values of ColumnRLE (" + std::to_string(values->size()) +
+                                ") doesn't match the number of runs (" +
+                                std::to_string(ends->size()) + ")",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+}
+
+ColumnRLE::Ptr ColumnRLE::createFromFull(const IColumn& column) {
+    const size_t rows = column.size();
+    Filter run_starts(rows);
+    auto res_ends = ColumnUInt64::create();
+    Offsets& res_ends_data = res_ends->getData();
+    for (size_t i = 0; i < rows; ++i) {
+        run_starts[i] = i == 0 || column.compareAt(i, i - 1, column, 1) != 0;
+        if (run_starts[i] && i > 0) res_ends_data.push_back(i);
+    }
+    if (rows > 0) res_ends_data.push_back(rows);
+
+    return ColumnRLE::create(column.filter(run_starts, res_ends_data.size())->assumeMutable(),
+                             std::move(res_ends));
+}
+
+ColumnPtr ColumnRLE::convertToRLEIfWorthIt(const ColumnPtr& column, double min_run_length) {
+    if (column->isRLE() || column->isSparse() || isColumnConst(*column) || column->empty())
+        return column;
+
+    const size_t rows = column->size();
+    const size_t max_runs = std::max(size_t(1), size_t(rows / min_run_length));
+    size_t runs = 1;
+    for (size_t i = 1; i < rows; ++i)
+        if (column->compareAt(i, i - 1, *column, 1) != 0 && ++runs > max_runs) return column;
+
+    return createFromFull(*column);
+}
+
+size_t ColumnRLE::getRunIndex(size_t n) const {
+    const Offsets& ends_data = getEndsData();
+    return std::upper_bound(ends_data.begin(), ends_data.end(), n) - ends_data.begin();
+}
+
+bool ColumnRLE::hasSameRuns(const ColumnRLE& rhs) const {
+    if (ends.get() == rhs.ends.get()) return true;
+    const Offsets& ends_data = getEndsData();
+    const Offsets& rhs_ends_data = rhs.getEndsData();
+    return ends_data.size() == rhs_ends_data.size() &&
+           0 == memcmp(ends_data.data(), rhs_ends_data.data(),
+                       ends_data.size() * sizeof(ends_data[0]));
+}
+
+MutableColumnPtr ColumnRLE::cloneResized(size_t new_size) const {
+    const size_t old_size = size();
+    if (new_size == 0) return cloneEmpty();
+    if (new_size > old_size) {
+        auto res = ColumnRLE::create(values->cloneResized(values->size()),
+                                     ends->cloneResized(ends->size()));
+        res->insertManyDefaults(new_size - old_size);
+        return res;
+    }
+
+    size_t runs = getRunIndex(new_size - 1) + 1;
+    auto res = ColumnRLE::create(values->cloneResized(runs), ends->cloneResized(runs));
+    res->getEndsData().back() = new_size;
+    return res;
+}
+
+ColumnPtr ColumnRLE::cut(size_t start, size_t length) const {
+    if (start + length > size())
+        throw Exception("Parameters start = " + std::to_string(start) +
+                                ", length = " + std::to_string(length) +
+                                " are out of bound in ColumnRLE::cut() method (size() = " +
+                                std::to_string(size()) + ")",
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+
+    if (length == 0) return cloneEmpty();
+
+    const Offsets& ends_data = getEndsData();
+    size_t first = getRunIndex(start);
+    size_t last = getRunIndex(start + length - 1);
+
+    auto res_ends = ColumnUInt64::create(last - first + 1);
+    Offsets& res_ends_data = res_ends->getData();
+    for (size_t i = first; i < last; ++i) res_ends_data[i - first] = ends_data[i] - start;
+    res_ends_data.back() = length;
+
+    return ColumnRLE::create(values->cut(first, last - first + 1), std::move(res_ends));
+}
+
+void ColumnRLE::insertLastValue(size_t length) {
+    size_t last = values->size() - 1;
+    Offsets& ends_data = getEndsData();
+    if (length == 0) {
+        values->popBack(1);
+    } else if (last > 0 && values->compareAt(last, last - 1, *values, 1) == 0) {
+        values->popBack(1);
+        ends_data.back() += length;
+    } else {
+        ends_data.push_back((ends_data.empty() ? 0 : ends_data.back()) + length);
+    }
+}
+
+void ColumnRLE::insert(const Field& x) {
+    values->insert(x);
+    insertLastValue(1);
+}
+
+void ColumnRLE::insertFrom(const IColumn& src, size_t n) {
+    if (const auto* src_rle = typeid_cast<const ColumnRLE*>(&src))
+        values->insertFrom(*src_rle->values, src_rle->getRunIndex(n));
+    else
+        values->insertFrom(src, n);
+    insertLastValue(1);
+}
+
+void ColumnRLE::insertRangeFrom(const IColumn& src, size_t start, size_t length) {
+    if (start + length > src.size())
+        throw Exception("Parameters start = " + std::to_string(start) +
+                                ", length = " + std::to_string(length) +
+                                " are out of bound in ColumnRLE::insertRangeFrom() method"
+                                " (src.size() = " +
+                                std::to_string(src.size()) + ")",
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+
+    const auto* src_rle = typeid_cast<const ColumnRLE*>(&src);
+    if (!src_rle) {
+        for (size_t i = 0; i < length; ++i) insertFrom(src, start + i);
+        return;
+    }
+
+    /// Append the parts of the runs of the source that are in the range.
+    const Offsets& src_ends = src_rle->getEndsData();
+    const size_t end = start + length;
+    for (size_t run = src_rle->getRunIndex(start), row = start; row < end; ++run) {
+        size_t run_end = std::min(size_t(src_ends[run]), end);
+        values->insertFrom(*src_rle->values, run);
+        insertLastValue(run_end - row);
+        row = run_end;
+    }
+}
+
+void ColumnRLE::insertData(const char* pos, size_t length) {
+    values->insertData(pos, length);
+    insertLastValue(1);
+}
+
+void ColumnRLE::insertManyDefaults(size_t length) {
+    values->insertDefault();
+    insertLastValue(length);
+}
+
+void ColumnRLE::popBack(size_t n) {
+    size_t new_size = size() - n;
+    size_t runs = new_size ? getRunIndex(new_size - 1) + 1 : 0;
+    values->popBack(values->size() - runs);
+    Offsets& ends_data = getEndsData();
+    ends_data.resize(runs);
+    if (runs) ends_data.back() = new_size;
+}
+
+const char* ColumnRLE::deserializeAndInsertFromArena(const char* pos) {
+    pos = values->deserializeAndInsertFromArena(pos);
+    insertLastValue(1);
+    return pos;
+}
+
+ColumnPtr ColumnRLE::filter(const Filter& filt, ssize_t /*result_size_hint*/) const {
+    if (size() != filt.size())
+        throw Exception("Size of filter (" + std::to_string(filt.size()) +
+                                ") doesn't match size of column (" + std::to_string(size()) +
+                                ")",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    /// A run is kept, shorter, if any of its rows is kept.
+    const Offsets& ends_data = getEndsData();
+    Filter values_filter(ends_data.size());
+    auto res_ends = ColumnUInt64::create();
+    Offsets& res_ends_data = res_ends->getData();
+    size_t res_rows = 0;
+    for (size_t run = 0, row = 0; run < ends_data.size(); ++run) {
+        size_t kept = 0;
+        for (; row < ends_data[run]; ++row) kept += filt[row] != 0;
+        values_filter[run] = kept != 0;
+        if (kept) res_ends_data.push_back(res_rows += kept);
+    }
+
+    return ColumnRLE::create(values->filter(values_filter, res_ends_data.size()),
+                             std::move(res_ends));
+}
+
+ColumnPtr ColumnRLE::permute(const Permutation& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+ColumnPtr ColumnRLE::permute(const Permutation32& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+template <typename Index>
+ColumnPtr ColumnRLE::permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const {
+    const size_t rows = size();
+    limit = limit ? std::min(rows, limit) : rows;
+
+    if (perm.size() < limit)
+        throw Exception("Size of permutation is less than required.",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    /// Neighbouring rows of the result that come from the same run make one run,
+    /// so a sorted column stays run-length encoded. A run may be taken several times.
+    auto res_values = values->cloneEmpty();
+    auto res_ends = ColumnUInt64::create();
+    Offsets& res_ends_data = res_ends->getData();
+    size_t last_run = 0;
+    for (size_t i = 0; i < limit; ++i) {
+        size_t run = getRunIndex(perm[i]);
+        if (i == 0 || run != last_run) {
+            res_values->insertFrom(*values, run);
+            res_ends_data.push_back(i + 1);
+            last_run = run;
+        } else {
+            res_ends_data.back() = i + 1;
+        }
+    }
+
+    return ColumnRLE::create(std::move(res_values), std::move(res_ends));
+}
+
+void ColumnRLE::getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                               Permutation& res) const {
+    getPermutationImpl(reverse, limit, nan_direction_hint, res);
+}
+
+void ColumnRLE::getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                               Permutation32& res) const {
+    getPermutationImpl(reverse, limit, nan_direction_hint, res);
+}
+
+template <typename Index>
+void ColumnRLE::getPermutationImpl(bool reverse, size_t limit, int nan_direction_hint,
+                                   PaddedPODArray<Index>& res) const {
+    const size_t rows = size();
+    checkPermutationSize<Index>(rows);
+
+    /// Sort the runs and put the rows of every run in their place. The first limit runs
+    /// have at least limit rows.
+    const size_t runs = getNumberOfRuns();
+    Permutation32 values_perm;
+    values->getPermutation(reverse, limit ? std::min(limit, runs) : 0, nan_direction_hint,
+                           values_perm);
+
+    const Offsets& ends_data = getEndsData();
+    res.resize(rows);
+    size_t pos = 0;
+    for (auto run : values_perm)
+        for (size_t row = run ? ends_data[run - 1] : 0; row < ends_data[run]; ++row)
+            res[pos++] = row;
+}
+
+ColumnPtr ColumnRLE::replicate(const Offsets& replicate_offsets) const {
+    if (size() != replicate_offsets.size())
+        throw Exception("Size of offsets doesn't match size of column.",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    /// Every run becomes a run as long as its rows replicated, empty runs are dropped.
+    const Offsets& ends_data = getEndsData();
+    Filter values_filter(ends_data.size());
+    auto res_ends = ColumnUInt64::create();
+    Offsets& res_ends_data = res_ends->getData();
+    size_t res_rows = 0;
+    for (size_t run = 0; run < ends_data.size(); ++run) {
+        size_t run_end = replicate_offsets[ends_data[run] - 1];
+        values_filter[run] = run_end > res_rows;
+        if (run_end > res_rows) res_ends_data.push_back(res_rows = run_end);
+    }
+
+    return ColumnRLE::create(values->filter(values_filter, res_ends_data.size()),
+                             std::move(res_ends));
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,191 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/columns/column.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris::vectorized {
+
+/** ColumnRLE stores runs of equal values: every value once, and the row where its run ends.
+  * It is used for sorted or clustered columns, where equal values come in long runs.
+  * ColumnConst is the case of a single run.
+  *
+  * values - a column of the nested type, values[i] is the value of the i-th run.
+  * ends - the end (exclusive) of every run, ascending, the same as the offsets of replicate():
+  *  the run i has the rows [ends[i - 1], ends[i]), and ends.back() is the size of the column.
+  *
+  * Runs are not empty. Neighbouring runs may have equal values, e.g. after filter().
+  *
+  * Like ColumnConst, ColumnRLE may be only at top and it is converted to a full column
+  *  (convertToFullColumnIfRLE) by the code that works only with concrete columns.
+  */
+class ColumnRLE final : public COWHelper<IColumn, ColumnRLE> {
+private:
+    friend class COWHelper<IColumn, ColumnRLE>;
+
+    /// An empty column.
+    explicit ColumnRLE(MutableColumnPtr&& values_);
+    ColumnRLE(MutableColumnPtr&& values_, MutableColumnPtr&& ends_);
+    ColumnRLE(const ColumnRLE&) = default;
+
+public:
+    using Base = COWHelper<IColumn, ColumnRLE>;
+    static Ptr create(const ColumnPtr& values_, const ColumnPtr& ends_) {
+        return Base::create(values_->assumeMutable(), ends_->assumeMutable());
+    }
+
+    template <typename... Args,
+              typename = typename std::enable_if<IsMutableColumns<Args...>::value>::type>
+    static MutablePtr create(Args&&... args) {
+        return Base::create(std::forward<Args>(args)...);
+    }
+
+    /// Makes a column of the runs of equal neighbouring rows of column.
+    static Ptr createFromFull(const IColumn& column);
+
+    /// Returns ColumnRLE if the runs of column are at least min_run_length rows long on average,
+    /// otherwise returns column itself.
+    static ColumnPtr convertToRLEIfWorthIt(const ColumnPtr& column, double min_run_length = 16);
+
+    std::string getName() const override { return "RLE(" + values->getName() + ")"; }
+    const char* getFamilyName() const override { return "RLE"; }
+
+    ColumnPtr convertToFullColumnIfRLE() const override { return convertToFullColumn(); }
+    ColumnPtr convertToFullColumn() const { return values->replicate(getEndsData()); }
+
+    MutableColumnPtr cloneResized(size_t new_size) const override;
+
+    size_t size() const override {
+        const Offsets& ends_data = getEndsData();
+        return ends_data.empty() ? 0 : ends_data.back();
+    }
+
+    Field operator[](size_t n) const override { return (*values)[getRunIndex(n)]; }
+    void get(size_t n, Field& res) const override { values->get(getRunIndex(n), res); }
+    StringRef getDataAt(size_t n) const override { return values->getDataAt(getRunIndex(n)); }
+    StringRef getDataAtWithTerminatingZero(size_t n) const override {
+        return values->getDataAtWithTerminatingZero(getRunIndex(n));
+    }
+    UInt64 get64(size_t n) const override { return values->get64(getRunIndex(n)); }
+    Float64 getFloat64(size_t n) const override { return values->getFloat64(getRunIndex(n)); }
+    UInt64 getUInt(size_t n) const override { return values->getUInt(getRunIndex(n)); }
+    Int64 getInt(size_t n) const override { return values->getInt(getRunIndex(n)); }
+    bool getBool(size_t n) const override { return values->getBool(getRunIndex(n)); }
+    bool isDefaultAt(size_t n) const override { return values->isDefaultAt(getRunIndex(n)); }
+    bool isNullAt(size_t n) const override { return values->isNullAt(getRunIndex(n)); }
+
+    ColumnPtr cut(size_t start, size_t length) const override;
+
+    void insert(const Field& x) override;
+    void insertFrom(const IColumn& src, size_t n) override;
+    void insertRangeFrom(const IColumn& src, size_t start, size_t length) override;
+    void insertData(const char* pos, size_t length) override;
+    void insertDefault() override { insertManyDefaults(1); }
+    void insertManyDefaults(size_t length) override;
+    void popBack(size_t n) override;
+
+    StringRef serializeValueIntoArena(size_t n, Arena& arena, char const*& begin) const override {
+        return values->serializeValueIntoArena(getRunIndex(n), arena, begin);
+    }
+    const char* deserializeAndInsertFromArena(const char* pos) override;
+    void updateHashWithValue(size_t n, SipHash& hash) const override {
+        values->updateHashWithValue(getRunIndex(n), hash);
+    }
+
+    ColumnPtr filter(const Filter& filt, ssize_t result_size_hint) const override;
+    ColumnPtr permute(const Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const Permutation32& perm, size_t limit) const override;
+
+    int compareAt(size_t n, size_t m, const IColumn& rhs_, int nan_direction_hint) const override {
+        const auto& rhs = assert_cast<const ColumnRLE&>(rhs_);
+        return values->compareAt(getRunIndex(n), rhs.getRunIndex(m), *rhs.values,
+                                 nan_direction_hint);
+    }
+
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        Permutation& res) const override;
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        Permutation32& res) const override;
+
+    ColumnPtr replicate(const Offsets& replicate_offsets) const override;
+
+    MutableColumns scatter(ColumnIndex num_columns, const Selector& selector) const override {
+        return scatterImpl<ColumnRLE>(num_columns, selector);
+    }
+
+    void getExtremes(Field& min, Field& max) const override { values->getExtremes(min, max); }
+
+    size_t byteSize() const override { return values->byteSize() + ends->byteSize(); }
+    size_t allocatedBytes() const override {
+        return values->allocatedBytes() + ends->allocatedBytes();
+    }
+
+    void forEachSubcolumn(ColumnCallback callback) override {
+        callback(values);
+        callback(ends);
+    }
+
+    bool structureEquals(const IColumn& rhs) const override {
+        if (auto rhs_rle = typeid_cast<const ColumnRLE*>(&rhs))
+            return values->structureEquals(*rhs_rle->values);
+        return false;
+    }
+
+    bool isRLE() const override { return true; }
+    bool isNullable() const override { return values->isNullable(); }
+    bool onlyNull() const override { return values->onlyNull(); }
+    bool valuesHaveFixedSize() const override { return values->valuesHaveFixedSize(); }
+    size_t sizeOfValueIfFixed() const override { return values->sizeOfValueIfFixed(); }
+
+    /// Not part of the common interface.
+
+    /// Number of the run of the n-th row.
+    size_t getRunIndex(size_t n) const;
+
+    size_t getNumberOfRuns() const { return values->size(); }
+
+    /// True if the runs of both columns have the same ends, so that their values
+    /// may be processed together run by run.
+    bool hasSameRuns(const ColumnRLE& rhs) const;
+
+    const IColumn& getValuesColumn() const { return *values; }
+    const ColumnPtr& getValuesColumnPtr() const { return values; }
+    const ColumnPtr& getEndsPtr() const { return ends; }
+    const Offsets& getEndsData() const { return assert_cast<const ColumnUInt64&>(*ends).getData(); }
+    Offsets& getEndsData() { return assert_cast<ColumnUInt64&>(*ends).getData(); }
+
+private:
+    /// Makes the value that was appended to values a run of length rows,
+    /// or extends the last run by it if the values are equal.
+    void insertLastValue(size_t length);
+
+    template <typename Index>
+    ColumnPtr permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const;
+
+    template <typename Index>
+    void getPermutationImpl(bool reverse, size_t limit, int nan_direction_hint,
+                            PaddedPODArray<Index>& res) const;
+
+    WrappedPtr values;
+    WrappedPtr ends;
+};
+
+} // namespace doris::vectorized
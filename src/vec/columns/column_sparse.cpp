@@ -0,0 +1,377 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/columns/column_sparse.h"
+
+#include <algorithm>
+
+#include "vec/columns/column_impl.h"
+#include "vec/columns/columns_common.h"
+#include "vec/common/pod_array.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_COLUMN;
+extern const int LOGICAL_ERROR;
+extern const int PARAMETER_OUT_OF_BOUND;
+extern const int SIZES_OF_COLUMNS_DOESNT_MATCH;
+} // namespace ErrorCodes
+
+ColumnSparse::ColumnSparse(MutableColumnPtr&& values_)
+        : values(std::move(values_)), offsets(ColumnUInt64::create()) {
+    if (!values->empty())
+        throw Exception("Values of an empty ColumnSparse must be empty", ErrorCodes::LOGICAL_ERROR);
+    values->insertDefault();
+}
+
+ColumnSparse::ColumnSparse(MutableColumnPtr&& values_, MutableColumnPtr&& offsets_, size_t size_)
+        : values(std::move(values_)), offsets(std::move(offsets_)), s(size_) {
+    if (values->isSparse() || values->isRLE() || isColumnConst(*values))
+        throw Exception("ColumnSparse cannot have " + values->getName() + " values",
+                        ErrorCodes::ILLEGAL_COLUMN);
+    if (!typeid_cast<const ColumnUInt64*>(offsets.get()))
+        throw Exception("Offsets of ColumnSparse must be ColumnUInt64, got " + offsets->getName(),
+                        ErrorCodes::ILLEGAL_COLUMN);
+
+    const Offsets& offsets_data = getOffsetsData();
+    if (values->size() != offsets_data.size() + 1)
+        throw Exception("Size of values of ColumnSparse (" + std::to_string(values->size()) +
+                                ") must be the number of offsets (" +
+                                std::to_string(offsets_data.size()) + ") plus one",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+    if (!offsets_data.empty() && offsets_data.back() >= s)
+        throw Exception("Offset of ColumnSparse " + std::to_string(offsets_data.back()) +
+                                " is out of bounds of its size " + std::to_string(s),
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+}
+
+ColumnSparse::Ptr ColumnSparse::createFromFull(const IColumn& column) {
+    const size_t rows = column.size();
+    auto res_offsets = ColumnUInt64::create();
+    Offsets& res_offsets_data = res_offsets->getData();
+    for (size_t i = 0; i < rows; ++i)
+        if (!column.isDefaultAt(i)) res_offsets_data.push_back(i);
+
+    auto res_values = column.cloneEmpty();
+    res_values->reserve(res_offsets_data.size() + 1);
+    res_values->insertDefault();
+    for (auto offset : res_offsets_data) res_values->insertFrom(column, offset);
+
+    return ColumnSparse::create(std::move(res_values), std::move(res_offsets), rows);
+}
+
+ColumnPtr ColumnSparse::convertToSparseIfWorthIt(const ColumnPtr& column, double ratio) {
+    if (column->isSparse() || isColumnConst(*column) || column->empty()) return column;
+
+    const size_t rows = column->size();
+    const size_t max_listed = rows - size_t(rows * ratio);
+    size_t listed = 0;
+    for (size_t i = 0; i < rows; ++i)
+        if (!column->isDefaultAt(i) && ++listed > max_listed) return column;
+
+    return createFromFull(*column);
+}
+
+size_t ColumnSparse::getValueIndex(size_t n) const {
+    const Offsets& offsets_data = getOffsetsData();
+    auto it = std::lower_bound(offsets_data.begin(), offsets_data.end(), n);
+    if (it == offsets_data.end() || *it != n) return 0;
+    return it - offsets_data.begin() + 1;
+}
+
+ColumnPtr ColumnSparse::convertToFullColumn() const {
+    const Offsets& offsets_data = getOffsetsData();
+    if (offsets_data.empty()) return values->cloneResized(1)->replicate(Offsets(1, s));
+
+    /// The rows are runs of the common value separated by single listed values: interleave
+    /// them and repeat every common value as many times as its run is long.
+    auto interleaved = values->cloneEmpty();
+    interleaved->reserve(offsets_data.size() * 2 + 1);
+    Offsets replicate_offsets(offsets_data.size() * 2 + 1);
+    for (size_t i = 0; i < offsets_data.size(); ++i) {
+        interleaved->insertFrom(*values, 0);
+        interleaved->insertFrom(*values, i + 1);
+        replicate_offsets[i * 2] = offsets_data[i];
+        replicate_offsets[i * 2 + 1] = offsets_data[i] + 1;
+    }
+    interleaved->insertFrom(*values, 0);
+    replicate_offsets.back() = s;
+
+    return interleaved->replicate(replicate_offsets);
+}
+
+MutableColumnPtr ColumnSparse::cloneResized(size_t new_size) const {
+    const Offsets& offsets_data = getOffsetsData();
+    size_t listed =
+            std::lower_bound(offsets_data.begin(), offsets_data.end(), new_size) -
+            offsets_data.begin();
+
+    auto res = ColumnSparse::create(values->cloneResized(listed + 1),
+                                    offsets->cloneResized(listed), std::min(s, new_size));
+    if (new_size > s) res->insertManyDefaults(new_size - s);
+    return res;
+}
+
+ColumnPtr ColumnSparse::cut(size_t start, size_t length) const {
+    if (start + length > s)
+        throw Exception("Parameters start = " + std::to_string(start) +
+                                ", length = " + std::to_string(length) +
+                                " are out of bound in ColumnSparse::cut() method (size() = " +
+                                std::to_string(s) + ")",
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+
+    const Offsets& offsets_data = getOffsetsData();
+    size_t begin = std::lower_bound(offsets_data.begin(), offsets_data.end(), start) -
+                   offsets_data.begin();
+    size_t end = std::lower_bound(offsets_data.begin() + begin, offsets_data.end(),
+                                  start + length) -
+                 offsets_data.begin();
+
+    auto res_values = values->cloneEmpty();
+    res_values->reserve(end - begin + 1);
+    res_values->insertFrom(*values, 0);
+    res_values->insertRangeFrom(*values, begin + 1, end - begin);
+
+    auto res_offsets = ColumnUInt64::create(end - begin);
+    Offsets& res_offsets_data = res_offsets->getData();
+    for (size_t i = begin; i < end; ++i) res_offsets_data[i - begin] = offsets_data[i] - start;
+
+    return ColumnSparse::create(std::move(res_values), std::move(res_offsets), length);
+}
+
+void ColumnSparse::insertLastValue() {
+    size_t last = values->size() - 1;
+    if (values->isDefaultAt(last) && values->isDefaultAt(0))
+        values->popBack(1);
+    else
+        getOffsetsData().push_back(s);
+    ++s;
+}
+
+void ColumnSparse::insert(const Field& x) {
+    values->insert(x);
+    insertLastValue();
+}
+
+void ColumnSparse::insertFrom(const IColumn& src, size_t n) {
+    if (const auto* src_sparse = typeid_cast<const ColumnSparse*>(&src))
+        values->insertFrom(*src_sparse->values, src_sparse->getValueIndex(n));
+    else
+        values->insertFrom(src, n);
+    insertLastValue();
+}
+
+void ColumnSparse::insertRangeFrom(const IColumn& src, size_t start, size_t length) {
+    if (start + length > src.size())
+        throw Exception("Parameters start = " + std::to_string(start) +
+                                ", length = " + std::to_string(length) +
+                                " are out of bound in ColumnSparse::insertRangeFrom() method"
+                                " (src.size() = " +
+                                std::to_string(src.size()) + ")",
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+
+    const auto* src_sparse = typeid_cast<const ColumnSparse*>(&src);
+    if (!src_sparse || !src_sparse->values->isDefaultAt(0) || !values->isDefaultAt(0)) {
+        for (size_t i = 0; i < length; ++i) insertFrom(src, start + i);
+        return;
+    }
+
+    /// Both columns list all the rows that are not default: append the listed rows of the range.
+    const Offsets& src_offsets = src_sparse->getOffsetsData();
+    size_t begin =
+            std::lower_bound(src_offsets.begin(), src_offsets.end(), start) - src_offsets.begin();
+    size_t end = std::lower_bound(src_offsets.begin() + begin, src_offsets.end(),
+                                  start + length) -
+                 src_offsets.begin();
+
+    values->insertRangeFrom(*src_sparse->values, begin + 1, end - begin);
+    Offsets& offsets_data = getOffsetsData();
+    size_t old_size = offsets_data.size();
+    offsets_data.resize(old_size + end - begin);
+    for (size_t i = begin; i < end; ++i)
+        offsets_data[old_size + i - begin] = src_offsets[i] - start + s;
+    s += length;
+}
+
+void ColumnSparse::insertData(const char* pos, size_t length) {
+    values->insertData(pos, length);
+    insertLastValue();
+}
+
+void ColumnSparse::insertManyDefaults(size_t length) {
+    if (!values->isDefaultAt(0)) {
+        Offsets& offsets_data = getOffsetsData();
+        for (size_t i = 0; i < length; ++i) {
+            values->insertDefault();
+            offsets_data.push_back(s + i);
+        }
+    }
+    s += length;
+}
+
+void ColumnSparse::popBack(size_t n) {
+    Offsets& offsets_data = getOffsetsData();
+    size_t new_size = s - n;
+    size_t listed = std::lower_bound(offsets_data.begin(), offsets_data.end(), new_size) -
+                    offsets_data.begin();
+    if (size_t removed = offsets_data.size() - listed) {
+        values->popBack(removed);
+        offsets_data.resize(listed);
+    }
+    s = new_size;
+}
+
+const char* ColumnSparse::deserializeAndInsertFromArena(const char* pos) {
+    pos = values->deserializeAndInsertFromArena(pos);
+    insertLastValue();
+    return pos;
+}
+
+ColumnPtr ColumnSparse::filter(const Filter& filt, ssize_t /*result_size_hint*/) const {
+    if (s != filt.size())
+        throw Exception("Size of filter (" + std::to_string(filt.size()) +
+                                ") doesn't match size of column (" + std::to_string(s) + ")",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    const Offsets& offsets_data = getOffsetsData();
+    Filter values_filter(values->size());
+    values_filter[0] = 1;
+
+    auto res_offsets = ColumnUInt64::create();
+    Offsets& res_offsets_data = res_offsets->getData();
+
+    /// Rows of the result before the current listed row.
+    size_t res_row = 0;
+    size_t prev = 0;
+    for (size_t i = 0; i < offsets_data.size(); ++i) {
+        size_t offset = offsets_data[i];
+        for (size_t row = prev; row < offset; ++row) res_row += filt[row] != 0;
+        prev = offset + 1;
+
+        values_filter[i + 1] = filt[offset] != 0;
+        if (filt[offset]) res_offsets_data.push_back(res_row++);
+    }
+    for (size_t row = prev; row < s; ++row) res_row += filt[row] != 0;
+
+    return ColumnSparse::create(values->filter(values_filter, res_offsets_data.size() + 1),
+                                std::move(res_offsets), res_row);
+}
+
+ColumnPtr ColumnSparse::permute(const Permutation& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+ColumnPtr ColumnSparse::permute(const Permutation32& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+template <typename Index>
+ColumnPtr ColumnSparse::permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const {
+    limit = limit ? std::min(s, limit) : s;
+
+    if (perm.size() < limit)
+        throw Exception("Size of permutation is less than required.",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    /// Only the listed rows are moved, the rows with the common value are not touched.
+    PaddedPODArray<UInt32> values_perm;
+    values_perm.push_back(0);
+    auto res_offsets = ColumnUInt64::create();
+    Offsets& res_offsets_data = res_offsets->getData();
+    for (size_t i = 0; i < limit; ++i) {
+        if (size_t index = getValueIndex(perm[i])) {
+            values_perm.push_back(index);
+            res_offsets_data.push_back(i);
+        }
+    }
+
+    return ColumnSparse::create(values->permute(values_perm, values_perm.size()),
+                                std::move(res_offsets), limit);
+}
+
+void ColumnSparse::getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                                  Permutation& res) const {
+    getPermutationImpl(reverse, limit, nan_direction_hint, res);
+}
+
+void ColumnSparse::getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                                  Permutation32& res) const {
+    getPermutationImpl(reverse, limit, nan_direction_hint, res);
+}
+
+template <typename Index>
+void ColumnSparse::getPermutationImpl(bool reverse, size_t limit, int nan_direction_hint,
+                                      PaddedPODArray<Index>& res) const {
+    checkPermutationSize<Index>(s);
+
+    /// Sort only the values. The common value stands for all the rows that are not listed,
+    /// so it is expanded to them where it is placed.
+    IColumn::Permutation32 values_perm;
+    values->getPermutation(reverse, limit ? std::min(limit, values->size()) : 0,
+                           nan_direction_hint, values_perm);
+
+    const Offsets& offsets_data = getOffsetsData();
+    res.resize(s);
+    size_t pos = 0;
+    for (auto index : values_perm) {
+        if (index) {
+            res[pos++] = offsets_data[index - 1];
+            continue;
+        }
+        size_t row = 0;
+        for (auto offset : offsets_data) {
+            for (; row < offset; ++row) res[pos++] = row;
+            row = offset + 1;
+        }
+        for (; row < s; ++row) res[pos++] = row;
+    }
+}
+
+ColumnPtr ColumnSparse::replicate(const Offsets& replicate_offsets) const {
+    if (s != replicate_offsets.size())
+        throw Exception("Size of offsets doesn't match size of column.",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    if (s == 0) return cloneEmpty();
+
+    /// Every listed row becomes a range of listed rows with the same value.
+    const Offsets& offsets_data = getOffsetsData();
+    Offsets values_offsets(offsets_data.size() + 1);
+    values_offsets[0] = 1;
+    auto res_offsets = ColumnUInt64::create();
+    Offsets& res_offsets_data = res_offsets->getData();
+    for (size_t i = 0; i < offsets_data.size(); ++i) {
+        size_t row = offsets_data[i];
+        size_t begin = replicate_offsets[row - 1];
+        size_t end = replicate_offsets[row];
+        values_offsets[i + 1] = values_offsets[i] + end - begin;
+        for (size_t j = begin; j < end; ++j) res_offsets_data.push_back(j);
+    }
+
+    return ColumnSparse::create(values->replicate(values_offsets), std::move(res_offsets),
+                                replicate_offsets.back());
+}
+
+void ColumnSparse::getExtremes(Field& min, Field& max) const {
+    if (getNumberOfCommonRows() > 0)
+        values->getExtremes(min, max);
+    else
+        values->cut(1, s)->getExtremes(min, max);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,197 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/columns/column.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris::vectorized {
+
+/** ColumnSparse stores only the rows of a column that differ from one common value.
+  * It is used for columns where almost all values are default (zeros, empty strings or NULLs).
+  *
+  * values - a column of the nested type. values[0] is the value of all rows that are not listed
+  *  in offsets, values[i + 1] is the value of the row offsets[i].
+  * offsets - the numbers of the listed rows, in ascending order.
+  *
+  * values[0] is the default value of the type when the column is made with createFromFull(), but
+  *  the result of a function keeps the value the function returned for it, see
+  *  PreparedFunctionImpl::defaultImplementationForSparseColumns.
+  *
+  * Like ColumnConst, ColumnSparse may be only at top and it is converted to a full column
+  *  (convertToFullColumnIfSparse) by the code that works only with concrete columns.
+  */
+class ColumnSparse final : public COWHelper<IColumn, ColumnSparse> {
+private:
+    friend class COWHelper<IColumn, ColumnSparse>;
+
+    /// An empty column with the default value of values_ as the common value.
+    explicit ColumnSparse(MutableColumnPtr&& values_);
+    ColumnSparse(MutableColumnPtr&& values_, MutableColumnPtr&& offsets_, size_t size_);
+    ColumnSparse(const ColumnSparse&) = default;
+
+public:
+    using Base = COWHelper<IColumn, ColumnSparse>;
+    static Ptr create(const ColumnPtr& values_, const ColumnPtr& offsets_, size_t size_) {
+        return Base::create(values_->assumeMutable(), offsets_->assumeMutable(), size_);
+    }
+
+    template <typename Values,
+              typename = typename std::enable_if<IsMutableColumns<Values>::value>::type>
+    static MutablePtr create(Values&& values_) {
+        return Base::create(std::forward<Values>(values_));
+    }
+
+    template <typename Values, typename OffsetsColumn,
+              typename = typename std::enable_if<
+                      IsMutableColumns<Values, OffsetsColumn>::value>::type>
+    static MutablePtr create(Values&& values_, OffsetsColumn&& offsets_, size_t size_) {
+        return Base::create(std::forward<Values>(values_),
+                            std::forward<OffsetsColumn>(offsets_), size_);
+    }
+
+    /// Makes a sparse column of the rows of column that are not default.
+    static Ptr createFromFull(const IColumn& column);
+
+    /// Returns a sparse column if at least ratio of the rows of column are default,
+    /// otherwise returns column itself.
+    static ColumnPtr convertToSparseIfWorthIt(const ColumnPtr& column, double ratio = 0.9);
+
+    std::string getName() const override { return "Sparse(" + values->getName() + ")"; }
+    const char* getFamilyName() const override { return "Sparse"; }
+
+    ColumnPtr convertToFullColumnIfSparse() const override { return convertToFullColumn(); }
+    ColumnPtr convertToFullColumn() const;
+
+    MutableColumnPtr cloneResized(size_t new_size) const override;
+
+    size_t size() const override { return s; }
+
+    Field operator[](size_t n) const override { return (*values)[getValueIndex(n)]; }
+    void get(size_t n, Field& res) const override { values->get(getValueIndex(n), res); }
+    StringRef getDataAt(size_t n) const override { return values->getDataAt(getValueIndex(n)); }
+    StringRef getDataAtWithTerminatingZero(size_t n) const override {
+        return values->getDataAtWithTerminatingZero(getValueIndex(n));
+    }
+    UInt64 get64(size_t n) const override { return values->get64(getValueIndex(n)); }
+    Float64 getFloat64(size_t n) const override { return values->getFloat64(getValueIndex(n)); }
+    UInt64 getUInt(size_t n) const override { return values->getUInt(getValueIndex(n)); }
+    Int64 getInt(size_t n) const override { return values->getInt(getValueIndex(n)); }
+    bool getBool(size_t n) const override { return values->getBool(getValueIndex(n)); }
+    bool isDefaultAt(size_t n) const override { return values->isDefaultAt(getValueIndex(n)); }
+    bool isNullAt(size_t n) const override { return values->isNullAt(getValueIndex(n)); }
+
+    ColumnPtr cut(size_t start, size_t length) const override;
+
+    void insert(const Field& x) override;
+    void insertFrom(const IColumn& src, size_t n) override;
+    void insertRangeFrom(const IColumn& src, size_t start, size_t length) override;
+    void insertData(const char* pos, size_t length) override;
+    void insertDefault() override { insertManyDefaults(1); }
+    void insertManyDefaults(size_t length) override;
+    void popBack(size_t n) override;
+
+    StringRef serializeValueIntoArena(size_t n, Arena& arena, char const*& begin) const override {
+        return values->serializeValueIntoArena(getValueIndex(n), arena, begin);
+    }
+    const char* deserializeAndInsertFromArena(const char* pos) override;
+    void updateHashWithValue(size_t n, SipHash& hash) const override {
+        values->updateHashWithValue(getValueIndex(n), hash);
+    }
+
+    ColumnPtr filter(const Filter& filt, ssize_t result_size_hint) const override;
+    ColumnPtr permute(const Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const Permutation32& perm, size_t limit) const override;
+
+    int compareAt(size_t n, size_t m, const IColumn& rhs_, int nan_direction_hint) const override {
+        const auto& rhs = assert_cast<const ColumnSparse&>(rhs_);
+        return values->compareAt(getValueIndex(n), rhs.getValueIndex(m), *rhs.values,
+                                 nan_direction_hint);
+    }
+
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        Permutation& res) const override;
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        Permutation32& res) const override;
+
+    ColumnPtr replicate(const Offsets& replicate_offsets) const override;
+
+    MutableColumns scatter(ColumnIndex num_columns, const Selector& selector) const override {
+        return scatterImpl<ColumnSparse>(num_columns, selector);
+    }
+
+    void getExtremes(Field& min, Field& max) const override;
+
+    size_t byteSize() const override { return values->byteSize() + offsets->byteSize(); }
+    size_t allocatedBytes() const override {
+        return values->allocatedBytes() + offsets->allocatedBytes();
+    }
+
+    void forEachSubcolumn(ColumnCallback callback) override {
+        callback(values);
+        callback(offsets);
+    }
+
+    bool structureEquals(const IColumn& rhs) const override {
+        if (auto rhs_sparse = typeid_cast<const ColumnSparse*>(&rhs))
+            return values->structureEquals(*rhs_sparse->values);
+        return false;
+    }
+
+    bool isSparse() const override { return true; }
+    bool isNullable() const override { return values->isNullable(); }
+    bool onlyNull() const override { return values->onlyNull(); }
+    bool valuesHaveFixedSize() const override { return values->valuesHaveFixedSize(); }
+    size_t sizeOfValueIfFixed() const override { return values->sizeOfValueIfFixed(); }
+
+    /// Not part of the common interface.
+
+    /// Position of the value of the n-th row in values, 0 if the row is not listed.
+    size_t getValueIndex(size_t n) const;
+
+    const IColumn& getValuesColumn() const { return *values; }
+    const ColumnPtr& getValuesColumnPtr() const { return values; }
+    const ColumnPtr& getOffsetsPtr() const { return offsets; }
+    const Offsets& getOffsetsData() const {
+        return assert_cast<const ColumnUInt64&>(*offsets).getData();
+    }
+    Offsets& getOffsetsData() { return assert_cast<ColumnUInt64&>(*offsets).getData(); }
+
+    /// Number of the rows that have the common value values[0].
+    size_t getNumberOfCommonRows() const { return s - getOffsetsData().size(); }
+
+private:
+    /// Lists the value that was appended to values as the value of a new row,
+    /// or drops it if it is the default value and the rows that are not listed are default.
+    void insertLastValue();
+
+    template <typename Index>
+    ColumnPtr permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const;
+
+    template <typename Index>
+    void getPermutationImpl(bool reverse, size_t limit, int nan_direction_hint,
+                            PaddedPODArray<Index>& res) const;
+
+    WrappedPtr values;
+    WrappedPtr offsets;
+    size_t s = 0;
+};
+
+} // namespace doris::vectorized
@@ -81,6 +81,7 @@ void ColumnString::insertRangeFrom(const IColumn& src, size_t start, size_t leng
     size_t nested_offset = src_concrete.offsetAt(start);
     size_t nested_length = src_concrete.offsets[start + length - 1] - nested_offset;
 
+    ensureOwnership();
     size_t old_chars_size = chars.size();
     chars.resize(old_chars_size + nested_length);
     memcpy(&chars[old_chars_size], &src_concrete.chars[nested_offset], nested_length);
@@ -111,6 +112,15 @@ ColumnPtr ColumnString::filter(const Filter& filt, ssize_t result_size_hint) con
 }
 
 ColumnPtr ColumnString::permute(const Permutation& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+ColumnPtr ColumnString::permute(const Permutation32& perm, size_t limit) const {
+    return permuteImpl(perm, limit);
+}
+
+template <typename Index>
+ColumnPtr ColumnString::permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const {
     size_t size = offsets.size();
 
     if (limit == 0)
@@ -174,6 +184,7 @@ const char* ColumnString::deserializeAndInsertFromArena(const char* pos) {
     const size_t string_size = unalignedLoad<size_t>(pos);
     pos += sizeof(string_size);
 
+    ensureOwnership();
     const size_t old_size = chars.size();
     const size_t new_size = old_size + string_size;
     chars.resize(new_size);
@@ -234,8 +245,20 @@ struct ColumnString::less {
 };
 
 void ColumnString::getPermutation(bool reverse, size_t limit, int /*nan_direction_hint*/, Permutation & res) const
+{
+    getPermutationImpl(reverse, limit, res);
+}
+
+void ColumnString::getPermutation(bool reverse, size_t limit, int /*nan_direction_hint*/,
+                                  Permutation32& res) const {
+    getPermutationImpl(reverse, limit, res);
+}
+
+template <typename Index>
+void ColumnString::getPermutationImpl(bool reverse, size_t limit, PaddedPODArray<Index>& res) const
 {
     size_t s = offsets.size();
+    checkPermutationSize<Index>(s);
     res.resize(s);
     for (size_t i = 0; i < s; ++i)
         res[i] = i;
@@ -304,6 +327,7 @@ ColumnPtr ColumnString::replicate(const Offsets& replicate_offsets) const {
 //}
 
 void ColumnString::reserve(size_t n) {
+    ensureOwnership();
     offsets.reserve(n);
 }
 
@@ -19,6 +19,7 @@
 
 #include <cassert>
 #include <cstring>
+#include <memory>
 
 #include "vec/columns/column.h"
 #include "vec/columns/column_impl.h"
@@ -50,6 +51,9 @@ private:
     /// For convenience, every string ends with terminating zero byte. Note that strings could contain zero bytes in the middle.
     Chars chars;
 
+    /// Keeps alive the memory of offsets and chars if they are borrowed, see borrow().
+    std::shared_ptr<const void> borrowed_memory;
+
     size_t ALWAYS_INLINE offsetAt(ssize_t i) const { return offsets[i - 1]; }
 
     /// Size of i-th element, including terminating zero.
@@ -61,6 +65,12 @@ private:
     template <bool positive>
     struct lessWithCollation;
 
+    template <typename Index>
+    ColumnPtr permuteImpl(const PaddedPODArray<Index>& perm, size_t limit) const;
+
+    template <typename Index>
+    void getPermutationImpl(bool reverse, size_t limit, PaddedPODArray<Index>& res) const;
+
     ColumnString() = default;
 
     ColumnString(const ColumnString& src)
@@ -68,6 +78,13 @@ private:
               chars(src.chars.begin(), src.chars.end()) {}
 
 public:
+    ~ColumnString() override {
+        if (borrowed_memory) {
+            offsets.releaseBorrowed();
+            chars.releaseBorrowed();
+        }
+    }
+
     const char* getFamilyName() const override { return "String"; }
 
     size_t size() const override { return offsets.size(); }
@@ -102,6 +119,8 @@ public:
         return StringRef(&chars[offsetAt(n)], sizeAt(n));
     }
 
+    bool isDefaultAt(size_t n) const override { return sizeAt(n) == 1; }
+
 /// Suppress gcc 7.3.1 warning: '*((void*)&<anonymous> +8)' may be used uninitialized in this function
 #if !__clang__
 #pragma GCC diagnostic push
@@ -110,6 +129,7 @@ public:
 
     void insert(const Field& x) override {
         const String& s = doris::vectorized::get<const String&>(x);
+        ensureOwnership();
         const size_t old_size = chars.size();
         const size_t size_to_append = s.size() + 1;
         const size_t new_size = old_size + size_to_append;
@@ -127,6 +147,7 @@ public:
         const ColumnString& src = assert_cast<const ColumnString&>(src_);
         const size_t size_to_append =
                 src.offsets[n] - src.offsets[n - 1]; /// -1th index is Ok, see PaddedPODArray.
+        ensureOwnership();
 
         if (size_to_append == 1) {
             /// shortcut for empty string
@@ -145,6 +166,7 @@ public:
     }
 
     void insertData(const char* pos, size_t length) override {
+        ensureOwnership();
         const size_t old_size = chars.size();
         const size_t new_size = old_size + length + 1;
 
@@ -156,6 +178,7 @@ public:
 
     /// Like getData, but inserting data should be zero-ending (i.e. length is 1 byte greater than real string size).
     void insertDataWithTerminatingZero(const char* pos, size_t length) {
+        ensureOwnership();
         const size_t old_size = chars.size();
         const size_t new_size = old_size + length;
 
@@ -165,6 +188,7 @@ public:
     }
 
     void popBack(size_t n) override {
+        ensureOwnership();
         size_t nested_n = offsets.back() - offsetAt(offsets.size() - n);
         chars.resize(chars.size() - nested_n);
         offsets.resize_assume_reserved(offsets.size() - n);
@@ -187,6 +211,7 @@ public:
     ColumnPtr filter(const Filter& filt, ssize_t result_size_hint) const override;
 
     ColumnPtr permute(const Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const Permutation32& perm, size_t limit) const override;
 
     //    ColumnPtr index(const IColumn & indexes, size_t limit) const override;
 
@@ -194,6 +219,7 @@ public:
     ColumnPtr indexImpl(const PaddedPODArray<Type>& indexes, size_t limit) const;
 
     void insertDefault() override {
+        ensureOwnership();
         chars.push_back(0);
         offsets.push_back(offsets.back() + 1);
     }
@@ -210,6 +236,8 @@ public:
                                const Collator& collator) const;
 
     void getPermutation(bool reverse, size_t limit, int nan_direction_hint, Permutation & res) const override;
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        Permutation32& res) const override;
 
     /// Sorting with respect of collation.
     void getPermutationWithCollation(const Collator& collator, bool reverse, size_t limit,
@@ -233,11 +261,44 @@ public:
         return typeid(rhs) == typeid(ColumnString);
     }
 
-    Chars& getChars() { return chars; }
+    Chars& getChars() {
+        ensureOwnership();
+        return chars;
+    }
     const Chars& getChars() const { return chars; }
 
-    Offsets& getOffsets() { return offsets; }
+    Offsets& getOffsets() {
+        ensureOwnership();
+        return offsets;
+    }
     const Offsets& getOffsets() const { return offsets; }
+
+    /** Makes the empty column use rows offsets and chars_size chars without copying, e.g. from
+      * a mapped file. owner keeps the memory alive. The memory is never written: the column
+      * makes a private copy before it is changed, including any non-const access to the data.
+      * The memory must be padded as the memory of PaddedPODArray, with the -1th offset zero,
+      * and the offsets must be valid for the chars.
+      */
+    void borrow(const char* offsets_begin, size_t rows, const char* chars_begin,
+                size_t chars_size, std::shared_ptr<const void> owner) {
+        assert(empty());
+        if (rows == 0) return;
+        offsets.borrow(offsets_begin, offsets_begin + rows * sizeof(Offset));
+        chars.borrow(chars_begin, chars_begin + chars_size);
+        borrowed_memory = std::move(owner);
+    }
+
+    /// True if the data is borrowed, see borrow().
+    bool isBorrowed() const { return borrowed_memory != nullptr; }
+
+    /// Makes a private copy of borrowed data.
+    void ensureOwnership() {
+        if (UNLIKELY(borrowed_memory)) {
+            offsets.unborrow();
+            chars.unborrow();
+            borrowed_memory.reset();
+        }
+    }
 };
 
 } // namespace doris::vectorized
@@ -20,6 +20,7 @@
 #include <cmath>
 #include <cstring>
 
+#include "vec/columns/columns_common.h"
 #include "vec/common/arena.h"
 #include "vec/common/exception.h"
 #include "vec/common/nan_utils.h"
@@ -55,6 +56,7 @@ StringRef ColumnVector<T>::serializeValueIntoArena(size_t n, Arena& arena,
 
 template <typename T>
 const char* ColumnVector<T>::deserializeAndInsertFromArena(const char* pos) {
+    ensureOwnership();
     data.push_back(unalignedLoad<T>(pos));
     return pos + sizeof(T);
 }
@@ -105,8 +107,23 @@ namespace
 
 template <typename T>
 void ColumnVector<T>::getPermutation(bool reverse, size_t limit, int nan_direction_hint, IColumn::Permutation & res) const
+{
+    getPermutationImpl(reverse, limit, nan_direction_hint, res);
+}
+
+template <typename T>
+void ColumnVector<T>::getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                                     IColumn::Permutation32& res) const {
+    getPermutationImpl(reverse, limit, nan_direction_hint, res);
+}
+
+template <typename T>
+template <typename Index>
+void ColumnVector<T>::getPermutationImpl(bool reverse, size_t limit, int nan_direction_hint,
+                                         PaddedPODArray<Index>& res) const
 {
     size_t s = data.size();
+    checkPermutationSize<Index>(s);
     res.resize(s);
 
     if (s == 0)
@@ -245,11 +262,28 @@ void ColumnVector<T>::insertRangeFrom(const IColumn& src, size_t start, size_t l
                                 std::to_string(src_vec.data.size()) + ").",
                         ErrorCodes::PARAMETER_OUT_OF_BOUND);
 
+    ensureOwnership();
     size_t old_size = data.size();
     data.resize(old_size + length);
     memcpy(data.data() + old_size, &src_vec.data[start], length * sizeof(data[0]));
 }
 
+template <typename T>
+ColumnPtr ColumnVector<T>::cut(size_t start, size_t length) const {
+    if (start + length > data.size())
+        throw Exception("Parameters start = " + std::to_string(start) +
+                                ", length = " + std::to_string(length) +
+                                " are out of bound in ColumnVector<T>::cut method"
+                                " (data.size() = " +
+                                std::to_string(data.size()) + ").",
+                        ErrorCodes::PARAMETER_OUT_OF_BOUND);
+
+    auto res = this->create();
+    this->template cutRawData<sizeof(T)>(
+            *res, reinterpret_cast<const char*>(data.data() + start), length);
+    return res;
+}
+
 template <typename T>
 ColumnPtr ColumnVector<T>::filter(const IColumn::Filter& filt, ssize_t result_size_hint) const {
     size_t size = data.size();
@@ -307,22 +341,12 @@ ColumnPtr ColumnVector<T>::filter(const IColumn::Filter& filt, ssize_t result_si
 
 template <typename T>
 ColumnPtr ColumnVector<T>::permute(const IColumn::Permutation& perm, size_t limit) const {
-    size_t size = data.size();
-
-    if (limit == 0)
-        limit = size;
-    else
-        limit = std::min(size, limit);
-
-    if (perm.size() < limit)
-        throw Exception("Size of permutation is less than required.",
-                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
-
-    auto res = this->create(limit);
-    typename Self::Container& res_data = res->getData();
-    for (size_t i = 0; i < limit; ++i) res_data[i] = data[perm[i]];
+    return permuteImpl(*this, perm, limit);
+}
 
-    return res;
+template <typename T>
+ColumnPtr ColumnVector<T>::permute(const IColumn::Permutation32& perm, size_t limit) const {
+    return permuteImpl(*this, perm, limit);
 }
 
 //template <typename T>
@@ -117,6 +117,8 @@ private:
     ColumnVector(std::initializer_list<T> il) : data {il} {}
 
 public:
+    ~ColumnVector() override { this->template releaseBorrowedImpl<sizeof(T)>(); }
+
     bool isNumeric() const override { return IsNumber<T>; }
 
     size_t size() const override { return data.size(); }
@@ -126,16 +128,24 @@ public:
     }
 
     void insertFrom(const IColumn& src, size_t n) override {
+        ensureOwnership();
         data.push_back(static_cast<const Self&>(src).getData()[n]);
     }
 
     void insertData(const char* pos, size_t /*length*/) override {
+        ensureOwnership();
         data.push_back(unalignedLoad<T>(pos));
     }
 
-    void insertDefault() override { data.push_back(T()); }
+    void insertDefault() override {
+        ensureOwnership();
+        data.push_back(T());
+    }
 
-    void popBack(size_t n) override { data.resize_assume_reserved(data.size() - n); }
+    void popBack(size_t n) override {
+        ensureOwnership();
+        data.resize_assume_reserved(data.size() - n);
+    }
 
     StringRef serializeValueIntoArena(size_t n, Arena& arena, char const*& begin) const override;
 
@@ -147,9 +157,15 @@ public:
 
     size_t allocatedBytes() const override { return data.allocated_bytes(); }
 
-    void protect() override { data.protect(); }
+    void protect() override {
+        ensureOwnership();
+        data.protect();
+    }
 
-    void insertValue(const T value) { data.push_back(value); }
+    void insertValue(const T value) {
+        ensureOwnership();
+        data.push_back(value);
+    }
 
     /// This method implemented in header because it could be possibly devirtualized.
     int compareAt(size_t n, size_t m, const IColumn& rhs_, int nan_direction_hint) const override {
@@ -158,8 +174,13 @@ public:
     }
 
     void getPermutation(bool reverse, size_t limit, int nan_direction_hint, IColumn::Permutation & res) const override;
+    void getPermutation(bool reverse, size_t limit, int nan_direction_hint,
+                        IColumn::Permutation32& res) const override;
 
-    void reserve(size_t n) override { data.reserve(n); }
+    void reserve(size_t n) override {
+        ensureOwnership();
+        data.reserve(n);
+    }
 
     const char* getFamilyName() const override;
 
@@ -180,14 +201,18 @@ public:
     Int64 getInt(size_t n) const override { return Int64(data[n]); }
 
     void insert(const Field& x) override {
+        ensureOwnership();
         data.push_back(doris::vectorized::get<NearestFieldType<T>>(x));
     }
 
     void insertRangeFrom(const IColumn& src, size_t start, size_t length) override;
 
+    ColumnPtr cut(size_t start, size_t length) const override;
+
     ColumnPtr filter(const IColumn::Filter& filt, ssize_t result_size_hint) const override;
 
     ColumnPtr permute(const IColumn::Permutation& perm, size_t limit) const override;
+    ColumnPtr permute(const IColumn::Permutation32& perm, size_t limit) const override;
 
     //    ColumnPtr index(const IColumn & indexes, size_t limit) const override;
 
@@ -210,7 +235,7 @@ public:
     bool isFixedAndContiguous() const override { return true; }
     size_t sizeOfValueIfFixed() const override { return sizeof(T); }
     StringRef getRawData() const override {
-        return StringRef(reinterpret_cast<const char*>(data.data()), data.size());
+        return StringRef(reinterpret_cast<const char*>(data.data()), byteSize());
     }
 
     bool structureEquals(const IColumn& rhs) const override {
@@ -218,16 +243,30 @@ public:
     }
 
     /** More efficient methods of manipulation - to manipulate with data directly. */
-    Container& getData() { return data; }
+    Container& getData() {
+        ensureOwnership();
+        return data;
+    }
 
     const Container& getData() const { return data; }
 
     const T& getElement(size_t n) const { return data[n]; }
 
-    T& getElement(size_t n) { return data[n]; }
+    T& getElement(size_t n) {
+        ensureOwnership();
+        return data[n];
+    }
+
+    /// Makes a private copy of borrowed data, see ColumnVectorHelper::borrowRawData().
+    void ensureOwnership() { this->template ensureOwnershipImpl<sizeof(T)>(); }
 
 protected:
     Container data;
+
+private:
+    template <typename Index>
+    void getPermutationImpl(bool reverse, size_t limit, int nan_direction_hint,
+                            PaddedPODArray<Index>& res) const;
 };
 
 template <typename T>
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "vec/columns/column.h"
 
 namespace doris::vectorized {
@@ -40,17 +43,132 @@ class ColumnVectorHelper : public IColumn {
 public:
     template <size_t ELEMENT_SIZE>
     const char* getRawDataBegin() const {
-        return reinterpret_cast<const PODArrayBase<ELEMENT_SIZE, 4096, Allocator<false>, 15, 16>*>(
+        return reinterpret_cast<const RawArray<ELEMENT_SIZE>*>(
                        reinterpret_cast<const char*>(this) + sizeof(*this))
                 ->raw_data();
     }
 
     template <size_t ELEMENT_SIZE>
     void insertRawData(const char* ptr) {
-        return reinterpret_cast<PODArrayBase<ELEMENT_SIZE, 4096, Allocator<false>, 15, 16>*>(
-                       reinterpret_cast<char*>(this) + sizeof(*this))
-                ->push_back_raw(ptr);
+        ensureOwnershipImpl<ELEMENT_SIZE>();
+        return getRawArray<ELEMENT_SIZE>().push_back_raw(ptr);
+    }
+
+    /// Appends n values stored one after another, e.g. read from a file.
+    template <size_t ELEMENT_SIZE>
+    void insertRawData(const char* ptr, size_t n) {
+        ensureOwnershipImpl<ELEMENT_SIZE>();
+        auto& data = getRawArray<ELEMENT_SIZE>();
+        size_t old_size = data.size();
+        data.resize(old_size + n);
+        memcpy(const_cast<char*>(data.raw_data()) + old_size * ELEMENT_SIZE, ptr, n * ELEMENT_SIZE);
+    }
+
+    /** Makes the empty column use n values at ptr without copying, e.g. from a mapped file.
+      * owner keeps the memory alive. The memory is never written: the column makes a private
+      * copy before it is changed, including any non-const access to the data.
+      * The memory must be padded as the memory of PaddedPODArray.
+      */
+    template <size_t ELEMENT_SIZE>
+    void borrowRawData(const char* ptr, size_t n, std::shared_ptr<const void> owner) {
+        if (!empty() || n == 0) {
+            insertRawData<ELEMENT_SIZE>(ptr, n);
+            return;
+        }
+        getRawArray<ELEMENT_SIZE>().borrow(ptr, ptr + n * ELEMENT_SIZE);
+        borrowed_memory = std::move(owner);
+    }
+
+    /// True if the data is borrowed, see borrowRawData().
+    bool isBorrowed() const { return borrowed_memory != nullptr; }
+
+    /// cut() makes a view only of a part of at least MIN_CUT_VIEW_BYTES bytes that is at least
+    /// 1 / MAX_CUT_VIEW_PINNED_RATIO of the column, see cutRawData().
+    static constexpr size_t MIN_CUT_VIEW_BYTES = 16 * 1024;
+    static constexpr size_t MAX_CUT_VIEW_PINNED_RATIO = 16;
+
+protected:
+    /** Fills the empty column res, of the same type, with the n values at ptr of this column,
+      * for cut(). A large part of the column is not copied: res is made a view that borrows
+      * the memory and pins the whole source (the owner of the borrowed memory, or the column
+      * itself) until res is destroyed or changed. A small part is copied, so that it does not
+      * keep alive much more memory than it uses.
+      */
+    template <size_t ELEMENT_SIZE>
+    void cutRawData(ColumnVectorHelper& res, const char* ptr, size_t n) const {
+        if (n * ELEMENT_SIZE < MIN_CUT_VIEW_BYTES || n * MAX_CUT_VIEW_PINNED_RATIO < size())
+            res.insertRawData<ELEMENT_SIZE>(ptr, n);
+        else
+            res.borrowRawData<ELEMENT_SIZE>(ptr, n, getMemoryOwner());
+    }
+
+    template <size_t ELEMENT_SIZE>
+    void ensureOwnershipImpl() {
+        if (UNLIKELY(borrowed_memory)) {
+            getRawArray<ELEMENT_SIZE>().unborrow();
+            borrowed_memory.reset();
+        } else if (UNLIKELY(viewed.load(std::memory_order_relaxed))) {
+            detachFromViews<ELEMENT_SIZE>();
+        }
+    }
+
+    /// Must be called by the destructor of the derived class, before the data is destroyed.
+    template <size_t ELEMENT_SIZE>
+    void releaseBorrowedImpl() {
+        if (borrowed_memory) getRawArray<ELEMENT_SIZE>().releaseBorrowed();
+    }
+
+private:
+    /** Keeps the data alive for a view of it: the owner of the borrowed memory, or the column
+      * itself. The column may still be changed through a MutablePtr held by the caller, so it
+      * is marked as viewed and moves its memory aside before the first change.
+      */
+    std::shared_ptr<const void> getMemoryOwner() const {
+        if (borrowed_memory) return borrowed_memory;
+        viewed.store(true, std::memory_order_relaxed);
+        return std::make_shared<const ColumnPtr>(getPtr());
+    }
+
+    template <size_t ELEMENT_SIZE>
+    using RawArray = PODArrayBase<ELEMENT_SIZE, 4096, Allocator<false>, 15, 16>;
+
+    template <size_t ELEMENT_SIZE>
+    RawArray<ELEMENT_SIZE>& getRawArray() {
+        return *reinterpret_cast<RawArray<ELEMENT_SIZE>*>(reinterpret_cast<char*>(this) +
+                                                          sizeof(*this));
+    }
+
+    /// Memory that was moved aside while views of it may still be alive.
+    template <size_t ELEMENT_SIZE>
+    struct RetiredMemory {
+        std::shared_ptr<const void> previous;
+        RawArray<ELEMENT_SIZE> data;
+    };
+
+    /// The views pin the column, not the memory: the memory is kept by the column until the
+    /// column is destroyed, or until it is changed again when there are no more views.
+    template <size_t ELEMENT_SIZE>
+    void detachFromViews() {
+        viewed.store(false, std::memory_order_relaxed);
+        if (this->use_count() <= 1) {
+            retired_memory.reset();
+            return;
+        }
+
+        auto& data = getRawArray<ELEMENT_SIZE>();
+        auto retired = std::make_shared<RetiredMemory<ELEMENT_SIZE>>();
+        retired->previous = std::move(retired_memory);
+        data.moveMemoryTo(retired->data);
+        data.borrow(retired->data.raw_data(),
+                    retired->data.raw_data() + retired->data.size() * ELEMENT_SIZE);
+        data.unborrow();
+        retired_memory = std::move(retired);
     }
+
+    std::shared_ptr<const void> borrowed_memory;
+    /// Set by getMemoryOwner(), see detachFromViews().
+    mutable std::atomic<bool> viewed{false};
+    std::shared_ptr<const void> retired_memory;
 };
 
 } // namespace doris::vectorized
@@ -20,7 +20,11 @@
 #endif
 
 #include "vec/columns/column.h"
+#include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/sip_hash.h"
+#include "vec/common/string_ref.h"
 #include "vec/common/typeid_cast.h"
 //#include <vec/Common/HashTable/HashSet.h>
 //#include <vec/Common/HashTable/HashMap.h>
@@ -258,6 +262,37 @@ INSTANTIATE(Float64)
 
 #undef INSTANTIATE
 
+void hashColumns(const IColumn** columns, size_t num_columns, size_t begin, size_t end,
+                 UInt64* __restrict hashes) {
+    for (size_t column_num = 0; column_num < num_columns; ++column_num) {
+        const IColumn& column = *columns[column_num];
+        /// The hashes of the previous columns are mixed in, so that (a, b) and (b, a) differ.
+        bool combine = column_num > 0;
+
+        if (column.isFixedAndContiguous() && column.sizeOfValueIfFixed() <= sizeof(UInt64)) {
+            size_t value_size = column.sizeOfValueIfFixed();
+            const char* data = column.getRawData().data + begin * value_size;
+            for (size_t i = 0; i < end - begin; ++i) {
+                UInt64 value = 0;
+                memcpy(&value, data + i * value_size, value_size);
+                hashes[i] = intHash64(combine ? value ^ intHash64(hashes[i]) : value);
+            }
+        } else if (const auto* strings = typeid_cast<const ColumnString*>(&column)) {
+            for (size_t i = 0; i < end - begin; ++i) {
+                UInt64 hash = StringRefHash64()(strings->getDataAt(begin + i));
+                hashes[i] = combine ? intHash64(hash ^ hashes[i]) : hash;
+            }
+        } else {
+            for (size_t i = 0; i < end - begin; ++i) {
+                SipHash hash;
+                if (combine) hash.update(hashes[i]);
+                column.updateHashWithValue(begin + i, hash);
+                hashes[i] = hash.get64();
+            }
+        }
+    }
+}
+
 namespace detail {
 template <typename T>
 const PaddedPODArray<T>* getIndexesData(const IColumn& indexes) {
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include "vec/columns/column.h"
 
 /// Common helper methods for implementation of different columns.
@@ -25,6 +27,7 @@ namespace doris::vectorized {
 
 namespace ErrorCodes {
 extern const int LOGICAL_ERROR;
+extern const int TOO_LARGE_ARRAY_SIZE;
 }
 
 /// Counts how many bytes of `filt` are greater than zero.
@@ -39,6 +42,13 @@ std::vector<size_t> countColumnsSizeInSelector(IColumn::ColumnIndex num_columns,
 bool memoryIsZero(const void* data, size_t size);
 bool memoryIsByte(const void* data, size_t size, uint8_t byte);
 
+/** Writes the hashes of the rows [begin, end) of the columns into hashes.
+  * Numbers are hashed by intHash64 in a loop over the raw data, strings by CityHash64,
+  *  and other columns by SipHash of every row.
+  */
+void hashColumns(const IColumn** columns, size_t num_columns, size_t begin, size_t end,
+                 UInt64* __restrict hashes);
+
 /// The general implementation of `filter` function for ColumnArray and ColumnString.
 template <typename T>
 void filterArraysImpl(const PaddedPODArray<T>& src_elems, const IColumn::Offsets& src_offsets,
@@ -79,6 +89,28 @@ ColumnPtr selectIndexImpl(const Column& column, const IColumn& indexes, size_t l
                 ErrorCodes::LOGICAL_ERROR);
 }
 
+/// Check limit <= perm.size() and call column.indexImpl(perm, limit), for IColumn::permute.
+template <typename Column, typename Index>
+ColumnPtr permuteImpl(const Column& column, const PaddedPODArray<Index>& perm, size_t limit) {
+    size_t size = column.size();
+    limit = limit ? std::min(size, limit) : size;
+
+    if (perm.size() < limit)
+        throw Exception("Size of permutation is less than required.",
+                        ErrorCodes::SIZES_OF_COLUMNS_DOESNT_MATCH);
+
+    if (limit == 0) return column.cloneEmpty();
+    return column.template indexImpl<Index>(perm, limit);
+}
+
+/// Check that every row of a column can be numbered by Index, for IColumn::getPermutation.
+template <typename Index>
+void checkPermutationSize(size_t size) {
+    if (size > std::numeric_limits<Index>::max())
+        throw Exception("Too many rows for permutation: " + std::to_string(size),
+                        ErrorCodes::TOO_LARGE_ARRAY_SIZE);
+}
+
 #define INSTANTIATE_INDEX_IMPL(Column)                                                  \
     template ColumnPtr Column::indexImpl<UInt8>(const PaddedPODArray<UInt8>& indexes,   \
                                                 size_t limit) const;                    \
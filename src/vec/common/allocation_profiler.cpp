@@ -0,0 +1,322 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/allocation_profiler.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <boost/stacktrace.hpp>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+namespace doris::vectorized {
+
+namespace {
+
+/// Frames of the profiler itself and of Allocator.
+constexpr size_t SKIP_FRAMES = 2;
+constexpr size_t MAX_STACK_DEPTH = 32;
+constexpr size_t NUMBER_OF_SHARDS = 16;
+
+struct Site {
+    explicit Site(const boost::stacktrace::stacktrace& stack_) : stack(stack_) {}
+
+    const boost::stacktrace::stacktrace stack;
+    std::atomic<UInt64> live_samples{0};
+    std::atomic<UInt64> live_sampled_bytes{0};
+    std::atomic<UInt64> live_estimated_bytes{0};
+    std::atomic<UInt64> total_samples{0};
+    std::atomic<UInt64> total_sampled_bytes{0};
+};
+
+struct Sample {
+    size_t size;
+    UInt64 estimated_bytes;
+    Site* site;
+};
+
+/// Live samples by address, sharded so that frees in different threads rarely contend.
+struct Shard {
+    std::mutex mutex;
+    std::unordered_map<const void*, Sample> samples;
+};
+
+struct State {
+    /// Protects sites. Always locked before the mutexes of shards.
+    std::mutex mutex;
+    std::map<boost::stacktrace::stacktrace, std::unique_ptr<Site>> sites;
+    Shard shards[NUMBER_OF_SHARDS];
+
+    std::atomic<size_t> sample_interval{AllocationProfiler::DEFAULT_SAMPLE_INTERVAL};
+    /// Incremented by every start(), so that threads reset their countdowns.
+    std::atomic<UInt64> generation{0};
+};
+
+/// Never destroyed: allocations are freed by static destructors of other objects.
+State& getState() {
+    static State* state = new State;
+    return *state;
+}
+
+struct ThreadState {
+    UInt64 generation = 0;
+    Int64 bytes_until_sample = 0;
+    std::minstd_rand rng;
+};
+
+thread_local ThreadState thread_state;
+
+Shard& getShard(State& state, const void* buf) {
+    UInt64 hash = (reinterpret_cast<uintptr_t>(buf) >> 4) * 0x9E3779B97F4A7C15ULL;
+    return state.shards[hash >> 60];
+}
+
+Int64 nextSampleDistance(ThreadState& thread, size_t sample_interval) {
+    std::exponential_distribution<double> distribution(1.0 / sample_interval);
+    return Int64(distribution(thread.rng)) + 1;
+}
+
+/** An allocation which counts c bytes towards sampling is sampled with the probability
+  * 1 - exp(-c / interval). Dividing the size by it gives an unbiased estimation.
+  */
+UInt64 estimateBytes(size_t size, size_t counted_size, size_t sample_interval) {
+    double probability = -std::expm1(-double(counted_size) / sample_interval);
+    return probability > 0 ? UInt64(size / probability) : size;
+}
+
+void addLiveSampleToSite(const Sample& sample) {
+    sample.site->live_samples.fetch_add(1, std::memory_order_relaxed);
+    sample.site->live_sampled_bytes.fetch_add(sample.size, std::memory_order_relaxed);
+    sample.site->live_estimated_bytes.fetch_add(sample.estimated_bytes,
+                                                std::memory_order_relaxed);
+}
+
+void forgetLiveSample(const Sample& sample) {
+    sample.site->live_samples.fetch_sub(1, std::memory_order_relaxed);
+    sample.site->live_sampled_bytes.fetch_sub(sample.size, std::memory_order_relaxed);
+    sample.site->live_estimated_bytes.fetch_sub(sample.estimated_bytes,
+                                                std::memory_order_relaxed);
+}
+
+/// Must be called under the lock of state.
+void addLiveSample(State& state, const void* buf, const Sample& sample,
+                   std::atomic<UInt64>& live_samples) {
+    auto& shard = getShard(state, buf);
+    std::lock_guard shard_lock(shard.mutex);
+    auto [it, inserted] = shard.samples.emplace(buf, sample);
+    if (inserted) {
+        live_samples.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        /// The free of the previous buffer at this address was not seen.
+        forgetLiveSample(it->second);
+        it->second = sample;
+    }
+}
+
+/// Must be called under the lock of state.
+void clear(State& state, std::atomic<UInt64>& live_samples) {
+    for (auto& shard : state.shards) {
+        std::lock_guard lock(shard.mutex);
+        shard.samples.clear();
+    }
+    live_samples.store(0, std::memory_order_relaxed);
+    state.sites.clear();
+}
+
+} // namespace
+
+void AllocationProfiler::start(size_t sample_interval) {
+    auto& state = getState();
+    std::lock_guard lock(state.mutex);
+    clear(state, live_samples);
+    state.sample_interval.store(std::max<size_t>(sample_interval, 1), std::memory_order_relaxed);
+    state.generation.fetch_add(1, std::memory_order_release);
+    running.store(true, std::memory_order_relaxed);
+}
+
+void AllocationProfiler::stop() {
+    auto& state = getState();
+    std::lock_guard lock(state.mutex);
+    running.store(false, std::memory_order_relaxed);
+    clear(state, live_samples);
+}
+
+void AllocationProfiler::onAllocImpl(const void* buf, size_t size, size_t counted_size) {
+    auto& state = getState();
+    auto& thread = thread_state;
+    size_t sample_interval = state.sample_interval.load(std::memory_order_relaxed);
+
+    UInt64 generation = state.generation.load(std::memory_order_acquire);
+    if (thread.generation != generation) {
+        thread.generation = generation;
+        thread.rng.seed(std::hash<std::thread::id>()(std::this_thread::get_id()) + generation);
+        thread.bytes_until_sample = nextSampleDistance(thread, sample_interval);
+    }
+
+    thread.bytes_until_sample -= Int64(counted_size);
+    if (LIKELY(thread.bytes_until_sample > 0)) return;
+    thread.bytes_until_sample = nextSampleDistance(thread, sample_interval);
+
+    /// Taken before the lock, it is the most expensive part.
+    boost::stacktrace::stacktrace stack(SKIP_FRAMES, MAX_STACK_DEPTH);
+
+    std::lock_guard lock(state.mutex);
+    /// Stopped or restarted in the meantime.
+    if (!isRunning() || state.generation.load(std::memory_order_relaxed) != generation) return;
+
+    auto& site = state.sites[stack];
+    if (!site) site = std::make_unique<Site>(stack);
+
+    Sample sample{size, estimateBytes(size, counted_size, sample_interval), site.get()};
+    site->total_samples.fetch_add(1, std::memory_order_relaxed);
+    site->total_sampled_bytes.fetch_add(size, std::memory_order_relaxed);
+    addLiveSampleToSite(sample);
+
+    addLiveSample(state, buf, sample, live_samples);
+}
+
+void AllocationProfiler::onFreeImpl(const void* buf) {
+    auto& shard = getShard(getState(), buf);
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.samples.find(buf);
+    if (it == shard.samples.end()) return;
+
+    forgetLiveSample(it->second);
+    shard.samples.erase(it);
+    live_samples.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AllocationProfiler::ReallocSample AllocationProfiler::takeSample(const void* buf) {
+    auto& state = getState();
+    auto& shard = getShard(state, buf);
+    std::lock_guard lock(shard.mutex);
+    auto it = shard.samples.find(buf);
+    if (it == shard.samples.end()) return {};
+
+    /// start() and stop() clear the shards before the sites, so while the sample is here
+    /// its site is alive and the generation is the one it was sampled in.
+    ReallocSample res {it->second.site, it->second.estimated_bytes,
+                       state.generation.load(std::memory_order_relaxed)};
+    forgetLiveSample(it->second);
+    shard.samples.erase(it);
+    live_samples.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+}
+
+void AllocationProfiler::putSample(const void* buf, size_t old_size, size_t new_size,
+                                   const ReallocSample& sample) {
+    auto& state = getState();
+    std::lock_guard lock(state.mutex);
+    /// The site is destroyed if the profiler was stopped or restarted in the meantime.
+    if (!isRunning() || state.generation.load(std::memory_order_relaxed) != sample.generation)
+        return;
+
+    /// The buffer keeps the weight it was sampled with, scaled to its new size.
+    Sample moved {new_size,
+                  old_size ? UInt64(double(sample.estimated_bytes) * new_size / old_size)
+                           : new_size,
+                  static_cast<Site*>(sample.site)};
+    addLiveSampleToSite(moved);
+    addLiveSample(state, buf, moved, live_samples);
+}
+
+std::vector<AllocationProfiler::CallSite> AllocationProfiler::getCallSites() {
+    std::vector<CallSite> res;
+    {
+        auto& state = getState();
+        std::lock_guard lock(state.mutex);
+        for (const auto& [stack, site] : state.sites) {
+            CallSite call_site;
+            for (const auto& frame : stack) call_site.stack.push_back(frame.address());
+            call_site.live_samples = site->live_samples.load(std::memory_order_relaxed);
+            call_site.live_sampled_bytes = site->live_sampled_bytes.load(std::memory_order_relaxed);
+            call_site.live_estimated_bytes =
+                    site->live_estimated_bytes.load(std::memory_order_relaxed);
+            call_site.total_samples = site->total_samples.load(std::memory_order_relaxed);
+            call_site.total_sampled_bytes =
+                    site->total_sampled_bytes.load(std::memory_order_relaxed);
+            res.push_back(std::move(call_site));
+        }
+    }
+    std::stable_sort(res.begin(), res.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.live_estimated_bytes > rhs.live_estimated_bytes;
+    });
+    return res;
+}
+
+String AllocationProfiler::dumpHeapProfile() {
+    auto call_sites = getCallSites();
+    UInt64 live_samples_sum = 0;
+    UInt64 live_bytes_sum = 0;
+    UInt64 total_samples_sum = 0;
+    UInt64 total_bytes_sum = 0;
+    for (const auto& call_site : call_sites) {
+        live_samples_sum += call_site.live_samples;
+        live_bytes_sum += call_site.live_sampled_bytes;
+        total_samples_sum += call_site.total_samples;
+        total_bytes_sum += call_site.total_sampled_bytes;
+    }
+
+    /// pprof scales sampled values back itself, knowing the interval from the header.
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "heap profile: {}: {} [{}: {}] @ heap_v2/{}\n",
+                   live_samples_sum, live_bytes_sum, total_samples_sum, total_bytes_sum,
+                   getState().sample_interval.load(std::memory_order_relaxed));
+    for (const auto& call_site : call_sites) {
+        fmt::format_to(std::back_inserter(out), "{}: {} [{}: {}] @", call_site.live_samples,
+                       call_site.live_sampled_bytes, call_site.total_samples,
+                       call_site.total_sampled_bytes);
+        for (const void* address : call_site.stack)
+            fmt::format_to(std::back_inserter(out), " {}", address);
+        out.push_back('\n');
+    }
+
+    fmt::format_to(std::back_inserter(out), "\nMAPPED_LIBRARIES:\n");
+    std::ifstream maps("/proc/self/maps");
+    std::stringstream maps_content;
+    maps_content << maps.rdbuf();
+    fmt::format_to(std::back_inserter(out), "{}", maps_content.str());
+    return fmt::to_string(out);
+}
+
+String AllocationProfiler::toString(size_t max_call_sites) {
+    auto call_sites = getCallSites();
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "Allocation profile, sample interval {} bytes\n",
+                   getState().sample_interval.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < std::min(max_call_sites, call_sites.size()); ++i) {
+        const auto& call_site = call_sites[i];
+        fmt::format_to(std::back_inserter(out),
+                       "#{}: ~{} bytes live in {} samples, {} samples of {} bytes in total\n",
+                       i + 1, call_site.live_estimated_bytes, call_site.live_samples,
+                       call_site.total_samples, call_site.total_sampled_bytes);
+        for (const void* address : call_site.stack)
+            fmt::format_to(std::back_inserter(out), "    {}\n",
+                           boost::stacktrace::to_string(boost::stacktrace::frame(address)));
+    }
+    return fmt::to_string(out);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+/** Sampling profiler of memory allocated through Allocator (PODArray, hash tables, Arena).
+  *
+  * While it is running, on average one allocation per sample_interval allocated bytes
+  * is sampled (the distance between samples is exponentially distributed, so that
+  * allocations of any size pattern are sampled fairly). A sampled allocation stores its
+  * stack trace and stays a live sample until it is freed. Samples are aggregated by
+  * call site, i.e. by the stack trace.
+  *
+  * When the profiler is stopped, Allocator pays one relaxed atomic load per alloc, realloc
+  * and free. When it is running, not sampled allocations only decrement a thread-local
+  * counter, and free looks up the pointer among live samples.
+  *
+  * Usage:
+  *     AllocationProfiler::start();
+  *     ...
+  *     std::ofstream("/tmp/query.heap") << AllocationProfiler::dumpHeapProfile();
+  *     AllocationProfiler::stop();
+  * and then `pprof --text <binary> /tmp/query.heap`.
+  */
+class AllocationProfiler {
+public:
+    static constexpr size_t DEFAULT_SAMPLE_INTERVAL = 1 << 20;
+
+    /// Forgets the samples taken before.
+    static void start(size_t sample_interval = DEFAULT_SAMPLE_INTERVAL);
+    /// Forgets all samples.
+    static void stop();
+    static bool isRunning() { return running.load(std::memory_order_relaxed); }
+
+    static void onAlloc(const void* buf, size_t size) {
+        if (UNLIKELY(isRunning())) onAllocImpl(buf, size);
+    }
+
+    /// Must be called before the memory is freed: its address may be reused right after.
+    static void onFree(const void* buf) {
+        if (UNLIKELY(live_samples.load(std::memory_order_relaxed) != 0)) onFreeImpl(buf);
+    }
+
+    /// What onReallocBegin() took from the buffer being reallocated, opaque for Allocator.
+    struct ReallocSample {
+        void* site = nullptr;
+        UInt64 estimated_bytes = 0;
+        UInt64 generation = 0;
+    };
+
+    /** Realloc is seen as the free of the old buffer before it and the allocation of the new
+      * one after it. A sampled buffer stays sampled with its new size and call site whether
+      * it grows or shrinks. A not sampled buffer is sampled only by its growth.
+      */
+    static ReallocSample onReallocBegin(const void* buf) {
+        if (UNLIKELY(live_samples.load(std::memory_order_relaxed) != 0)) return takeSample(buf);
+        return {};
+    }
+
+    static void onRealloc(const void* new_buf, size_t old_size, size_t new_size,
+                          const ReallocSample& sample) {
+        if (UNLIKELY(sample.site != nullptr))
+            putSample(new_buf, old_size, new_size, sample);
+        else if (UNLIKELY(isRunning()) && new_size > old_size)
+            onAllocImpl(new_buf, new_size, new_size - old_size);
+    }
+
+    struct CallSite {
+        /// Return addresses, the innermost first. Symbolized by toString().
+        std::vector<const void*> stack;
+        /// Sampled allocations that are not freed yet.
+        UInt64 live_samples = 0;
+        UInt64 live_sampled_bytes = 0;
+        /// Estimation of the memory allocated at this site that is not freed yet.
+        UInt64 live_estimated_bytes = 0;
+        /// All sampled allocations since start().
+        UInt64 total_samples = 0;
+        UInt64 total_sampled_bytes = 0;
+    };
+
+    /// Sorted by live_estimated_bytes, the largest first.
+    static std::vector<CallSite> getCallSites();
+
+    /// Live and total samples in the legacy heap profile format of gperftools,
+    /// readable by pprof, with the mappings of the process for symbolization.
+    static String dumpHeapProfile();
+
+    /// The top call sites by the estimation of live memory, with symbolized stack traces.
+    static String toString(size_t max_call_sites = 10);
+
+private:
+    static void onAllocImpl(const void* buf, size_t size) { onAllocImpl(buf, size, size); }
+    static void onAllocImpl(const void* buf, size_t size, size_t counted_size);
+    static void onFreeImpl(const void* buf);
+    static ReallocSample takeSample(const void* buf);
+    static void putSample(const void* buf, size_t old_size, size_t new_size,
+                          const ReallocSample& sample);
+
+    inline static std::atomic<bool> running{false};
+    inline static std::atomic<UInt64> live_samples{0};
+};
+
+} // namespace doris::vectorized
@@ -50,7 +50,8 @@
 #endif
 #include "vec/common/mremap.h"
 
-// #include <vec/Common/MemoryTracker.h>
+#include "vec/common/allocation_profiler.h"
+#include "vec/common/memory_tracker.h"
 #include "vec/common/exception.h"
 // #include <vec/Common/formatReadable.h>
 
@@ -112,14 +113,17 @@ class Allocator {
 public:
     /// Allocate memory range.
     void* alloc(size_t size, size_t alignment = 0) {
-        // CurrentMemoryTracker::alloc(size);
-        return allocNoTrack(size, alignment);
+        doris::vectorized::CurrentMemoryTracker::alloc(size);
+        void* buf = allocNoTrack(size, alignment);
+        doris::vectorized::AllocationProfiler::onAlloc(buf, size);
+        return buf;
     }
 
     /// Free memory range.
     void free(void* buf, size_t size) {
+        doris::vectorized::AllocationProfiler::onFree(buf);
         freeNoTrack(buf, size);
-        // CurrentMemoryTracker::free(size);
+        doris::vectorized::CurrentMemoryTracker::free(size);
     }
 
     /** Enlarge memory range.
@@ -127,13 +131,17 @@ public:
       * Address of memory range could change.
       */
     void* realloc(void* buf, size_t old_size, size_t new_size, size_t alignment = 0) {
+        doris::vectorized::AllocationProfiler::ReallocSample sample;
+        if (old_size != new_size)
+            sample = doris::vectorized::AllocationProfiler::onReallocBegin(buf);
+
         if (old_size == new_size) {
             /// nothing to do.
             /// BTW, it's not possible to change alignment while doing realloc.
         } else if (old_size < MMAP_THRESHOLD && new_size < MMAP_THRESHOLD &&
                    alignment <= MALLOC_MIN_ALIGNMENT) {
             /// Resize malloc'd memory region with no special alignment requirement.
-            // CurrentMemoryTracker::realloc(old_size, new_size);
+            doris::vectorized::CurrentMemoryTracker::realloc(old_size, new_size);
 
             void* new_buf = ::realloc(buf, new_size);
             if (nullptr == new_buf)
@@ -148,7 +156,7 @@ public:
                     memset(reinterpret_cast<char*>(buf) + old_size, 0, new_size - old_size);
         } else if (old_size >= MMAP_THRESHOLD && new_size >= MMAP_THRESHOLD) {
             /// Resize mmap'd memory region.
-            // CurrentMemoryTracker::realloc(old_size, new_size);
+            doris::vectorized::CurrentMemoryTracker::realloc(old_size, new_size);
 
             // On apple and freebsd self-implemented mremap used (common/mremap.h)
             buf = clickhouse_mremap(buf, old_size, new_size, MREMAP_MAYMOVE, PROT_READ | PROT_WRITE,
@@ -162,21 +170,23 @@ public:
             /// No need for zero-fill, because mmap guarantees it.
         } else if (new_size < MMAP_THRESHOLD) {
             /// Small allocs that requires a copy. Assume there's enough memory in system. Call CurrentMemoryTracker once.
-            // CurrentMemoryTracker::realloc(old_size, new_size);
+            doris::vectorized::CurrentMemoryTracker::realloc(old_size, new_size);
 
             void* new_buf = allocNoTrack(new_size, alignment);
             memcpy(new_buf, buf, std::min(old_size, new_size));
             freeNoTrack(buf, old_size);
             buf = new_buf;
         } else {
-            /// Big allocs that requires a copy. MemoryTracker is called inside 'alloc', 'free' methods.
+            /// Big allocs that requires a copy.
+            doris::vectorized::CurrentMemoryTracker::realloc(old_size, new_size);
 
-            void* new_buf = alloc(new_size, alignment);
+            void* new_buf = allocNoTrack(new_size, alignment);
             memcpy(new_buf, buf, std::min(old_size, new_size));
-            free(buf, old_size);
+            freeNoTrack(buf, old_size);
             buf = new_buf;
         }
 
+        doris::vectorized::AllocationProfiler::onRealloc(buf, old_size, new_size, sample);
         return buf;
     }
 
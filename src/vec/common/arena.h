@@ -30,6 +30,7 @@
 #include "vec/core/defines.h"
 //#include <vec/Common/ProfileEvents.h>
 #include "vec/common/allocator.h"
+#include "vec/common/query_trace.h"
 
 //namespace ProfileEvents
 //{
@@ -124,7 +125,9 @@ private:
 
     /// Add next contiguous chunk of memory with size not less than specified.
     void NO_INLINE addChunk(size_t min_size) {
+        TraceScope trace_scope("Arena::addChunk");
         head = new Chunk(nextSize(min_size + pad_right), head);
+        trace_scope.setValue(head->size());
         size_in_bytes += head->size();
     }
 
@@ -0,0 +1,67 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/common/arena.h"
+
+namespace doris::vectorized {
+
+/** Allocator for PODArray, that takes the memory from the Arena passed to every allocating call,
+  *  e.g. array.push_back(x, arena). It is used by the states of aggregate functions.
+  * The memory is freed together with the Arena. If the array is the last allocation in the Arena,
+  *  it grows in place, otherwise the old memory is wasted.
+  */
+class ArenaAllocator {
+public:
+    static void* alloc(size_t size, Arena* arena) { return arena->alloc(size); }
+
+    static void* realloc(void* buf, size_t old_size, size_t new_size, Arena* arena) {
+        const char* data = reinterpret_cast<const char*>(buf);
+        if (data && data + old_size == arena->head->pos) {
+            arena->allocContinue(new_size - old_size, data);
+            return const_cast<char*>(data);
+        }
+        return arena->realloc(data, old_size, new_size);
+    }
+
+    static void free(void*, size_t) {}
+
+    static constexpr size_t getStackThreshold() { return 0; }
+};
+
+/// The same as ArenaAllocator, but the memory is aligned.
+template <size_t alignment>
+class AlignedArenaAllocator {
+public:
+    static void* alloc(size_t size, Arena* arena) { return arena->alignedAlloc(size, alignment); }
+
+    static void* realloc(void* buf, size_t old_size, size_t new_size, Arena* arena) {
+        const char* data = reinterpret_cast<const char*>(buf);
+        if (data && data + old_size == arena->head->pos) {
+            arena->allocContinue(new_size - old_size, data, alignment);
+            return const_cast<char*>(data);
+        }
+        return arena->alignedRealloc(data, old_size, new_size, alignment);
+    }
+
+    static void free(void*, size_t) {}
+
+    static constexpr size_t getStackThreshold() { return 0; }
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,54 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/field_visitors.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int CANNOT_PARSE_UUID;
+}
+
+/// The text form is xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, the first half goes to high.
+UInt128 stringToUUID(const String& str) {
+    UInt64 halves[2] = {0, 0};
+    size_t digits = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        char c = str[i];
+        if (c == '-' && (i == 8 || i == 13 || i == 18 || i == 23)) continue;
+
+        UInt64 value;
+        if (c >= '0' && c <= '9')
+            value = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            value = c - 'A' + 10;
+        else
+            break;
+
+        if (digits == 32) break;
+        halves[digits / 16] = (halves[digits / 16] << 4) | value;
+        ++digits;
+    }
+
+    if (digits != 32 || str.size() != 36)
+        throw Exception("Cannot parse UUID from " + str, ErrorCodes::CANNOT_PARSE_UUID);
+    return UInt128(halves[1], halves[0]);
+}
+
+} // namespace doris::vectorized
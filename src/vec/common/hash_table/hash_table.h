@@ -13,6 +13,7 @@
 #include <vec/core/defines.h>
 #include <vec/core/types.h>
 #include <vec/common/exception.h>
+#include <vec/common/query_trace.h>
 
 // #include <IO/WriteBuffer.h>
 // #include <IO/WriteHelpers.h>
@@ -421,6 +422,7 @@ protected:
 #ifdef DBMS_HASH_MAP_DEBUG_RESIZES
         Stopwatch watch;
 #endif
+        doris::vectorized::TraceScope trace_scope("HashTable::resize");
 
         size_t old_size = grower.bufSize();
 
@@ -446,6 +448,8 @@ protected:
         else
             new_grower.increaseSize();
 
+        trace_scope.setValue(new_grower.bufSize());
+
         /// Expand the space.
         buf = reinterpret_cast<Cell *>(Allocator::realloc(buf, getBufferSizeInBytes(), new_grower.bufSize() * sizeof(Cell)));
         grower = new_grower;
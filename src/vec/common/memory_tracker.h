@@ -0,0 +1,79 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+/** Accounting of memory allocated by the current thread through Allocator.
+  * Unlike MemoryTracker in ClickHouse there are no limits and no hierarchy,
+  * only two thread-local counters, so it is cheap enough to be always on.
+  * Profilers take differences of allocatedBytes() around the code they measure.
+  */
+namespace CurrentMemoryTracker {
+
+struct ThreadCounters {
+    /// Total number of bytes ever allocated by this thread.
+    UInt64 allocated = 0;
+    /// Total number of bytes ever freed by this thread (maybe allocated by another thread).
+    UInt64 freed = 0;
+    /// The maximum of allocated - freed since the last resetPeak().
+    Int64 peak = 0;
+};
+
+inline thread_local ThreadCounters thread_counters;
+
+inline void alloc(size_t size) {
+    thread_counters.allocated += size;
+    Int64 current = Int64(thread_counters.allocated) - Int64(thread_counters.freed);
+    if (current > thread_counters.peak) thread_counters.peak = current;
+}
+
+inline void free(size_t size) {
+    thread_counters.freed += size;
+}
+
+inline void realloc(size_t old_size, size_t new_size) {
+    if (new_size > old_size)
+        alloc(new_size - old_size);
+    else
+        free(old_size - new_size);
+}
+
+inline UInt64 allocatedBytes() {
+    return thread_counters.allocated;
+}
+
+inline Int64 currentBytes() {
+    return Int64(thread_counters.allocated) - Int64(thread_counters.freed);
+}
+
+/// Starts a new measurement of peakBytes() from the current amount of memory.
+inline void resetPeak() {
+    thread_counters.peak = currentBytes();
+}
+
+/// Compare with currentBytes() taken right after resetPeak() to get the peak of a piece of code.
+inline Int64 peakBytes() {
+    return thread_counters.peak;
+}
+
+} // namespace CurrentMemoryTracker
+
+} // namespace doris::vectorized
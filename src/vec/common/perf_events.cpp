@@ -0,0 +1,172 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/perf_events.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <iterator>
+
+namespace doris::vectorized {
+
+PerfEventValues PerfEventValues::operator-(const PerfEventValues& rhs) const {
+    PerfEventValues res;
+    res.cycles = cycles - rhs.cycles;
+    res.instructions = instructions - rhs.instructions;
+    res.llc_misses = llc_misses - rhs.llc_misses;
+    res.branch_misses = branch_misses - rhs.branch_misses;
+    res.dtlb_misses = dtlb_misses - rhs.dtlb_misses;
+    return res;
+}
+
+#if defined(__linux__)
+
+namespace {
+
+struct EventDescription {
+    UInt32 type;
+    UInt64 config;
+};
+
+constexpr UInt64 cacheMissEvent(UInt64 cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+/// In the order of fields of PerfEventValues. The first one is the group leader.
+constexpr EventDescription events[] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, cacheMissEvent(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, cacheMissEvent(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+int openEvent(const EventDescription& event, int group_fd) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    /// Current thread on any CPU.
+    return int(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+
+PerfEvents::PerfEvents() {
+    static_assert(std::size(events) == NUMBER_OF_EVENTS);
+    for (size_t i = 0; i < NUMBER_OF_EVENTS; ++i) {
+        fds[i] = -1;
+        positions[i] = -1;
+    }
+
+    leader_fd = openEvent(events[0], -1);
+    if (leader_fd == -1) return;
+    fds[0] = leader_fd;
+    positions[0] = opened_events++;
+
+    for (size_t i = 1; i < NUMBER_OF_EVENTS; ++i) {
+        fds[i] = openEvent(events[i], leader_fd);
+        if (fds[i] != -1) positions[i] = opened_events++;
+    }
+}
+
+PerfEvents::~PerfEvents() {
+    for (int fd : fds)
+        if (fd != -1) close(fd);
+}
+
+PerfEventValues PerfEvents::read() const {
+    PerfEventValues res;
+    if (leader_fd == -1) return res;
+
+    /// With PERF_FORMAT_GROUP: the number of events and then the values in order of opening.
+    UInt64 data[1 + NUMBER_OF_EVENTS];
+    ssize_t bytes = ::read(leader_fd, data, sizeof(data));
+    if (bytes < ssize_t(sizeof(UInt64)) || data[0] != opened_events) return res;
+
+    auto value = [&](size_t event) {
+        return positions[event] == -1 ? 0 : data[1 + positions[event]];
+    };
+    res.cycles = value(0);
+    res.instructions = value(1);
+    res.llc_misses = value(2);
+    res.branch_misses = value(3);
+    res.dtlb_misses = value(4);
+    return res;
+}
+
+#else
+
+PerfEvents::PerfEvents() {
+    for (size_t i = 0; i < NUMBER_OF_EVENTS; ++i) {
+        fds[i] = -1;
+        positions[i] = -1;
+    }
+}
+
+PerfEvents::~PerfEvents() = default;
+
+PerfEventValues PerfEvents::read() const {
+    return {};
+}
+
+#endif
+
+PerfEvents& PerfEvents::threadInstance() {
+    static thread_local PerfEvents instance;
+    return instance;
+}
+
+thread_local ProfileCounters* PerfEventsScope::measured_counters = nullptr;
+
+void PerfEventsScope::start() {
+    auto& perf_events = PerfEvents::threadInstance();
+    if (!perf_events.isAvailable()) return;
+
+    auto* target = &QueryProfile::current()->currentParent()->counters;
+    if (target == measured_counters) return;
+
+    counters = target;
+    previous_measured_counters = measured_counters;
+    measured_counters = counters;
+    start_values = perf_events.read();
+}
+
+void PerfEventsScope::finish() {
+    measured_counters = previous_measured_counters;
+    auto end_values = PerfEvents::threadInstance().read();
+    /// Reading failed.
+    if (end_values.cycles < start_values.cycles) return;
+
+    auto diff = end_values - start_values;
+    ProfileCounters::add(counters->cycles, diff.cycles);
+    ProfileCounters::add(counters->instructions, diff.instructions);
+    ProfileCounters::add(counters->llc_misses, diff.llc_misses);
+    ProfileCounters::add(counters->branch_misses, diff.branch_misses);
+    ProfileCounters::add(counters->dtlb_misses, diff.dtlb_misses);
+}
+
+} // namespace doris::vectorized
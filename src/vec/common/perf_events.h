@@ -0,0 +1,98 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include "vec/common/query_profile.h"
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+/// Values of hardware counters. Zero if the event is not available.
+struct PerfEventValues {
+    UInt64 cycles = 0;
+    UInt64 instructions = 0;
+    UInt64 llc_misses = 0;
+    UInt64 branch_misses = 0;
+    UInt64 dtlb_misses = 0;
+
+    PerfEventValues operator-(const PerfEventValues& rhs) const;
+};
+
+/** Hardware performance counters of the current thread, read through perf_event_open(2).
+  *
+  * Events are opened once per thread as a group, on the first use, counting user space only,
+  * so that no privileges are needed with the default kernel.perf_event_paranoid.
+  * If perf events are not available (not Linux, perf_event_paranoid = 3, seccomp in
+  * containers, no PMU in a VM), everything still works and all values are zero.
+  * Individual events which are not supported by the CPU are zero as well.
+  */
+class PerfEvents : private boost::noncopyable {
+public:
+    static PerfEvents& threadInstance();
+
+    bool isAvailable() const { return leader_fd != -1; }
+
+    /// Current values of the counters of this thread. All zeros if not available.
+    PerfEventValues read() const;
+
+    ~PerfEvents();
+
+private:
+    PerfEvents();
+
+    static constexpr size_t NUMBER_OF_EVENTS = 5;
+
+    int leader_fd = -1;
+    int fds[NUMBER_OF_EVENTS];
+    /// Position of the event in the data returned by read() of the group, -1 if not opened.
+    int positions[NUMBER_OF_EVENTS];
+    size_t opened_events = 0;
+};
+
+/** Measures hardware counters of the code in its scope and adds them to counters of
+  * the innermost operator (or function) in QueryProfile. Place it around hot kernels:
+  * hash table probes, filters, sorts, aggregation.
+  * Does nothing (except the check of QueryProfile::current()) if profiling is disabled.
+  * A scope nested into another one of the same node does nothing too, so counters are
+  * not added twice.
+  */
+class PerfEventsScope : private boost::noncopyable {
+public:
+    PerfEventsScope() {
+        if (UNLIKELY(QueryProfile::current() != nullptr)) start();
+    }
+
+    ~PerfEventsScope() {
+        if (UNLIKELY(counters != nullptr)) finish();
+    }
+
+private:
+    void start();
+    void finish();
+
+    /// Counters measured by the outermost scope of this thread.
+    static thread_local ProfileCounters* measured_counters;
+
+    ProfileCounters* counters = nullptr;
+    ProfileCounters* previous_measured_counters = nullptr;
+    PerfEventValues start_values;
+};
+
+} // namespace doris::vectorized
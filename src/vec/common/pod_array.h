@@ -237,6 +237,45 @@ public:
         c_end += byte_size(1);
     }
 
+    /** Makes the empty array use memory that it does not own, e.g. a mapped file.
+      * pad_left bytes before begin and pad_right bytes after end must be readable, and
+      * the -1th element must be zero if it is used.
+      * The array does not know that the memory is borrowed and would write to and free it,
+      * so the owner of the array must call unborrow() before changing the array and
+      * releaseBorrowed() before destroying it.
+      */
+    void borrow(const char* begin, const char* end) {
+        assert(empty());
+        dealloc();
+        c_start = const_cast<char*>(begin);
+        c_end = c_end_of_storage = const_cast<char*>(end);
+    }
+
+    /// Copies the borrowed elements into own memory.
+    void unborrow() {
+        const char* begin = c_start;
+        size_t bytes = c_end - c_start;
+        releaseBorrowed();
+        alloc_for_num_elements(bytes / ELEMENT_SIZE);
+        memcpy(c_start, begin, bytes);
+        c_end = c_start + bytes;
+    }
+
+    /// Forgets the borrowed memory, the array becomes empty.
+    void releaseBorrowed() { c_start = c_end = c_end_of_storage = null; }
+
+    /// Gives the memory to the empty array `to`, e.g. to keep it alive for the readers of it
+    /// while this array goes on with a copy. This array becomes empty.
+    void moveMemoryTo(PODArrayBase& to) {
+        static_assert(TAllocator::getStackThreshold() == 0, "The memory must not be inline");
+        assert(to.c_start == null);
+        unprotect();
+        to.c_start = c_start;
+        to.c_end = c_end;
+        to.c_end_of_storage = c_end_of_storage;
+        releaseBorrowed();
+    }
+
     void protect() {
 #ifndef NDEBUG
         protectImpl(PROT_READ);
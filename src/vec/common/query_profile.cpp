@@ -0,0 +1,205 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/query_profile.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "vec/common/memory_tracker.h"
+
+namespace doris::vectorized {
+
+namespace {
+std::atomic<UInt64> next_profile_id{1};
+}
+
+QueryProfile::QueryProfile(String name_)
+        : id(next_profile_id.fetch_add(1, std::memory_order_relaxed)),
+          root(std::move(name_), nullptr) {}
+
+QueryProfile::~QueryProfile() {
+    ProfileNode* node = nodes.load();
+    while (node) {
+        ProfileNode* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+ProfileNode* QueryProfile::registerNode(String name, ProfileNode* parent) {
+    auto* node = new ProfileNode(std::move(name), parent);
+    node->next = nodes.load(std::memory_order_relaxed);
+    while (!nodes.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                        std::memory_order_relaxed))
+        ;
+    return node;
+}
+
+QueryProfile::Scope::Scope(QueryProfile& profile)
+        : previous_profile(current_profile), previous_parent(current_parent) {
+    current_profile = &profile;
+    current_parent = nullptr;
+}
+
+QueryProfile::Scope::~Scope() {
+    current_profile = previous_profile;
+    current_parent = previous_parent;
+}
+
+ProfileNode* ProfileNodeHandle::get(QueryProfile& profile, const String& name) {
+    if (profile_id != profile.getId()) {
+        node = profile.registerNode(name, profile.currentParent());
+        profile_id = profile.getId();
+    }
+    return node;
+}
+
+QueryProfile::OperatorScope::OperatorScope(ProfileNodeHandle& handle, const String& name,
+                                           size_t rows_in) {
+    auto* profile = current_profile;
+    if (LIKELY(!profile)) return;
+
+    node = handle.get(*profile, name);
+    ProfileCounters::add(node->counters.calls, 1);
+    ProfileCounters::add(node->counters.rows_in, rows_in);
+    node_scope.emplace(node);
+    allocated_before = CurrentMemoryTracker::allocatedBytes();
+    start_ns = clockMonotonicNanoseconds();
+}
+
+QueryProfile::OperatorScope::~OperatorScope() {
+    if (LIKELY(!node)) return;
+
+    ProfileCounters::add(node->counters.nanoseconds, clockMonotonicNanoseconds() - start_ns);
+    ProfileCounters::add(node->counters.allocated_bytes,
+                         CurrentMemoryTracker::allocatedBytes() - allocated_before);
+    ProfileCounters::add(node->counters.rows_out, rows_out);
+}
+
+namespace {
+
+using Children = std::unordered_map<const ProfileNode*, std::vector<const ProfileNode*>>;
+
+void fillSnapshot(QueryProfile::Snapshot& res, const std::vector<const ProfileNode*>& same_nodes,
+                  const Children& children) {
+    res.name = same_nodes.front()->name;
+    std::vector<const ProfileNode*> all_children;
+    for (const auto* node : same_nodes) {
+        const auto& counters = node->counters;
+        ++res.instances;
+        res.calls += counters.calls.load(std::memory_order_relaxed);
+        res.rows_in += counters.rows_in.load(std::memory_order_relaxed);
+        res.rows_out += counters.rows_out.load(std::memory_order_relaxed);
+        res.nanoseconds += counters.nanoseconds.load(std::memory_order_relaxed);
+        res.allocated_bytes += counters.allocated_bytes.load(std::memory_order_relaxed);
+        res.const_default_rows += counters.const_default_rows.load(std::memory_order_relaxed);
+        res.null_default_rows += counters.null_default_rows.load(std::memory_order_relaxed);
+        res.sparse_default_rows += counters.sparse_default_rows.load(std::memory_order_relaxed);
+        res.rle_default_rows += counters.rle_default_rows.load(std::memory_order_relaxed);
+        res.cycles += counters.cycles.load(std::memory_order_relaxed);
+        res.instructions += counters.instructions.load(std::memory_order_relaxed);
+        res.llc_misses += counters.llc_misses.load(std::memory_order_relaxed);
+        res.branch_misses += counters.branch_misses.load(std::memory_order_relaxed);
+        res.dtlb_misses += counters.dtlb_misses.load(std::memory_order_relaxed);
+
+        if (auto it = children.find(node); it != children.end())
+            all_children.insert(all_children.end(), it->second.begin(), it->second.end());
+    }
+
+    /// Group children by name, keeping the order of their registration.
+    std::vector<std::vector<const ProfileNode*>> groups;
+    std::unordered_map<String, size_t> group_by_name;
+    for (const auto* child : all_children) {
+        auto [it, inserted] = group_by_name.emplace(child->name, groups.size());
+        if (inserted) groups.emplace_back();
+        groups[it->second].push_back(child);
+    }
+
+    res.children.resize(groups.size());
+    for (size_t i = 0; i < groups.size(); ++i) fillSnapshot(res.children[i], groups[i], children);
+}
+
+void toStringImpl(const QueryProfile::Snapshot& snapshot, size_t depth, fmt::memory_buffer& out) {
+    fmt::format_to(std::back_inserter(out), "{:{}}{}", "", depth * 2, snapshot.name);
+    if (snapshot.instances > 1)
+        fmt::format_to(std::back_inserter(out), " (x{})", snapshot.instances);
+    fmt::format_to(std::back_inserter(out), ": {:.3f} ms", snapshot.nanoseconds / 1e6);
+    if (snapshot.calls) fmt::format_to(std::back_inserter(out), ", {} calls", snapshot.calls);
+    if (snapshot.rows_in || snapshot.rows_out)
+        fmt::format_to(std::back_inserter(out), ", rows {} -> {}", snapshot.rows_in,
+                       snapshot.rows_out);
+    fmt::format_to(std::back_inserter(out), ", allocated {} bytes", snapshot.allocated_bytes);
+    if (snapshot.const_default_rows)
+        fmt::format_to(std::back_inserter(out), ", const default rows {}",
+                       snapshot.const_default_rows);
+    if (snapshot.null_default_rows)
+        fmt::format_to(std::back_inserter(out), ", null default rows {}",
+                       snapshot.null_default_rows);
+    if (snapshot.sparse_default_rows)
+        fmt::format_to(std::back_inserter(out), ", sparse default rows {}",
+                       snapshot.sparse_default_rows);
+    if (snapshot.rle_default_rows)
+        fmt::format_to(std::back_inserter(out), ", rle default rows {}",
+                       snapshot.rle_default_rows);
+    if (snapshot.cycles)
+        fmt::format_to(std::back_inserter(out),
+                       ", cycles {}, instructions {} (IPC {:.2f}), LLC misses {}, "
+                       "branch misses {}, dTLB misses {}",
+                       snapshot.cycles, snapshot.instructions,
+                       double(snapshot.instructions) / snapshot.cycles, snapshot.llc_misses,
+                       snapshot.branch_misses, snapshot.dtlb_misses);
+    out.push_back('\n');
+
+    std::vector<const QueryProfile::Snapshot*> children;
+    for (const auto& child : snapshot.children) children.push_back(&child);
+    std::stable_sort(children.begin(), children.end(), [](const auto* lhs, const auto* rhs) {
+        return lhs->nanoseconds > rhs->nanoseconds;
+    });
+    for (const auto* child : children) toStringImpl(*child, depth + 1, out);
+}
+
+} // namespace
+
+QueryProfile::Snapshot QueryProfile::snapshot() const {
+    /// The list is only prepended to, so everything after the loaded head is immutable.
+    std::vector<const ProfileNode*> all_nodes;
+    for (const ProfileNode* node = nodes.load(std::memory_order_acquire); node; node = node->next)
+        all_nodes.push_back(node);
+    std::reverse(all_nodes.begin(), all_nodes.end());
+
+    Children children;
+    for (const auto* node : all_nodes) children[node->parent].push_back(node);
+
+    Snapshot res;
+    fillSnapshot(res, {&root}, children);
+    for (const auto& child : res.children) {
+        res.nanoseconds += child.nanoseconds;
+        res.allocated_bytes += child.allocated_bytes;
+    }
+    return res;
+}
+
+String QueryProfile::Snapshot::toString() const {
+    fmt::memory_buffer out;
+    toStringImpl(*this, 0, out);
+    return fmt::to_string(out);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,223 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <time.h>
+
+#include <atomic>
+#include <optional>
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+inline UInt64 clockMonotonicNanoseconds() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return UInt64(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+/// Counters of one profiled entity (a function instance or an operator).
+struct ProfileCounters {
+    std::atomic<UInt64> calls{0};
+    std::atomic<UInt64> rows_in{0};
+    std::atomic<UInt64> rows_out{0};
+    std::atomic<UInt64> nanoseconds{0};
+    std::atomic<UInt64> allocated_bytes{0};
+    /// Rows processed by the default implementation for constant arguments.
+    std::atomic<UInt64> const_default_rows{0};
+    /// Rows processed by the default implementation for Nullable arguments.
+    std::atomic<UInt64> null_default_rows{0};
+    /// Rows processed by the default implementation for sparse arguments.
+    std::atomic<UInt64> sparse_default_rows{0};
+    /// Rows processed by the default implementation for run-length encoded arguments.
+    std::atomic<UInt64> rle_default_rows{0};
+    /// Hardware counters, collected only by PerfEventsScope.
+    std::atomic<UInt64> cycles{0};
+    std::atomic<UInt64> instructions{0};
+    std::atomic<UInt64> llc_misses{0};
+    std::atomic<UInt64> branch_misses{0};
+    std::atomic<UInt64> dtlb_misses{0};
+
+    static void add(std::atomic<UInt64>& counter, UInt64 value) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+};
+
+/// Node of the profile tree. Nodes are owned by QueryProfile and live as long as it.
+class ProfileNode : private boost::noncopyable {
+public:
+    ProfileNode(String name_, ProfileNode* parent_) : name(std::move(name_)), parent(parent_) {}
+
+    const String name;
+    ProfileNode* const parent;
+    ProfileCounters counters;
+
+private:
+    friend class QueryProfile;
+    /// Next node in the list of all nodes of the query.
+    ProfileNode* next = nullptr;
+};
+
+class QueryProfile;
+
+/** Node of an object executed many times (a function, an operator) in the profile
+  * of the current query. The node is registered on the first execution within a query.
+  * Not thread-safe, like the objects themselves.
+  */
+class ProfileNodeHandle {
+public:
+    ProfileNode* get(QueryProfile& profile, const String& name);
+
+private:
+    ProfileNode* node = nullptr;
+    UInt64 profile_id = 0;
+};
+
+/** Opt-in execution profile of one query.
+  *
+  * Profiling is enabled for a thread while QueryProfile::Scope is alive. Every profiled
+  * object (e.g. PreparedFunctionImpl) registers its own node once per query (see
+  * ProfileNodeHandle), which is a lock-free push into the list of nodes, and then only
+  * does relaxed atomic increments,
+  * so threads executing the same query never wait for each other. Nodes of the same name
+  * under the same parent are summed up in snapshot().
+  *
+  * When profiling is disabled, the only cost for the profiled code is a check of
+  * the thread-local QueryProfile::current().
+  *
+  * Usage:
+  *     QueryProfile profile("q1");
+  *     {
+  *         QueryProfile::Scope scope(profile);
+  *         QueryProfile::OperatorScope filter(filter_node, "Filter", rows);
+  *         function->execute(block, arguments, result, rows);
+  *     }
+  *     std::cerr << profile.snapshot().toString();
+  */
+class QueryProfile : private boost::noncopyable {
+public:
+    explicit QueryProfile(String name_);
+    ~QueryProfile();
+
+    /// Profile enabled in this thread, nullptr if profiling is disabled.
+    static QueryProfile* current() { return current_profile; }
+
+    /// Counters of the function being executed in this thread, if it is profiled.
+    static ProfileCounters* currentCounters() { return current_counters; }
+
+    /// Unique during the process lifetime, unlike the address of the profile.
+    UInt64 getId() const { return id; }
+
+    /// Innermost operator or function of this thread, or the root. The parent for new nodes.
+    ProfileNode* currentParent() { return current_parent ? current_parent : &root; }
+
+    /// Thread-safe and lock-free.
+    ProfileNode* registerNode(String name, ProfileNode* parent);
+
+    /// Enables the profile in this thread.
+    class Scope : private boost::noncopyable {
+    public:
+        explicit Scope(QueryProfile& profile);
+        ~Scope();
+
+    private:
+        QueryProfile* previous_profile;
+        ProfileNode* previous_parent;
+    };
+
+    /// Makes the node the parent of nodes registered in this thread and
+    /// the owner of currentCounters(), while the scope is alive.
+    class NodeScope : private boost::noncopyable {
+    public:
+        explicit NodeScope(ProfileNode* node)
+                : previous_parent(current_parent), previous_counters(current_counters) {
+            current_parent = node;
+            current_counters = &node->counters;
+        }
+        ~NodeScope() {
+            current_parent = previous_parent;
+            current_counters = previous_counters;
+        }
+
+    private:
+        ProfileNode* previous_parent;
+        ProfileCounters* previous_counters;
+    };
+
+    /// Measures an operator, functions executed inside become its children.
+    /// Does nothing if profiling is disabled.
+    class OperatorScope : private boost::noncopyable {
+    public:
+        OperatorScope(ProfileNodeHandle& handle, const String& name, size_t rows_in);
+        ~OperatorScope();
+
+        void setRowsOut(size_t rows) { rows_out = rows; }
+
+    private:
+        ProfileNode* node = nullptr;
+        std::optional<NodeScope> node_scope;
+        UInt64 start_ns = 0;
+        UInt64 allocated_before = 0;
+        size_t rows_out = 0;
+    };
+
+    /// Values of counters at some moment, with equal nodes merged.
+    struct Snapshot {
+        String name;
+        UInt64 instances = 0;
+        UInt64 calls = 0;
+        UInt64 rows_in = 0;
+        UInt64 rows_out = 0;
+        UInt64 nanoseconds = 0;
+        UInt64 allocated_bytes = 0;
+        UInt64 const_default_rows = 0;
+        UInt64 null_default_rows = 0;
+        UInt64 sparse_default_rows = 0;
+        UInt64 rle_default_rows = 0;
+        UInt64 cycles = 0;
+        UInt64 instructions = 0;
+        UInt64 llc_misses = 0;
+        UInt64 branch_misses = 0;
+        UInt64 dtlb_misses = 0;
+        std::vector<Snapshot> children;
+
+        /// Children are sorted by time, the slowest first.
+        String toString() const;
+    };
+
+    /// Can be taken while the query is running,
+    /// though counters of one node may be inconsistent with each other.
+    Snapshot snapshot() const;
+
+private:
+    /// Defined inline with a constant initializer, so that the "profiling disabled" check in
+    /// the hot paths is a plain thread-local load, not a call of the TLS init wrapper.
+    static inline thread_local QueryProfile* current_profile = nullptr;
+    static inline thread_local ProfileNode* current_parent = nullptr;
+    static inline thread_local ProfileCounters* current_counters = nullptr;
+
+    const UInt64 id;
+    ProfileNode root;
+    std::atomic<ProfileNode*> nodes{nullptr};
+};
+
+} // namespace doris::vectorized
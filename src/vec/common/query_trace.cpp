@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/query_trace.h"
+
+#include <fmt/format.h>
+
+#include "vec/common/bit_helpers.h"
+
+namespace doris::vectorized {
+
+TraceBuffer::TraceBuffer(size_t capacity_, std::thread::id thread_id_, size_t thread_number_)
+        : thread_id(thread_id_),
+          thread_number(thread_number_),
+          events(capacity_),
+          mask(capacity_ - 1) {}
+
+std::vector<TraceEvent> TraceBuffer::getEvents() const {
+    std::vector<TraceEvent> res;
+    size_t begin = getOverwrittenEvents();
+    res.reserve(written - begin);
+    for (size_t i = begin; i < written; ++i) res.push_back(events[i & mask]);
+    return res;
+}
+
+QueryTrace::QueryTrace(String name_, size_t events_per_thread_)
+        : name(std::move(name_)),
+          events_per_thread(roundUpToPowerOfTwoOrZero(std::max<size_t>(events_per_thread_, 1))),
+          start_ns(clockMonotonicNanoseconds()) {}
+
+QueryTrace::~QueryTrace() = default;
+
+TraceBuffer* QueryTrace::getBufferOfThisThread() {
+    auto thread_id = std::this_thread::get_id();
+    std::lock_guard lock(mutex);
+    for (const auto& buffer : buffers)
+        if (buffer->thread_id == thread_id) return buffer.get();
+    buffers.push_back(
+            std::make_unique<TraceBuffer>(events_per_thread, thread_id, buffers.size() + 1));
+    return buffers.back().get();
+}
+
+QueryTrace::Scope::Scope(QueryTrace& trace)
+        : previous_trace(current_trace), previous_buffer(current_buffer) {
+    current_trace = &trace;
+    current_buffer = trace.getBufferOfThisThread();
+}
+
+QueryTrace::Scope::~Scope() {
+    current_trace = previous_trace;
+    current_buffer = previous_buffer;
+}
+
+namespace {
+
+void writeJSONString(const String& s, fmt::memory_buffer& out) {
+    out.push_back('"');
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            fmt::format_to(std::back_inserter(out), "\\u{:04x}", int(c));
+        } else {
+            out.push_back(c);
+        }
+    }
+    out.push_back('"');
+}
+
+/// Microseconds with a fractional part, the unit of timestamps in the Chrome trace format.
+double toMicroseconds(UInt64 ns) {
+    return ns / 1e3;
+}
+
+} // namespace
+
+String QueryTrace::toChromeTrace() const {
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out),
+                   "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+                   "{{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{{\"name\":");
+    writeJSONString(name, out);
+    fmt::format_to(std::back_inserter(out), "}}}}");
+
+    std::lock_guard lock(mutex);
+    for (const auto& buffer : buffers) {
+        fmt::format_to(std::back_inserter(out),
+                       ",\n{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},"
+                       "\"args\":{{\"name\":\"thread {}\",\"overwritten_events\":{}}}}}",
+                       buffer->thread_number, buffer->thread_number,
+                       buffer->getOverwrittenEvents());
+
+        for (const auto& event : buffer->getEvents()) {
+            /// Events started before the trace (e.g. enclosing the Scope) are cut.
+            UInt64 event_start_ns = std::max(event.start_ns, start_ns);
+            UInt64 event_end_ns = std::max(event.end_ns, event_start_ns);
+            fmt::format_to(std::back_inserter(out), ",\n{{\"ph\":\"X\",\"name\":");
+            writeJSONString(event.name, out);
+            fmt::format_to(std::back_inserter(out),
+                           ",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},"
+                           "\"args\":{{\"value\":{}}}}}",
+                           buffer->thread_number, toMicroseconds(event_start_ns - start_ns),
+                           toMicroseconds(event_end_ns - event_start_ns), event.value);
+        }
+    }
+    fmt::format_to(std::back_inserter(out), "\n]}}\n");
+    return fmt::to_string(out);
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,161 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/compiler_util.h"
+#include "vec/common/query_profile.h"
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+/// An interval of execution of one thread.
+struct TraceEvent {
+    /// Must live as long as the trace, normally a string literal.
+    const char* name = nullptr;
+    UInt64 start_ns = 0;
+    UInt64 end_ns = 0;
+    /// Event-specific number shown in the trace viewer: rows, bytes, cells.
+    UInt64 value = 0;
+};
+
+/** Ring buffer of the events of one thread. When it is full, the oldest events
+  * are overwritten, so a trace of a long query keeps its end.
+  * Each event holds both the begin and the end of an interval: overwriting never leaves
+  * an unmatched begin or end, and there is one write per interval.
+  * Written only by its thread, without synchronization.
+  */
+class TraceBuffer : private boost::noncopyable {
+public:
+    TraceBuffer(size_t capacity_, std::thread::id thread_id_, size_t thread_number_);
+
+    void push(const TraceEvent& event) {
+        events[written & mask] = event;
+        ++written;
+    }
+
+    const std::thread::id thread_id;
+    /// Number of the thread in the trace, starting from 1.
+    const size_t thread_number;
+
+    /// Events in order of their end, the oldest first.
+    std::vector<TraceEvent> getEvents() const;
+    size_t getOverwrittenEvents() const {
+        return written > events.size() ? written - events.size() : 0;
+    }
+
+private:
+    std::vector<TraceEvent> events;
+    const size_t mask;
+    size_t written = 0;
+};
+
+/** Timeline of execution of one query, exported in the Chrome trace format
+  * (chrome://tracing, https://ui.perfetto.dev).
+  *
+  * Tracing is enabled for a thread while QueryTrace::Scope is alive. The thread gets its
+  * own buffer in the trace (registering it is the only place that takes a lock), and then
+  * TraceScope only writes to this buffer. When tracing is disabled, the cost of
+  * TraceScope is a check of a thread-local pointer, so it can stay in hot code
+  * like HashTable::resize and Arena::addChunk.
+  *
+  * Usage:
+  *     QueryTrace trace("q1");
+  *     {
+  *         QueryTrace::Scope scope(trace);
+  *         TraceScope filter("Filter", block.rows());
+  *         ...
+  *     }
+  *     out << trace.toChromeTrace();
+  */
+class QueryTrace : private boost::noncopyable {
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 65536;
+
+    /// events_per_thread is rounded up to a power of two.
+    explicit QueryTrace(String name_, size_t events_per_thread_ = DEFAULT_EVENTS_PER_THREAD);
+    ~QueryTrace();
+
+    /// Trace enabled in this thread, nullptr if tracing is disabled.
+    static QueryTrace* current() { return current_trace; }
+
+    /// Buffer of this thread in the enabled trace, nullptr if tracing is disabled.
+    static TraceBuffer* currentBuffer() { return current_buffer; }
+
+    /// Enables the trace in this thread.
+    class Scope : private boost::noncopyable {
+    public:
+        explicit Scope(QueryTrace& trace);
+        ~Scope();
+
+    private:
+        QueryTrace* previous_trace;
+        TraceBuffer* previous_buffer;
+    };
+
+    /// JSON in the Chrome trace event format, with timestamps relative to the creation of
+    /// the trace. Must be called when no thread writes to the trace.
+    String toChromeTrace() const;
+
+private:
+    TraceBuffer* getBufferOfThisThread();
+
+    inline static thread_local QueryTrace* current_trace = nullptr;
+    inline static thread_local TraceBuffer* current_buffer = nullptr;
+
+    const String name;
+    const size_t events_per_thread;
+    const UInt64 start_ns;
+
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+};
+
+/// Adds an event for the code in its scope to the trace of the current thread, if any.
+class TraceScope : private boost::noncopyable {
+public:
+    explicit TraceScope(const char* name, UInt64 value = 0) {
+        if (UNLIKELY(QueryTrace::currentBuffer() != nullptr)) {
+            buffer = QueryTrace::currentBuffer();
+            event.name = name;
+            event.value = value;
+            event.start_ns = clockMonotonicNanoseconds();
+        }
+    }
+
+    ~TraceScope() {
+        if (UNLIKELY(buffer != nullptr)) {
+            event.end_ns = clockMonotonicNanoseconds();
+            buffer->push(event);
+        }
+    }
+
+    /// For values known only after the start, e.g. the number of output rows.
+    void setValue(UInt64 value) { event.value = value; }
+
+private:
+    TraceBuffer* buffer = nullptr;
+    TraceEvent event;
+};
+
+} // namespace doris::vectorized
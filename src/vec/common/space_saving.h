@@ -0,0 +1,269 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vec/common/exception.h"
+#include "vec/common/hash_table/hash_map.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/common/string_ref.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int INCORRECT_DATA;
+}
+
+/// How SpaceSaving indexes, compares and serializes the keys.
+/// The numbers are indexed by their bits, that is why they must not be larger than 8 bytes.
+template <typename TKey>
+struct SpaceSavingKeyTraits {
+    static_assert(sizeof(TKey) <= sizeof(UInt64));
+    using KeyRef = TKey;
+
+    static UInt64 hash(TKey key) {
+        UInt64 res = 0;
+        memcpy(&res, &key, sizeof(key));
+        return res;
+    }
+    static bool equals(const TKey& stored, TKey key) { return hash(stored) == hash(key); }
+    static void assign(TKey& stored, TKey key) { stored = key; }
+    static void write(const TKey& key, BufferWritable& buf) { buf.write_binary(key); }
+    static void read(TKey& key, BufferReadable& buf) { buf.read_binary(key); }
+};
+
+/// The strings are indexed by CityHash64, and the hash is checked by the comparison of the strings.
+template <>
+struct SpaceSavingKeyTraits<std::string> {
+    using KeyRef = StringRef;
+
+    static UInt64 hash(StringRef key) { return StringRefHash64()(key); }
+    static bool equals(const std::string& stored, StringRef key) {
+        return StringRef(stored) == key;
+    }
+    static void assign(std::string& stored, StringRef key) { stored.assign(key.data, key.size); }
+
+    static void write(const std::string& key, BufferWritable& buf) {
+        buf.write_binary(UInt64(key.size()));
+        buf.write(key.data(), key.size());
+    }
+
+    static void read(std::string& key, BufferReadable& buf) {
+        UInt64 size;
+        buf.read_binary(size);
+        key.resize(size);
+        buf.read(key.data(), size);
+    }
+};
+
+/** The Space-Saving algorithm (Metwally et al.) for the most frequent keys:
+  *  there are at most capacity counters, a new key takes the counter with the smallest count,
+  *  and the old count becomes the error of the new key. So the memory does not depend on
+  *  the number of distinct keys, and every key with the weight more than total / capacity is
+  *  kept.
+  * The counters are kept in the descending order of count (order), an increment moves
+  *  the counter towards the beginning. The index is a hash map from the hash of the key to
+  *  the chain of the counters of the keys with this hash (Counter::next), so the keys with
+  *  the same hash do not replace each other. When a counter is taken by a new key, it is
+  *  removed from its chain, and the entry of an empty chain is left in the index. The index
+  *  is rebuilt when it has too many such entries.
+  * Two states are merged as in "Parallel Space Saving" (Cafaro et al.): a key missing in one
+  *  state gets the smallest count of that state, if it is full.
+  */
+template <typename TKey>
+class SpaceSaving {
+public:
+    using Traits = SpaceSavingKeyTraits<TKey>;
+    using KeyRef = typename Traits::KeyRef;
+
+    static constexpr UInt32 NO_COUNTER = std::numeric_limits<UInt32>::max();
+
+    struct Counter {
+        TKey key {};
+        UInt64 count = 0;
+        UInt64 error = 0;
+        /// The position in order.
+        UInt32 slot = 0;
+        /// The next counter of a key with the same hash, see link().
+        UInt32 next = NO_COUNTER;
+    };
+
+    explicit SpaceSaving(size_t capacity_ = 0) : capacity(capacity_) {}
+
+    size_t size() const { return counters.size(); }
+
+    void insert(KeyRef key, UInt64 weight = 1) {
+        if (Counter* counter = findCounter(key)) {
+            counter->count += weight;
+            percolate(counter->slot);
+            return;
+        }
+
+        UInt32 i;
+        if (counters.size() < capacity) {
+            i = counters.size();
+            counters.emplace_back();
+            counters[i].slot = order.size();
+            order.push_back(i);
+        } else {
+            i = order.back();
+            unlink(i);
+            counters[i].error = counters[i].count;
+        }
+        Counter& counter = counters[i];
+        Traits::assign(counter.key, key);
+        counter.count += weight;
+        link(i);
+        percolate(counter.slot);
+
+        if (index.size() > capacity * max_index_load) rebuildIndex();
+    }
+
+    void merge(const SpaceSaving& rhs) {
+        if (rhs.counters.empty()) return;
+        UInt64 min_count = isFull() ? counters[order.back()].count : 0;
+        UInt64 rhs_min_count = rhs.isFull() ? rhs.counters[rhs.order.back()].count : 0;
+
+        std::vector<Counter> merged;
+        merged.reserve(counters.size() + rhs.counters.size());
+        for (const Counter& counter : counters) {
+            merged.push_back(counter);
+            if (const Counter* rhs_counter = rhs.findCounter(counter.key)) {
+                merged.back().count += rhs_counter->count;
+                merged.back().error += rhs_counter->error;
+            } else {
+                merged.back().count += rhs_min_count;
+                merged.back().error += rhs_min_count;
+            }
+        }
+        for (const Counter& rhs_counter : rhs.counters) {
+            if (findCounter(rhs_counter.key)) continue;
+            merged.push_back(rhs_counter);
+            merged.back().count += min_count;
+            merged.back().error += min_count;
+        }
+
+        std::sort(merged.begin(), merged.end(),
+                  [](const Counter& a, const Counter& b) { return a.count > b.count; });
+        if (merged.size() > capacity) merged.resize(capacity);
+        counters = std::move(merged);
+        order.resize(counters.size());
+        std::iota(order.begin(), order.end(), 0);
+        for (size_t i = 0; i < counters.size(); ++i) counters[i].slot = i;
+        rebuildIndex();
+    }
+
+    /// Calls f(counter) for the first limit counters in the descending order of count.
+    template <typename F>
+    void forEachTop(size_t limit, F&& f) const {
+        for (size_t i = 0; i < std::min(limit, order.size()); ++i) f(counters[order[i]]);
+    }
+
+    /// The counters are written in the descending order of count.
+    void write(BufferWritable& buf) const {
+        buf.write_binary(UInt64(counters.size()));
+        for (UInt32 i : order) {
+            Traits::write(counters[i].key, buf);
+            buf.write_binary(counters[i].count);
+            buf.write_binary(counters[i].error);
+        }
+    }
+
+    /// Reads into an empty state.
+    void read(BufferReadable& buf) {
+        UInt64 size;
+        buf.read_binary(size);
+        if (size > capacity)
+            throw Exception("Too many counters in the state of topK: " + std::to_string(size),
+                            ErrorCodes::INCORRECT_DATA);
+        counters.resize(size);
+        order.resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            Traits::read(counters[i].key, buf);
+            buf.read_binary(counters[i].count);
+            buf.read_binary(counters[i].error);
+            counters[i].slot = i;
+            order[i] = i;
+        }
+        rebuildIndex();
+    }
+
+private:
+    using Index = HashMap<UInt64, UInt32>;
+
+    /// The index is rebuilt when it has more entries than max_index_load * capacity.
+    static constexpr size_t max_index_load = 4;
+
+    bool isFull() const { return counters.size() == capacity; }
+
+    const Counter* findCounter(KeyRef key) const {
+        auto it = index.find(Traits::hash(key));
+        if (!it) return nullptr;
+        for (UInt32 i = it->getSecond(); i != NO_COUNTER; i = counters[i].next)
+            if (Traits::equals(counters[i].key, key)) return &counters[i];
+        return nullptr;
+    }
+
+    Counter* findCounter(KeyRef key) {
+        return const_cast<Counter*>(std::as_const(*this).findCounter(key));
+    }
+
+    void percolate(UInt32 slot) {
+        while (slot > 0 && counters[order[slot - 1]].count < counters[order[slot]].count) {
+            std::swap(order[slot - 1], order[slot]);
+            counters[order[slot]].slot = slot;
+            --slot;
+            counters[order[slot]].slot = slot;
+        }
+    }
+
+    /// Puts the counter i at the head of the chain of the hash of its key.
+    void link(UInt32 i) {
+        typename Index::LookupResult it;
+        bool inserted;
+        index.emplace(Traits::hash(counters[i].key), it, inserted);
+        counters[i].next = inserted ? NO_COUNTER : it->getSecond();
+        it->getSecond() = i;
+    }
+
+    /// Removes the counter i from the chain of the hash of its key.
+    void unlink(UInt32 i) {
+        UInt32* link = &index.find(Traits::hash(counters[i].key))->getSecond();
+        while (*link != i) link = &counters[*link].next;
+        *link = counters[i].next;
+    }
+
+    void rebuildIndex() {
+        index.clear();
+        for (size_t i = 0; i < counters.size(); ++i) link(i);
+    }
+
+    size_t capacity;
+    std::vector<Counter> counters;
+    std::vector<UInt32> order;
+    Index index;
+};
+
+} // namespace doris::vectorized
@@ -20,7 +20,15 @@
 
 #include <cstring>
 
+#include "vec/common/exception.h"
+#include "vec/common/string_ref.h"
+
 namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int CANNOT_READ_ALL_DATA;
+}
+
 class BufferWritable {
 public:
     virtual void write(const char* data, int len) = 0;
@@ -33,6 +41,12 @@ public:
         write(buffer.data(), buffer.size());
     }
 
+    /// Writes the bytes of a trivially copyable value, read it back by BufferReadable::read_binary.
+    template <typename T>
+    void write_binary(const T& data) {
+        write(reinterpret_cast<const char*>(&data), sizeof(T));
+    }
+
     int count() const { return _writer_counter; }
 
 protected:
@@ -55,4 +69,30 @@ public:
 private:
     T& _vector;
 };
+
+/// Reads from memory what was written by BufferWritable.
+class BufferReadable {
+public:
+    explicit BufferReadable(StringRef data) : _pos(data.data), _end(data.data + data.size) {}
+
+    void read(char* data, int len) {
+        if (len > _end - _pos)
+            throw Exception("Cannot read all data, there are " + std::to_string(_end - _pos) +
+                                    " bytes left of " + std::to_string(len),
+                            ErrorCodes::CANNOT_READ_ALL_DATA);
+        memcpy(data, _pos, len);
+        _pos += len;
+    }
+
+    template <typename T>
+    void read_binary(T& data) {
+        read(reinterpret_cast<char*>(&data), sizeof(T));
+    }
+
+    bool eof() const { return _pos == _end; }
+
+private:
+    const char* _pos;
+    const char* _end;
+};
 } // namespace doris::vectorized
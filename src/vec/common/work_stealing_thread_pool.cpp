@@ -0,0 +1,226 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/work_stealing_thread_pool.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace doris::vectorized {
+
+namespace {
+
+thread_local const WorkStealingThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+#if defined(__linux__)
+
+/// Parses lists like "0-3,8-11" from sysfs.
+std::vector<int> parseCPUList(const std::string& list) {
+    std::vector<int> res;
+    std::stringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) res.push_back(cpu);
+    }
+    return res;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::string res;
+    std::getline(in, res);
+    return res;
+}
+
+/// CPUs available to the process, grouped by NUMA nodes.
+std::vector<std::vector<int>> getCPUsByNumaNodes() {
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool has_affinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    auto is_allowed = [&](int cpu) {
+        return !has_affinity || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed));
+    };
+
+    std::vector<std::vector<int>> res;
+    for (int node : parseCPUList(readFile("/sys/devices/system/node/online"))) {
+        std::vector<int> cpus;
+        for (int cpu : parseCPUList(readFile("/sys/devices/system/node/node" +
+                                             std::to_string(node) + "/cpulist")))
+            if (is_allowed(cpu)) cpus.push_back(cpu);
+        if (!cpus.empty()) res.push_back(std::move(cpus));
+    }
+
+    if (res.empty()) {
+        /// No NUMA information in sysfs.
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (has_affinity && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        res.push_back(std::move(cpus));
+    }
+    return res;
+}
+
+void bindToCPUs(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    /// It is only an optimization, e.g. a cgroup may not allow it.
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+#else
+
+std::vector<std::vector<int>> getCPUsByNumaNodes() {
+    return {{}};
+}
+
+void bindToCPUs(const std::vector<int>&) {}
+
+#endif
+
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t num_threads) {
+    auto nodes = getCPUsByNumaNodes();
+    numa_nodes = nodes.size();
+
+    /// All CPUs in order of nodes, to give each node the share of workers it has of CPUs.
+    std::vector<size_t> node_of_cpu;
+    for (size_t node = 0; node < nodes.size(); ++node)
+        node_of_cpu.insert(node_of_cpu.end(), std::max<size_t>(nodes[node].size(), 1), node);
+
+    if (num_threads == 0) {
+        num_threads = nodes.size() == 1 && nodes[0].empty() ? std::thread::hardware_concurrency()
+                                                            : node_of_cpu.size();
+        num_threads = std::max<size_t>(num_threads, 1);
+    }
+
+    for (size_t i = 0; i < num_threads; ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        worker->numa_node = node_of_cpu[i * node_of_cpu.size() / num_threads];
+        if (numa_nodes > 1) worker->cpus = nodes[worker->numa_node];
+        workers.push_back(std::move(worker));
+    }
+    for (auto& worker : workers) {
+        Worker* ptr = worker.get();
+        worker->thread = std::thread([this, ptr] { workerLoop(*ptr); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard lock(idle_mutex);
+        shutdown = true;
+    }
+    idle_cv.notify_all();
+    for (auto& worker : workers) worker->thread.join();
+}
+
+std::optional<size_t> WorkStealingThreadPool::getCurrentWorker() const {
+    if (current_pool != this) return {};
+    return current_worker;
+}
+
+void WorkStealingThreadPool::schedule(Job job, int numa_node) {
+    if (current_pool == this) {
+        push(*workers[current_worker], std::move(job));
+        return;
+    }
+
+    size_t start = next_worker.fetch_add(1, std::memory_order_relaxed);
+    if (numa_node >= 0 && size_t(numa_node) < numa_nodes) {
+        for (size_t i = 0; i < workers.size(); ++i) {
+            auto& worker = *workers[(start + i) % workers.size()];
+            if (worker.numa_node == size_t(numa_node)) {
+                push(worker, std::move(job));
+                return;
+            }
+        }
+    }
+    push(*workers[start % workers.size()], std::move(job));
+}
+
+void WorkStealingThreadPool::push(Worker& worker, Job job) {
+    /// Before the job becomes visible, so that the counter never goes below zero.
+    pending_jobs.fetch_add(1);
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    }
+    /// Workers check pending_jobs under this mutex before they sleep.
+    { std::lock_guard lock(idle_mutex); }
+    idle_cv.notify_one();
+}
+
+bool WorkStealingThreadPool::tryPop(Worker& worker, Job& job) {
+    std::lock_guard lock(worker.mutex);
+    if (worker.jobs.empty()) return false;
+    job = std::move(worker.jobs.back());
+    worker.jobs.pop_back();
+    pending_jobs.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingThreadPool::trySteal(Worker& thief, Job& job) {
+    for (bool same_node : {true, false}) {
+        for (size_t i = 1; i < workers.size(); ++i) {
+            auto& victim = *workers[(thief.index + i) % workers.size()];
+            if ((victim.numa_node == thief.numa_node) != same_node) continue;
+
+            std::lock_guard lock(victim.mutex);
+            if (victim.jobs.empty()) continue;
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            pending_jobs.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::workerLoop(Worker& worker) {
+    current_pool = this;
+    current_worker = worker.index;
+    if (!worker.cpus.empty()) bindToCPUs(worker.cpus);
+
+    while (true) {
+        Job job;
+        if (tryPop(worker, job) || trySteal(worker, job)) {
+            job();
+            continue;
+        }
+
+        std::unique_lock lock(idle_mutex);
+        if (pending_jobs.load() != 0) continue;
+        if (shutdown) return;
+        idle_cv.wait(lock, [&] { return pending_jobs.load() != 0 || shutdown; });
+    }
+}
+
+} // namespace doris::vectorized
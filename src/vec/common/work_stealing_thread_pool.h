@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <boost/noncopyable.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace doris::vectorized {
+
+/** Thread pool where every worker has its own deque of jobs.
+  *
+  * A job scheduled from a worker goes to the back of the deque of this worker and is taken
+  * by it in LIFO order, so that the data just produced by the worker is processed while it
+  * is still in its caches. Idle workers steal from the front of the deques of other
+  * workers: first of the workers on the same NUMA node, then of all others.
+  * Jobs scheduled from other threads are distributed over the workers round-robin
+  * (or over the workers of the requested NUMA node).
+  *
+  * If the machine has several NUMA nodes, every worker is bound to the CPUs of its node,
+  * and workers are distributed over the nodes proportionally to their CPUs.
+  *
+  * Jobs must not throw: the pool has nobody to pass the exception to.
+  * The destructor waits for all scheduled jobs.
+  */
+class WorkStealingThreadPool : private boost::noncopyable {
+public:
+    using Job = std::function<void()>;
+
+    /// 0 means the number of CPUs available to the process.
+    explicit WorkStealingThreadPool(size_t num_threads = 0);
+    ~WorkStealingThreadPool();
+
+    /// numa_node is a hint for jobs scheduled from outside of the pool, -1 means any.
+    void schedule(Job job, int numa_node = -1);
+
+    size_t getNumberOfThreads() const { return workers.size(); }
+    size_t getNumberOfNumaNodes() const { return numa_nodes; }
+
+    /// Index of the current thread among the workers of this pool, if it is one of them.
+    std::optional<size_t> getCurrentWorker() const;
+
+private:
+    struct Worker {
+        size_t index;
+        size_t numa_node;
+        std::vector<int> cpus;
+
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::thread thread;
+    };
+
+    void workerLoop(Worker& worker);
+    bool tryPop(Worker& worker, Job& job);
+    bool trySteal(Worker& thief, Job& job);
+    void push(Worker& worker, Job job);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    size_t numa_nodes = 1;
+    std::atomic<size_t> next_worker{0};
+
+    /// Scheduled and not yet taken jobs of all workers.
+    std::atomic<size_t> pending_jobs{0};
+    std::mutex idle_mutex;
+    std::condition_variable idle_cv;
+    bool shutdown = false;
+};
+
+} // namespace doris::vectorized
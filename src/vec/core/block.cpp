@@ -29,6 +29,8 @@
 #include "vec/columns/column_vector.h"
 #include "vec/columns/column_const.h"
 #include "vec/common/assert_cast.h"
+#include "vec/common/perf_events.h"
+#include "vec/common/query_trace.h"
 #include "vec/common/typeid_cast.h"
 
 namespace doris::vectorized {
@@ -340,6 +342,13 @@ Block Block::cloneWithColumns(const Columns& columns) const {
     return res;
 }
 
+Block Block::cut(size_t offset, size_t length) const {
+    Columns columns;
+    columns.reserve(data.size());
+    for (const auto& elem : data) columns.push_back(elem.column->cut(offset, length));
+    return cloneWithColumns(columns);
+}
+
 Block Block::cloneWithoutColumns() const {
     Block res;
 
@@ -531,18 +540,25 @@ void Block::updateHash(SipHash& hash) const {
 }
 
 void Block::filter_block(Block* block, int filter_column_id, int column_to_keep) {
+    TraceScope trace_scope("Block::filter_block", block->rows());
+    PerfEventsScope perf_events_scope;
     ColumnPtr filter_column = block->getByPosition(filter_column_id).column;
     const IColumn::Filter& filter =
             assert_cast<const doris::vectorized::ColumnVector<UInt8>&>(*filter_column).getData();
 
     block->getByPosition(0).column = block->getByPosition(0).column->filter(filter, 0);
-    if (block->getByPosition(0).column->empty()) return;
-
-    for (int i = 1; i < column_to_keep; ++i) {
-        block->getByPosition(i).column = block->getByPosition(i).column->filter(filter, 0);
+    if (block->getByPosition(0).column->empty()) {
+        for (int i = 1; i < column_to_keep; ++i) {
+            block->getByPosition(i).column = block->getByPosition(i).column->cloneEmpty();
+        }
+    } else {
+        for (int i = 1; i < column_to_keep; ++i) {
+            block->getByPosition(i).column = block->getByPosition(i).column->filter(filter, 0);
+        }
     }
-    for (size_t i = column_to_keep; i < block->columns(); ++i) {
-        block->erase(i);
+    /// Erase from the back, so that positions of the remaining columns do not shift.
+    while (block->columns() > static_cast<size_t>(column_to_keep)) {
+        block->erase(block->columns() - 1);
     }
 }
 
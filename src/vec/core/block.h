@@ -128,6 +128,9 @@ public:
     Block cloneWithColumns(const Columns& columns) const;
     Block cloneWithoutColumns() const;
 
+    /** Get rows [offset, offset + length) of the block, see IColumn::cut. */
+    Block cut(size_t offset, size_t length) const;
+
     /** Get empty columns with the same types as in block. */
     MutableColumns cloneEmptyColumns() const;
 
@@ -0,0 +1,87 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/data_types/data_type_aggregate_function.h"
+
+#include <fmt/format.h>
+
+#include "vec/columns/column_string.h"
+#include "vec/common/arena.h"
+#include "vec/common/pod_array.h"
+#include "vec/common/string_buffer.hpp"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// The parameters of aggregate functions are numbers or strings.
+String parameterToString(const Field& field) {
+    switch (field.getType()) {
+    case Field::Types::UInt64:
+        return std::to_string(field.get<UInt64>());
+    case Field::Types::Int64:
+        return std::to_string(field.get<Int64>());
+    case Field::Types::Float64:
+        return fmt::format("{}", field.get<Float64>());
+    case Field::Types::String:
+        return "'" + field.get<String>() + "'";
+    default:
+        return Field::Types::toString(field.getType());
+    }
+}
+
+} // namespace
+
+std::string DataTypeAggregateFunction::doGetName() const {
+    std::string res = "AggregateFunction(" + function->getName();
+    if (!parameters.empty()) {
+        res += "(";
+        for (size_t i = 0; i < parameters.size(); ++i) {
+            if (i) res += ", ";
+            res += parameterToString(parameters[i]);
+        }
+        res += ")";
+    }
+    for (const auto& argument_type : argument_types) res += ", " + argument_type->getName();
+    return res + ")";
+}
+
+MutableColumnPtr DataTypeAggregateFunction::createColumn() const {
+    return ColumnString::create();
+}
+
+Field DataTypeAggregateFunction::getDefault() const {
+    Arena arena;
+    AggregateDataPtr place = arena.alignedAlloc(function->sizeOfData(), function->alignOfData());
+    function->create(place);
+    PaddedPODArray<char> buffer;
+    VectorBufferWriter<PaddedPODArray<char>> writer(buffer);
+    try {
+        function->serialize(place, writer);
+    } catch (...) {
+        function->destroy(place);
+        throw;
+    }
+    function->destroy(place);
+    return String(buffer.data(), buffer.size());
+}
+
+bool DataTypeAggregateFunction::equals(const IDataType& rhs) const {
+    return typeid(rhs) == typeid(*this) && getName() == rhs.getName();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,63 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/data_types/data_type.h"
+
+namespace doris::vectorized {
+
+/** Type - the states of an aggregate function, as returned by the -State combinator
+  *  and taken by the -Merge combinator.
+  * The column is a ColumnString, every row is a state written by IAggregateFunction::serialize.
+  * The type knows the function and its arguments, so that -Merge creates the same function.
+  */
+class DataTypeAggregateFunction final : public IDataType {
+private:
+    AggregateFunctionPtr function;
+    DataTypes argument_types;
+    Array parameters;
+
+public:
+    static constexpr bool is_parametric = true;
+
+    DataTypeAggregateFunction(const AggregateFunctionPtr& function_, const DataTypes& arguments_,
+                              const Array& params_)
+            : function(function_), argument_types(arguments_), parameters(params_) {}
+
+    String getFunctionName() const { return function->getName(); }
+    AggregateFunctionPtr getFunction() const { return function; }
+    const DataTypes& getArgumentsDataTypes() const { return argument_types; }
+    const Array& getParameters() const { return parameters; }
+
+    std::string doGetName() const override;
+    const char* getFamilyName() const override { return "AggregateFunction"; }
+    TypeIndex getTypeId() const override { return TypeIndex::AggregateFunction; }
+
+    MutableColumnPtr createColumn() const override;
+
+    /// The serialized empty state.
+    Field getDefault() const override;
+
+    bool equals(const IDataType& rhs) const override;
+
+    bool isParametric() const override { return true; }
+    bool haveSubtypes() const override { return false; }
+};
+
+} // namespace doris::vectorized
@@ -16,11 +16,13 @@
 // under the License.
 
 #pragma once
+#include <cstdio>
 #include <mutex>
 #include <string>
 
 #include "vec/data_types/data_type.h"
 #include "vec/data_types/data_type_nothing.h"
+#include "vec/data_types/data_type_nullable.h"
 #include "vec/data_types/data_type_string.h"
 #include "vec/data_types/data_types_decimal.h"
 #include "vec/data_types/data_types_number.h"
@@ -46,10 +48,25 @@ public:
             instance.regist_data_type("Int64", DataTypePtr(std::make_shared<DataTypeInt64>()));
             instance.regist_data_type("Float32", DataTypePtr(std::make_shared<DataTypeFloat32>()));
             instance.regist_data_type("Float64", DataTypePtr(std::make_shared<DataTypeFloat64>()));
+            instance.regist_data_type("String", DataTypePtr(std::make_shared<DataTypeString>()));
         });
         return instance;
     }
-    DataTypePtr get(const std::string& name) { return _data_type_map[name]; }
+    /// Also parses the names of parametric types, as returned by IDataType::getName():
+    /// Nullable(T) and Decimal(P, S). Null if the type is unknown.
+    DataTypePtr get(const std::string& name) {
+        if (name.size() > 10 && name.compare(0, 9, "Nullable(") == 0 && name.back() == ')') {
+            auto nested = get(name.substr(9, name.size() - 10));
+            return nested ? makeNullable(nested) : nullptr;
+        }
+        unsigned precision = 0;
+        unsigned scale = 0;
+        if (sscanf(name.c_str(), "Decimal(%u, %u)", &precision, &scale) == 2)
+            return createDecimal(precision, scale);
+
+        auto it = _data_type_map.find(name);
+        return it == _data_type_map.end() ? nullptr : it->second;
+    }
     const std::string& get(const DataTypePtr& data_type) const {
         for (const auto& entity : _invert_data_type_map) {
             if (entity.first->equals(*data_type)) {
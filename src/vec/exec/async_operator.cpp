@@ -0,0 +1,219 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/async_operator.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+#include "vec/exec/async_scheduler.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_COLUMN;
+extern const int CANNOT_READ_ALL_DATA;
+extern const int CANNOT_READ_FROM_FILE_DESCRIPTOR;
+}
+
+PollStatus AsyncTransformOperator::poll(Block& block, AsyncContext& context) {
+    auto status = child->poll(block, context);
+    if (status == PollStatus::Ready && block.rows() != 0)
+        transform->transform(block, context.getWorker());
+    return status;
+}
+
+AsyncFdSource::AsyncFdSource(int fd_, Block header_, size_t block_rows)
+        : fd(fd_), header(std::move(header_)) {
+    for (const auto& column : header) {
+        if (!column.column->valuesHaveFixedSize())
+            throw Exception("Column " + column.name + " of FdSource must have values of fixed size",
+                            ErrorCodes::ILLEGAL_COLUMN);
+        value_sizes.push_back(column.column->sizeOfValueIfFixed());
+        row_size += value_sizes.back();
+    }
+    if (row_size == 0)
+        throw Exception("FdSource must have columns", ErrorCodes::ILLEGAL_COLUMN);
+    buffer.resize(std::max<size_t>(block_rows, 1) * row_size);
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && !S_ISREG(st.st_mode)) {
+        int flags = fcntl(fd, F_GETFL);
+        if (flags != -1) fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+AsyncFdSource::~AsyncFdSource() {
+    if (poller) poller->remove(fd);
+}
+
+PollStatus AsyncFdSource::poll(Block& block, AsyncContext& context) {
+    while (!eof && buffer_size < buffer.size()) {
+        ssize_t res = read(fd, buffer.data() + buffer_size, buffer.size() - buffer_size);
+        if (res > 0) {
+            buffer_size += res;
+        } else if (res == 0) {
+            eof = true;
+            if (poller) poller->remove(fd);
+            poller = nullptr;
+            if (buffer_size % row_size != 0)
+                throw Exception("Incomplete row at the end of the input of FdSource",
+                                ErrorCodes::CANNOT_READ_ALL_DATA);
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            poller = &context.getScheduler().getPoller();
+            context.waitReadable(fd);
+            return PollStatus::Pending;
+        } else if (errno != EINTR) {
+            throwFromErrno("Cannot read from descriptor",
+                           ErrorCodes::CANNOT_READ_FROM_FILE_DESCRIPTOR);
+        }
+    }
+
+    if (buffer_size < row_size || (eof && buffer_size == 0)) return PollStatus::Finished;
+    block = makeBlock();
+    return PollStatus::Ready;
+}
+
+Block AsyncFdSource::makeBlock() {
+    size_t rows = buffer_size / row_size;
+    auto columns = header.cloneEmptyColumns();
+    for (auto& column : columns) column->reserve(rows);
+
+    const char* pos = buffer.data();
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i]->insertData(pos, value_sizes[i]);
+            pos += value_sizes[i];
+        }
+    }
+
+    size_t used = rows * row_size;
+    memmove(buffer.data(), buffer.data() + used, buffer_size - used);
+    buffer_size -= used;
+    return header.cloneWithColumns(std::move(columns));
+}
+
+/// The blocks read ahead, shared by the consumer and the task of the producer.
+struct AsyncPrefetchOperator::State {
+    std::mutex mutex;
+    std::deque<Block> blocks;
+    Waker consumer;
+    /// Set while the producer waits for room in blocks.
+    Waker producer;
+    /// The task of the producer, whatever it waits for. Woken up to cancel it.
+    Waker producer_task;
+    bool finished = false;
+    bool cancelled = false;
+    std::exception_ptr exception;
+};
+
+/// The root operator of the task that reads ahead. Never returns a block: it returns Ready
+/// without rows for every block put into the state, so that the task can yield.
+class AsyncPrefetchOperator::Producer : public IAsyncOperator {
+public:
+    Producer(AsyncOperatorPtr child_, std::shared_ptr<State> state_, size_t max_blocks_)
+            : child(std::move(child_)), state(std::move(state_)), max_blocks(max_blocks_) {}
+
+    String getName() const override { return "PrefetchProducer"; }
+
+    PollStatus poll(Block& block, AsyncContext& context) override {
+        {
+            std::lock_guard lock(state->mutex);
+            if (state->cancelled) return PollStatus::Finished;
+            if (!state->producer_task) state->producer_task = context.getWaker();
+            if (state->blocks.size() >= max_blocks) {
+                state->producer = context.getWaker();
+                return PollStatus::Pending;
+            }
+        }
+
+        Block next;
+        auto status = child->poll(next, context);
+        if (status != PollStatus::Ready) return status;
+        if (next.rows() == 0) return PollStatus::Ready;
+
+        Waker consumer;
+        {
+            std::lock_guard lock(state->mutex);
+            state->blocks.push_back(std::move(next));
+            consumer = std::move(state->consumer);
+        }
+        consumer.wake();
+        return PollStatus::Ready;
+    }
+
+private:
+    AsyncOperatorPtr child;
+    std::shared_ptr<State> state;
+    size_t max_blocks;
+};
+
+AsyncPrefetchOperator::AsyncPrefetchOperator(AsyncOperatorPtr child_, size_t max_blocks_)
+        : child(std::move(child_)), max_blocks(std::max<size_t>(max_blocks_, 1)) {}
+
+AsyncPrefetchOperator::~AsyncPrefetchOperator() {
+    if (!state) return;
+    Waker producer;
+    {
+        std::lock_guard lock(state->mutex);
+        state->cancelled = true;
+        producer = std::move(state->producer_task);
+        state->producer = {};
+    }
+    producer.wake();
+}
+
+PollStatus AsyncPrefetchOperator::poll(Block& block, AsyncContext& context) {
+    if (!state) {
+        state = std::make_shared<State>();
+        context.getScheduler().spawn(
+                std::make_shared<Producer>(std::move(child), state, max_blocks),
+                [state = state](std::exception_ptr exception) {
+                    Waker consumer;
+                    {
+                        std::lock_guard lock(state->mutex);
+                        state->finished = true;
+                        state->exception = exception;
+                        consumer = std::move(state->consumer);
+                    }
+                    consumer.wake();
+                });
+    }
+
+    Waker producer;
+    {
+        std::lock_guard lock(state->mutex);
+        if (state->blocks.empty()) {
+            if (state->exception) std::rethrow_exception(state->exception);
+            if (state->finished) return PollStatus::Finished;
+            state->consumer = context.getWaker();
+            return PollStatus::Pending;
+        }
+        block = std::move(state->blocks.front());
+        state->blocks.pop_front();
+        producer = std::move(state->producer);
+    }
+    producer.wake();
+    return PollStatus::Ready;
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,136 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "vec/core/block.h"
+#include "vec/exec/block_transform.h"
+
+namespace doris::vectorized {
+
+class AsyncContext;
+class IoPoller;
+
+enum class PollStatus {
+    /// A block is returned. It may have no rows, e.g. when a filter removed all of them.
+    Ready,
+    /// No block yet. The operator has arranged for the waker of the context to be called
+    /// when it can make progress, and will be polled again after that.
+    Pending,
+    /// There will be no more blocks.
+    Finished,
+};
+
+/** Operator that can suspend while it waits for its input, without blocking a thread.
+  *
+  * This is a stackless coroutine written by hand: poll() resumes the operator, which either
+  * returns the next block or suspends with Pending, keeping in its members the state
+  * to continue from. An operator awaits its input by polling its child and returning
+  * Pending when the child does, so a whole chain of operators suspends at once, down to
+  * the source that waits for a file descriptor.
+  *
+  * poll() is never called by two threads at once, but successive calls may come from
+  * different threads. It is not called again after Finished or an exception.
+  */
+class IAsyncOperator {
+public:
+    virtual ~IAsyncOperator() = default;
+
+    virtual String getName() const = 0;
+
+    virtual PollStatus poll(Block& block, AsyncContext& context) = 0;
+};
+
+using AsyncOperatorPtr = std::shared_ptr<IAsyncOperator>;
+
+/// Applies a transform to the blocks of the child, see IBlockTransform.
+/// The transform gets the index of the worker of the pool that polls the operator.
+class AsyncTransformOperator : public IAsyncOperator {
+public:
+    AsyncTransformOperator(AsyncOperatorPtr child_, BlockTransformPtr transform_)
+            : child(std::move(child_)), transform(std::move(transform_)) {}
+
+    String getName() const override { return transform->getName(); }
+
+    PollStatus poll(Block& block, AsyncContext& context) override;
+
+private:
+    AsyncOperatorPtr child;
+    BlockTransformPtr transform;
+};
+
+/** Reads rows of fixed-size values from a file descriptor: every row is the values
+  * of all columns of the header, one after another, in their memory representation.
+  *
+  * Pipes and sockets are switched to non-blocking mode, and the operator suspends until
+  * the descriptor is readable. Regular files are always readable for epoll, so they are
+  * read synchronously; put an AsyncPrefetchOperator above to read them ahead.
+  * The descriptor is not closed, but it is removed from the poller when the operator is
+  * destroyed, e.g. when the query is cancelled while the operator waits for it.
+  */
+class AsyncFdSource : public IAsyncOperator {
+public:
+    AsyncFdSource(int fd_, Block header_, size_t block_rows = 8192);
+    ~AsyncFdSource() override;
+
+    String getName() const override { return "FdSource"; }
+
+    PollStatus poll(Block& block, AsyncContext& context) override;
+
+private:
+    /// Makes a block of the complete rows in the buffer.
+    Block makeBlock();
+
+    const int fd;
+    const Block header;
+    std::vector<size_t> value_sizes;
+    size_t row_size = 0;
+
+    std::vector<char> buffer;
+    size_t buffer_size = 0;
+    bool eof = false;
+    /// Where the descriptor is registered, if it is.
+    IoPoller* poller = nullptr;
+};
+
+/** Runs the child as a separate task of the scheduler, which reads up to max_blocks blocks
+  * ahead. So the next block of a scan is read on one thread while the previous one is
+  * processed on another. Exceptions of the child are rethrown by poll().
+  * When the operator is destroyed, the task is woken up and finishes, destroying the child.
+  */
+class AsyncPrefetchOperator : public IAsyncOperator {
+public:
+    AsyncPrefetchOperator(AsyncOperatorPtr child_, size_t max_blocks_ = 2);
+    ~AsyncPrefetchOperator() override;
+
+    String getName() const override { return "Prefetch"; }
+
+    PollStatus poll(Block& block, AsyncContext& context) override;
+
+private:
+    struct State;
+    class Producer;
+
+    AsyncOperatorPtr child;
+    const size_t max_blocks;
+    std::shared_ptr<State> state;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,228 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/async_scheduler.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <condition_variable>
+
+#include "vec/common/exception.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int SYSTEM_ERROR;
+}
+
+/** A root operator with the state of its execution:
+  *
+  *   Idle -> Scheduled: woken up, a job of the pool will run it.
+  *   Scheduled -> Running: the job polls the operator.
+  *   Running -> Notified: woken up while running, it must be polled again.
+  *   Running -> Idle: the operator returned Pending and nobody woke the task meanwhile.
+  *   Running -> Done: finished or thrown.
+  */
+class AsyncTask : public std::enable_shared_from_this<AsyncTask> {
+public:
+    AsyncTask(AsyncScheduler& scheduler_, AsyncOperatorPtr root_,
+              AsyncScheduler::FinishCallback on_finish_)
+            : scheduler(scheduler_), root(std::move(root_)), on_finish(std::move(on_finish_)) {}
+
+    void wake() {
+        auto current = state.load();
+        while (true) {
+            if (current == Idle) {
+                if (state.compare_exchange_weak(current, Scheduled)) {
+                    schedule();
+                    return;
+                }
+            } else if (current == Running) {
+                if (state.compare_exchange_weak(current, Notified)) return;
+            } else {
+                return;
+            }
+        }
+    }
+
+    void start() {
+        state.store(Scheduled);
+        schedule();
+    }
+
+private:
+    enum State { Idle, Scheduled, Running, Notified, Done };
+
+    void schedule() {
+        scheduler.pool.schedule([task = shared_from_this()] { task->run(); });
+    }
+
+    void run() {
+        state.store(Running);
+        AsyncContext context(scheduler, shared_from_this(), *scheduler.pool.getCurrentWorker());
+        size_t blocks = 0;
+        try {
+            while (true) {
+                Block block;
+                auto status = root->poll(block, context);
+                if (status == PollStatus::Ready) {
+                    if (++blocks < scheduler.blocks_per_run) continue;
+                    /// Let other tasks run. Wake-ups meanwhile are covered by the next run.
+                    state.store(Scheduled);
+                    schedule();
+                    return;
+                }
+                if (status == PollStatus::Finished) {
+                    finish(nullptr);
+                    return;
+                }
+                auto expected = Running;
+                if (state.compare_exchange_strong(expected, Idle)) return;
+                /// Notified: the operator may be able to continue already.
+                state.store(Running);
+            }
+        } catch (...) {
+            finish(std::current_exception());
+        }
+    }
+
+    void finish(std::exception_ptr exception) {
+        state.store(Done);
+        /// Breaks the cycles through the wakers kept by the operators.
+        root.reset();
+        auto callback = std::move(on_finish);
+        callback(exception);
+    }
+
+    AsyncScheduler& scheduler;
+    AsyncOperatorPtr root;
+    AsyncScheduler::FinishCallback on_finish;
+    std::atomic<State> state{Idle};
+};
+
+void Waker::wake() const {
+    if (task) task->wake();
+}
+
+IoPoller::IoPoller() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) throwFromErrno("Cannot create epoll", ErrorCodes::SYSTEM_ERROR);
+    stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stop_fd == -1) {
+        close(epoll_fd);
+        throwFromErrno("Cannot create eventfd", ErrorCodes::SYSTEM_ERROR);
+    }
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = stop_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &event);
+
+    thread = std::thread([this] { loop(); });
+}
+
+IoPoller::~IoPoller() {
+    uint64_t one = 1;
+    [[maybe_unused]] auto res = write(stop_fd, &one, sizeof(one));
+    thread.join();
+    close(stop_fd);
+    close(epoll_fd);
+}
+
+void IoPoller::waitReadable(int fd, Waker waker) {
+    std::unique_lock lock(mutex);
+    /// Before epoll_ctl: the event may come at once.
+    waiters[fd] = waker;
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.fd = fd;
+    bool is_registered = registered.count(fd);
+    if (epoll_ctl(epoll_fd, is_registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) == 0) {
+        registered.insert(fd);
+        return;
+    }
+
+    int saved_errno = errno;
+    waiters.erase(fd);
+    lock.unlock();
+    if (saved_errno != EPERM)
+        throwFromErrno("Cannot add descriptor to epoll", ErrorCodes::SYSTEM_ERROR, saved_errno);
+    waker.wake();
+}
+
+void IoPoller::remove(int fd) {
+    std::lock_guard lock(mutex);
+    waiters.erase(fd);
+    if (registered.erase(fd)) epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void IoPoller::loop() {
+    constexpr int max_events = 64;
+    epoll_event events[max_events];
+    std::vector<Waker> ready;
+    while (true) {
+        int num_events = epoll_wait(epoll_fd, events, max_events, -1);
+        if (num_events == -1) continue;
+
+        {
+            std::lock_guard lock(mutex);
+            for (int i = 0; i < num_events; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == stop_fd) return;
+                auto it = waiters.find(fd);
+                if (it == waiters.end()) continue;
+                ready.push_back(std::move(it->second));
+                waiters.erase(it);
+            }
+        }
+        for (const auto& waker : ready) waker.wake();
+        ready.clear();
+    }
+}
+
+void AsyncContext::waitReadable(int fd) const {
+    scheduler.getPoller().waitReadable(fd, getWaker());
+}
+
+void AsyncScheduler::spawn(AsyncOperatorPtr root, FinishCallback on_finish) {
+    std::make_shared<AsyncTask>(*this, std::move(root), std::move(on_finish))->start();
+}
+
+void AsyncScheduler::execute(const std::vector<AsyncOperatorPtr>& roots) {
+    std::mutex mutex;
+    std::condition_variable finished_cv;
+    size_t active = roots.size();
+    std::exception_ptr first_exception;
+
+    for (const auto& root : roots) {
+        spawn(root, [&](std::exception_ptr exception) {
+            std::lock_guard lock(mutex);
+            if (exception && !first_exception) first_exception = exception;
+            if (--active == 0) finished_cv.notify_all();
+        });
+    }
+
+    std::unique_lock lock(mutex);
+    finished_cv.wait(lock, [&] { return active == 0; });
+    if (first_exception) std::rethrow_exception(first_exception);
+}
+
+} // namespace doris::vectorized
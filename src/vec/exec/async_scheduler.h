@@ -0,0 +1,147 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/exec/async_operator.h"
+
+namespace doris::vectorized {
+
+class AsyncScheduler;
+class AsyncTask;
+
+/// Resumes a suspended task. May be called from any thread and any number of times:
+/// wake-ups of a task that is already scheduled are merged.
+class Waker {
+public:
+    Waker() = default;
+    explicit Waker(std::shared_ptr<AsyncTask> task_) : task(std::move(task_)) {}
+
+    void wake() const;
+
+    explicit operator bool() const { return task != nullptr; }
+
+private:
+    std::shared_ptr<AsyncTask> task;
+};
+
+/** Waits for readiness of file descriptors with epoll, on a thread of its own.
+  * Every wait is one-shot: the waker is called once, when the descriptor becomes readable
+  * or gets an error or a hangup.
+  */
+class IoPoller : private boost::noncopyable {
+public:
+    IoPoller();
+    ~IoPoller();
+
+    /// Descriptors that epoll does not support, e.g. regular files, are always readable:
+    /// the waker is called at once.
+    void waitReadable(int fd, Waker waker);
+
+    /// Forgets the descriptor. Must be called before it is closed.
+    void remove(int fd);
+
+private:
+    void loop();
+
+    int epoll_fd = -1;
+    /// eventfd that stops the loop.
+    int stop_fd = -1;
+    std::thread thread;
+
+    std::mutex mutex;
+    std::unordered_map<int, Waker> waiters;
+    std::unordered_set<int> registered;
+};
+
+/// What a polled operator knows about the task that polls it.
+class AsyncContext {
+public:
+    AsyncContext(AsyncScheduler& scheduler_, std::shared_ptr<AsyncTask> task_, size_t worker_)
+            : scheduler(scheduler_), task(std::move(task_)), worker(worker_) {}
+
+    AsyncScheduler& getScheduler() const { return scheduler; }
+    /// Index of the worker of the pool, for per-thread state.
+    size_t getWorker() const { return worker; }
+    Waker getWaker() const { return Waker(task); }
+
+    /// Suspends the task until the descriptor is readable: return Pending after it.
+    void waitReadable(int fd) const;
+
+private:
+    AsyncScheduler& scheduler;
+    std::shared_ptr<AsyncTask> task;
+    size_t worker;
+};
+
+/** Executes async operators as tasks in a thread pool, so that thousands of them share a few
+  * threads: a task that waits for its input does not hold a thread.
+  *
+  * A task polls its root operator and drops the blocks it returns, so the root is normally
+  * a sink (e.g. AsyncTransformOperator with PartialAggregateTransform). When the operator
+  * returns Pending, the task is suspended until its waker is called, and then it is
+  * scheduled to the pool again. A task that always has blocks is rescheduled after
+  * blocks_per_run blocks, so that it does not hold a worker while other tasks wait.
+  *
+  * Usage:
+  *     WorkStealingThreadPool pool(4);
+  *     AsyncScheduler scheduler(pool);
+  *     auto source = std::make_shared<AsyncFdSource>(fd, header);
+  *     auto aggregate = std::make_shared<PartialAggregateTransform>(
+  *             functions, arguments, pool.getNumberOfThreads());
+  *     scheduler.execute({std::make_shared<AsyncTransformOperator>(source, aggregate)});
+  *     Block result = aggregate->finalize();
+  */
+class AsyncScheduler : private boost::noncopyable {
+public:
+    /// Called once, when the task is finished. The exception is null if it was not thrown.
+    using FinishCallback = std::function<void(std::exception_ptr)>;
+
+    explicit AsyncScheduler(WorkStealingThreadPool& pool_, size_t blocks_per_run_ = 16)
+            : pool(pool_), blocks_per_run(blocks_per_run_) {}
+
+    /// Starts a task that polls the operator until it is finished.
+    /// The scheduler must outlive the task.
+    void spawn(AsyncOperatorPtr root, FinishCallback on_finish);
+
+    /// Runs the operators to the end. Rethrows the first exception, after all of them
+    /// are finished.
+    void execute(const std::vector<AsyncOperatorPtr>& roots);
+
+    WorkStealingThreadPool& getPool() { return pool; }
+    IoPoller& getPoller() { return poller; }
+
+private:
+    friend class AsyncTask;
+
+    WorkStealingThreadPool& pool;
+    const size_t blocks_per_run;
+    IoPoller poller;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,195 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/block_queue.h"
+
+#include <thread>
+
+#include "vec/common/bit_helpers.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// Attempts before push() and pop() go to sleep.
+constexpr size_t spin_tries = 64;
+
+} // namespace
+
+BlockQueue::BlockQueue(size_t max_blocks, size_t max_bytes_)
+        : capacity(roundUpToPowerOfTwoOrZero(std::max<size_t>(max_blocks, 1))),
+          mask(capacity - 1),
+          max_bytes(max_bytes_),
+          cells(new Cell[capacity]) {
+    for (size_t i = 0; i < capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool BlockQueue::enqueue(Block& block, size_t block_bytes) {
+    /// Reserve the bytes first. An empty queue takes a block of any size.
+    size_t current_bytes = queued_bytes.load(std::memory_order_relaxed);
+    do {
+        if (current_bytes != 0 && current_bytes + block_bytes > max_bytes) return false;
+    } while (!queued_bytes.compare_exchange_weak(current_bytes, current_bytes + block_bytes,
+                                                 std::memory_order_relaxed));
+
+    Cell* cell;
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<ssize_t>(sequence - pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            /// The cell still holds the block of the previous round: the queue is full.
+            queued_bytes.fetch_sub(block_bytes, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->block = std::move(block);
+    cell->bytes = block_bytes;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool BlockQueue::dequeue(Block& block) {
+    Cell* cell;
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<ssize_t>(sequence - (pos + 1));
+        if (diff == 0) {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    block = std::move(cell->block);
+    cell->block.clear();
+    size_t block_bytes = cell->bytes;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    queued_bytes.fetch_sub(block_bytes, std::memory_order_relaxed);
+    return true;
+}
+
+bool BlockQueue::tryPush(Block& block) {
+    if (!enqueue(block, block.bytes())) return false;
+    wakeUp(not_empty);
+    return true;
+}
+
+bool BlockQueue::tryPop(Block& block) {
+    if (!dequeue(block)) return false;
+    wakeUp(not_full);
+    return true;
+}
+
+void BlockQueue::wakeUp(std::condition_variable& condition) {
+    /// Pairs with the fence in push() and pop(): either the sleeping thread sees the change
+    /// of the queue, or we see that it sleeps. Locking the mutex makes sure that it is
+    /// already waiting and does not miss the notification.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed) == 0) return;
+    { std::lock_guard lock(wait_mutex); }
+    condition.notify_all();
+}
+
+bool BlockQueue::push(Block block) {
+    size_t block_bytes = block.bytes();
+    for (size_t i = 0; i < spin_tries; ++i) {
+        if (finished.load(std::memory_order_relaxed)) return false;
+        if (enqueue(block, block_bytes)) {
+            wakeUp(not_empty);
+            return true;
+        }
+        std::this_thread::yield();
+    }
+
+    std::unique_lock lock(wait_mutex);
+    while (true) {
+        sleeping.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (finished.load()) {
+            sleeping.fetch_sub(1);
+            return false;
+        }
+        if (enqueue(block, block_bytes)) {
+            sleeping.fetch_sub(1);
+            lock.unlock();
+            wakeUp(not_empty);
+            return true;
+        }
+        not_full.wait(lock);
+        sleeping.fetch_sub(1);
+    }
+}
+
+bool BlockQueue::pop(Block& block) {
+    for (size_t i = 0; i < spin_tries; ++i) {
+        /// Checked before dequeue(): all blocks are pushed before finish().
+        bool was_finished = finished.load();
+        if (dequeue(block)) {
+            wakeUp(not_full);
+            return true;
+        }
+        if (was_finished) return false;
+        std::this_thread::yield();
+    }
+
+    std::unique_lock lock(wait_mutex);
+    while (true) {
+        sleeping.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool was_finished = finished.load();
+        if (dequeue(block)) {
+            sleeping.fetch_sub(1);
+            lock.unlock();
+            wakeUp(not_full);
+            return true;
+        }
+        if (was_finished) {
+            sleeping.fetch_sub(1);
+            return false;
+        }
+        not_empty.wait(lock);
+        sleeping.fetch_sub(1);
+    }
+}
+
+void BlockQueue::finish() {
+    {
+        std::lock_guard lock(wait_mutex);
+        finished.store(true);
+    }
+    not_full.notify_all();
+    not_empty.notify_all();
+}
+
+size_t BlockQueue::size() const {
+    size_t dequeued = dequeue_pos.load(std::memory_order_relaxed);
+    size_t enqueued = enqueue_pos.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <boost/noncopyable.hpp>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+/** Bounded multi-producer multi-consumer queue of blocks.
+  *
+  * tryPush() and tryPop() are lock-free: a ring of cells with sequence numbers
+  * (D. Vyukov's bounded MPMC queue), so producers and consumers only contend on
+  * one atomic each. The capacity is limited both in blocks and in bytes; a block larger
+  * than the limit of bytes is still accepted by an empty queue, so that it cannot get stuck.
+  *
+  * push() and pop() wait for room or for a block. They spin for a while and then sleep
+  * on a condition variable, which is touched by the other side only if somebody sleeps.
+  */
+class BlockQueue : private boost::noncopyable {
+public:
+    /// max_blocks is rounded up to a power of two.
+    BlockQueue(size_t max_blocks, size_t max_bytes);
+
+    /// The block is moved from only on success.
+    bool tryPush(Block& block);
+    bool tryPop(Block& block);
+
+    /// Waits while the queue is full. False if the queue is finished, the block is dropped.
+    bool push(Block block);
+    /// Waits while the queue is empty. False if the queue is finished and empty.
+    bool pop(Block& block);
+
+    /// There will be no more blocks: pop() returns the rest and then false.
+    /// Blocks pushed concurrently with finish() may be lost, so producers call it after their
+    /// last push(). Consumers may call it too, to stop the producers waiting for room.
+    void finish();
+    bool isFinished() const { return finished.load(); }
+
+    /// Approximate, while other threads push and pop.
+    size_t size() const;
+    size_t bytes() const { return queued_bytes.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        size_t bytes = 0;
+        Block block;
+    };
+
+    bool enqueue(Block& block, size_t block_bytes);
+    bool dequeue(Block& block);
+    void wakeUp(std::condition_variable& condition);
+
+    const size_t capacity;
+    const size_t mask;
+    const size_t max_bytes;
+    std::unique_ptr<Cell[]> cells;
+
+    /// On different cache lines: producers and consumers do not disturb each other.
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+    alignas(64) std::atomic<size_t> queued_bytes{0};
+    std::atomic<bool> finished{false};
+
+    std::mutex wait_mutex;
+    std::condition_variable not_full;
+    std::condition_variable not_empty;
+    std::atomic<size_t> sleeping{0};
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,205 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/block_squashing.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "vec/common/query_profile.h"
+
+namespace doris::vectorized {
+
+size_t getL2CacheSize() {
+    static const size_t size = [] {
+        long res = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        return res > 0 ? size_t(res) : size_t(1) << 20;
+    }();
+    return size;
+}
+
+AdaptiveBlockSize::AdaptiveBlockSize(const BlockSizeSettings& settings)
+        : min_rows(std::max<size_t>(settings.min_rows, 1)),
+          max_rows(std::max(settings.max_rows, min_rows)),
+          max_bytes(settings.max_bytes ? settings.max_bytes : getL2CacheSize()),
+          adaptive(settings.adaptive),
+          target_rows(std::clamp(settings.initial_rows, min_rows, max_rows)) {}
+
+size_t AdaptiveBlockSize::getRows() const {
+    if (total_rows == 0 || total_bytes == 0) return target_rows;
+    auto rows_by_bytes = size_t(double(max_bytes) * total_rows / total_bytes);
+    return std::min(target_rows, std::max(rows_by_bytes, min_rows));
+}
+
+void AdaptiveBlockSize::update(size_t rows, size_t bytes, UInt64 nanoseconds) {
+    total_rows += rows;
+    total_bytes += bytes;
+    if (!adaptive) return;
+
+    window_rows += rows;
+    window_nanoseconds += nanoseconds;
+    if (++window_count < window_blocks) return;
+
+    double throughput = double(window_rows) / std::max<UInt64>(window_nanoseconds, 1);
+    if (throughput < previous_throughput) growing = !growing;
+    previous_throughput = throughput;
+    window_count = 0;
+    window_rows = 0;
+    window_nanoseconds = 0;
+
+    auto next_rows = size_t(growing ? target_rows * step : target_rows / step);
+    target_rows = std::clamp(next_rows, min_rows, max_rows);
+    /// Nothing to find beyond the bounds.
+    if (target_rows == min_rows || target_rows == max_rows) growing = target_rows == min_rows;
+}
+
+Block BlockSquasher::add(Block block) {
+    /// A big block kept by the previous call goes first.
+    Block res = std::move(pending);
+    pending.clear();
+
+    size_t rows = block.rows();
+    if (rows == 0) return res;
+    size_t bytes = block.bytes();
+
+    if (isEnough(rows, bytes)) {
+        if (!res && accumulated_rows == 0) return block;
+        /// Return what was before it, and pass the block as is on the next call.
+        if (!res) res = flush();
+        pending = std::move(block);
+        return res;
+    }
+
+    append(block);
+    if (!res && isEnough(accumulated_rows, accumulated_bytes)) return flush();
+    return res;
+}
+
+void BlockSquasher::append(const Block& block) {
+    size_t rows = block.rows();
+    size_t bytes = block.bytes();
+    if (accumulated_rows == 0) {
+        header = block.cloneEmpty();
+        accumulated = header.cloneEmptyColumns();
+        /// Rows expected until one of the targets is reached, assuming rows of the same size.
+        size_t expected_rows = min_rows;
+        if (bytes) expected_rows = std::min(expected_rows, min_bytes / (bytes / rows + 1) + 1);
+        for (auto& column : accumulated) column->reserve(std::max(expected_rows, rows));
+    }
+
+    for (size_t i = 0; i < accumulated.size(); ++i)
+        accumulated[i]->insertRangeFrom(*block.getByPosition(i).column, 0, rows);
+    accumulated_rows += rows;
+    accumulated_bytes += bytes;
+}
+
+Block BlockSquasher::flush() {
+    if (pending) {
+        /// Nothing is accumulated after a pending block until it is returned.
+        Block res = std::move(pending);
+        pending.clear();
+        return res;
+    }
+    if (accumulated_rows == 0) return {};
+    Block res = header.cloneWithColumns(std::move(accumulated));
+    accumulated.clear();
+    accumulated_rows = 0;
+    accumulated_bytes = 0;
+    return res;
+}
+
+bool BlockSplitter::next(Block& piece, size_t max_rows) {
+    size_t rows = block.rows();
+    if (offset >= rows) return false;
+
+    max_rows = std::max<size_t>(max_rows, 1);
+    size_t length = rows - offset;
+    if (length > max_rows + max_rows / 2) length = max_rows;
+
+    if (length == rows) {
+        piece = std::move(block);
+        block.clear();
+        return true;
+    }
+
+    piece = block.cut(offset, length);
+    offset += length;
+    if (offset == rows) block.clear();
+    return true;
+}
+
+AsyncSquashingOperator::AsyncSquashingOperator(AsyncOperatorPtr child_,
+                                               const BlockSizeSettings& settings)
+        : child(std::move(child_)), size(settings), squasher(size.getRows(), size.getBytes()) {}
+
+PollStatus AsyncSquashingOperator::poll(Block& block, AsyncContext& context) {
+    UInt64 start = clockMonotonicNanoseconds();
+    auto status = pollImpl(block, context);
+    work_nanoseconds += clockMonotonicNanoseconds() - start;
+    if (status == PollStatus::Ready) {
+        size.update(block.rows(), block.bytes(), work_nanoseconds);
+        work_nanoseconds = 0;
+        squasher.setTargets(size.getRows(), size.getBytes());
+    }
+    return status;
+}
+
+PollStatus AsyncSquashingOperator::pollImpl(Block& block, AsyncContext& context) {
+    Block res;
+    while (!child_finished && !res) {
+        Block input;
+        auto status = child->poll(input, context);
+        if (status == PollStatus::Pending) return status;
+        if (status == PollStatus::Finished)
+            child_finished = true;
+        else
+            res = squasher.add(std::move(input));
+    }
+    if (!res) res = squasher.flush();
+    if (!res) return PollStatus::Finished;
+
+    block = std::move(res);
+    return PollStatus::Ready;
+}
+
+AsyncSplittingOperator::AsyncSplittingOperator(AsyncOperatorPtr child_,
+                                               const BlockSizeSettings& settings)
+        : child(std::move(child_)), size(settings) {}
+
+PollStatus AsyncSplittingOperator::poll(Block& block, AsyncContext& context) {
+    UInt64 start = clockMonotonicNanoseconds();
+    auto status = pollImpl(block, context);
+    work_nanoseconds += clockMonotonicNanoseconds() - start;
+    if (status == PollStatus::Ready) {
+        size.update(block.rows(), block.bytes(), work_nanoseconds);
+        work_nanoseconds = 0;
+    }
+    return status;
+}
+
+PollStatus AsyncSplittingOperator::pollImpl(Block& block, AsyncContext& context) {
+    while (!splitter.next(block, size.getRows())) {
+        Block input;
+        auto status = child->poll(input, context);
+        if (status != PollStatus::Ready) return status;
+        splitter.setBlock(std::move(input));
+    }
+    return PollStatus::Ready;
+}
+
+} // namespace doris::vectorized
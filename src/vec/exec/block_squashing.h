@@ -0,0 +1,184 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/core/block.h"
+#include "vec/core/types.h"
+#include "vec/exec/async_operator.h"
+
+namespace doris::vectorized {
+
+struct BlockSizeSettings {
+    /// Bounds of the number of rows in a block.
+    size_t min_rows = 1024;
+    size_t max_rows = 65536;
+    /// Starting point of the adaptation, or the fixed number of rows without it.
+    size_t initial_rows = 8192;
+    /// Blocks are kept below this size, so that the columns being processed together stay
+    /// in the cache. 0 means the size of the L2 cache.
+    size_t max_bytes = 0;
+    /// Adjust the number of rows to the measured throughput.
+    bool adaptive = true;
+};
+
+/// Size of the L2 cache of the CPU, or 1 MiB if it is unknown.
+size_t getL2CacheSize();
+
+/** Number of rows of the blocks to produce, chosen by hill climbing on the throughput
+  * of the consumer: the rows per nanosecond over a window of blocks are compared with
+  * the previous window, and the size keeps moving in the same direction while it helps
+  * and turns back when it does not. The result is also limited by max_bytes,
+  * with the average size of a row seen so far.
+  */
+class AdaptiveBlockSize {
+public:
+    explicit AdaptiveBlockSize(const BlockSizeSettings& settings_ = {});
+
+    size_t getRows() const;
+    size_t getBytes() const { return max_bytes; }
+
+    /// Reports that a block was processed by the consumer in the given time.
+    void update(size_t rows, size_t bytes, UInt64 nanoseconds);
+
+private:
+    static constexpr size_t window_blocks = 8;
+    static constexpr double step = 1.25;
+
+    const size_t min_rows;
+    const size_t max_rows;
+    const size_t max_bytes;
+    const bool adaptive;
+
+    size_t target_rows;
+    bool growing = true;
+    double previous_throughput = 0;
+
+    size_t window_count = 0;
+    size_t window_rows = 0;
+    UInt64 window_nanoseconds = 0;
+
+    size_t total_rows = 0;
+    size_t total_bytes = 0;
+};
+
+/** Concatenates small blocks into bigger ones with insertRangeFrom, with the columns
+  * reserved for the target number of rows in advance. Every block must have the same
+  * structure.
+  */
+class BlockSquasher {
+public:
+    BlockSquasher(size_t min_rows_, size_t min_bytes_)
+            : min_rows(min_rows_), min_bytes(min_bytes_) {}
+
+    /// Returns a block of at least min_rows rows or min_bytes bytes when there is one,
+    /// otherwise an empty block. A block that is big enough by itself is never copied:
+    /// if rows are accumulated before it, they are returned first, and the block is
+    /// returned as is by the next call of add() or flush().
+    Block add(Block block);
+    /// Returns the rest, possibly empty. Call until it returns an empty block.
+    Block flush();
+
+    void setTargets(size_t min_rows_, size_t min_bytes_) {
+        min_rows = min_rows_;
+        min_bytes = min_bytes_;
+    }
+
+private:
+    bool isEnough(size_t rows, size_t bytes) const {
+        return rows >= min_rows || bytes >= min_bytes;
+    }
+    void append(const Block& block);
+
+    size_t min_rows;
+    size_t min_bytes;
+
+    Block header;
+    MutableColumns accumulated;
+    size_t accumulated_rows = 0;
+    size_t accumulated_bytes = 0;
+    /// A big block that waits for the accumulated rows before it to be returned.
+    Block pending;
+};
+
+/** Cuts a block into pieces of at most max_rows rows (IColumn::cut). A tail smaller than
+  * half of max_rows is attached to the previous piece.
+  */
+class BlockSplitter {
+public:
+    void setBlock(Block block_) {
+        block = std::move(block_);
+        offset = 0;
+    }
+
+    /// False when the whole block has been returned.
+    bool next(Block& piece, size_t max_rows);
+
+private:
+    Block block;
+    size_t offset = 0;
+};
+
+/// Squashes the blocks of the child to the size of AdaptiveBlockSize, measured by the time
+/// spent in poll() to produce a block. The time the task is suspended or the parent
+/// works in between is not counted.
+class AsyncSquashingOperator : public IAsyncOperator {
+public:
+    AsyncSquashingOperator(AsyncOperatorPtr child_, const BlockSizeSettings& settings = {});
+
+    String getName() const override { return "Squashing"; }
+
+    PollStatus poll(Block& block, AsyncContext& context) override;
+
+    const AdaptiveBlockSize& getBlockSize() const { return size; }
+
+private:
+    PollStatus pollImpl(Block& block, AsyncContext& context);
+
+    AsyncOperatorPtr child;
+    AdaptiveBlockSize size;
+    BlockSquasher squasher;
+    bool child_finished = false;
+
+    /// Spent in poll() since the last returned block.
+    UInt64 work_nanoseconds = 0;
+};
+
+/// Splits the blocks of the child to the size of AdaptiveBlockSize, measured by the time
+/// spent in poll() to produce a block, as in AsyncSquashingOperator.
+class AsyncSplittingOperator : public IAsyncOperator {
+public:
+    AsyncSplittingOperator(AsyncOperatorPtr child_, const BlockSizeSettings& settings = {});
+
+    String getName() const override { return "Splitting"; }
+
+    PollStatus poll(Block& block, AsyncContext& context) override;
+
+    const AdaptiveBlockSize& getBlockSize() const { return size; }
+
+private:
+    PollStatus pollImpl(Block& block, AsyncContext& context);
+
+    AsyncOperatorPtr child;
+    AdaptiveBlockSize size;
+    BlockSplitter splitter;
+
+    /// Spent in poll() since the last returned block.
+    UInt64 work_nanoseconds = 0;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,126 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/block_transform.h"
+
+#include "vec/columns/column_rle.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+}
+
+void ExpressionTransform::transform(Block& block, size_t) {
+    block.insert({nullptr, function->getReturnType(), function->getName()});
+    function->execute(block, arguments, block.columns() - 1, block.rows());
+}
+
+void FilterTransform::transform(Block& block, size_t) {
+    Block::filter_block(&block, filter_column, columns_to_keep);
+}
+
+PartialAggregateTransform::PartialAggregateTransform(std::vector<AggregateFunctionPtr> functions_,
+                                                     std::vector<ColumnNumbers> arguments_,
+                                                     size_t num_workers)
+        : functions(std::move(functions_)), arguments(std::move(arguments_)) {
+    if (functions.size() != arguments.size())
+        throw Exception("Aggregate functions and their arguments do not match",
+                        ErrorCodes::LOGICAL_ERROR);
+
+    for (const auto& function : functions) {
+        total_size = (total_size + function->alignOfData() - 1) / function->alignOfData() *
+                     function->alignOfData();
+        offsets.push_back(total_size);
+        total_size += function->sizeOfData();
+        align = std::max(align, function->alignOfData());
+    }
+
+    for (size_t i = 0; i < num_workers; ++i) {
+        auto state = std::make_unique<WorkerState>();
+        state->place = state->arena.alignedAlloc(total_size, align);
+        for (size_t j = 0; j < functions.size(); ++j)
+            functions[j]->create(state->place + offsets[j]);
+        states.push_back(std::move(state));
+    }
+}
+
+PartialAggregateTransform::~PartialAggregateTransform() {
+    for (auto& state : states)
+        for (size_t i = 0; i < functions.size(); ++i)
+            functions[i]->destroy(state->place + offsets[i]);
+}
+
+void PartialAggregateTransform::transform(Block& block, size_t worker) {
+    auto& state = *states[worker];
+    Columns full_columns;
+    std::vector<const IColumn*> columns;
+    for (size_t i = 0; i < functions.size(); ++i) {
+        AggregateDataPtr place = state.place + offsets[i];
+        columns.clear();
+
+        /// If all the arguments have the same runs, every run is added at once.
+        const ColumnRLE* runs = nullptr;
+        for (auto position : arguments[i]) {
+            const auto* rle = typeid_cast<const ColumnRLE*>(
+                    block.getByPosition(position).column.get());
+            if (!rle || (runs && !rle->hasSameRuns(*runs))) {
+                runs = nullptr;
+                break;
+            }
+            runs = rle;
+            columns.push_back(&rle->getValuesColumn());
+        }
+        if (runs) {
+            const auto& ends = runs->getEndsData();
+            for (size_t run = 0, begin = 0; run < ends.size(); begin = ends[run++])
+                functions[i]->addMany(place, columns.data(), run, ends[run] - begin,
+                                      &state.arena);
+            continue;
+        }
+
+        /// Aggregate functions work only with concrete columns.
+        columns.clear();
+        for (auto position : arguments[i]) {
+            const auto& column = block.getByPosition(position).column;
+            full_columns.push_back(column->convertToFullColumnIfConst()
+                                           ->convertToFullColumnIfSparse()
+                                           ->convertToFullColumnIfRLE());
+            columns.push_back(full_columns.back().get());
+        }
+        functions[i]->addBatchSinglePlace(block.rows(), place, columns.data(), &state.arena);
+    }
+    block.clear();
+}
+
+Block PartialAggregateTransform::finalize() {
+    auto& result = *states[0];
+    for (size_t worker = 1; worker < states.size(); ++worker)
+        for (size_t i = 0; i < functions.size(); ++i)
+            functions[i]->merge(result.place + offsets[i], states[worker]->place + offsets[i],
+                                &result.arena);
+
+    Block block;
+    for (size_t i = 0; i < functions.size(); ++i) {
+        auto column = functions[i]->getReturnType()->createColumn();
+        functions[i]->insertResultInto(result.place + offsets[i], *column);
+        block.insert({std::move(column), functions[i]->getReturnType(), functions[i]->getName()});
+    }
+    return block;
+}
+
+} // namespace doris::vectorized
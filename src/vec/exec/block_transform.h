@@ -0,0 +1,110 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/common/arena.h"
+#include "vec/core/block.h"
+#include "vec/functions/function.h"
+
+namespace doris::vectorized {
+
+/** A step of a pipeline, applied to every morsel (a small block) of the input.
+  * The same transform is executed by many threads at once, each with its own block.
+  */
+class IBlockTransform {
+public:
+    virtual ~IBlockTransform() = default;
+
+    virtual String getName() const = 0;
+
+    /// worker is the index of the thread in [0, num_workers), for per-thread state.
+    /// If the transform leaves the block without rows, the following ones are skipped.
+    virtual void transform(Block& block, size_t worker) = 0;
+};
+
+using BlockTransformPtr = std::shared_ptr<IBlockTransform>;
+using BlockTransforms = std::vector<BlockTransformPtr>;
+
+/// Executes a function and appends its result to the block.
+class ExpressionTransform : public IBlockTransform {
+public:
+    ExpressionTransform(FunctionBasePtr function_, ColumnNumbers arguments_)
+            : function(std::move(function_)), arguments(std::move(arguments_)) {}
+
+    String getName() const override { return "Expression"; }
+
+    void transform(Block& block, size_t worker) override;
+
+private:
+    FunctionBasePtr function;
+    ColumnNumbers arguments;
+};
+
+/// Keeps the rows where the filter column is non-zero, see Block::filter_block.
+class FilterTransform : public IBlockTransform {
+public:
+    FilterTransform(size_t filter_column_, size_t columns_to_keep_)
+            : filter_column(filter_column_), columns_to_keep(columns_to_keep_) {}
+
+    String getName() const override { return "Filter"; }
+
+    void transform(Block& block, size_t worker) override;
+
+private:
+    size_t filter_column;
+    size_t columns_to_keep;
+};
+
+/** Aggregation without keys. Every worker adds morsels into its own states,
+  * so that there is no synchronization, and the states are merged by finalize().
+  * Consumes the blocks.
+  */
+class PartialAggregateTransform : public IBlockTransform {
+public:
+    /// arguments[i] are the positions of the arguments of functions[i] in the input blocks.
+    PartialAggregateTransform(std::vector<AggregateFunctionPtr> functions_,
+                              std::vector<ColumnNumbers> arguments_, size_t num_workers);
+    ~PartialAggregateTransform() override;
+
+    String getName() const override { return "PartialAggregate"; }
+
+    void transform(Block& block, size_t worker) override;
+
+    /// Merges the states of all workers. A block with one row of results.
+    /// Must be called once, after all morsels are processed.
+    Block finalize();
+
+private:
+    struct WorkerState {
+        Arena arena;
+        AggregateDataPtr place = nullptr;
+    };
+
+    std::vector<AggregateFunctionPtr> functions;
+    std::vector<ColumnNumbers> arguments;
+    std::vector<size_t> offsets;
+    size_t total_size = 0;
+    size_t align = 1;
+    std::vector<std::unique_ptr<WorkerState>> states;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/local_exchange.h"
+
+#include "vec/columns/columns_common.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+}
+
+LocalExchange::LocalExchange(size_t num_producers, size_t num_consumers,
+                             ColumnNumbers key_columns_, const LocalExchangeSettings& settings_)
+        : key_columns(std::move(key_columns_)),
+          settings(settings_),
+          active_producers(num_producers) {
+    if (num_producers == 0 || num_consumers == 0)
+        throw Exception("Local exchange must have producers and consumers",
+                        ErrorCodes::LOGICAL_ERROR);
+
+    for (size_t i = 0; i < num_consumers; ++i)
+        queues.push_back(std::make_unique<BlockQueue>(settings.max_blocks_per_consumer,
+                                                      settings.max_bytes_per_consumer));
+    for (size_t i = 0; i < num_producers; ++i)
+        producers.push_back(std::unique_ptr<Producer>(new Producer(*this)));
+}
+
+void LocalExchange::cancel() {
+    for (auto& queue : queues) queue->finish();
+}
+
+LocalExchange::Producer::Producer(LocalExchange& exchange_)
+        : exchange(exchange_),
+          buffers(exchange.queues.size()),
+          buffered_rows(exchange.queues.size()) {}
+
+void LocalExchange::Producer::push(const Block& block) {
+    size_t rows = block.rows();
+    if (rows == 0) return;
+    if (!header) header = block.cloneEmpty();
+
+    size_t num_consumers = exchange.queues.size();
+    if (exchange.key_columns.empty() || num_consumers == 1) {
+        append(next_consumer, block);
+        next_consumer = (next_consumer + 1) % num_consumers;
+        return;
+    }
+
+    std::vector<const IColumn*> keys;
+    for (auto position : exchange.key_columns)
+        keys.push_back(block.getByPosition(position).column.get());
+    hashes.resize(rows);
+    hashColumns(keys.data(), keys.size(), 0, rows, hashes.data());
+    selector.resize(rows);
+    for (size_t row = 0; row < rows; ++row) selector[row] = hashes[row] % num_consumers;
+
+    size_t num_columns = block.columns();
+    std::vector<MutableColumns> parts(num_consumers);
+    for (auto& part : parts) part.resize(num_columns);
+    for (size_t i = 0; i < num_columns; ++i) {
+        auto scattered = block.getByPosition(i).column->scatter(num_consumers, selector);
+        for (size_t consumer = 0; consumer < num_consumers; ++consumer)
+            parts[consumer][i] = std::move(scattered[consumer]);
+    }
+
+    for (size_t consumer = 0; consumer < num_consumers; ++consumer)
+        if (parts[consumer][0]->size() != 0)
+            append(consumer, block.cloneWithColumns(std::move(parts[consumer])));
+}
+
+void LocalExchange::Producer::append(size_t consumer, Block part) {
+    size_t rows = part.rows();
+    size_t& buffered = buffered_rows[consumer];
+    if (buffered == 0 && rows >= exchange.settings.batch_rows) {
+        /// Big enough by itself, no need to copy it.
+        exchange.queues[consumer]->push(std::move(part));
+        return;
+    }
+
+    auto& buffer = buffers[consumer];
+    if (buffered == 0) {
+        buffer = part.mutateColumns();
+    } else {
+        for (size_t i = 0; i < buffer.size(); ++i)
+            buffer[i]->insertRangeFrom(*part.getByPosition(i).column, 0, rows);
+    }
+    buffered += rows;
+
+    if (buffered >= exchange.settings.batch_rows) flush(consumer);
+}
+
+void LocalExchange::Producer::flush(size_t consumer) {
+    if (buffered_rows[consumer] == 0) return;
+    exchange.queues[consumer]->push(header.cloneWithColumns(std::move(buffers[consumer])));
+    buffers[consumer].clear();
+    buffered_rows[consumer] = 0;
+}
+
+void LocalExchange::Producer::finish() {
+    if (finished) return;
+    finished = true;
+
+    for (size_t consumer = 0; consumer < buffers.size(); ++consumer) flush(consumer);
+    if (exchange.active_producers.fetch_sub(1) == 1) exchange.cancel();
+}
+
+void ExchangeSinkTransform::transform(Block& block, size_t worker) {
+    exchange.getProducer(worker).push(block);
+    block.clear();
+}
+
+void ExchangeSinkTransform::finish() {
+    for (size_t i = 0; i < exchange.getNumberOfProducers(); ++i) exchange.getProducer(i).finish();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <boost/noncopyable.hpp>
+#include <memory>
+#include <vector>
+
+#include "vec/common/pod_array.h"
+#include "vec/core/column_numbers.h"
+#include "vec/exec/block_queue.h"
+#include "vec/exec/block_transform.h"
+
+namespace doris::vectorized {
+
+struct LocalExchangeSettings {
+    /// Limits of the queue of every consumer.
+    size_t max_blocks_per_consumer = 16;
+    size_t max_bytes_per_consumer = 64 << 20;
+    /// Rows of a producer for one consumer are accumulated up to this number before they
+    /// are pushed, so that small parts of scattered blocks do not cost an operation of
+    /// the queue each. 0 pushes every part as it is.
+    size_t batch_rows = 8192;
+};
+
+/** Repartitioning of blocks between pipelines of the same query:
+  * every producer splits its blocks by the hash of the key columns, so that all rows with
+  * the same key go to the same consumer, which e.g. can aggregate or join them without
+  * synchronization. Without key columns, whole blocks are distributed round-robin.
+  *
+  * Every consumer has its own BlockQueue. A producer is used by one thread at a time,
+  * a consumer may be popped by several threads.
+  *
+  * Usage:
+  *     LocalExchange exchange(num_producers, num_consumers, {key_position});
+  *     /// in producer thread i
+  *     auto& producer = exchange.getProducer(i);
+  *     while (...) producer.push(block);
+  *     producer.finish();
+  *     /// in consumer thread j
+  *     Block block;
+  *     while (exchange.pop(j, block)) ...;
+  */
+class LocalExchange : private boost::noncopyable {
+public:
+    class Producer : private boost::noncopyable {
+    public:
+        /// Waits while the queue of a consumer is full.
+        /// After cancel() the blocks are dropped.
+        void push(const Block& block);
+        /// Flushes the accumulated rows. The last producer to finish finishes the queues.
+        void finish();
+
+    private:
+        friend class LocalExchange;
+        explicit Producer(LocalExchange& exchange_);
+
+        void append(size_t consumer, Block part);
+        void flush(size_t consumer);
+
+        LocalExchange& exchange;
+        Block header;
+        std::vector<MutableColumns> buffers;
+        std::vector<size_t> buffered_rows;
+        PaddedPODArray<UInt64> hashes;
+        IColumn::Selector selector;
+        size_t next_consumer = 0;
+        bool finished = false;
+    };
+
+    LocalExchange(size_t num_producers, size_t num_consumers, ColumnNumbers key_columns_,
+                  const LocalExchangeSettings& settings_ = {});
+
+    Producer& getProducer(size_t producer) { return *producers[producer]; }
+
+    /// Waits for a block of the consumer. False when all producers are finished
+    /// and the queue is empty.
+    bool pop(size_t consumer, Block& block) { return queues[consumer]->pop(block); }
+
+    /// Finishes all queues: consumers get the rest, producers stop waiting.
+    void cancel();
+
+    size_t getNumberOfProducers() const { return producers.size(); }
+    size_t getNumberOfConsumers() const { return queues.size(); }
+
+private:
+    const ColumnNumbers key_columns;
+    const LocalExchangeSettings settings;
+    std::vector<std::unique_ptr<BlockQueue>> queues;
+    std::vector<std::unique_ptr<Producer>> producers;
+    std::atomic<size_t> active_producers;
+};
+
+/** Sink of a pipeline that sends the morsels to a local exchange, one producer per worker:
+  * the exchange must have as many producers as the thread pool has threads.
+  * finish() is called after the execution of the pipeline.
+  *
+  * The producers wait while the queues are full, so the consumers must not run as jobs
+  * of the same pool, otherwise all workers may wait for each other.
+  */
+class ExchangeSinkTransform : public IBlockTransform {
+public:
+    explicit ExchangeSinkTransform(LocalExchange& exchange_) : exchange(exchange_) {}
+
+    String getName() const override { return "ExchangeSink"; }
+
+    void transform(Block& block, size_t worker) override;
+
+    /// Finishes all producers of the exchange.
+    void finish();
+
+private:
+    LocalExchange& exchange;
+};
+
+} // namespace doris::vectorized
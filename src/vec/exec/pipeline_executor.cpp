@@ -0,0 +1,158 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/pipeline_executor.h"
+
+#include <optional>
+
+#include "vec/common/query_trace.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+}
+
+namespace {
+
+/// Enables the profile and the trace of the query in a pool thread for the time of a job.
+class QueryScopes : private boost::noncopyable {
+public:
+    QueryScopes(QueryProfile* profile, QueryTrace* trace) {
+        if (profile) profile_scope.emplace(*profile);
+        if (trace) trace_scope.emplace(*trace);
+    }
+
+private:
+    std::optional<QueryProfile::Scope> profile_scope;
+    std::optional<QueryTrace::Scope> trace_scope;
+};
+
+} // namespace
+
+PipelineExecutor::PipelineExecutor(WorkStealingThreadPool& pool_, Source source_,
+                                   BlockTransforms transforms_, const PipelineSettings& settings_)
+        : pool(pool_),
+          source(std::move(source_)),
+          transforms(std::move(transforms_)),
+          morsel_rows(std::max<size_t>(settings_.morsel_rows, 1)),
+          max_morsels_in_flight(settings_.max_morsels_in_flight
+                                        ? settings_.max_morsels_in_flight
+                                        : 2 * pool.getNumberOfThreads()) {}
+
+void PipelineExecutor::execute() {
+    if (finished) throw Exception("Pipeline is already executed", ErrorCodes::LOGICAL_ERROR);
+
+    profile = QueryProfile::current();
+    trace = QueryTrace::current();
+
+    /// The slot of this thread, as if it was a morsel that has just finished.
+    morsels_in_flight.store(1);
+    scheduleMorsels();
+    finishMorsel();
+
+    std::unique_lock lock(finish_mutex);
+    finish_cv.wait(lock, [&] { return finished; });
+    if (exception) std::rethrow_exception(exception);
+}
+
+void PipelineExecutor::scheduleMorsels() {
+    while (!isCancelled()) {
+        /// The caller holds a slot which it is about to release, hence + 1.
+        size_t in_flight = morsels_in_flight.load();
+        do {
+            if (in_flight >= max_morsels_in_flight + 1) return;
+        } while (!morsels_in_flight.compare_exchange_weak(in_flight, in_flight + 1));
+
+        Block morsel;
+        bool has_morsel = false;
+        try {
+            has_morsel = getNextMorsel(morsel);
+        } catch (...) {
+            onException();
+        }
+        if (!has_morsel) {
+            finishMorsel();
+            return;
+        }
+
+        pool.schedule([this, morsel = std::move(morsel)]() mutable {
+            {
+                QueryScopes scopes(profile, trace);
+                if (!isCancelled()) processMorsel(morsel);
+                /// Before the slot is released, so that the execution cannot finish in between.
+                scheduleMorsels();
+            }
+            finishMorsel();
+        });
+    }
+}
+
+bool PipelineExecutor::getNextMorsel(Block& morsel) {
+    std::lock_guard lock(source_mutex);
+    while (current_offset >= current_block.rows()) {
+        if (source_finished) return false;
+        current_block = source();
+        current_offset = 0;
+        if (!current_block) {
+            source_finished = true;
+            return false;
+        }
+    }
+
+    size_t rows = current_block.rows();
+    size_t length = rows - current_offset;
+    /// Do not leave a tiny morsel at the end of the block.
+    if (length > morsel_rows + morsel_rows / 2) length = morsel_rows;
+
+    if (length == rows)
+        morsel = current_block;
+    else
+        morsel = current_block.cut(current_offset, length);
+    current_offset += length;
+    return true;
+}
+
+void PipelineExecutor::processMorsel(Block& morsel) {
+    TraceScope trace_scope("PipelineExecutor::processMorsel", morsel.rows());
+    size_t worker = *pool.getCurrentWorker();
+    size_t rows = morsel.rows();
+    try {
+        for (const auto& transform : transforms) {
+            if (morsel.rows() == 0) break;
+            transform->transform(morsel, worker);
+        }
+        processed_rows.fetch_add(rows, std::memory_order_relaxed);
+    } catch (...) {
+        onException();
+    }
+}
+
+void PipelineExecutor::finishMorsel() {
+    if (morsels_in_flight.fetch_sub(1) != 1) return;
+    std::lock_guard lock(finish_mutex);
+    finished = true;
+    finish_cv.notify_all();
+}
+
+void PipelineExecutor::onException() {
+    std::lock_guard lock(finish_mutex);
+    if (!exception) exception = std::current_exception();
+    cancel();
+}
+
+} // namespace doris::vectorized
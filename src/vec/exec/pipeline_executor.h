@@ -0,0 +1,118 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <boost/noncopyable.hpp>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/exec/block_transform.h"
+
+namespace doris::vectorized {
+
+class QueryProfile;
+class QueryTrace;
+
+struct PipelineSettings {
+    /// Blocks of the source are cut into morsels of about this number of rows.
+    size_t morsel_rows = 4096;
+    /// Limit of morsels taken from the source and not processed yet. It bounds the memory
+    /// of a fast source with slow transforms. 0 means twice the number of threads.
+    size_t max_morsels_in_flight = 0;
+};
+
+/** Morsel-driven execution of a pipeline: source -> transform -> ... -> transform.
+  *
+  * Blocks of the source are cut into morsels, and every morsel is a job in the thread pool
+  * which runs all the transforms over it. When a worker finishes a morsel, it takes
+  * the next morsels from the source into its own deque, so that a morsel is processed
+  * by the same worker (and NUMA node) as the one before, and idle workers steal the rest.
+  * Reading of the source is serialized, transforms run in parallel.
+  *
+  * The query profile and trace enabled in the thread that calls execute() are enabled
+  * in the pool threads while they run the jobs of the pipeline.
+  *
+  * The last transform is normally a sink that consumes the blocks
+  * (e.g. PartialAggregateTransform), rows left after it are dropped.
+  *
+  * Usage:
+  *     auto aggregate = std::make_shared<PartialAggregateTransform>(
+  *             functions, arguments, pool.getNumberOfThreads());
+  *     PipelineExecutor executor(pool, source, {filter, expression, aggregate});
+  *     executor.execute();
+  *     Block result = aggregate->finalize();
+  */
+class PipelineExecutor : private boost::noncopyable {
+public:
+    /// Returns the next block of the input, or a block without columns at the end.
+    /// Called under a lock, never by two threads at once.
+    using Source = std::function<Block()>;
+
+    PipelineExecutor(WorkStealingThreadPool& pool_, Source source_, BlockTransforms transforms_,
+                     const PipelineSettings& settings_ = {});
+
+    /// Blocks until all morsels are processed or the execution is cancelled.
+    /// Rethrows the first exception of the source or transforms, which cancels the execution.
+    void execute();
+
+    /// Thread-safe. Morsels being processed are finished, the others are skipped.
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    /// Rows of the source in the morsels that went through all the transforms.
+    size_t getProcessedRows() const { return processed_rows.load(std::memory_order_relaxed); }
+
+private:
+    /// Takes morsels from the source and schedules them, while there is room for them.
+    void scheduleMorsels();
+    bool getNextMorsel(Block& morsel);
+    void processMorsel(Block& morsel);
+    /// Releases the slot of a morsel in flight, the last one finishes the execution.
+    void finishMorsel();
+    void onException();
+
+    WorkStealingThreadPool& pool;
+    const Source source;
+    const BlockTransforms transforms;
+    const size_t morsel_rows;
+    const size_t max_morsels_in_flight;
+
+    std::mutex source_mutex;
+    Block current_block;
+    size_t current_offset = 0;
+    bool source_finished = false;
+
+    /// Of the thread that called execute().
+    QueryProfile* profile = nullptr;
+    QueryTrace* trace = nullptr;
+
+    std::atomic<size_t> morsels_in_flight{0};
+    std::atomic<size_t> processed_rows{0};
+    std::atomic<bool> cancelled{false};
+
+    std::mutex finish_mutex;
+    std::condition_variable finish_cv;
+    bool finished = false;
+    std::exception_ptr exception;
+};
+
+} // namespace doris::vectorized
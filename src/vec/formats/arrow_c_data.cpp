@@ -0,0 +1,524 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/arrow_c_data.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_common.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/common/unaligned.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int BAD_ARGUMENTS;
+extern const int INCORRECT_DATA;
+extern const int NOT_IMPLEMENTED;
+} // namespace ErrorCodes
+
+namespace {
+
+/// Writes bit i of bitmap, counted from bit_offset, to out[i] as 0 or 1, inverted if invert.
+void unpackBits(const UInt8* bitmap, size_t bit_offset, size_t size, UInt8* out, bool invert) {
+    size_t i = 0;
+#ifdef __SSE2__
+    if (bit_offset % 8 == 0) {
+        const UInt8* pos = bitmap + bit_offset / 8;
+        const __m128i bits =
+                _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+        const __m128i zero16 = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi8(1);
+        const __m128i flip = invert ? ones : zero16;
+        /// Every byte of the bitmap is repeated 8 times and every copy is tested for its bit.
+        for (; i + 16 <= size; i += 16, pos += 2) {
+            __m128i bytes = _mm_set_epi64x(Int64(0x0101010101010101ULL * pos[1]),
+                                           Int64(0x0101010101010101ULL * pos[0]));
+            __m128i unset = _mm_cmpeq_epi8(_mm_and_si128(bytes, bits), zero16);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                             _mm_xor_si128(_mm_andnot_si128(unset, ones), flip));
+        }
+    }
+#endif
+    for (; i < size; ++i) {
+        size_t bit = bit_offset + i;
+        out[i] = ((bitmap[bit / 8] >> (bit % 8)) & 1) ^ invert;
+    }
+}
+
+/// Private data of the exported structures. Their destructors release the children, so
+/// partially exported structures are cleaned up as well.
+struct ExportedSchema {
+    String format;
+    String name;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> child_pointers;
+
+    ~ExportedSchema() {
+        for (auto& child : children)
+            if (child.release) child.release(&child);
+    }
+};
+
+struct ExportedArray {
+    /// The columns whose memory is used by the buffers. A column is not changed while it is
+    /// shared, because IColumn::mutate() copies it.
+    std::vector<ColumnPtr> columns;
+    /// Buffers made for the export.
+    PaddedPODArray<UInt8> validity;
+    PaddedPODArray<Int64> offsets;
+    PaddedPODArray<UInt8> chars;
+
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> child_pointers;
+
+    ~ExportedArray() {
+        for (auto& child : children)
+            if (child.release) child.release(&child);
+    }
+};
+
+void releaseSchema(ArrowSchema* schema) {
+    delete static_cast<ExportedSchema*>(schema->private_data);
+    schema->release = nullptr;
+}
+
+void releaseArray(ArrowArray* array) {
+    delete static_cast<ExportedArray*>(array->private_data);
+    array->release = nullptr;
+}
+
+ExportedSchema& initSchema(ArrowSchema* schema, const String& format, const String& name,
+                           Int64 flags, size_t num_children) {
+    auto exported = std::make_unique<ExportedSchema>();
+    exported->format = format;
+    exported->name = name;
+    exported->children.resize(num_children);
+    for (auto& child : exported->children) exported->child_pointers.push_back(&child);
+
+    *schema = {};
+    schema->format = exported->format.c_str();
+    schema->name = exported->name.c_str();
+    schema->flags = flags;
+    schema->n_children = num_children;
+    schema->children = exported->child_pointers.data();
+    schema->release = releaseSchema;
+    schema->private_data = exported.get();
+    return *exported.release();
+}
+
+ExportedArray& initArray(ArrowArray* array, size_t length, size_t num_buffers,
+                         size_t num_children) {
+    auto exported = std::make_unique<ExportedArray>();
+    exported->buffers.resize(num_buffers);
+    exported->children.resize(num_children);
+    for (auto& child : exported->children) exported->child_pointers.push_back(&child);
+
+    *array = {};
+    array->length = length;
+    array->n_buffers = num_buffers;
+    array->n_children = num_children;
+    array->buffers = exported->buffers.data();
+    array->children = exported->child_pointers.data();
+    array->release = releaseArray;
+    array->private_data = exported.get();
+    return *exported.release();
+}
+
+const char* numberFormat(const WhichDataType& which) {
+    if (which.isInt8()) return "c";
+    if (which.isUInt8()) return "C";
+    if (which.isInt16()) return "s";
+    if (which.isUInt16()) return "S";
+    if (which.isInt32()) return "i";
+    if (which.isUInt32()) return "I";
+    if (which.isInt64()) return "l";
+    if (which.isUInt64()) return "L";
+    if (which.isFloat32()) return "f";
+    if (which.isFloat64()) return "g";
+    return nullptr;
+}
+
+DataTypePtr numberType(char format) {
+    switch (format) {
+    case 'c':
+        return std::make_shared<DataTypeInt8>();
+    case 'C':
+        return std::make_shared<DataTypeUInt8>();
+    case 's':
+        return std::make_shared<DataTypeInt16>();
+    case 'S':
+        return std::make_shared<DataTypeUInt16>();
+    case 'i':
+        return std::make_shared<DataTypeInt32>();
+    case 'I':
+        return std::make_shared<DataTypeUInt32>();
+    case 'l':
+        return std::make_shared<DataTypeInt64>();
+    case 'L':
+        return std::make_shared<DataTypeUInt64>();
+    case 'f':
+        return std::make_shared<DataTypeFloat32>();
+    case 'g':
+        return std::make_shared<DataTypeFloat64>();
+    default:
+        return nullptr;
+    }
+}
+
+template <typename T>
+bool decimalFormat(const IDataType& type, String& format) {
+    const auto* decimal = typeid_cast<const DataTypeDecimal<T>*>(&type);
+    if (!decimal) return false;
+    format = "d:" + std::to_string(decimal->getPrecision()) + "," +
+             std::to_string(decimal->getScale());
+    return true;
+}
+
+/// Arrow has decimal32 and decimal64 only since recent versions, so all decimals are exported
+/// as decimal128.
+template <typename T>
+ColumnPtr toDecimal128(const ColumnPtr& column) {
+    const auto* decimals = typeid_cast<const ColumnDecimal<T>*>(column.get());
+    if (!decimals) return column;
+    const auto& data = decimals->getData();
+    auto res = ColumnDecimal<Decimal128>::create(data.size(), data.getScale());
+    auto& res_data = res->getData();
+    for (size_t i = 0; i < data.size(); ++i) res_data[i] = Decimal128(Int128(data[i].value));
+    return res;
+}
+
+void exportColumn(const ColumnWithTypeAndName& column, ArrowSchema* schema, ArrowArray* array) {
+    ColumnPtr data = column.column->convertToFullColumnIfConst()
+                             ->convertToFullColumnIfSparse()
+                             ->convertToFullColumnIfRLE();
+    const auto* nullable = typeid_cast<const ColumnNullable*>(data.get());
+    ColumnPtr values = nullable ? nullable->getNestedColumnPtr() : data;
+    DataTypePtr values_type = removeNullable(column.type);
+    WhichDataType which(values_type);
+
+    String format;
+    if (which.isString())
+        format = "U";
+    else if (const char* number = numberFormat(which))
+        format = number;
+    else if (!decimalFormat<Decimal32>(*values_type, format) &&
+             !decimalFormat<Decimal64>(*values_type, format) &&
+             !decimalFormat<Decimal128>(*values_type, format))
+        throw Exception("Column " + column.name + " of type " + column.type->getName() +
+                                " cannot be exported to Arrow",
+                        ErrorCodes::NOT_IMPLEMENTED);
+
+    size_t rows = data->size();
+    initSchema(schema, format, column.name, nullable ? ARROW_FLAG_NULLABLE : 0, 0);
+    auto& exported = initArray(array, rows, which.isString() ? 3 : 2, 0);
+
+    if (nullable) {
+        const auto& null_map = nullable->getNullMapData();
+        exported.validity.resize((rows + 7) / 8);
+        nullMapToValidityBitmap(null_map.data(), rows, exported.validity.data());
+        array->null_count = countBytesInFilter(null_map);
+        exported.buffers[0] = exported.validity.data();
+    }
+
+    if (which.isString()) {
+        /// Strings without the terminating zeros, with the offsets of their starts.
+        const auto& strings = assert_cast<const ColumnString&>(*values);
+        const auto& src_offsets = strings.getOffsets();
+        const auto& src_chars = strings.getChars();
+        exported.offsets.resize(rows + 1);
+        exported.chars.resize(src_chars.size() - rows);
+        exported.offsets[0] = 0;
+        size_t pos = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            size_t size = src_offsets[i] - src_offsets[i - 1] - 1;
+            memcpy(exported.chars.data() + pos, &src_chars[src_offsets[i - 1]], size);
+            pos += size;
+            exported.offsets[i + 1] = pos;
+        }
+        exported.buffers[1] = exported.offsets.data();
+        exported.buffers[2] = exported.chars.data();
+        return;
+    }
+
+    values = toDecimal128<Decimal64>(toDecimal128<Decimal32>(values));
+    exported.columns.push_back(values);
+    exported.buffers[1] = values->getRawData().data;
+}
+
+template <size_t ELEMENT_SIZE>
+void insertValues(ColumnVectorHelper& column, const char* data, size_t n,
+                  const std::shared_ptr<const void>& owner) {
+    if (owner && reinterpret_cast<uintptr_t>(data) % ELEMENT_SIZE == 0)
+        column.borrowRawData<ELEMENT_SIZE>(data, n, owner);
+    else
+        column.insertRawData<ELEMENT_SIZE>(data, n);
+}
+
+/// Fills an empty ColumnVector or ColumnDecimal, in place if owner is set.
+void insertValues(IColumn& column, const char* data, size_t n,
+                  const std::shared_ptr<const void>& owner) {
+    auto& helper = static_cast<ColumnVectorHelper&>(column);
+    switch (column.sizeOfValueIfFixed()) {
+    case 1:
+        insertValues<1>(helper, data, n, owner);
+        break;
+    case 2:
+        insertValues<2>(helper, data, n, owner);
+        break;
+    case 4:
+        insertValues<4>(helper, data, n, owner);
+        break;
+    case 8:
+        insertValues<8>(helper, data, n, owner);
+        break;
+    case 16:
+        insertValues<16>(helper, data, n, owner);
+        break;
+    default:
+        throw Exception("Values of column " + column.getName() + " cannot be imported from Arrow",
+                        ErrorCodes::NOT_IMPLEMENTED);
+    }
+}
+
+/// Arrow decimals of another width than the column.
+template <typename T>
+bool convertDecimals(IColumn& column, const char* data, size_t width, size_t n) {
+    auto* decimals = typeid_cast<ColumnDecimal<T>*>(&column);
+    if (!decimals) return false;
+    auto& res = decimals->getData();
+    res.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const char* pos = data + i * width;
+        Int128 value = width == 4   ? unalignedLoad<Int32>(pos)
+                       : width == 8 ? unalignedLoad<Int64>(pos)
+                                    : unalignedLoad<Int128>(pos);
+        res[i] = T(static_cast<typename T::NativeType>(value));
+    }
+    return true;
+}
+
+ColumnWithTypeAndName importColumn(const ArrowArray& array, const ArrowSchema& schema,
+                                   size_t first, size_t rows,
+                                   const std::shared_ptr<const void>& owner) {
+    String format = schema.format ? schema.format : "";
+    String name = schema.name ? schema.name : "";
+    auto throw_incorrect = [&](const String& what) {
+        throw Exception("Arrow array of column " + name + " " + what,
+                        ErrorCodes::INCORRECT_DATA);
+    };
+
+    if (schema.dictionary || array.dictionary)
+        throw Exception("Column " + name + " is dictionary-encoded, which is not supported",
+                        ErrorCodes::NOT_IMPLEMENTED);
+    if (array.length < 0 || array.offset < 0 || first + rows > size_t(array.length))
+        throw_incorrect("has " + std::to_string(array.length) + " rows instead of " +
+                        std::to_string(first + rows));
+    size_t offset = array.offset + first;
+
+    auto get_buffer = [&](size_t index) {
+        if (size_t(array.n_buffers) <= index)
+            throw_incorrect("has " + std::to_string(array.n_buffers) + " buffers");
+        const char* buffer = static_cast<const char*>(array.buffers[index]);
+        if (!buffer && rows) throw_incorrect("has no buffer " + std::to_string(index));
+        return buffer;
+    };
+
+    DataTypePtr type;
+    MutableColumnPtr values;
+    if (format.size() == 1 && (type = numberType(format[0]))) {
+        values = type->createColumn();
+        if (rows)
+            insertValues(*values, get_buffer(1) + offset * values->sizeOfValueIfFixed(), rows,
+                         owner);
+    } else if (format == "b") {
+        type = std::make_shared<DataTypeUInt8>();
+        auto bools = ColumnUInt8::create(rows);
+        if (rows)
+            unpackBits(reinterpret_cast<const UInt8*>(get_buffer(1)), offset, rows,
+                       bools->getData().data(), false);
+        values = std::move(bools);
+    } else if (format == "u" || format == "U" || format == "z" || format == "Z") {
+        bool large = format == "U" || format == "Z";
+        type = std::make_shared<DataTypeString>();
+        auto strings = ColumnString::create();
+        if (rows) {
+            const char* offsets_buffer = get_buffer(1);
+            const char* chars_buffer = get_buffer(2);
+            auto offset_at = [&](size_t i) -> Int64 {
+                return large ? unalignedLoad<Int64>(offsets_buffer + (offset + i) * 8)
+                             : unalignedLoad<Int32>(offsets_buffer + (offset + i) * 4);
+            };
+            Int64 begin = offset_at(0);
+            Int64 end = offset_at(rows);
+            if (begin < 0 || end < begin) throw_incorrect("has broken offsets");
+
+            /// The strings are copied to add the terminating zeros.
+            auto& chars = strings->getChars();
+            auto& offsets = strings->getOffsets();
+            chars.resize(end - begin + rows);
+            offsets.resize(rows);
+            size_t pos = 0;
+            Int64 prev = begin;
+            for (size_t i = 0; i < rows; ++i) {
+                Int64 next = offset_at(i + 1);
+                if (next < prev || next > end) throw_incorrect("has broken offsets");
+                memcpy(chars.data() + pos, chars_buffer + prev, next - prev);
+                pos += next - prev;
+                chars[pos++] = 0;
+                offsets[i] = pos;
+                prev = next;
+            }
+        }
+        values = std::move(strings);
+    } else if (format.compare(0, 2, "d:") == 0) {
+        unsigned precision = 0;
+        unsigned scale = 0;
+        unsigned bit_width = 128;
+        int consumed = 0;
+        if ((sscanf(format.c_str(), "d:%u,%u%n", &precision, &scale, &consumed) != 2 ||
+             size_t(consumed) != format.size()) &&
+            (sscanf(format.c_str(), "d:%u,%u,%u%n", &precision, &scale, &bit_width,
+                    &consumed) != 3 ||
+             size_t(consumed) != format.size()))
+            throw_incorrect("has broken format " + format);
+        if (bit_width != 32 && bit_width != 64 && bit_width != 128)
+            throw Exception("Column " + name + " is decimal" + std::to_string(bit_width) +
+                                    ", which is not supported",
+                            ErrorCodes::NOT_IMPLEMENTED);
+
+        type = createDecimal(precision, scale);
+        values = type->createColumn();
+        size_t width = bit_width / 8;
+        if (rows) {
+            const char* data = get_buffer(1) + offset * width;
+            if (width == values->sizeOfValueIfFixed())
+                insertValues(*values, data, rows, owner);
+            else if (!convertDecimals<Decimal32>(*values, data, width, rows) &&
+                     !convertDecimals<Decimal64>(*values, data, width, rows))
+                convertDecimals<Decimal128>(*values, data, width, rows);
+        }
+    } else {
+        throw Exception("Column " + name + " has Arrow format " + format +
+                                ", which is not supported",
+                        ErrorCodes::NOT_IMPLEMENTED);
+    }
+
+    const UInt8* bitmap = nullptr;
+    if (array.null_count != 0 && array.n_buffers > 0)
+        bitmap = static_cast<const UInt8*>(array.buffers[0]);
+    if (!bitmap && !(schema.flags & ARROW_FLAG_NULLABLE)) return {std::move(values), type, name};
+
+    auto null_map = ColumnUInt8::create(rows, 0);
+    if (bitmap && rows)
+        validityBitmapToNullMap(bitmap, offset, rows, null_map->getData().data());
+    return {ColumnNullable::create(std::move(values), std::move(null_map)), makeNullable(type),
+            name};
+}
+
+} // namespace
+
+void nullMapToValidityBitmap(const UInt8* null_map, size_t size, UInt8* bitmap) {
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i zero16 = _mm_setzero_si128();
+    for (; i + 16 <= size; i += 16) {
+        UInt16 valid = _mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(null_map + i)), zero16));
+        unalignedStore<UInt16>(bitmap + i / 8, valid);
+    }
+#endif
+    for (; i < size; i += 8) {
+        UInt8 byte = 0;
+        for (size_t j = 0; j < 8 && i + j < size; ++j) byte |= UInt8(null_map[i + j] == 0) << j;
+        bitmap[i / 8] = byte;
+    }
+}
+
+void validityBitmapToNullMap(const UInt8* bitmap, size_t bit_offset, size_t size,
+                             UInt8* null_map) {
+    unpackBits(bitmap, bit_offset, size, null_map, true);
+}
+
+void exportArrowBlock(const Block& block, ArrowSchema* schema, ArrowArray* array) {
+    schema->release = nullptr;
+    array->release = nullptr;
+    try {
+        auto& exported_schema = initSchema(schema, "+s", "", 0, block.columns());
+        auto& exported_array = initArray(array, block.rows(), 1, block.columns());
+        for (size_t i = 0; i < block.columns(); ++i)
+            exportColumn(block.getByPosition(i), &exported_schema.children[i],
+                         &exported_array.children[i]);
+    } catch (...) {
+        if (schema->release) schema->release(schema);
+        if (array->release) array->release(array);
+        throw;
+    }
+}
+
+Block importArrowBlock(ArrowArray* array, const ArrowSchema* schema,
+                       const ArrowImportSettings& settings) {
+    if (!array->release)
+        throw Exception("Cannot import a released Arrow array", ErrorCodes::BAD_ARGUMENTS);
+
+    /// The array is moved to the holder, which releases it with all its children.
+    std::shared_ptr<const ArrowArray> holder(new ArrowArray(*array), [](const ArrowArray* moved) {
+        auto* released = const_cast<ArrowArray*>(moved);
+        if (released->release) released->release(released);
+        delete released;
+    });
+    array->release = nullptr;
+
+    if (!schema->format || strcmp(schema->format, "+s") != 0)
+        throw Exception("Only a struct array can be imported as a block, not format " +
+                                String(schema->format ? schema->format : ""),
+                        ErrorCodes::NOT_IMPLEMENTED);
+    if (schema->n_children != holder->n_children)
+        throw Exception("Arrow array has " + std::to_string(holder->n_children) +
+                                " children, but its schema has " +
+                                std::to_string(schema->n_children),
+                        ErrorCodes::INCORRECT_DATA);
+    if (holder->null_count > 0)
+        throw Exception("Arrow struct array with nulls cannot be imported as a block",
+                        ErrorCodes::NOT_IMPLEMENTED);
+
+    std::shared_ptr<const void> owner;
+    if (settings.zero_copy) owner = holder;
+
+    Block res;
+    for (Int64 i = 0; i < holder->n_children; ++i)
+        res.insert(importColumn(*holder->children[i], *schema->children[i], holder->offset,
+                                holder->length, owner));
+    return res;
+}
+
+} // namespace doris::vectorized
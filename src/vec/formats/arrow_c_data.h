@@ -0,0 +1,70 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/core/block.h"
+#include "vec/formats/arrow_abi.h"
+
+namespace doris::vectorized {
+
+/** Exchange of blocks through the Arrow C Data Interface, see arrow_abi.h.
+  *
+  * A block is a struct array with a child array for every column, as a record batch.
+  * Types are mapped as:
+  *     Int8 .. UInt64, Float32, Float64    c C s S i I l L f g
+  *     Decimal(P, S)                       d:P,S (decimal128)
+  *     String                              U (large utf8); u, z and Z are also imported
+  *     UInt8                               b (boolean) is also imported
+  *     Nullable(T)                         T with a validity bitmap and ARROW_FLAG_NULLABLE
+  *
+  * Buffers are shared without copies where the layouts match: numbers and Decimal128 in both
+  * directions, and also Decimal32 and Decimal64 on import if Arrow has the same width and
+  * ArrowImportSettings::zero_copy is set.
+  * Strings are always copied, because every string in a ColumnString ends with a zero byte,
+  * and null maps are converted to and from bitmaps.
+  */
+
+/** Fills schema and array with the block. The array keeps references to the columns, and a
+  * column that is shared is copied before it is changed (COW), so the buffers stay valid until
+  * the consumer calls the release callbacks.
+  */
+void exportArrowBlock(const Block& block, ArrowSchema* schema, ArrowArray* array);
+
+struct ArrowImportSettings {
+    /// Use the buffers of the array in place where the layouts match. The array is released
+    /// when all columns that use it are destroyed or changed. Set it only if the producer
+    /// guarantees the padding of PaddedPODArray: every buffer is readable for 15 bytes before
+    /// the first value used (after the offset of a slice) and 16 bytes after the last one.
+    /// Arrow only recommends padding, so buffers are copied by default.
+    bool zero_copy = false;
+};
+
+/** Makes a block from a struct array. The array is moved from, as the specification says:
+  * it is released by the block even if an exception is thrown. The schema is only read.
+  */
+Block importArrowBlock(ArrowArray* array, const ArrowSchema* schema,
+                       const ArrowImportSettings& settings = {});
+
+/// Sets the bit of a row in bitmap if the row is not null. bitmap has (size + 7) / 8 bytes.
+void nullMapToValidityBitmap(const UInt8* null_map, size_t size, UInt8* bitmap);
+
+/// The reverse, for the rows from the bit at bit_offset.
+void validityBitmapToNullMap(const UInt8* bitmap, size_t bit_offset, size_t size,
+                             UInt8* null_map);
+
+} // namespace doris::vectorized
@@ -0,0 +1,324 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/key_condition.h"
+
+#include <algorithm>
+
+#include "vec/common/field_visitors.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int BAD_ARGUMENTS;
+extern const int UNKNOWN_FUNCTION;
+extern const int LOGICAL_ERROR;
+} // namespace ErrorCodes
+
+namespace {
+
+bool less(const Field& lhs, const Field& rhs) {
+    return applyVisitor(FieldVisitorAccurateLess(), lhs, rhs);
+}
+
+bool equals(const Field& lhs, const Field& rhs) {
+    return applyVisitor(FieldVisitorAccurateEquals(), lhs, rhs);
+}
+
+/// Whether a value is on the correct side of a left bound, and of a right bound.
+bool aboveLeft(const Field& value, const Field& left, bool included) {
+    return included ? !less(value, left) : less(left, value);
+}
+
+bool belowRight(const Field& value, const Field& right, bool included) {
+    return included ? !less(right, value) : less(value, right);
+}
+
+[[noreturn]] void throwInvalid() {
+    throw Exception("Invalid key condition: an operator has too few operands",
+                    ErrorCodes::LOGICAL_ERROR);
+}
+
+} // namespace
+
+FieldRange FieldRange::createLeftBounded(const Field& left, bool included) {
+    FieldRange range;
+    range.left = left;
+    range.left_bounded = true;
+    range.left_included = included;
+    return range;
+}
+
+FieldRange FieldRange::createRightBounded(const Field& right, bool included) {
+    FieldRange range;
+    range.right = right;
+    range.right_bounded = true;
+    range.right_included = included;
+    return range;
+}
+
+bool FieldRange::contains(const Field& value) const {
+    return (!left_bounded || aboveLeft(value, left, left_included)) &&
+           (!right_bounded || belowRight(value, right, right_included));
+}
+
+bool FieldRange::intersectsRange(const FieldRange& other) const {
+    /// other is entirely to the left of this range.
+    if (left_bounded && other.right_bounded &&
+        (less(other.right, left) ||
+         (equals(other.right, left) && !(left_included && other.right_included))))
+        return false;
+    /// other is entirely to the right of this range.
+    if (right_bounded && other.left_bounded &&
+        (less(right, other.left) ||
+         (equals(right, other.left) && !(right_included && other.left_included))))
+        return false;
+    return true;
+}
+
+bool FieldRange::containsRange(const FieldRange& other) const {
+    if (left_bounded) {
+        if (!other.left_bounded) return false;
+        if (less(other.left, left)) return false;
+        if (equals(other.left, left) && other.left_included && !left_included) return false;
+    }
+    if (right_bounded) {
+        if (!other.right_bounded) return false;
+        if (less(right, other.right)) return false;
+        if (equals(other.right, right) && other.right_included && !right_included) return false;
+    }
+    return true;
+}
+
+void FieldRange::swapLeftAndRight() {
+    std::swap(left, right);
+    std::swap(left_bounded, right_bounded);
+    std::swap(left_included, right_included);
+}
+
+KeyCondition::KeyCondition(const Block& header_) : header(header_.cloneEmpty()) {}
+
+KeyCondition::KeyFunction KeyCondition::makeCast(const DataTypePtr& from_type,
+                                                 const String& to_type_name) {
+    auto string_type = std::make_shared<DataTypeString>();
+    ColumnsWithTypeAndName arguments {{nullptr, from_type, ""},
+                                      {string_type->createColumnConst(1, to_type_name),
+                                       string_type, ""}};
+    auto function = SimpleFunctionFactory::instance().get_function("CAST", arguments);
+    return {function, arguments, 0};
+}
+
+void KeyCondition::addAtom(Element element, const String& column, KeyFunctions chain) {
+    element.column = header.getPositionByName(column);
+    DataTypePtr type = removeNullable(header.getByPosition(element.column).type);
+    for (const auto& step : chain) {
+        if (!step.function || step.key_argument >= step.arguments.size() ||
+            !step.arguments[step.key_argument].type->equals(*type))
+            throw Exception("Function in the condition on " + column +
+                                    " does not take the result of the previous one",
+                            ErrorCodes::BAD_ARGUMENTS);
+        type = removeNullable(step.function->getReturnType());
+    }
+    element.chain = std::move(chain);
+    rpn.push_back(std::move(element));
+}
+
+void KeyCondition::addComparison(const String& function, const String& column, const Field& value,
+                                 KeyFunctions chain) {
+    Element element;
+    element.kind = Kind::InRange;
+    if (value.isNull()) {
+        /// A comparison with NULL is never true.
+        element.kind = Kind::InSet;
+    } else if (function == "eq") {
+        element.range = FieldRange(value);
+    } else if (function == "ne") {
+        element.kind = Kind::NotInRange;
+        element.range = FieldRange(value);
+    } else if (function == "lt") {
+        element.range = FieldRange::createRightBounded(value, false);
+    } else if (function == "le") {
+        element.range = FieldRange::createRightBounded(value, true);
+    } else if (function == "gt") {
+        element.range = FieldRange::createLeftBounded(value, false);
+    } else if (function == "ge") {
+        element.range = FieldRange::createLeftBounded(value, true);
+    } else {
+        throw Exception("Function " + function + " cannot be used in a key condition",
+                        ErrorCodes::UNKNOWN_FUNCTION);
+    }
+    addAtom(std::move(element), column, std::move(chain));
+}
+
+void KeyCondition::addIn(const String& column, std::vector<Field> values, KeyFunctions chain) {
+    values.erase(std::remove_if(values.begin(), values.end(),
+                                [](const Field& value) { return value.isNull(); }),
+                 values.end());
+    std::sort(values.begin(), values.end(), less);
+    values.erase(std::unique(values.begin(), values.end(), equals), values.end());
+
+    Element element;
+    element.kind = Kind::InSet;
+    element.set = std::move(values);
+    addAtom(std::move(element), column, std::move(chain));
+}
+
+void KeyCondition::addUnknown() {
+    rpn.push_back({});
+}
+
+void KeyCondition::addNot() {
+    Element element;
+    element.kind = Kind::Not;
+    rpn.push_back(std::move(element));
+}
+
+void KeyCondition::addAnd() {
+    Element element;
+    element.kind = Kind::And;
+    rpn.push_back(std::move(element));
+}
+
+void KeyCondition::addOr() {
+    Element element;
+    element.kind = Kind::Or;
+    rpn.push_back(std::move(element));
+}
+
+bool KeyCondition::applyChain(const Element& element, FieldRange& range) const {
+    DataTypePtr type = removeNullable(header.getByPosition(element.column).type);
+    for (const auto& step : element.chain) {
+        if (!step.function->hasInformationAboutMonotonicity()) return false;
+        auto monotonicity = step.function->getMonotonicityForRange(*type, range.left, range.right);
+        if (!monotonicity.is_monotonic) return false;
+
+        for (Field* bound : {&range.left, &range.right}) {
+            Block block(step.arguments);
+            auto& argument = block.getByPosition(step.key_argument);
+            auto column = type->createColumn();
+            column->insert(*bound);
+            argument.type = type;
+            argument.column = std::move(column);
+            for (auto& constant : block)
+                if (!constant.column) return false;
+
+            ColumnNumbers arguments(block.columns());
+            for (size_t i = 0; i < arguments.size(); ++i) arguments[i] = i;
+            block.insert({nullptr, step.function->getReturnType(), ""});
+            step.function->execute(block, arguments, arguments.size(), 1);
+            *bound = (*block.getByPosition(arguments.size()).column)[0];
+            if (bound->isNull()) return false;
+        }
+
+        if (!monotonicity.is_positive) range.swapLeftAndRight();
+        type = removeNullable(step.function->getReturnType());
+    }
+    return true;
+}
+
+BoolMask KeyCondition::checkAtom(const Element& element, const ColumnRange& column_range) const {
+    if (!column_range.has_values) return {false, true};
+
+    FieldRange range = column_range.range;
+    if (!range.left_bounded || !range.right_bounded || !applyChain(element, range)) return {};
+
+    BoolMask mask;
+    switch (element.kind) {
+    case Kind::InRange:
+    case Kind::NotInRange:
+        mask = {element.range.intersectsRange(range), !element.range.containsRange(range)};
+        if (element.kind == Kind::NotInRange) mask = !mask;
+        break;
+    case Kind::InSet: {
+        auto it = std::lower_bound(element.set.begin(), element.set.end(), range.left,
+                                   [&](const Field& value, const Field& left) {
+                                       return !aboveLeft(value, left, range.left_included);
+                                   });
+        mask.can_be_true = it != element.set.end() && range.contains(*it);
+        mask.can_be_false = !(mask.can_be_true && equals(range.left, range.right));
+        break;
+    }
+    default:
+        throw Exception("Element is not an atom", ErrorCodes::LOGICAL_ERROR);
+    }
+
+    /// A comparison with NULL is NULL, which is neither true nor false. Counting it as false
+    /// is safe, it can only make the condition less selective.
+    if (column_range.has_nulls) mask.can_be_false = true;
+    return mask;
+}
+
+BoolMask KeyCondition::checkInRanges(const std::vector<ColumnRange>& ranges) const {
+    if (rpn.empty()) return {};
+
+    std::vector<BoolMask> stack;
+    for (const auto& element : rpn) {
+        if (element.kind == Kind::Not) {
+            if (stack.empty()) throwInvalid();
+            stack.back() = !stack.back();
+        } else if (element.kind == Kind::And || element.kind == Kind::Or) {
+            if (stack.size() < 2) throwInvalid();
+            BoolMask rhs = stack.back();
+            stack.pop_back();
+            stack.back() = element.kind == Kind::And ? stack.back() & rhs : stack.back() | rhs;
+        } else if (element.kind == Kind::Unknown) {
+            stack.emplace_back();
+        } else {
+            stack.push_back(checkAtom(element, ranges.at(element.column)));
+        }
+    }
+
+    if (stack.size() != 1)
+        throw Exception("Invalid key condition: " + std::to_string(stack.size()) +
+                                " values are left on the stack",
+                        ErrorCodes::LOGICAL_ERROR);
+    return stack.back();
+}
+
+std::vector<size_t> KeyCondition::getUsedColumns() const {
+    std::vector<size_t> res;
+    for (const auto& element : rpn)
+        if (element.kind == Kind::InRange || element.kind == Kind::NotInRange ||
+            element.kind == Kind::InSet)
+            res.push_back(element.column);
+    std::sort(res.begin(), res.end());
+    res.erase(std::unique(res.begin(), res.end()), res.end());
+    return res;
+}
+
+bool KeyCondition::alwaysUnknownOrTrue() const {
+    /// Whether a subexpression can ever be false for a whole part of data.
+    std::vector<bool> stack;
+    for (const auto& element : rpn) {
+        if (element.kind == Kind::Not) {
+            if (stack.empty()) throwInvalid();
+        } else if (element.kind == Kind::And || element.kind == Kind::Or) {
+            if (stack.size() < 2) throwInvalid();
+            bool rhs = stack.back();
+            stack.pop_back();
+            stack.back() = element.kind == Kind::And ? stack.back() || rhs : stack.back() && rhs;
+        } else {
+            stack.push_back(element.kind != Kind::Unknown);
+        }
+    }
+    return stack.size() != 1 || !stack.back();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,172 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "vec/core/block.h"
+#include "vec/core/field.h"
+#include "vec/functions/function.h"
+
+namespace doris::vectorized {
+
+/** A range of values, possibly unbounded or open on either side.
+  * Fields are compared with FieldVisitorAccurateLess, so Int64, UInt64, Float64 and
+  * decimals are compared by value.
+  */
+struct FieldRange {
+    Field left;
+    Field right;
+    bool left_bounded = false;
+    bool right_bounded = false;
+    bool left_included = false;
+    bool right_included = false;
+
+    /// All values.
+    FieldRange() = default;
+    /// A single point.
+    FieldRange(const Field& point)
+            : left(point),
+              right(point),
+              left_bounded(true),
+              right_bounded(true),
+              left_included(true),
+              right_included(true) {}
+    FieldRange(const Field& left_, bool left_included_, const Field& right_, bool right_included_)
+            : left(left_),
+              right(right_),
+              left_bounded(true),
+              right_bounded(true),
+              left_included(left_included_),
+              right_included(right_included_) {}
+
+    static FieldRange createLeftBounded(const Field& left, bool included);
+    static FieldRange createRightBounded(const Field& right, bool included);
+
+    bool contains(const Field& value) const;
+    bool intersectsRange(const FieldRange& other) const;
+    bool containsRange(const FieldRange& other) const;
+    /// Swaps the bounds, for a nonincreasing function.
+    void swapLeftAndRight();
+};
+
+/// What values a condition can take over a range of rows.
+struct BoolMask {
+    bool can_be_true = true;
+    bool can_be_false = true;
+
+    BoolMask operator&(const BoolMask& m) const {
+        return {can_be_true && m.can_be_true, can_be_false || m.can_be_false};
+    }
+    BoolMask operator|(const BoolMask& m) const {
+        return {can_be_true || m.can_be_true, can_be_false && m.can_be_false};
+    }
+    BoolMask operator!() const { return {can_be_false, can_be_true}; }
+};
+
+/** A filter expression that is evaluated over ranges of values instead of values, to skip
+  * the parts of data where it is false for all rows, e.g. granules by their zone maps.
+  *
+  * The expression is given in reverse Polish notation. Atoms compare a function of a column
+  * with constants: eq, ne, lt, gt, le, ge and in. The function is a chain of functions of one
+  * non-constant argument, e.g. CAST(t AS Int32), and it is used only on ranges where all of
+  * the chain is monotonic according to IFunctionBase::getMonotonicityForRange. Anything else,
+  * and atoms over such ranges, are unknown, which is always safe.
+  *
+  * Usage, for lt(t, 100) AND NOT eq(CAST(x AS Int8), 5):
+  *     KeyCondition condition(header);
+  *     condition.addComparison("lt", "t", 100);
+  *     condition.addComparison("eq", "x", 5, {KeyCondition::makeCast(x_type, "Int8")});
+  *     condition.addNot();
+  *     condition.addAnd();
+  *     if (!condition.checkInRanges(ranges).can_be_true) skip();
+  */
+class KeyCondition {
+public:
+    /// The columns that can be used in atoms, the positions of ranges are the positions here.
+    explicit KeyCondition(const Block& header_);
+
+    /// A step of a chain: the result of the previous step is the argument at key_argument,
+    /// the other arguments are constant columns.
+    struct KeyFunction {
+        FunctionBasePtr function;
+        ColumnsWithTypeAndName arguments;
+        size_t key_argument = 0;
+    };
+    using KeyFunctions = std::vector<KeyFunction>;
+
+    static KeyFunction makeCast(const DataTypePtr& from_type, const String& to_type_name);
+
+    /// function(chain(column), value), function is one of eq, ne, lt, gt, le, ge.
+    void addComparison(const String& function, const String& column, const Field& value,
+                       KeyFunctions chain = {});
+    /// chain(column) IN (values).
+    void addIn(const String& column, std::vector<Field> values, KeyFunctions chain = {});
+    /// A condition that cannot be analyzed.
+    void addUnknown();
+    void addNot();
+    void addAnd();
+    void addOr();
+
+    /// Values of a column in a part of data.
+    struct ColumnRange {
+        /// Range of the non-null values.
+        FieldRange range;
+        bool has_nulls = false;
+        /// False if all values are null, then range does not matter.
+        bool has_values = true;
+    };
+
+    /// ranges are indexed by the positions in the header; only the used columns are read.
+    BoolMask checkInRanges(const std::vector<ColumnRange>& ranges) const;
+
+    /// Positions in the header of the columns used by atoms.
+    std::vector<size_t> getUsedColumns() const;
+    /// True if the condition never allows to skip anything.
+    bool alwaysUnknownOrTrue() const;
+
+private:
+    enum class Kind {
+        InRange,
+        NotInRange,
+        InSet,
+        Unknown,
+        Not,
+        And,
+        Or,
+    };
+
+    struct Element {
+        Kind kind = Kind::Unknown;
+        size_t column = 0;
+        KeyFunctions chain;
+        FieldRange range;
+        /// Sorted and unique.
+        std::vector<Field> set;
+    };
+
+    void addAtom(Element element, const String& column, KeyFunctions chain);
+    BoolMask checkAtom(const Element& element, const ColumnRange& column_range) const;
+    /// Applies the chain to a closed range, false if it is not monotonic there.
+    bool applyChain(const Element& element, FieldRange& range) const;
+
+    const Block header;
+    std::vector<Element> rpn;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,49 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/segment_format.h"
+
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int ILLEGAL_COLUMN;
+}
+
+namespace Segment {
+
+void enumerateStreams(const IColumn& column, std::vector<StreamDescription>& streams) {
+    if (const auto* nullable = typeid_cast<const ColumnNullable*>(&column)) {
+        streams.push_back({StreamKind::NullMap, 1});
+        enumerateStreams(nullable->getNestedColumn(), streams);
+    } else if (typeid_cast<const ColumnString*>(&column)) {
+        streams.push_back({StreamKind::Offsets, sizeof(IColumn::Offset)});
+        streams.push_back({StreamKind::Chars, 1});
+    } else if (column.isFixedAndContiguous()) {
+        streams.push_back({StreamKind::Data, UInt32(column.sizeOfValueIfFixed())});
+    } else {
+        throw Exception("Column " + column.getName() + " cannot be stored in a segment",
+                        ErrorCodes::ILLEGAL_COLUMN);
+    }
+}
+
+} // namespace Segment
+
+} // namespace doris::vectorized
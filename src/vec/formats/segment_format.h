@@ -0,0 +1,149 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "vec/columns/column.h"
+#include "vec/core/types.h"
+
+namespace doris::vectorized {
+
+/** Layout of a segment file, a columnar file of blocks.
+  *
+  * Every column is stored as one or more streams: a column of fixed-size values has a data
+  * stream, a String column has the offsets (UInt64, cumulative) and the chars, and a Nullable
+  * column has the null map followed by the streams of the nested column.
+  *
+  * Rows are divided into granules of granule_rows rows, and granules into stripes. The file
+  * is the stripes one after another, and in a stripe every stream is one contiguous range,
+  * aligned to stream_alignment and surrounded by at least stream_padding zero bytes, so that
+  * a range can be used in place as the memory of a padded array. String offsets are counted
+  * from the start of the chars of the stripe.
+  *
+  * A mark is the range of a stream in a granule, so any subset of columns and granules is read
+  * without touching the rest. Every granule also has a zone map of every column: min and max
+  * of the non-null values and the number of nulls. Strings in zone maps are cut to
+  * max_zone_map_string_size bytes, and a cut max is rounded up, so the bounds stay correct
+  * but are not exact.
+  *
+  * The footer is a SegmentFooterHeader followed by arrays of the structures below, at the
+  * offsets given in the header, so it can be used in place in a mapped file. Variable-size
+  * things (names, types, min and max values) are in the blob at the end of the footer.
+  * The file ends with a SegmentTrailer. All numbers are little-endian.
+  */
+namespace Segment {
+
+constexpr char magic[8] = {'V', 'E', 'C', 'S', 'E', 'G', '0', '1'};
+constexpr UInt32 version = 1;
+constexpr size_t stream_alignment = 64;
+constexpr size_t stream_padding = 64;
+constexpr size_t max_zone_map_string_size = 64;
+
+enum class StreamKind : UInt32 {
+    Data = 0,
+    NullMap = 1,
+    Offsets = 2,
+    Chars = 3,
+};
+
+struct StreamDescription {
+    StreamKind kind;
+    /// Size of a value in the stream: one for the null map and chars.
+    UInt32 value_size;
+};
+
+/// Streams of a column, in the order they are stored. Throws for unsupported columns.
+void enumerateStreams(const IColumn& column, std::vector<StreamDescription>& streams);
+
+struct BlobRef {
+    UInt32 offset = 0;
+    UInt32 size = 0;
+};
+
+struct ColumnEntry {
+    BlobRef name;
+    BlobRef type;
+    UInt32 first_stream = 0;
+    UInt32 num_streams = 0;
+};
+
+struct StreamEntry {
+    UInt32 column = 0;
+    StreamKind kind = StreamKind::Data;
+    UInt32 value_size = 0;
+    UInt32 reserved = 0;
+};
+
+struct GranuleEntry {
+    UInt64 first_row = 0;
+    UInt32 rows = 0;
+    UInt32 stripe = 0;
+};
+
+struct StripeEntry {
+    UInt32 first_granule = 0;
+    UInt32 num_granules = 0;
+};
+
+/// A range of the file.
+struct Range {
+    UInt64 offset = 0;
+    UInt64 size = 0;
+};
+
+struct ZoneMapEntry {
+    UInt64 null_count = 0;
+    BlobRef min;
+    BlobRef max;
+    /// False if all values are null.
+    UInt8 has_min_max = 0;
+    UInt8 reserved[7] = {};
+};
+
+struct SegmentFooterHeader {
+    UInt32 version = 0;
+    UInt32 num_columns = 0;
+    UInt32 num_streams = 0;
+    UInt32 num_granules = 0;
+    UInt32 num_stripes = 0;
+    UInt32 reserved = 0;
+    UInt64 rows = 0;
+    UInt64 granule_rows = 0;
+
+    /// Offsets of the arrays from the start of the footer.
+    UInt64 columns_offset = 0;      /// ColumnEntry[num_columns]
+    UInt64 streams_offset = 0;      /// StreamEntry[num_streams]
+    UInt64 granules_offset = 0;     /// GranuleEntry[num_granules]
+    UInt64 stripes_offset = 0;      /// StripeEntry[num_stripes]
+    UInt64 stripe_streams_offset = 0; /// Range[num_stripes][num_streams]
+    UInt64 marks_offset = 0;        /// Range[num_streams][num_granules]
+    UInt64 zone_maps_offset = 0;    /// ZoneMapEntry[num_columns][num_granules]
+    UInt64 blob_offset = 0;
+    UInt64 blob_size = 0;
+};
+
+struct SegmentTrailer {
+    UInt64 footer_offset = 0;
+    UInt64 footer_size = 0;
+    char magic[8] = {};
+};
+
+} // namespace Segment
+
+} // namespace doris::vectorized
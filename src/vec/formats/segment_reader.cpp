@@ -0,0 +1,399 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/segment_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_rle.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector_helper.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/common/unaligned.h"
+#include "vec/data_types/data_type_factory.hpp"
+#include "vec/data_types/data_type_nullable.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int CANNOT_OPEN_FILE;
+extern const int CANNOT_STAT;
+extern const int SYSTEM_ERROR;
+extern const int CORRUPTED_DATA;
+extern const int UNKNOWN_FORMAT_VERSION;
+extern const int UNKNOWN_TYPE;
+extern const int ARGUMENT_OUT_OF_BOUND;
+} // namespace ErrorCodes
+
+using namespace Segment;
+
+namespace {
+
+/// The padding of the streams makes their ranges valid memory of padded arrays, so they can be
+/// used in place.
+template <size_t ELEMENT_SIZE>
+void insertValues(ColumnVectorHelper& helper, StringRef values, bool in_place,
+                  const std::shared_ptr<const void>& owner) {
+    size_t n = values.size / ELEMENT_SIZE;
+    if (in_place)
+        helper.borrowRawData<ELEMENT_SIZE>(values.data, n, owner);
+    else
+        helper.insertRawData<ELEMENT_SIZE>(values.data, n);
+}
+
+} // namespace
+
+SegmentReader::SegmentReader(const String& path_, const SegmentReaderSettings& settings_)
+        : path(path_), settings(settings_) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        throwFromErrnoWithPath("Cannot open file " + path, path, ErrorCodes::CANNOT_OPEN_FILE);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throwFromErrnoWithPath("Cannot stat file " + path, path, ErrorCodes::CANNOT_STAT);
+    }
+    size = st.st_size;
+
+    if (size < sizeof(SegmentTrailer)) {
+        close(fd);
+        throw Exception("File " + path + " is too small to be a segment",
+                        ErrorCodes::CORRUPTED_DATA);
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    /// The mapping does not need the descriptor.
+    close(fd);
+    if (mapped == MAP_FAILED)
+        throwFromErrnoWithPath("Cannot mmap file " + path, path, ErrorCodes::SYSTEM_ERROR);
+    size_t mapped_size = size;
+    mapping = std::shared_ptr<const void>(mapped, [mapped_size](const void* ptr) {
+        munmap(const_cast<void*>(ptr), mapped_size);
+    });
+    data = static_cast<const char*>(mapped);
+
+    SegmentTrailer trailer;
+    memcpy(&trailer, data + size - sizeof(trailer), sizeof(trailer));
+    if (memcmp(trailer.magic, magic, sizeof(magic)) != 0)
+        throw Exception("File " + path + " is not a segment", ErrorCodes::CORRUPTED_DATA);
+    if (trailer.footer_size < sizeof(SegmentFooterHeader) ||
+        trailer.footer_offset % alignof(SegmentFooterHeader) != 0 ||
+        trailer.footer_offset > size - sizeof(trailer) ||
+        trailer.footer_size > size - sizeof(trailer) - trailer.footer_offset)
+        throw Exception("Segment " + path + " has a broken trailer", ErrorCodes::CORRUPTED_DATA);
+
+    footer = data + trailer.footer_offset;
+    footer_size = trailer.footer_size;
+    footer_header = reinterpret_cast<const SegmentFooterHeader*>(footer);
+    if (footer_header->version != version)
+        throw Exception("Segment " + path + " has unsupported version " +
+                                std::to_string(footer_header->version),
+                        ErrorCodes::UNKNOWN_FORMAT_VERSION);
+
+    const auto& h = *footer_header;
+    columns = getArray<ColumnEntry>(h.columns_offset, h.num_columns);
+    streams = getArray<StreamEntry>(h.streams_offset, h.num_streams);
+    granules = getArray<GranuleEntry>(h.granules_offset, h.num_granules);
+    getArray<StripeEntry>(h.stripes_offset, h.num_stripes);
+    stripe_streams =
+            getArray<Range>(h.stripe_streams_offset, size_t(h.num_stripes) * h.num_streams);
+    marks = getArray<Range>(h.marks_offset, size_t(h.num_streams) * h.num_granules);
+    zone_maps = getArray<ZoneMapEntry>(h.zone_maps_offset, size_t(h.num_columns) * h.num_granules);
+    getArray<char>(h.blob_offset, h.blob_size);
+
+    for (size_t granule = 0; granule < h.num_granules; ++granule)
+        if (granules[granule].stripe >= h.num_stripes)
+            throw Exception("Segment " + path + " has a granule of a missing stripe",
+                            ErrorCodes::CORRUPTED_DATA);
+
+    for (size_t i = 0; i < h.num_columns; ++i) {
+        const auto& entry = columns[i];
+        StringRef name = getBlob(entry.name);
+        StringRef type_name = getBlob(entry.type);
+
+        DataTypePtr type = DataTypeFactory::instance().get(type_name.toString());
+        if (!type)
+            throw Exception("Unknown type " + type_name.toString() + " of column " +
+                                    name.toString() + " in segment " + path,
+                            ErrorCodes::UNKNOWN_TYPE);
+
+        /// Names of types do not always identify the layout, e.g. Decimal(9, 2) may have
+        /// been stored as Decimal64, so the streams are compared as well.
+        auto column = type->createColumn();
+        std::vector<StreamDescription> descriptions;
+        enumerateStreams(*column, descriptions);
+        bool matches = descriptions.size() == entry.num_streams &&
+                       size_t(entry.first_stream) + entry.num_streams <= h.num_streams;
+        for (size_t j = 0; matches && j < descriptions.size(); ++j) {
+            const auto& stream = streams[entry.first_stream + j];
+            matches = stream.column == i && stream.kind == descriptions[j].kind &&
+                      stream.value_size == descriptions[j].value_size;
+        }
+        if (!matches)
+            throw Exception("Streams of column " + name.toString() + " in segment " + path +
+                                    " do not match its type " + type->getName(),
+                            ErrorCodes::CORRUPTED_DATA);
+
+        header.insert({std::move(column), type, name.toString()});
+    }
+}
+
+template <typename T>
+const T* SegmentReader::getArray(UInt64 offset, size_t count) const {
+    if (offset % alignof(T) != 0 || offset > footer_size ||
+        count > (footer_size - offset) / sizeof(T))
+        throw Exception("Segment " + path + " has a broken footer", ErrorCodes::CORRUPTED_DATA);
+    return reinterpret_cast<const T*>(footer + offset);
+}
+
+StringRef SegmentReader::getBlob(const BlobRef& ref) const {
+    if (size_t(ref.offset) + ref.size > footer_header->blob_size)
+        throw Exception("Segment " + path + " has a broken footer", ErrorCodes::CORRUPTED_DATA);
+    return StringRef(footer + footer_header->blob_offset + ref.offset, ref.size);
+}
+
+SegmentReader::ZoneMap SegmentReader::getZoneMap(size_t column, size_t granule) const {
+    if (column >= footer_header->num_columns || granule >= footer_header->num_granules)
+        throw Exception("Zone map of column " + std::to_string(column) + " and granule " +
+                                std::to_string(granule) + " is out of bounds",
+                        ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+
+    const auto& entry = zone_maps[column * footer_header->num_granules + granule];
+    ZoneMap zone_map;
+    zone_map.null_count = entry.null_count;
+    zone_map.has_min_max = entry.has_min_max;
+    if (zone_map.has_min_max) {
+        auto values = removeNullable(header.getByPosition(column).type)->createColumn();
+        StringRef min = getBlob(entry.min);
+        StringRef max = getBlob(entry.max);
+        values->insertData(min.data, min.size);
+        values->insertData(max.data, max.size);
+        values->get(0, zone_map.min);
+        values->get(1, zone_map.max);
+    }
+    return zone_map;
+}
+
+SegmentReader::GranuleRanges SegmentReader::selectGranules(const KeyCondition& condition) const {
+    size_t num_granules = footer_header->num_granules;
+    GranuleRanges res;
+    if (condition.alwaysUnknownOrTrue()) {
+        if (num_granules) res.emplace_back(0, num_granules);
+        return res;
+    }
+
+    auto used_columns = condition.getUsedColumns();
+    std::vector<KeyCondition::ColumnRange> ranges(header.columns());
+    for (size_t granule = 0; granule < num_granules; ++granule) {
+        for (size_t column : used_columns) {
+            auto zone_map = getZoneMap(column, granule);
+            auto& range = ranges[column];
+            range.has_values = zone_map.has_min_max;
+            range.has_nulls = zone_map.null_count != 0;
+            if (zone_map.has_min_max)
+                range.range = FieldRange(zone_map.min, true, zone_map.max, true);
+        }
+        if (!condition.checkInRanges(ranges).can_be_true) continue;
+
+        if (!res.empty() && res.back().first + res.back().second == granule)
+            ++res.back().second;
+        else
+            res.emplace_back(granule, 1);
+    }
+    return res;
+}
+
+void SegmentReader::readStreams(IColumn& column, size_t& stream, size_t first_granule,
+                                size_t num_granules, bool borrow) const {
+    /// Granules of a stripe are one after another in every stream.
+    auto get_data = [&](size_t index) {
+        UInt64 begin = getMark(index, first_granule).offset;
+        UInt64 end = begin;
+        for (size_t granule = first_granule; granule < first_granule + num_granules; ++granule) {
+            const auto& mark = getMark(index, granule);
+            if (mark.offset != end || mark.offset > size || mark.size > size - mark.offset)
+                throw Exception("Segment " + path + " has a broken mark",
+                                ErrorCodes::CORRUPTED_DATA);
+            end += mark.size;
+        }
+        if ((end - begin) % streams[index].value_size != 0)
+            throw Exception("Segment " + path + " has a broken mark", ErrorCodes::CORRUPTED_DATA);
+        return StringRef(data + begin, end - begin);
+    };
+
+    auto insert_values = [&](ColumnVectorHelper& helper, size_t value_size, StringRef values) {
+        bool in_place = borrow && reinterpret_cast<uintptr_t>(values.data) % value_size == 0;
+        switch (value_size) {
+        case 1:
+            insertValues<1>(helper, values, in_place, mapping);
+            break;
+        case 2:
+            insertValues<2>(helper, values, in_place, mapping);
+            break;
+        case 4:
+            insertValues<4>(helper, values, in_place, mapping);
+            break;
+        case 8:
+            insertValues<8>(helper, values, in_place, mapping);
+            break;
+        case 16:
+            insertValues<16>(helper, values, in_place, mapping);
+            break;
+        default:
+            throw Exception("Segment " + path + " has values of unsupported size " +
+                                    std::to_string(value_size),
+                            ErrorCodes::CORRUPTED_DATA);
+        }
+    };
+
+    if (auto* nullable = typeid_cast<ColumnNullable*>(&column)) {
+        StringRef null_map = get_data(stream++);
+        insert_values(nullable->getNullMapColumn(), 1, null_map);
+        readStreams(nullable->getNestedColumn(), stream, first_granule, num_granules, borrow);
+    } else if (auto* string = typeid_cast<ColumnString*>(&column)) {
+        size_t offsets_stream = stream++;
+        size_t chars_stream = stream++;
+        StringRef offsets_data = get_data(offsets_stream);
+        StringRef chars_data = get_data(chars_stream);
+
+        /// Stored offsets are counted from the start of the chars of the stripe.
+        UInt64 base = getMark(chars_stream, first_granule).offset -
+                      getStripeStream(granules[first_granule].stripe, chars_stream).offset;
+        size_t rows = offsets_data.size / sizeof(IColumn::Offset);
+        IColumn::Offset prev = base;
+        for (size_t i = 0; i < rows; ++i) {
+            IColumn::Offset offset = unalignedLoad<IColumn::Offset>(
+                    offsets_data.data + i * sizeof(IColumn::Offset));
+            if (offset < prev || offset - base > chars_data.size ||
+                (i == rows - 1 && offset - base != chars_data.size))
+                throw Exception("Segment " + path + " has broken string offsets",
+                                ErrorCodes::CORRUPTED_DATA);
+            prev = offset;
+        }
+
+        /// In place only from the start of the stripe, where the stored offsets are the offsets
+        /// of the column and the padding before them is the zero -1th offset.
+        if (borrow && base == 0 &&
+            reinterpret_cast<uintptr_t>(offsets_data.data) % sizeof(IColumn::Offset) == 0) {
+            string->borrow(offsets_data.data, rows, chars_data.data, chars_data.size, mapping);
+            return;
+        }
+
+        auto& offsets = string->getOffsets();
+        auto& chars = string->getChars();
+        IColumn::Offset prev_chars_size = chars.size();
+        size_t old_rows = offsets.size();
+        offsets.resize(old_rows + rows);
+        memcpy(&offsets[old_rows], offsets_data.data, offsets_data.size);
+        for (size_t i = old_rows; i < old_rows + rows; ++i)
+            offsets[i] = offsets[i] - base + prev_chars_size;
+        chars.insert(chars_data.data, chars_data.data + chars_data.size);
+    } else {
+        /// Only ColumnVector and ColumnDecimal have a single data stream.
+        size_t value_size = streams[stream].value_size;
+        StringRef values = get_data(stream++);
+        insert_values(static_cast<ColumnVectorHelper&>(column), value_size, values);
+    }
+}
+
+Block SegmentReader::readGranules(const Names& column_names, size_t first_granule,
+                                  size_t num_granules) const {
+    if (first_granule > footer_header->num_granules ||
+        num_granules > footer_header->num_granules - first_granule)
+        throw Exception("Granules [" + std::to_string(first_granule) + ", " +
+                                std::to_string(first_granule + num_granules) +
+                                ") are out of bounds of segment " + path,
+                        ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+
+    size_t rows = 0;
+    for (size_t granule = first_granule; granule < first_granule + num_granules; ++granule)
+        rows += granules[granule].rows;
+
+    /// Runs of granules of one stripe, as (first granule, number of granules).
+    std::vector<std::pair<size_t, size_t>> stripe_runs;
+    for (size_t granule = first_granule; granule < first_granule + num_granules; ++granule) {
+        if (!stripe_runs.empty() &&
+            granules[stripe_runs.back().first].stripe == granules[granule].stripe)
+            ++stripe_runs.back().second;
+        else
+            stripe_runs.emplace_back(granule, 1);
+    }
+    /// Data of several stripes is not contiguous, so it is copied.
+    bool borrow = settings.zero_copy && stripe_runs.size() == 1;
+
+    Block res;
+    for (const auto& name : column_names) {
+        size_t position = header.getPositionByName(name);
+        const auto& description = header.getByPosition(position);
+        auto column = description.type->createColumn();
+        if (!borrow) column->reserve(rows);
+        for (const auto& [run_first, run_granules] : stripe_runs) {
+            size_t stream = columns[position].first_stream;
+            readStreams(*column, stream, run_first, run_granules, borrow);
+        }
+        if (column->size() != rows)
+            throw Exception("Column " + name + " in segment " + path + " has " +
+                                    std::to_string(column->size()) + " rows instead of " +
+                                    std::to_string(rows),
+                            ErrorCodes::CORRUPTED_DATA);
+        ColumnPtr res_column = std::move(column);
+        if (settings.rle_min_run_length > 0)
+            res_column = ColumnRLE::convertToRLEIfWorthIt(res_column, settings.rle_min_run_length);
+        res.insert({std::move(res_column), description.type, name});
+    }
+    return res;
+}
+
+Block SegmentReader::read(const Names& column_names, size_t first_row, size_t rows) const {
+    size_t total_rows = footer_header->rows;
+    if (first_row > total_rows || rows > total_rows - first_row)
+        throw Exception("Rows [" + std::to_string(first_row) + ", " +
+                                std::to_string(first_row + rows) +
+                                ") are out of bounds of segment " + path + " with " +
+                                std::to_string(total_rows) + " rows",
+                        ErrorCodes::ARGUMENT_OUT_OF_BOUND);
+    if (rows == 0) return readGranules(column_names, 0, 0);
+
+    auto granule_after = [&](size_t row) {
+        return std::upper_bound(granules, granules + footer_header->num_granules, row,
+                                [](size_t value, const GranuleEntry& granule) {
+                                    return value < granule.first_row;
+                                }) -
+               granules;
+    };
+    size_t first_granule = granule_after(first_row) - 1;
+    size_t end_granule = granule_after(first_row + rows - 1);
+
+    Block res = readGranules(column_names, first_granule, end_granule - first_granule);
+    size_t offset = first_row - granules[first_granule].first_row;
+    if (offset == 0 && res.rows() == rows) return res;
+
+    for (size_t i = 0; i < res.columns(); ++i) {
+        auto& column = res.getByPosition(i).column;
+        column = column->cut(offset, rows);
+    }
+    return res;
+}
+
+} // namespace doris::vectorized
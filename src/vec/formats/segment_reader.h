@@ -0,0 +1,121 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <memory>
+
+#include "vec/core/block.h"
+#include "vec/core/field.h"
+#include "vec/core/names.h"
+#include "vec/formats/key_condition.h"
+#include "vec/formats/segment_format.h"
+
+namespace doris::vectorized {
+
+struct SegmentReaderSettings {
+    /// Columns of numbers, decimals and strings use the mapped file in place instead of a copy,
+    /// when the granules that are read are in one stripe (strings: from its first granule).
+    /// Such columns keep the file mapped and copy the data only when they are changed.
+    bool zero_copy = false;
+    /// Columns whose runs of equal values are at least this long on average, such as the
+    /// sorting key of a sorted segment, are read as ColumnRLE. 0 - never.
+    double rle_min_run_length = 0;
+};
+
+/** Reads a segment file written by SegmentWriter, see segment_format.h.
+  * The file is mapped into memory and the footer is used in place.
+  * Reading is thread-safe. The file must not be changed while it is read, or while columns
+  * read with zero_copy exist.
+  *
+  * Usage:
+  *     SegmentReader reader(path);
+  *     Block block = reader.read({"x", "y"}, first_row, rows);
+  */
+class SegmentReader : private boost::noncopyable {
+public:
+    explicit SegmentReader(const String& path_, const SegmentReaderSettings& settings_ = {});
+
+    /// Names and types of all columns, without data.
+    const Block& getHeader() const { return header; }
+
+    size_t getRows() const { return footer_header->rows; }
+    size_t getNumberOfGranules() const { return footer_header->num_granules; }
+    size_t getGranuleFirstRow(size_t granule) const { return granules[granule].first_row; }
+    size_t getGranuleRows(size_t granule) const { return granules[granule].rows; }
+
+    struct ZoneMap {
+        /// Min and max of the non-null values, unset if all values are null.
+        /// Long strings are bounded by prefixes, see Segment::max_zone_map_string_size.
+        bool has_min_max = false;
+        Field min;
+        Field max;
+        UInt64 null_count = 0;
+    };
+
+    /// column is the position in the header.
+    ZoneMap getZoneMap(size_t column, size_t granule) const;
+
+    using GranuleRanges = std::vector<std::pair<size_t, size_t>>;
+    /// Runs of granules, as (first granule, number of granules), where the condition may be
+    /// true according to the zone maps. The condition must be made from getHeader().
+    GranuleRanges selectGranules(const KeyCondition& condition) const;
+
+    /// Reads the rows [first_row, first_row + rows) of the columns, in the order of the names.
+    Block read(const Names& column_names, size_t first_row, size_t rows) const;
+    /// Reads the granules [first_granule, first_granule + num_granules).
+    Block readGranules(const Names& column_names, size_t first_granule,
+                       size_t num_granules) const;
+
+private:
+    template <typename T>
+    const T* getArray(UInt64 offset, size_t size) const;
+    StringRef getBlob(const Segment::BlobRef& ref) const;
+    const Segment::Range& getMark(size_t stream, size_t granule) const {
+        return marks[stream * footer_header->num_granules + granule];
+    }
+    const Segment::Range& getStripeStream(size_t stripe, size_t stream) const {
+        return stripe_streams[stripe * footer_header->num_streams + stream];
+    }
+
+    /// Appends granules of one stripe to the column from its streams, starting from stream.
+    /// If borrow is set, the column is empty and may use the mapped file in place.
+    void readStreams(IColumn& column, size_t& stream, size_t first_granule, size_t num_granules,
+                     bool borrow) const;
+
+    const String path;
+    const SegmentReaderSettings settings;
+    /// Unmaps the file when the reader and all columns that use the file are destroyed.
+    std::shared_ptr<const void> mapping;
+    const char* data = nullptr;
+    size_t size = 0;
+
+    const char* footer = nullptr;
+    size_t footer_size = 0;
+    const Segment::SegmentFooterHeader* footer_header = nullptr;
+    const Segment::ColumnEntry* columns = nullptr;
+    const Segment::StreamEntry* streams = nullptr;
+    const Segment::GranuleEntry* granules = nullptr;
+    const Segment::Range* stripe_streams = nullptr;
+    const Segment::Range* marks = nullptr;
+    const Segment::ZoneMapEntry* zone_maps = nullptr;
+
+    Block header;
+};
+
+} // namespace doris::vectorized
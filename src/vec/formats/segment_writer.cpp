@@ -0,0 +1,320 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/segment_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+extern const int ILLEGAL_COLUMN;
+extern const int CANNOT_OPEN_FILE;
+extern const int CANNOT_CLOSE_FILE;
+extern const int CANNOT_WRITE_TO_FILE_DESCRIPTOR;
+}
+
+using namespace Segment;
+
+namespace {
+
+size_t roundUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/** The shortest string of at most max_size bytes that is not less than the value,
+  * or the value itself if there is no such string (its prefix is all 0xFF bytes).
+  */
+String roundUpPrefix(const StringRef& value, size_t max_size) {
+    String res(value.data, std::min(value.size, max_size));
+    if (res.size() == value.size) return res;
+    while (!res.empty() && static_cast<UInt8>(res.back()) == 0xFF) res.pop_back();
+    if (res.empty()) return value.toString();
+    ++res.back();
+    return res;
+}
+
+} // namespace
+
+SegmentWriter::SegmentWriter(const String& path_, const Block& header_,
+                             const SegmentWriterSettings& settings_)
+        : path(path_),
+          header(header_.cloneEmpty()),
+          granule_rows(std::max<size_t>(settings_.granule_rows, 1)),
+          stripe_granules(std::max<size_t>(settings_.stripe_granules, 1)) {
+    for (size_t i = 0; i < header.columns(); ++i) {
+        const auto& column = header.getByPosition(i);
+        pending.push_back(column.type->createColumn());
+
+        std::vector<StreamDescription> descriptions;
+        enumerateStreams(*pending.back(), descriptions);
+
+        ColumnEntry entry;
+        entry.name = addToBlob(column.name.data(), column.name.size());
+        String type_name = column.type->getName();
+        entry.type = addToBlob(type_name.data(), type_name.size());
+        entry.first_stream = streams.size();
+        entry.num_streams = descriptions.size();
+        columns.push_back(entry);
+
+        for (const auto& description : descriptions)
+            streams.push_back({UInt32(i), description.kind, description.value_size, 0});
+    }
+
+    stripe_buffers.resize(streams.size());
+    marks.resize(streams.size());
+    zone_maps.resize(columns.size());
+
+    fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd == -1)
+        throwFromErrnoWithPath("Cannot open file " + path, path, ErrorCodes::CANNOT_OPEN_FILE);
+}
+
+SegmentWriter::~SegmentWriter() {
+    if (fd != -1) close(fd);
+}
+
+void SegmentWriter::write(const Block& block) {
+    if (finished) throw Exception("Segment is already finished", ErrorCodes::LOGICAL_ERROR);
+    if (block.columns() != header.columns())
+        throw Exception("Block has " + std::to_string(block.columns()) +
+                                " columns, but the segment has " +
+                                std::to_string(header.columns()),
+                        ErrorCodes::LOGICAL_ERROR);
+
+    Columns block_columns;
+    for (size_t i = 0; i < block.columns(); ++i) {
+        const auto& column = block.getByPosition(i);
+        if (!column.type->equals(*header.getByPosition(i).type))
+            throw Exception("Column " + column.name + " has type " + column.type->getName() +
+                                    ", but the segment has " +
+                                    header.getByPosition(i).type->getName(),
+                            ErrorCodes::ILLEGAL_COLUMN);
+        block_columns.push_back(column.column->convertToFullColumnIfConst()
+                                        ->convertToFullColumnIfSparse()
+                                        ->convertToFullColumnIfRLE());
+    }
+
+    size_t rows = block.rows();
+    for (size_t offset = 0; offset < rows;) {
+        size_t length = std::min(granule_rows - pending_rows, rows - offset);
+        for (size_t i = 0; i < pending.size(); ++i)
+            pending[i]->insertRangeFrom(*block_columns[i], offset, length);
+        pending_rows += length;
+        offset += length;
+        if (pending_rows == granule_rows) writeGranule();
+    }
+}
+
+void SegmentWriter::writeGranule() {
+    if (pending_rows == 0) return;
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const IColumn* values = pending[i].get();
+        ColumnPtr not_null_values;
+        ZoneMapEntry zone_map;
+        zone_map.has_min_max = 1;
+
+        if (const auto* nullable = typeid_cast<const ColumnNullable*>(values)) {
+            const auto& null_map = nullable->getNullMapData();
+            IColumn::Filter filter(null_map.size());
+            for (size_t row = 0; row < null_map.size(); ++row) {
+                zone_map.null_count += null_map[row] != 0;
+                filter[row] = !null_map[row];
+            }
+            values = &nullable->getNestedColumn();
+            if (zone_map.null_count == pending_rows) {
+                zone_map.has_min_max = 0;
+            } else if (zone_map.null_count != 0) {
+                not_null_values = values->filter(filter, pending_rows - zone_map.null_count);
+                values = not_null_values.get();
+            }
+        }
+
+        if (zone_map.has_min_max) {
+            Field min;
+            Field max;
+            values->getExtremes(min, max);
+            auto extremes = values->cloneEmpty();
+            extremes->insert(min);
+            extremes->insert(max);
+            auto min_data = extremes->getDataAt(0);
+            auto max_data = extremes->getDataAt(1);
+            String max_prefix;
+            if (!values->valuesHaveFixedSize()) {
+                /// A prefix is not greater than the value, the max is rounded up.
+                min_data.size = std::min(min_data.size, max_zone_map_string_size);
+                max_prefix = roundUpPrefix(max_data, max_zone_map_string_size);
+                max_data = StringRef(max_prefix.data(), max_prefix.size());
+            }
+            zone_map.min = addToBlob(min_data.data, min_data.size);
+            zone_map.max = addToBlob(max_data.data, max_data.size);
+        }
+        zone_maps[i].push_back(zone_map);
+    }
+
+    size_t stream = 0;
+    for (const auto& column : pending) writeStreams(*column, stream);
+
+    granules.push_back({total_rows, UInt32(pending_rows), UInt32(stripes.size())});
+    total_rows += pending_rows;
+    for (auto& column : pending) column = column->cloneEmpty();
+    pending_rows = 0;
+
+    size_t stripe_first_granule = stripes.empty() ? 0 : stripes.back().first_granule +
+                                                                stripes.back().num_granules;
+    if (granules.size() - stripe_first_granule == stripe_granules) writeStripe();
+}
+
+void SegmentWriter::writeStreams(const IColumn& column, size_t& stream) {
+    auto append = [&](size_t index, const char* data, size_t size) {
+        auto& buffer = stripe_buffers[index];
+        marks[index].push_back({buffer.size(), size});
+        buffer.insert(data, data + size);
+    };
+
+    if (const auto* nullable = typeid_cast<const ColumnNullable*>(&column)) {
+        const auto& null_map = nullable->getNullMapData();
+        append(stream++, reinterpret_cast<const char*>(null_map.data()), null_map.size());
+        writeStreams(nullable->getNestedColumn(), stream);
+    } else if (const auto* string = typeid_cast<const ColumnString*>(&column)) {
+        const auto& offsets = string->getOffsets();
+        const auto& chars = string->getChars();
+        /// Offsets are counted from the start of the chars of the stripe.
+        IColumn::Offset base = stripe_buffers[stream + 1].size();
+        PODArray<IColumn::Offset> shifted(offsets.size());
+        for (size_t i = 0; i < offsets.size(); ++i) shifted[i] = offsets[i] + base;
+        append(stream++, reinterpret_cast<const char*>(shifted.data()),
+               shifted.size() * sizeof(IColumn::Offset));
+        append(stream++, reinterpret_cast<const char*>(chars.data()), chars.size());
+    } else {
+        auto data = column.getRawData();
+        append(stream++, data.data, data.size);
+    }
+}
+
+void SegmentWriter::writeStripe() {
+    UInt32 first_granule =
+            stripes.empty() ? 0 : stripes.back().first_granule + stripes.back().num_granules;
+    if (first_granule == granules.size()) return;
+
+    for (size_t stream = 0; stream < streams.size(); ++stream) {
+        writeZeros(roundUp(file_size + stream_padding, stream_alignment) - file_size);
+        auto& buffer = stripe_buffers[stream];
+        UInt64 base = file_size;
+        stripe_streams.push_back({base, buffer.size()});
+        writeToFile(buffer.data(), buffer.size());
+        buffer.clear();
+        for (size_t granule = first_granule; granule < granules.size(); ++granule)
+            marks[stream][granule].offset += base;
+    }
+    stripes.push_back({first_granule, UInt32(granules.size() - first_granule)});
+}
+
+void SegmentWriter::writeFooter() {
+    writeZeros(roundUp(file_size + stream_padding, stream_alignment) - file_size);
+
+    SegmentFooterHeader footer_header;
+    footer_header.version = version;
+    footer_header.num_columns = columns.size();
+    footer_header.num_streams = streams.size();
+    footer_header.num_granules = granules.size();
+    footer_header.num_stripes = stripes.size();
+    footer_header.rows = total_rows;
+    footer_header.granule_rows = granule_rows;
+
+    Buffer footer;
+    footer.resize(sizeof(footer_header));
+    auto append_array = [&](const auto& array) {
+        UInt64 offset = footer.size();
+        const char* data = reinterpret_cast<const char*>(array.data());
+        footer.insert(data, data + array.size() * sizeof(array[0]));
+        return offset;
+    };
+
+    footer_header.columns_offset = append_array(columns);
+    footer_header.streams_offset = append_array(streams);
+    footer_header.granules_offset = append_array(granules);
+    footer_header.stripes_offset = append_array(stripes);
+    footer_header.stripe_streams_offset = append_array(stripe_streams);
+    footer_header.marks_offset = footer.size();
+    for (const auto& stream_marks : marks) append_array(stream_marks);
+    footer_header.zone_maps_offset = footer.size();
+    for (const auto& column_zone_maps : zone_maps) append_array(column_zone_maps);
+    footer_header.blob_offset = footer.size();
+    footer_header.blob_size = blob.size();
+    footer.insert(blob.begin(), blob.end());
+    memcpy(footer.data(), &footer_header, sizeof(footer_header));
+
+    SegmentTrailer trailer;
+    trailer.footer_offset = file_size;
+    trailer.footer_size = footer.size();
+    memcpy(trailer.magic, magic, sizeof(magic));
+
+    writeToFile(footer.data(), footer.size());
+    writeToFile(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+}
+
+void SegmentWriter::finish() {
+    if (finished) return;
+    writeGranule();
+    writeStripe();
+    writeFooter();
+
+    int res = close(fd);
+    fd = -1;
+    if (res != 0)
+        throwFromErrnoWithPath("Cannot close file " + path, path, ErrorCodes::CANNOT_CLOSE_FILE);
+    finished = true;
+}
+
+void SegmentWriter::writeToFile(const char* data, size_t size) {
+    while (size) {
+        ssize_t res = ::write(fd, data, size);
+        if (res < 0) {
+            if (errno == EINTR) continue;
+            throwFromErrnoWithPath("Cannot write to file " + path, path,
+                                   ErrorCodes::CANNOT_WRITE_TO_FILE_DESCRIPTOR);
+        }
+        data += res;
+        size -= res;
+        file_size += res;
+    }
+}
+
+void SegmentWriter::writeZeros(size_t size) {
+    static const char zeros[stream_alignment + stream_padding] = {};
+    while (size) {
+        size_t length = std::min(size, sizeof(zeros));
+        writeToFile(zeros, length);
+        size -= length;
+    }
+}
+
+BlobRef SegmentWriter::addToBlob(const char* data, size_t size) {
+    BlobRef ref {UInt32(blob.size()), UInt32(size)};
+    blob.insert(data, data + size);
+    return ref;
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,96 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+#include "vec/common/pod_array.h"
+#include "vec/core/block.h"
+#include "vec/formats/segment_format.h"
+
+namespace doris::vectorized {
+
+struct SegmentWriterSettings {
+    /// Rows in a granule, the unit of reading and of zone maps.
+    size_t granule_rows = 8192;
+    /// Granules in a stripe. A stripe is buffered in memory until it is written.
+    size_t stripe_granules = 64;
+};
+
+/** Writes blocks into a segment file, see segment_format.h.
+  *
+  * Usage:
+  *     SegmentWriter writer(path, header);
+  *     while (...) writer.write(block);
+  *     writer.finish();
+  *
+  * The file is complete only after finish(). Columns of the blocks are matched with
+  * the header by position.
+  */
+class SegmentWriter : private boost::noncopyable {
+public:
+    SegmentWriter(const String& path_, const Block& header_,
+                  const SegmentWriterSettings& settings_ = {});
+    ~SegmentWriter();
+
+    void write(const Block& block);
+    void finish();
+
+private:
+    using Buffer = PODArray<char>;
+
+    /// Appends the values of a column to its streams in the current stripe.
+    void writeStreams(const IColumn& column, size_t& stream);
+    void writeGranule();
+    void writeStripe();
+    void writeFooter();
+
+    void writeToFile(const char* data, size_t size);
+    void writeZeros(size_t size);
+    Segment::BlobRef addToBlob(const char* data, size_t size);
+
+    const String path;
+    const Block header;
+    const size_t granule_rows;
+    const size_t stripe_granules;
+    int fd = -1;
+    UInt64 file_size = 0;
+    bool finished = false;
+
+    std::vector<Segment::ColumnEntry> columns;
+    std::vector<Segment::StreamEntry> streams;
+    std::vector<Segment::GranuleEntry> granules;
+    std::vector<Segment::StripeEntry> stripes;
+    std::vector<Segment::Range> stripe_streams;
+    /// [stream][granule], offsets relative to the stream in the stripe until it is written.
+    std::vector<std::vector<Segment::Range>> marks;
+    /// [column][granule]
+    std::vector<std::vector<Segment::ZoneMapEntry>> zone_maps;
+    Buffer blob;
+
+    /// Rows of the granule being filled.
+    MutableColumns pending;
+    size_t pending_rows = 0;
+    UInt64 total_rows = 0;
+
+    /// Streams of the stripe being filled.
+    std::vector<Buffer> stripe_buffers;
+};
+
+} // namespace doris::vectorized
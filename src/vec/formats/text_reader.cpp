@@ -0,0 +1,617 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/text_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/arithmetic_overflow.h"
+#include "vec/common/exception.h"
+#include "vec/common/find_symbols.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/core/call_on_type_index.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int BAD_ARGUMENTS;
+extern const int NOT_IMPLEMENTED;
+extern const int CANNOT_OPEN_FILE;
+extern const int CANNOT_STAT;
+extern const int SYSTEM_ERROR;
+extern const int INCORRECT_NUMBER_OF_COLUMNS;
+extern const int CANNOT_PARSE_QUOTED_STRING;
+extern const int CANNOT_PARSE_ESCAPE_SEQUENCE;
+extern const int CANNOT_PARSE_NUMBER;
+extern const int DECIMAL_OVERFLOW;
+} // namespace ErrorCodes
+
+/// The fields of one column in the rows [first_row, first_row + rows) of a parsed range.
+/// Field i of the range is between separators i - 1 and i.
+struct TextReader::Fields {
+    const char* data;
+    const UInt64* separators;
+    size_t num_columns;
+    size_t column;
+    size_t first_row;
+    size_t rows;
+    /// Of data in the file.
+    size_t offset;
+
+    const char* begin(size_t row) const {
+        size_t i = (first_row + row) * num_columns + column;
+        return i == 0 ? data : data + separators[i - 1] + 1;
+    }
+
+    const char* end(size_t row) const {
+        const char* res = data + separators[(first_row + row) * num_columns + column];
+        /// CRLF line endings.
+        if (column + 1 == num_columns && res != begin(row) && res[-1] == '\r') --res;
+        return res;
+    }
+
+    String position(size_t row) const {
+        return "at byte " + std::to_string(offset + (begin(row) - data));
+    }
+};
+
+namespace {
+
+/// Bit i of the result is the XOR of bits 0..i of x.
+inline UInt64 prefixXor(UInt64 x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+#ifdef __SSE2__
+inline UInt64 movemask(__m128i mask) {
+    return static_cast<UInt16>(_mm_movemask_epi8(mask));
+}
+#endif
+
+/// The number of quotes in [begin, end).
+size_t countQuotes(const char* begin, const char* end) {
+    size_t res = 0;
+    const char* pos = begin;
+#ifdef __SSE2__
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        res += __builtin_popcount(movemask(detail::mm_is_in<'"'>(bytes)));
+    }
+#endif
+    for (; pos < end; ++pos) res += *pos == '"';
+    return res;
+}
+
+inline bool isNullField(const char* begin, const char* end, bool csv) {
+    return (end - begin == 2 && begin[0] == '\\' && begin[1] == 'N') || (csv && begin == end);
+}
+
+/// Removes the quotes around a CSV field that is not a string; quotes in it are not allowed.
+template <typename Fields>
+void unquoteCSVValue(const char*& begin, const char*& end, const Fields& fields, size_t row) {
+    if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+        ++begin;
+        --end;
+    }
+    if (find_first_symbols<'"'>(begin, end) != end)
+        throw Exception("Unexpected quote in a CSV field " + fields.position(row),
+                        ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+}
+
+template <typename T>
+bool parseNumber(const char* begin, const char* end, T& res) {
+    if (begin != end && *begin == '+') ++begin;
+    auto [ptr, ec] = std::from_chars(begin, end, res);
+    return ec == std::errc() && ptr == end && begin != end;
+}
+
+/// Digits with an optional sign and point, at most scale digits after the point except
+/// trailing zeros, and at most precision digits in total without the leading zeros.
+template <typename T>
+bool parseDecimal(const char* pos, const char* end, UInt32 precision, UInt32 scale, T& res) {
+    using NativeType = typename T::NativeType;
+    bool negative = false;
+    if (pos != end && (*pos == '-' || *pos == '+')) negative = *pos++ == '-';
+
+    /// Accumulated as a negative number, which has the larger range.
+    NativeType value = 0;
+    bool has_digits = false;
+    bool after_point = false;
+    UInt32 fractional_digits = 0;
+    for (; pos != end; ++pos) {
+        if (*pos == '.' && !after_point) {
+            after_point = true;
+            continue;
+        }
+        if (*pos < '0' || *pos > '9') return false;
+        has_digits = true;
+        if (after_point && fractional_digits == scale) {
+            if (*pos != '0') return false;
+            continue;
+        }
+        if (common::mulOverflow(value, NativeType(10), value) ||
+            common::subOverflow(value, NativeType(*pos - '0'), value))
+            throw Exception("Decimal value is out of range", ErrorCodes::DECIMAL_OVERFLOW);
+        fractional_digits += after_point;
+    }
+    if (!has_digits) return false;
+    for (; fractional_digits < scale; ++fractional_digits)
+        if (common::mulOverflow(value, NativeType(10), value))
+            throw Exception("Decimal value is out of range", ErrorCodes::DECIMAL_OVERFLOW);
+
+    /// 10^precision fits, precision is at most the maximum of the type.
+    NativeType limit = 1;
+    for (UInt32 i = 0; i < precision; ++i) limit *= 10;
+    if (value <= -limit)
+        throw Exception("Decimal value has more than " + std::to_string(precision) + " digits",
+                        ErrorCodes::DECIMAL_OVERFLOW);
+    res = T(negative ? value : -value);
+    return true;
+}
+
+/// Calls parse(begin, end, value) for the fields of values that are not NULL, with NULL and
+/// empty fields inserted as default values.
+template <typename Container, typename Fields, typename Parse>
+void parseValues(Container& data, NullMap* null_map, const Fields& fields, bool csv,
+                 Parse&& parse) {
+    size_t old_size = data.size();
+    data.resize_fill(old_size + fields.rows);
+    auto* values = &data[old_size];
+    for (size_t row = 0; row < fields.rows; ++row) {
+        const char* begin = fields.begin(row);
+        const char* end = fields.end(row);
+        if (null_map) {
+            bool is_null = isNullField(begin, end, csv);
+            null_map->push_back(is_null);
+            if (is_null) continue;
+        }
+        if (csv) unquoteCSVValue(begin, end, fields, row);
+        if (begin != end && !parse(begin, end, values[row]))
+            throw Exception("Cannot parse number " + String(begin, end) + " " +
+                                    fields.position(row),
+                            ErrorCodes::CANNOT_PARSE_NUMBER);
+    }
+}
+
+/// Appends a CSV field to chars without the quotes, "" becomes ".
+template <typename Fields>
+void appendCSVString(const char* begin, const char* end, ColumnString::Chars& chars,
+                     const Fields& fields, size_t row) {
+    if (begin == end || *begin != '"') {
+        if (find_first_symbols<'"'>(begin, end) != end)
+            throw Exception("Unexpected quote in a CSV field " + fields.position(row),
+                            ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+        chars.insert(begin, end);
+        return;
+    }
+
+    /// After the opening quote every quote is either the closing one at the end or a pair.
+    const char* pos = begin + 1;
+    while (true) {
+        const char* quote = find_first_symbols<'"'>(pos, end);
+        if (quote == end)
+            throw Exception("Unterminated quoted CSV field " + fields.position(row),
+                            ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+        chars.insert(pos, quote);
+        if (quote + 1 == end) return;
+        if (quote[1] != '"')
+            throw Exception("Unexpected quote in a CSV field " + fields.position(row),
+                            ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+        chars.push_back('"');
+        pos = quote + 2;
+    }
+}
+
+/// Appends a TSV field to chars without the escaping.
+template <typename Fields>
+void appendTSVString(const char* begin, const char* end, ColumnString::Chars& chars,
+                     const Fields& fields, size_t row) {
+    const char* pos = begin;
+    while (true) {
+        const char* backslash = find_first_symbols<'\\'>(pos, end);
+        chars.insert(pos, backslash);
+        if (backslash == end) return;
+        if (backslash + 1 == end)
+            throw Exception("Backslash at the end of a TSV field " + fields.position(row),
+                            ErrorCodes::CANNOT_PARSE_ESCAPE_SEQUENCE);
+        char c = backslash[1];
+        switch (c) {
+        case 'n':
+            c = '\n';
+            break;
+        case 't':
+            c = '\t';
+            break;
+        case 'r':
+            c = '\r';
+            break;
+        case '0':
+            c = '\0';
+            break;
+        case 'b':
+            c = '\b';
+            break;
+        case 'f':
+            c = '\f';
+            break;
+        default:
+            /// \\, \' and others are the character itself.
+            break;
+        }
+        chars.push_back(c);
+        pos = backslash + 2;
+    }
+}
+
+template <typename Fields>
+void parseStrings(ColumnString& column, NullMap* null_map, const Fields& fields, bool csv) {
+    ColumnString::Chars& chars = column.getChars();
+    ColumnString::Offsets& offsets = column.getOffsets();
+    offsets.reserve(offsets.size() + fields.rows);
+    for (size_t row = 0; row < fields.rows; ++row) {
+        const char* begin = fields.begin(row);
+        const char* end = fields.end(row);
+        bool is_null = null_map && isNullField(begin, end, csv);
+        if (null_map) null_map->push_back(is_null);
+        if (!is_null) {
+            if (csv)
+                appendCSVString(begin, end, chars, fields, row);
+            else
+                appendTSVString(begin, end, chars, fields, row);
+        }
+        chars.push_back(0);
+        offsets.push_back(chars.size());
+    }
+}
+
+} // namespace
+
+TextReader::TextReader(const Block& header_, const TextReaderSettings& settings_)
+        : header(header_.cloneEmpty()),
+          settings(settings_),
+          delimiter(settings.delimiter
+                            ? settings.delimiter
+                            : (settings.format == TextReaderSettings::Format::CSV ? ',' : '\t')) {
+    if (delimiter == '\n' || delimiter == '\r' || delimiter == '"' || delimiter == '\\')
+        throw Exception(String("Bad delimiter '") + delimiter + "' for a text format",
+                        ErrorCodes::BAD_ARGUMENTS);
+    if (header.columns() == 0)
+        throw Exception("Text format needs at least one column", ErrorCodes::BAD_ARGUMENTS);
+    if (settings.max_block_rows == 0 || settings.chunk_bytes == 0)
+        throw Exception("Block and chunk sizes of a text format must be positive",
+                        ErrorCodes::BAD_ARGUMENTS);
+
+    for (const auto& elem : header) {
+        bool supported = callOnIndexAndDataType<void>(
+                removeNullable(elem.type)->getTypeId(), [](const auto&) { return true; });
+        if (!supported)
+            throw Exception("Type " + elem.type->getName() + " of column " + elem.name +
+                                    " is not supported by text formats",
+                            ErrorCodes::NOT_IMPLEMENTED);
+    }
+}
+
+void TextReader::findSeparators(const char* begin, const char* end,
+                                PaddedPODArray<UInt64>& res) const {
+    const bool csv = settings.format == TextReaderSettings::Format::CSV;
+    const size_t size = end - begin;
+
+    /// All ones if the previous block ended inside quotes.
+    UInt64 inside_quotes = 0;
+    alignas(16) char tail[64];
+    for (size_t pos = 0; pos < size; pos += 64) {
+        const char* block = begin + pos;
+        if (size - pos < 64) {
+            /// Zero bytes are neither separators nor quotes.
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, block, size - pos);
+            block = tail;
+        }
+
+        UInt64 separators = 0;
+        UInt64 quotes = 0;
+#ifdef __SSE2__
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        for (size_t i = 0; i < 4; ++i) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+            separators |= movemask(_mm_or_si128(detail::mm_is_in<'\n'>(bytes),
+                                                _mm_cmpeq_epi8(bytes, delimiters)))
+                          << (i * 16);
+            if (csv) quotes |= movemask(detail::mm_is_in<'"'>(bytes)) << (i * 16);
+        }
+#else
+        for (size_t i = 0; i < 64; ++i) {
+            separators |= UInt64(block[i] == '\n' || block[i] == delimiter) << i;
+            if (csv) quotes |= UInt64(block[i] == '"') << i;
+        }
+#endif
+
+        if (csv) {
+            /// Set from an opening quote up to the closing one, excluding it.
+            UInt64 quoted = prefixXor(quotes) ^ inside_quotes;
+            inside_quotes = UInt64(Int64(quoted) >> 63);
+            separators &= ~quoted;
+        }
+
+        while (separators) {
+            res.push_back(pos + __builtin_ctzll(separators));
+            separators &= separators - 1;
+        }
+    }
+
+    if (inside_quotes)
+        throw Exception("Unterminated quoted CSV field", ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+    /// The last row without a newline.
+    if (size && end[-1] != '\n') res.push_back(size);
+}
+
+size_t TextReader::findEndOfRow(const char* begin, const char* end) const {
+    const bool csv = settings.format == TextReaderSettings::Format::CSV;
+    const char* pos = begin;
+    bool inside_quotes = false;
+    while (true) {
+        pos = csv ? find_first_symbols<'"', '\n'>(pos, end) : find_first_symbols<'\n'>(pos, end);
+        if (pos == end) return end - begin;
+        if (*pos == '\n' && !inside_quotes) return pos + 1 - begin;
+        inside_quotes ^= *pos == '"';
+        ++pos;
+    }
+}
+
+std::vector<std::pair<size_t, size_t>> TextReader::splitIntoChunks(const char* begin,
+                                                                   const char* end) const {
+    const bool csv = settings.format == TextReaderSettings::Format::CSV;
+    const size_t size = end - begin;
+    std::vector<std::pair<size_t, size_t>> res;
+    size_t chunk_begin = 0;
+    while (chunk_begin < size) {
+        if (size - chunk_begin <= settings.chunk_bytes) {
+            res.emplace_back(chunk_begin, size);
+            break;
+        }
+        /// Whether the middle of the chunk is inside quotes is known from the number of quotes
+        /// before it, which is counted much faster than the rows are found.
+        size_t middle = chunk_begin + settings.chunk_bytes;
+        if (csv && countQuotes(begin + chunk_begin, begin + middle) % 2) {
+            const char* closing = find_first_symbols<'"'>(begin + middle, end);
+            if (closing == end)
+                throw Exception("Unterminated quoted CSV field",
+                                ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+            middle = closing + 1 - begin;
+        }
+        size_t chunk_end = middle + findEndOfRow(begin + middle, end);
+        res.emplace_back(chunk_begin, chunk_end);
+        chunk_begin = chunk_end;
+    }
+    return res;
+}
+
+void TextReader::parse(const char* begin, const char* end, Blocks& res) const {
+    parseImpl(begin, end, 0, res);
+}
+
+void TextReader::parseImpl(const char* begin, const char* end, size_t offset,
+                           Blocks& res) const {
+    PaddedPODArray<UInt64> separators;
+    /// A guess of the average field size, to reallocate rarely.
+    separators.reserve((end - begin) / 8 + 16);
+    findSeparators(begin, end, separators);
+
+    const size_t num_columns = header.columns();
+    for (size_t i = 0; i < separators.size(); ++i) {
+        bool is_newline = separators[i] == size_t(end - begin) || begin[separators[i]] == '\n';
+        if (is_newline != (i % num_columns == num_columns - 1))
+            throw Exception("Row has " + String(is_newline ? "fewer" : "more") + " than " +
+                                    std::to_string(num_columns) + " fields at byte " +
+                                    std::to_string(offset + separators[i]),
+                            ErrorCodes::INCORRECT_NUMBER_OF_COLUMNS);
+    }
+    if (separators.size() % num_columns)
+        throw Exception("Last row has fewer than " + std::to_string(num_columns) + " fields",
+                        ErrorCodes::INCORRECT_NUMBER_OF_COLUMNS);
+
+    const size_t rows = separators.size() / num_columns;
+    for (size_t first_row = 0; first_row < rows; first_row += settings.max_block_rows) {
+        Fields fields;
+        fields.data = begin;
+        fields.separators = separators.data();
+        fields.num_columns = num_columns;
+        fields.first_row = first_row;
+        fields.rows = std::min(settings.max_block_rows, rows - first_row);
+        fields.offset = offset;
+        MutableColumns columns = header.cloneEmptyColumns();
+        for (size_t i = 0; i < num_columns; ++i) {
+            fields.column = i;
+            parseColumn(*columns[i], *header.getByPosition(i).type, fields);
+        }
+        res.push_back(header.cloneWithColumns(std::move(columns)));
+    }
+}
+
+void TextReader::parseColumn(IColumn& column, const IDataType& type,
+                             const Fields& fields) const {
+    const bool csv = settings.format == TextReaderSettings::Format::CSV;
+
+    IColumn* values = &column;
+    const IDataType* values_type = &type;
+    NullMap* null_map = nullptr;
+    if (auto* nullable = typeid_cast<ColumnNullable*>(&column)) {
+        values = &nullable->getNestedColumn();
+        values_type = static_cast<const DataTypeNullable&>(type).getNestedType().get();
+        null_map = &nullable->getNullMapData();
+        null_map->reserve(null_map->size() + fields.rows);
+    }
+
+    callOnIndexAndDataType<void>(values_type->getTypeId(), [&](const auto& types) {
+        using Types = std::decay_t<decltype(types)>;
+        using DataType = typename Types::LeftType;
+
+        if constexpr (std::is_same_v<DataType, DataTypeString>) {
+            parseStrings(static_cast<ColumnString&>(*values), null_map, fields, csv);
+        } else if constexpr (IsDataTypeDecimal<DataType>) {
+            using FieldType = typename DataType::FieldType;
+            const auto& decimal_type = static_cast<const DataType&>(*values_type);
+            UInt32 precision = decimal_type.getPrecision();
+            UInt32 scale = decimal_type.getScale();
+            auto& data = static_cast<typename DataType::ColumnType&>(*values).getData();
+            parseValues(data, null_map, fields, csv,
+                        [precision, scale](const char* begin, const char* end, FieldType& value) {
+                            return parseDecimal(begin, end, precision, scale, value);
+                        });
+        } else {
+            using FieldType = typename DataType::FieldType;
+            auto& data = static_cast<ColumnVector<FieldType>&>(*values).getData();
+            parseValues(data, null_map, fields, csv,
+                        [](const char* begin, const char* end, FieldType& value) {
+                            return parseNumber(begin, end, value);
+                        });
+        }
+        return true;
+    });
+}
+
+namespace {
+
+/// Chunks of a file, parsed by whichever threads claim them.
+class ParallelChunks {
+public:
+    ParallelChunks(size_t size_, std::function<void(size_t)> parse_)
+            : size(size_), remaining(size_), parse(std::move(parse_)) {}
+
+    /// Parses the chunks not claimed yet.
+    void run() {
+        for (size_t i = next.fetch_add(1); i < size; i = next.fetch_add(1)) {
+            std::exception_ptr error;
+            try {
+                parse(i);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard lock(mutex);
+            if (error && !exception) exception = error;
+            if (--remaining == 0) finished.notify_all();
+        }
+    }
+
+    /// Waits for the chunks claimed by the other threads, and rethrows the first error.
+    void wait() {
+        std::unique_lock lock(mutex);
+        finished.wait(lock, [this] { return remaining == 0; });
+        if (exception) std::rethrow_exception(exception);
+    }
+
+private:
+    const size_t size;
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t remaining;
+    std::exception_ptr exception;
+    std::function<void(size_t)> parse;
+};
+
+} // namespace
+
+Blocks TextReader::readFile(const String& path, WorkStealingThreadPool* pool) const {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        throwFromErrnoWithPath("Cannot open file " + path, path, ErrorCodes::CANNOT_OPEN_FILE);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throwFromErrnoWithPath("Cannot stat file " + path, path, ErrorCodes::CANNOT_STAT);
+    }
+    size_t size = st.st_size;
+    if (size == 0) {
+        close(fd);
+        return {};
+    }
+
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    /// The mapping does not need the descriptor.
+    close(fd);
+    if (mapped == MAP_FAILED)
+        throwFromErrnoWithPath("Cannot mmap file " + path, path, ErrorCodes::SYSTEM_ERROR);
+    std::shared_ptr<const void> mapping(mapped, [size](const void* ptr) {
+        munmap(const_cast<void*>(ptr), size);
+    });
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(mapped);
+    size_t start = settings.with_names ? findEndOfRow(data, data + size) : 0;
+    auto chunks = splitIntoChunks(data + start, data + size);
+
+    std::vector<Blocks> chunk_blocks(chunks.size());
+    auto parse_chunk = [&](size_t i) {
+        parseImpl(data + start + chunks[i].first, data + start + chunks[i].second,
+                  start + chunks[i].first, chunk_blocks[i]);
+    };
+
+    if (pool && chunks.size() > 1) {
+        /// The chunks are claimed one by one by the helper jobs and by the calling thread, that
+        /// parses too instead of only waiting. So the call does not depend on free workers and
+        /// can be made from a worker of the same pool. The helpers may start after the return,
+        /// then they find nothing to claim and only touch the shared context.
+        auto context = std::make_shared<ParallelChunks>(chunks.size(), parse_chunk);
+        size_t helpers = std::min(chunks.size(), pool->getNumberOfThreads());
+        for (size_t i = 0; i < helpers; ++i) pool->schedule([context] { context->run(); });
+        context->run();
+        context->wait();
+    } else {
+        for (size_t i = 0; i < chunks.size(); ++i) parse_chunk(i);
+    }
+
+    Blocks res;
+    for (auto& blocks : chunk_blocks)
+        for (auto& block : blocks) res.push_back(std::move(block));
+    return res;
+}
+
+} // namespace doris::vectorized
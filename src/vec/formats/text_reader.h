@@ -0,0 +1,92 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "vec/core/block.h"
+#include "vec/common/pod_array.h"
+
+namespace doris::vectorized {
+
+class WorkStealingThreadPool;
+
+struct TextReaderSettings {
+    enum class Format {
+        /// Fields may be quoted with ", a quote in a quoted field is doubled.
+        CSV,
+        /// Fields are escaped with backslashes: \t, \n, \\ and so on.
+        TSV,
+    };
+    Format format = Format::CSV;
+    /// 0 means ',' for CSV and '\t' for TSV.
+    char delimiter = 0;
+    /// The first row has the names of the columns and is skipped by readFile().
+    bool with_names = false;
+    size_t max_block_rows = 65536;
+    /// readFile() splits the file into chunks of about this size, parsed in parallel.
+    size_t chunk_bytes = 16 << 20;
+};
+
+/** Parses CSV or TSV text into blocks of the structure of the header, matching fields with
+  * columns by position. Columns can be numbers, decimals, strings and Nullable of them.
+  * \N is NULL, and so is an empty unquoted CSV field; other empty fields are default values.
+  *
+  * Parsing has two passes. The first finds all separators of fields in the text at once:
+  * 64 bytes at a time, it makes bitmasks of delimiters, newlines and quotes with SSE2, and
+  * the separators inside quotes are removed by the prefix XOR of the quote mask. The second
+  * parses the fields column by column, directly into the columns.
+  *
+  * Usage:
+  *     TextReader reader(header, settings);
+  *     Blocks blocks = reader.readFile(path, &pool);
+  */
+class TextReader {
+public:
+    TextReader(const Block& header_, const TextReaderSettings& settings_);
+
+    /// Parses rows from [begin, end), the last of them may have no newline.
+    /// Appends blocks of at most max_block_rows rows to res. Thread-safe.
+    void parse(const char* begin, const char* end, Blocks& res) const;
+
+    /// Parses a whole file, in chunks parsed by the pool if it is given.
+    Blocks readFile(const String& path, WorkStealingThreadPool* pool = nullptr) const;
+
+    /// Splits [begin, end) at the starts of rows into ranges of about chunk_bytes, relative
+    /// to begin. Newlines in quoted fields are not the ends of rows.
+    std::vector<std::pair<size_t, size_t>> splitIntoChunks(const char* begin,
+                                                           const char* end) const;
+
+private:
+    /// offset is the position of begin in the file, for messages.
+    void parseImpl(const char* begin, const char* end, size_t offset, Blocks& res) const;
+    /// Appends the positions of the separators of fields outside of quotes.
+    void findSeparators(const char* begin, const char* end, PaddedPODArray<UInt64>& res) const;
+    /// Position after the end of the first row.
+    size_t findEndOfRow(const char* begin, const char* end) const;
+
+    struct Fields;
+    void parseColumn(IColumn& column, const IDataType& type, const Fields& fields) const;
+
+    const Block header;
+    const TextReaderSettings settings;
+    const char delimiter;
+};
+
+} // namespace doris::vectorized
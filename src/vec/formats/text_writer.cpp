@@ -0,0 +1,392 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/formats/text_writer.h"
+
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/exception.h"
+#include "vec/common/find_symbols.h"
+#include "vec/common/itoa.h"
+#include "vec/common/memcpy_small.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/core/call_on_type_index.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int BAD_ARGUMENTS;
+extern const int LOGICAL_ERROR;
+extern const int NOT_IMPLEMENTED;
+extern const int CANNOT_WRITE_TO_FILE_DESCRIPTOR;
+} // namespace ErrorCodes
+
+namespace {
+
+/// Max length of a formatted number: 20 digits and the sign of Int64, 24 characters of
+/// the shortest Float64, 38 digits, the sign and the point of Decimal128.
+constexpr size_t max_number_size = 48;
+
+/// Formats values of rows [0, rows) with format(row, pos) -> end, or the null literal.
+template <typename Format>
+void formatValues(size_t rows, const NullMap* null_map, const String& null_literal,
+                  PaddedPODArray<char>& chars, PaddedPODArray<UInt64>& offsets,
+                  Format&& format) {
+    chars.resize(rows * std::max(max_number_size, null_literal.size()));
+    offsets.resize(rows);
+    char* begin = chars.data();
+    char* pos = begin;
+    for (size_t row = 0; row < rows; ++row) {
+        if (null_map && (*null_map)[row]) {
+            memcpy(pos, null_literal.data(), null_literal.size());
+            pos += null_literal.size();
+        } else {
+            pos = format(row, pos);
+        }
+        offsets[row] = pos - begin;
+    }
+    chars.resize(pos - begin);
+}
+
+template <typename T>
+char* writeDecimal(T value, UInt32 scale, T multiplier, char* pos) {
+    if (scale == 0) return itoa(value, pos);
+    T whole = value / multiplier;
+    T fractional = value % multiplier;
+    if (value < 0) {
+        *pos++ = '-';
+        whole = -whole;
+        fractional = -fractional;
+    }
+    pos = itoa(whole, pos);
+    *pos++ = '.';
+    for (size_t i = scale; i-- > 0;) {
+        pos[i] = '0' + fractional % 10;
+        fractional /= 10;
+    }
+    return pos + scale;
+}
+
+/// The first character that is escaped in a JSON string: a quote, a backslash or a control one.
+const char* findFirstJSONEscape(const char* pos, const char* end) {
+#ifdef __SSE2__
+    const __m128i max_control = _mm_set1_epi8(0x1F);
+    for (; pos + 16 <= end; pos += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(bytes, max_control), bytes);
+        int mask = _mm_movemask_epi8(_mm_or_si128(detail::mm_is_in<'"', '\\'>(bytes), control));
+        if (mask) return pos + __builtin_ctz(mask);
+    }
+#endif
+    for (; pos < end; ++pos)
+        if (*pos == '"' || *pos == '\\' || static_cast<UInt8>(*pos) < 0x20) return pos;
+    return end;
+}
+
+/// The escape sequences of TSV and JSON for a character, 0 if it has none.
+char escapeLetter(char c) {
+    switch (c) {
+    case '\n':
+        return 'n';
+    case '\t':
+        return 't';
+    case '\r':
+        return 'r';
+    case '\b':
+        return 'b';
+    case '\f':
+        return 'f';
+    case '\\':
+        return '\\';
+    case '"':
+        return '"';
+    default:
+        return 0;
+    }
+}
+
+char* writeCSVString(const char* data, const char* end, char* pos) {
+    *pos++ = '"';
+    while (true) {
+        const char* quote = find_first_symbols<'"'>(data, end);
+        memcpy(pos, data, quote - data);
+        pos += quote - data;
+        if (quote == end) break;
+        *pos++ = '"';
+        *pos++ = '"';
+        data = quote + 1;
+    }
+    *pos++ = '"';
+    return pos;
+}
+
+char* writeTSVString(const char* data, const char* end, char* pos) {
+    while (true) {
+        const char* special =
+                find_first_symbols<'\\', '\t', '\n', '\r', '\0', '\b', '\f'>(data, end);
+        memcpy(pos, data, special - data);
+        pos += special - data;
+        if (special == end) break;
+        *pos++ = '\\';
+        *pos++ = *special ? escapeLetter(*special) : '0';
+        data = special + 1;
+    }
+    return pos;
+}
+
+char* writeJSONString(const char* data, const char* end, char* pos) {
+    static const char hex_digits[] = "0123456789abcdef";
+    *pos++ = '"';
+    while (true) {
+        const char* special = findFirstJSONEscape(data, end);
+        memcpy(pos, data, special - data);
+        pos += special - data;
+        if (special == end) break;
+        *pos++ = '\\';
+        if (char letter = escapeLetter(*special)) {
+            *pos++ = letter;
+        } else {
+            memcpy(pos, "u00", 3);
+            pos[3] = hex_digits[static_cast<UInt8>(*special) >> 4];
+            pos[4] = hex_digits[*special & 0xF];
+            pos += 5;
+        }
+        data = special + 1;
+    }
+    *pos++ = '"';
+    return pos;
+}
+
+} // namespace
+
+TextWriter::TextWriter(int fd_, const Block& header_, const TextWriterSettings& settings_)
+        : fd(fd_),
+          header(header_.cloneEmpty()),
+          settings(settings_),
+          delimiter(settings.delimiter
+                            ? settings.delimiter
+                            : (settings.format == TextWriterSettings::Format::TSV ? '\t' : ',')) {
+    if (delimiter == '\n' || delimiter == '\r' || delimiter == '"' || delimiter == '\\')
+        throw Exception(String("Bad delimiter '") + delimiter + "' for a text format",
+                        ErrorCodes::BAD_ARGUMENTS);
+
+    for (const auto& elem : header) {
+        bool supported = callOnIndexAndDataType<void>(
+                removeNullable(elem.type)->getTypeId(), [](const auto&) { return true; });
+        if (!supported)
+            throw Exception("Type " + elem.type->getName() + " of column " + elem.name +
+                                    " is not supported by text formats",
+                            ErrorCodes::NOT_IMPLEMENTED);
+    }
+    columns.resize(header.columns());
+    buffer.reserve(settings.buffer_size);
+
+    if (settings.format == TextWriterSettings::Format::JSONEachRow) {
+        PaddedPODArray<char> key;
+        for (size_t i = 0; i < header.columns(); ++i) {
+            key.clear();
+            if (i) key.push_back(',');
+            appendString(header.getByPosition(i).name.data(), header.getByPosition(i).name.size(),
+                         key);
+            key.push_back(':');
+            json_keys.emplace_back(key.begin(), key.end());
+        }
+    } else if (settings.with_names) {
+        for (size_t i = 0; i < header.columns(); ++i) {
+            if (i) buffer.push_back(delimiter);
+            const String& name = header.getByPosition(i).name;
+            appendString(name.data(), name.size(), buffer);
+        }
+        buffer.push_back('\n');
+    }
+}
+
+void TextWriter::appendString(const char* data, size_t size, PaddedPODArray<char>& res) const {
+    size_t old_size = res.size();
+    switch (settings.format) {
+    case TextWriterSettings::Format::CSV:
+        res.resize(old_size + size * 2 + 2);
+        res.resize(writeCSVString(data, data + size, &res[old_size]) - res.data());
+        break;
+    case TextWriterSettings::Format::TSV:
+        res.resize(old_size + size * 2);
+        res.resize(writeTSVString(data, data + size, &res[old_size]) - res.data());
+        break;
+    case TextWriterSettings::Format::JSONEachRow:
+        res.resize(old_size + size * 6 + 2);
+        res.resize(writeJSONString(data, data + size, &res[old_size]) - res.data());
+        break;
+    }
+}
+
+void TextWriter::formatColumn(const IColumn& column, const IDataType& type,
+                              ColumnText& res) const {
+    const bool json = settings.format == TextWriterSettings::Format::JSONEachRow;
+    static const String json_null = "null";
+    static const String text_null = "\\N";
+    const String& null_literal = json ? json_null : text_null;
+
+    const IColumn* values = &column;
+    const IDataType* values_type = &type;
+    const NullMap* null_map = nullptr;
+    if (const auto* nullable = typeid_cast<const ColumnNullable*>(&column)) {
+        values = &nullable->getNestedColumn();
+        values_type = static_cast<const DataTypeNullable&>(type).getNestedType().get();
+        null_map = &nullable->getNullMapData();
+    }
+
+    const size_t rows = column.size();
+    res.chars.clear();
+    res.offsets.clear();
+
+    callOnIndexAndDataType<void>(values_type->getTypeId(), [&](const auto& types) {
+        using Types = std::decay_t<decltype(types)>;
+        using DataType = typename Types::LeftType;
+
+        if constexpr (std::is_same_v<DataType, DataTypeString>) {
+            const auto& string_column = static_cast<const ColumnString&>(*values);
+            const auto& chars = string_column.getChars();
+            const auto& offsets = string_column.getOffsets();
+            res.offsets.resize(rows);
+            /// The most common case of no escaping, and the quotes.
+            res.chars.reserve(chars.size() + rows * 2);
+            for (size_t row = 0; row < rows; ++row) {
+                if (null_map && (*null_map)[row]) {
+                    res.chars.insert(null_literal.begin(), null_literal.end());
+                } else {
+                    /// Without the terminating zero.
+                    const char* data = reinterpret_cast<const char*>(&chars[offsets[row - 1]]);
+                    appendString(data, offsets[row] - offsets[row - 1] - 1, res.chars);
+                }
+                res.offsets[row] = res.chars.size();
+            }
+        } else if constexpr (IsDataTypeDecimal<DataType>) {
+            using NativeType = typename DataType::FieldType::NativeType;
+            const auto& decimal_type = static_cast<const DataType&>(*values_type);
+            UInt32 scale = decimal_type.getScale();
+            NativeType multiplier = decimal_type.getScaleMultiplier().value;
+            const auto& data = static_cast<const typename DataType::ColumnType&>(*values).getData();
+            formatValues(rows, null_map, null_literal, res.chars, res.offsets,
+                         [&](size_t row, char* pos) {
+                             return writeDecimal(data[row].value, scale, multiplier, pos);
+                         });
+        } else {
+            using FieldType = typename DataType::FieldType;
+            const auto& data = static_cast<const ColumnVector<FieldType>&>(*values).getData();
+            formatValues(rows, null_map, null_literal, res.chars, res.offsets,
+                         [&](size_t row, char* pos) {
+                             if constexpr (std::is_floating_point_v<FieldType>) {
+                                 /// JSON has no infinities and NaN.
+                                 if (json && !std::isfinite(data[row])) {
+                                     memcpy(pos, "null", 4);
+                                     return pos + 4;
+                                 }
+                                 return std::to_chars(pos, pos + max_number_size, data[row]).ptr;
+                             } else {
+                                 return itoa(data[row], pos);
+                             }
+                         });
+        }
+        return true;
+    });
+}
+
+void TextWriter::write(const Block& block) {
+    if (block.columns() != header.columns())
+        throw Exception("Block has " + std::to_string(block.columns()) +
+                                " columns, but the output has " +
+                                std::to_string(header.columns()),
+                        ErrorCodes::LOGICAL_ERROR);
+
+    const size_t num_columns = columns.size();
+    for (size_t i = 0; i < num_columns; ++i) {
+        ColumnPtr column = block.getByPosition(i)
+                                   .column->convertToFullColumnIfConst()
+                                   ->convertToFullColumnIfSparse()
+                                   ->convertToFullColumnIfRLE();
+        formatColumn(*column, *header.getByPosition(i).type, columns[i]);
+    }
+
+    const bool json = settings.format == TextWriterSettings::Format::JSONEachRow;
+    const size_t rows = block.rows();
+    for (size_t row = 0; row < rows; ++row) {
+        /// The delimiters, or the braces and the keys, and the newline.
+        size_t row_size = json ? 3 : num_columns;
+        for (size_t i = 0; i < num_columns; ++i) {
+            row_size += columns[i].offsets[row] - columns[i].offsets[row - 1];
+            if (json) row_size += json_keys[i].size();
+        }
+        if (buffer.size() + row_size > settings.buffer_size && !buffer.empty()) flush();
+
+        size_t old_size = buffer.size();
+        buffer.resize(old_size + row_size);
+        char* pos = &buffer[old_size];
+        if (json) *pos++ = '{';
+        for (size_t i = 0; i < num_columns; ++i) {
+            if (json) {
+                memcpy(pos, json_keys[i].data(), json_keys[i].size());
+                pos += json_keys[i].size();
+            } else if (i) {
+                *pos++ = delimiter;
+            }
+            const ColumnText& text = columns[i];
+            size_t begin = text.offsets[row - 1];
+            size_t size = text.offsets[row] - begin;
+            /// Both arrays are padded.
+            memcpySmallAllowReadWriteOverflow15(pos, &text.chars[begin], size);
+            pos += size;
+        }
+        if (json) *pos++ = '}';
+        *pos++ = '\n';
+    }
+    if (buffer.size() > settings.buffer_size) flush();
+}
+
+void TextWriter::flush() {
+    const char* data = buffer.data();
+    size_t size = buffer.size();
+    while (size) {
+        ssize_t res = ::write(fd, data, size);
+        if (res < 0) {
+            if (errno == EINTR) continue;
+            throwFromErrno("Cannot write to file descriptor " + std::to_string(fd),
+                           ErrorCodes::CANNOT_WRITE_TO_FILE_DESCRIPTOR);
+        }
+        data += res;
+        size -= res;
+        bytes_written += res;
+    }
+    buffer.clear();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,94 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <vector>
+
+#include "vec/common/pod_array.h"
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+struct TextWriterSettings {
+    enum class Format {
+        /// Strings are always quoted with ", a quote in a string is doubled.
+        CSV,
+        /// Tabs, newlines, backslashes and other control characters are escaped.
+        TSV,
+        /// A JSON object per line, with the names of the columns as keys.
+        JSONEachRow,
+    };
+    Format format = Format::CSV;
+    /// 0 means ',' for CSV and '\t' for TSV. Not used by JSONEachRow.
+    char delimiter = 0;
+    /// Write the names of the columns as the first row of CSV and TSV.
+    bool with_names = false;
+    /// Output is flushed when it is larger than this.
+    size_t buffer_size = 1 << 20;
+};
+
+/** Writes blocks as text to a file descriptor, in the formats read by TextReader.
+  * NULL is \N in CSV and TSV and null in JSON.
+  *
+  * A block is formatted column by column: all values of a column are written one after another
+  * into a scratch buffer, with the end of every value in offsets, so the loops over the values
+  * have no virtual calls and no dispatch by type. Then the rows are assembled from the scratch
+  * buffers into the output buffer.
+  *
+  * Usage:
+  *     TextWriter writer(fd, header, settings);
+  *     while (...) writer.write(block);
+  *     writer.flush();
+  *
+  * The descriptor is not owned. The destructor does not flush, so that errors are not lost.
+  */
+class TextWriter : private boost::noncopyable {
+public:
+    TextWriter(int fd_, const Block& header_, const TextWriterSettings& settings_ = {});
+
+    void write(const Block& block);
+    void flush();
+
+    /// Including the bytes that are not flushed yet.
+    size_t bytesWritten() const { return bytes_written + buffer.size(); }
+
+private:
+    struct ColumnText {
+        PaddedPODArray<char> chars;
+        /// Ends of values in chars.
+        PaddedPODArray<UInt64> offsets;
+    };
+
+    void formatColumn(const IColumn& column, const IDataType& type, ColumnText& res) const;
+    /// Appends a string in the format, with quotes or escapes.
+    void appendString(const char* data, size_t size, PaddedPODArray<char>& res) const;
+
+    const int fd;
+    const Block header;
+    const TextWriterSettings settings;
+    const char delimiter;
+
+    /// For JSONEachRow, "name": of every column, with the separating comma after the first.
+    std::vector<String> json_keys;
+    std::vector<ColumnText> columns;
+    PaddedPODArray<char> buffer;
+    size_t bytes_written = 0;
+};
+
+} // namespace doris::vectorized
@@ -18,10 +18,14 @@
 #include "vec/functions/function.h"
 //#include <vec/Common/config.h>
 #include "vec/common/assert_cast.h"
+#include "vec/common/memory_tracker.h"
+#include "vec/common/perf_events.h"
 #include "vec/common/typeid_cast.h"
 //#include <vec/Common/LRUCache.h>
 #include "vec/columns/column_const.h"
 #include "vec/columns/column_nullable.h"
+#include "vec/columns/column_rle.h"
+#include "vec/columns/column_sparse.h"
 //#include <vec/Columns/ColumnArray.h>
 //#include <vec/Columns/ColumnTuple.h>
 //#include <vec/Columns/ColumnLowCardinality.h>
@@ -264,6 +268,130 @@ bool PreparedFunctionImpl::defaultImplementationForConstantArguments(Block& bloc
         result_column = temporary_block.getByPosition(arguments_size).column;
 
     block.getByPosition(result).column = ColumnConst::create(result_column, input_rows_count);
+    if (auto* counters = QueryProfile::currentCounters())
+        ProfileCounters::add(counters->const_default_rows, input_rows_count);
+    return true;
+}
+
+bool PreparedFunctionImpl::defaultImplementationForSparseColumns(Block& block,
+                                                                 const ColumnNumbers& args,
+                                                                 size_t result,
+                                                                 size_t input_rows_count,
+                                                                 bool dry_run) {
+    const ColumnSparse* sparse = nullptr;
+    size_t num_sparse = 0;
+    bool others_are_const = true;
+    for (auto arg : args) {
+        const IColumn& column = *block.getByPosition(arg).column;
+        if (const auto* sparse_column = typeid_cast<const ColumnSparse*>(&column)) {
+            sparse = sparse_column;
+            ++num_sparse;
+        } else if (!isColumnConst(column)) {
+            others_are_const = false;
+        }
+    }
+
+    if (!sparse) return false;
+
+    /// Execute the function on the values of the sparse column, or on full columns,
+    /// in a block with only the arguments and the result.
+    const bool on_values = num_sparse == 1 && others_are_const &&
+                           useDefaultImplementationForSparseColumns() &&
+                           canBeExecutedOnDefaultArguments();
+    const size_t rows = on_values ? sparse->getValuesColumn().size() : input_rows_count;
+
+    Block temporary_block;
+    size_t arguments_size = args.size();
+    for (auto arg : args) {
+        ColumnWithTypeAndName column = block.getByPosition(arg);
+        if (!on_values)
+            column.column = column.column->convertToFullColumnIfSparse();
+        else if (column.column->isSparse())
+            column.column = sparse->getValuesColumnPtr();
+        else
+            column.column = column.column->cloneResized(rows);
+        temporary_block.insert(std::move(column));
+    }
+    temporary_block.insert(block.getByPosition(result));
+
+    ColumnNumbers temporary_argument_numbers(arguments_size);
+    for (size_t i = 0; i < arguments_size; ++i) temporary_argument_numbers[i] = i;
+
+    executeWithoutLowCardinalityColumns(temporary_block, temporary_argument_numbers,
+                                        arguments_size, rows, dry_run);
+
+    ColumnPtr result_column = temporary_block.getByPosition(arguments_size).column;
+    if (on_values) {
+        ColumnPtr values = result_column->convertToFullColumnIfConst();
+        result_column = ColumnSparse::create(values, sparse->getOffsetsPtr(), input_rows_count);
+        /// The listed rows must differ from the common value, values[0], or the result is full.
+        for (size_t i = 1; i < rows; ++i) {
+            if (values->compareAt(i, 0, *values, 1) == 0) {
+                result_column = result_column->convertToFullColumnIfSparse();
+                break;
+            }
+        }
+        if (auto* counters = QueryProfile::currentCounters())
+            ProfileCounters::add(counters->sparse_default_rows, input_rows_count);
+    }
+    block.getByPosition(result).column = std::move(result_column);
+    return true;
+}
+
+bool PreparedFunctionImpl::defaultImplementationForRLEColumns(Block& block,
+                                                              const ColumnNumbers& args,
+                                                              size_t result,
+                                                              size_t input_rows_count,
+                                                              bool dry_run) {
+    const ColumnRLE* runs = nullptr;
+    bool same_runs = true;
+    for (auto arg : args) {
+        const IColumn& column = *block.getByPosition(arg).column;
+        if (const auto* rle = typeid_cast<const ColumnRLE*>(&column)) {
+            if (!runs)
+                runs = rle;
+            else if (!rle->hasSameRuns(*runs))
+                same_runs = false;
+        } else if (!isColumnConst(column)) {
+            same_runs = false;
+        }
+    }
+
+    if (!runs) return false;
+
+    /// Execute the function on the values of the runs, or on full columns,
+    /// in a block with only the arguments and the result.
+    const bool on_values = same_runs && useDefaultImplementationForRLEColumns();
+    const size_t rows = on_values ? runs->getNumberOfRuns() : input_rows_count;
+
+    Block temporary_block;
+    size_t arguments_size = args.size();
+    for (auto arg : args) {
+        ColumnWithTypeAndName column = block.getByPosition(arg);
+        if (!on_values)
+            column.column = column.column->convertToFullColumnIfRLE();
+        else if (const auto* rle = typeid_cast<const ColumnRLE*>(column.column.get()))
+            column.column = rle->getValuesColumnPtr();
+        else
+            column.column = column.column->cloneResized(rows);
+        temporary_block.insert(std::move(column));
+    }
+    temporary_block.insert(block.getByPosition(result));
+
+    ColumnNumbers temporary_argument_numbers(arguments_size);
+    for (size_t i = 0; i < arguments_size; ++i) temporary_argument_numbers[i] = i;
+
+    executeWithoutLowCardinalityColumns(temporary_block, temporary_argument_numbers,
+                                        arguments_size, rows, dry_run);
+
+    ColumnPtr result_column = temporary_block.getByPosition(arguments_size).column;
+    if (on_values) {
+        result_column =
+                ColumnRLE::create(result_column->convertToFullColumnIfConst(), runs->getEndsPtr());
+        if (auto* counters = QueryProfile::currentCounters())
+            ProfileCounters::add(counters->rle_default_rows, input_rows_count);
+    }
+    block.getByPosition(result).column = std::move(result_column);
     return true;
 }
 
@@ -277,6 +405,8 @@ bool PreparedFunctionImpl::defaultImplementationForNulls(Block& block, const Col
     if (null_presence.has_null_constant) {
         block.getByPosition(result).column =
                 block.getByPosition(result).type->createColumnConst(input_rows_count, Null());
+        if (auto* counters = QueryProfile::currentCounters())
+            ProfileCounters::add(counters->null_default_rows, input_rows_count);
         return true;
     }
 
@@ -287,6 +417,8 @@ bool PreparedFunctionImpl::defaultImplementationForNulls(Block& block, const Col
         block.getByPosition(result).column =
                 wrapInNullable(temporary_block.getByPosition(result).column, block, args, result,
                                input_rows_count);
+        if (auto* counters = QueryProfile::currentCounters())
+            ProfileCounters::add(counters->null_default_rows, input_rows_count);
         return true;
     }
 
@@ -301,6 +433,12 @@ void PreparedFunctionImpl::executeWithoutLowCardinalityColumns(Block& block,
     if (defaultImplementationForConstantArguments(block, args, result, input_rows_count, dry_run))
         return;
 
+    if (defaultImplementationForSparseColumns(block, args, result, input_rows_count, dry_run))
+        return;
+
+    if (defaultImplementationForRLEColumns(block, args, result, input_rows_count, dry_run))
+        return;
+
     if (defaultImplementationForNulls(block, args, result, input_rows_count, dry_run)) return;
 
     if (dry_run)
@@ -399,6 +537,37 @@ void PreparedFunctionImpl::executeWithoutLowCardinalityColumns(Block& block,
 
 void PreparedFunctionImpl::execute(Block& block, const ColumnNumbers& args, size_t result,
                                    size_t input_rows_count, bool dry_run) {
+    if (UNLIKELY(QueryProfile::current() != nullptr))
+        executeWithProfile(block, args, result, input_rows_count, dry_run);
+    else
+        executeWithoutProfile(block, args, result, input_rows_count, dry_run);
+}
+
+void PreparedFunctionImpl::executeWithProfile(Block& block, const ColumnNumbers& args,
+                                              size_t result, size_t input_rows_count,
+                                              bool dry_run) {
+    auto* node = profile_node.get(*QueryProfile::current(), getName());
+    auto& counters = node->counters;
+
+    UInt64 allocated_before = CurrentMemoryTracker::allocatedBytes();
+    UInt64 start_ns = clockMonotonicNanoseconds();
+    {
+        /// Functions executed by this one (e.g. by CAST) become its children.
+        QueryProfile::NodeScope node_scope(node);
+        PerfEventsScope perf_events_scope;
+        executeWithoutProfile(block, args, result, input_rows_count, dry_run);
+    }
+    ProfileCounters::add(counters.nanoseconds, clockMonotonicNanoseconds() - start_ns);
+    ProfileCounters::add(counters.allocated_bytes,
+                         CurrentMemoryTracker::allocatedBytes() - allocated_before);
+    ProfileCounters::add(counters.calls, 1);
+    ProfileCounters::add(counters.rows_in, input_rows_count);
+    ProfileCounters::add(counters.rows_out, block.getByPosition(result).column->size());
+}
+
+void PreparedFunctionImpl::executeWithoutProfile(Block& block, const ColumnNumbers& args,
+                                                 size_t result, size_t input_rows_count,
+                                                 bool dry_run) {
     if (useDefaultImplementationForLowCardinalityColumns()) {
         auto& res = block.safeGetByPosition(result);
         Block block_without_low_cardinality = block.cloneWithoutColumns();
@@ -20,6 +20,7 @@
 #include <memory>
 
 //#include "config_core.h"
+#include "vec/common/query_profile.h"
 #include "vec/core/block.h"
 #include "vec/core/column_numbers.h"
 #include "vec/core/names.h"
@@ -102,6 +103,22 @@ protected:
       */
     virtual bool useDefaultImplementationForLowCardinalityColumns() const { return true; }
 
+    /** If function arguments has single sparse column and all other arguments are constants,
+      *  call function on the values of the sparse column and return a sparse column with the
+      *  same offsets: the function is computed once for all the rows with the common value.
+      * Otherwise, convert all sparse columns to ordinary columns.
+      * Functions opt in: only those whose result in a row depends on this row only may return true.
+      */
+    virtual bool useDefaultImplementationForSparseColumns() const { return false; }
+
+    /** If function arguments are run-length encoded columns with the same runs and constants,
+      *  call function on the values of the runs and return ColumnRLE with these runs:
+      *  the function is computed once per run instead of once per row.
+      * Otherwise, convert all run-length encoded columns to ordinary columns.
+      * Functions opt in: only those whose result in a row depends on this row only may return true.
+      */
+    virtual bool useDefaultImplementationForRLEColumns() const { return false; }
+
     /** Some arguments could remain constant during this implementation.
       */
     virtual ColumnNumbers getArgumentsThatAreAlwaysConstant() const { return {}; }
@@ -112,16 +129,29 @@ protected:
     virtual bool canBeExecutedOnDefaultArguments() const { return true; }
 
 private:
+    void executeWithoutProfile(Block& block, const ColumnNumbers& arguments, size_t result,
+                               size_t input_rows_count, bool dry_run);
+    void executeWithProfile(Block& block, const ColumnNumbers& arguments, size_t result,
+                            size_t input_rows_count, bool dry_run);
+
     bool defaultImplementationForNulls(Block& block, const ColumnNumbers& args, size_t result,
                                        size_t input_rows_count, bool dry_run);
     bool defaultImplementationForConstantArguments(Block& block, const ColumnNumbers& args,
                                                    size_t result, size_t input_rows_count,
                                                    bool dry_run);
+    bool defaultImplementationForSparseColumns(Block& block, const ColumnNumbers& args,
+                                               size_t result, size_t input_rows_count,
+                                               bool dry_run);
+    bool defaultImplementationForRLEColumns(Block& block, const ColumnNumbers& args,
+                                            size_t result, size_t input_rows_count,
+                                            bool dry_run);
     void executeWithoutLowCardinalityColumns(Block& block, const ColumnNumbers& arguments,
                                              size_t result, size_t input_rows_count, bool dry_run);
 
     /// Cache is created by function createLowCardinalityResultCache()
     PreparedFunctionLowCardinalityResultCachePtr low_cardinality_result_cache;
+
+    ProfileNodeHandle profile_node;
 };
 
 using ValuePlaceholders = std::vector<std::function<llvm::Value*()>>;
@@ -388,6 +418,8 @@ public:
     bool useDefaultImplementationForNulls() const override { return true; }
     bool useDefaultImplementationForConstants() const override { return false; }
     bool useDefaultImplementationForLowCardinalityColumns() const override { return true; }
+    bool useDefaultImplementationForSparseColumns() const override { return false; }
+    bool useDefaultImplementationForRLEColumns() const override { return false; }
     ColumnNumbers getArgumentsThatAreAlwaysConstant() const override { return {}; }
     bool canBeExecutedOnDefaultArguments() const override { return true; }
     bool canBeExecutedOnLowCardinalityDictionary() const override {
@@ -486,6 +518,12 @@ protected:
     bool useDefaultImplementationForLowCardinalityColumns() const final {
         return function->useDefaultImplementationForLowCardinalityColumns();
     }
+    bool useDefaultImplementationForSparseColumns() const final {
+        return function->useDefaultImplementationForSparseColumns();
+    }
+    bool useDefaultImplementationForRLEColumns() const final {
+        return function->useDefaultImplementationForRLEColumns();
+    }
     ColumnNumbers getArgumentsThatAreAlwaysConstant() const final {
         return function->getArgumentsThatAreAlwaysConstant();
     }
@@ -682,6 +682,8 @@ public:
     }
 
     size_t getNumberOfArguments() const override { return 2; }
+    bool useDefaultImplementationForSparseColumns() const override { return true; }
+    bool useDefaultImplementationForRLEColumns() const override { return true; }
 
     DataTypePtr getReturnTypeImpl(const DataTypes & arguments) const override
     {
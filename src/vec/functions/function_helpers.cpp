@@ -22,6 +22,8 @@
 //#include <vec/Columns/ColumnString.h>
 //#include <vec/Columns/ColumnFixedString.h>
 #include "vec/columns/column_nullable.h"
+#include "vec/columns/column_rle.h"
+#include "vec/columns/column_sparse.h"
 //#include <vec/Common/assert_cast.h>
 #include "vec/data_types/data_type_nullable.h"
 //#include <IO/WriteHelpers.h>
@@ -84,6 +86,19 @@ static Block createBlockWithNestedColumnsImpl(const Block& block,
                                 ->getNestedColumnPtr();
                 res.insert({ColumnConst::create(nested_col, col.column->size()), nested_type,
                             col.name});
+            } else if (auto* sparse = checkAndGetColumn<ColumnSparse>(*col.column)) {
+                const auto& nested_col =
+                        assert_cast<const ColumnNullable&>(sparse->getValuesColumn())
+                                .getNestedColumnPtr();
+                res.insert({ColumnSparse::create(nested_col, sparse->getOffsetsPtr(),
+                                                 col.column->size()),
+                            nested_type, col.name});
+            } else if (auto* rle = checkAndGetColumn<ColumnRLE>(*col.column)) {
+                const auto& nested_col =
+                        assert_cast<const ColumnNullable&>(rle->getValuesColumn())
+                                .getNestedColumnPtr();
+                res.insert({ColumnRLE::create(nested_col, rle->getEndsPtr()), nested_type,
+                            col.name});
             } else
                 throw Exception("Illegal column for DataTypeNullable", ErrorCodes::ILLEGAL_COLUMN);
         } else
@@ -95,6 +95,8 @@ public:
     bool isInjective(const Block&) override { return is_injective; }
 
     bool useDefaultImplementationForConstants() const override { return true; }
+    bool useDefaultImplementationForSparseColumns() const override { return true; }
+    bool useDefaultImplementationForRLEColumns() const override { return true; }
 
     DataTypePtr getReturnTypeImpl(const DataTypes& arguments) const override {
         DataTypePtr result;
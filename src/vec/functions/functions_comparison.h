@@ -545,6 +545,8 @@ public:
     FunctionComparison() {}
 
     bool useDefaultImplementationForNulls() const override { return false; }
+    bool useDefaultImplementationForSparseColumns() const override { return true; }
+    bool useDefaultImplementationForRLEColumns() const override { return true; }
 private:
     //    const Context & context;
     //    bool check_decimal_overflow = true;
@@ -133,6 +133,8 @@ public:
     bool useDefaultImplementationForNulls() const override {
         return !Impl::specialImplementationForNulls();
     }
+    bool useDefaultImplementationForSparseColumns() const override { return true; }
+    bool useDefaultImplementationForRLEColumns() const override { return true; }
 
     /// Get result types by argument types. If the function does not apply to these arguments, throw an exception.
     DataTypePtr getReturnTypeImpl(const DataTypes& arguments) const override;
@@ -193,6 +195,8 @@ public:
     DataTypePtr getReturnTypeImpl(const DataTypes& arguments) const override;
 
     bool useDefaultImplementationForConstants() const override { return true; }
+    bool useDefaultImplementationForSparseColumns() const override { return true; }
+    bool useDefaultImplementationForRLEColumns() const override { return true; }
 
     void executeImpl(Block& block, const ColumnNumbers& arguments, size_t result,
                      size_t /*input_rows_count*/) override;
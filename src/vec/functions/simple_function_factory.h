@@ -18,6 +18,7 @@
 #pragma once
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "vec/functions/function.h"
 
@@ -59,6 +60,14 @@ public:
         return nullptr;
     }
 
+    /// Names of all registered functions, e.g. to run something over each of them.
+    std::vector<std::string> get_function_names() const {
+        std::vector<std::string> names;
+        names.reserve(function_creators.size());
+        for (const auto& [name, creator] : function_creators) names.push_back(name);
+        return names;
+    }
+
 private:
     FunctionCreators function_creators;
 
@@ -78,6 +78,39 @@ TEST(AggTest, nullable_test) {
     // factory.registerFunction()
 }
 
+TEST(AggTest, count_test) {
+    auto column_vector_int32 = ColumnVector<Int32>::create();
+    auto null_map = ColumnUInt8::create();
+    for (int i = 0; i < 4096; i++) {
+        column_vector_int32->insert(castToNearestFieldType(i));
+        null_map->insert(castToNearestFieldType(UInt8(i % 4 == 0)));
+    }
+    auto nullable_column = ColumnNullable::create(std::move(column_vector_int32), std::move(null_map));
+
+    AggregateFunctionSimpleFactory &factory = AggregateFunctionSimpleFactory::instance();
+    Array array;
+    auto count = factory.get("count", {}, array);
+    auto count_not_null = factory.get("count", {makeNullable(std::make_shared<DataTypeInt32>())}, array);
+
+    AggregateDataPtr place = (char*)malloc(sizeof(uint64_t));
+    AggregateDataPtr place_not_null = (char*)malloc(sizeof(uint64_t));
+    count->create(place);
+    count_not_null->create(place_not_null);
+    const IColumn* column[1] = {nullable_column.get()};
+    count->addBatchSinglePlace(4096, place, nullptr, nullptr);
+    count_not_null->addBatchSinglePlace(4096, place_not_null, column, nullptr);
+
+    auto res_column = count->getReturnType()->createColumn();
+    count->insertResultInto(place, *res_column.get());
+    count_not_null->insertResultInto(place_not_null, *res_column.get());
+    ASSERT_EQ(res_column->get64(0), 4096);
+    ASSERT_EQ(res_column->get64(1), 3072);
+    count->destroy(place);
+    count_not_null->destroy(place_not_null);
+    free(place);
+    free(place_not_null);
+}
+
 } // namespace DB
 
 int main(int argc, char** argv) {
@@ -0,0 +1,325 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <numeric>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_aggregate_function.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+
+#include "aggregate_function_test_helpers.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// The column of the values that are not NULL.
+const IColumn& valuesOf(const ColumnPtr& column) {
+    if (column->isNullable()) return assert_cast<const ColumnNullable&>(*column).getNestedColumn();
+    return *column;
+}
+
+AggregateFunctionPtr getFunction(const std::string& name, const DataTypes& types,
+                                 const Array& parameters = {}) {
+    return AggregateFunctionSimpleFactory::instance().get(name, types, parameters);
+}
+
+/// Adds the columns by rows and by a batch, checks that the results are the same
+/// and returns the result.
+ColumnPtr aggregate(const AggregateFunctionPtr& function, const Columns& columns) {
+    AggregateState by_rows(function);
+    by_rows.addRows(columns);
+    AggregateState by_batch(function);
+    by_batch.addBatch(columns);
+    auto res = by_batch.result();
+    EXPECT_EQ(valuesOf(by_rows.result()).getDataAt(0), valuesOf(res).getDataAt(0));
+    return res;
+}
+
+ColumnPtr makeColumn(const std::vector<Int64>& values) {
+    auto column = ColumnInt64::create();
+    column->getData().assign(values.begin(), values.end());
+    return column;
+}
+
+ColumnPtr makeCondition(size_t rows, size_t every) {
+    auto column = ColumnUInt8::create();
+    for (size_t i = 0; i < rows; ++i) column->insertValue(i % every == 0);
+    return column;
+}
+
+/// 1..rows.
+ColumnPtr makeSequence(size_t rows) {
+    std::vector<Int64> values(rows);
+    std::iota(values.begin(), values.end(), 1);
+    return makeColumn(values);
+}
+
+DataTypePtr int64_type = std::make_shared<DataTypeInt64>();
+DataTypePtr uint8_type = std::make_shared<DataTypeUInt8>();
+
+} // namespace
+
+TEST(AggregateFunctionCombinatorTest, if_test) {
+    auto values = makeSequence(1000);
+    auto sum_if = getFunction("sumIf", {int64_type, uint8_type});
+    ASSERT_EQ(sum_if->getName(), "sumIf");
+    /// 1 + 4 + 7 + ... + 1000.
+    ASSERT_EQ(aggregate(sum_if, {values, makeCondition(1000, 3)})->getInt(0), 167167);
+    ASSERT_EQ(aggregate(sum_if, {values, makeCondition(1000, 1)})->getInt(0), 500500);
+    ASSERT_EQ(aggregate(sum_if, {values, makeCondition(1000, 2000)})->getInt(0), 1);
+
+    auto count_if = getFunction("countIf", {uint8_type});
+    ASSERT_EQ(aggregate(count_if, {makeCondition(1000, 3)})->getUInt(0), 334);
+
+    for (const char* name : {"minIf", "maxIf", "avgIf", "uniqIf", "quantileExactIf"}) {
+        auto function = getFunction(name, {int64_type, uint8_type});
+        AggregateState all(
+                getFunction(std::string(name).substr(0, strlen(name) - 2), {int64_type}));
+        all.addBatch({values});
+        ASSERT_EQ(aggregate(function, {values, makeCondition(1000, 1)})->getDataAt(0),
+                  all.result()->getDataAt(0))
+                << name;
+    }
+
+    /// The batch for many places, the rows go to the places in turn.
+    AggregateState first(sum_if);
+    AggregateState second(sum_if);
+    std::vector<AggregateDataPtr> places;
+    for (size_t i = 0; i < 1000; ++i) places.push_back(i % 2 ? second.place : first.place);
+    auto condition = makeCondition(1000, 1);
+    const IColumn* columns[] = {values.get(), condition.get()};
+    sum_if->addBatch(1000, places.data(), 0, columns, &first.arena);
+    ASSERT_EQ(first.result()->getInt(0), 250000);
+    ASSERT_EQ(second.result()->getInt(0), 250500);
+
+    ASSERT_ANY_THROW(getFunction("sumIf", {int64_type, int64_type}));
+    ASSERT_ANY_THROW(getFunction("sumIf", {}));
+}
+
+TEST(AggregateFunctionCombinatorTest, nullable_if_test) {
+    auto type = makeNullable(int64_type);
+    auto values = type->createColumn();
+    for (Int64 i = 1; i <= 1000; ++i) {
+        if (i % 4 == 0)
+            values->insert(Null());
+        else
+            values->insert(i);
+    }
+    ColumnPtr nullable_values = std::move(values);
+    auto sum_if = getFunction("sumIf", {type, uint8_type});
+    ASSERT_EQ(sum_if->getName(), "sumIf");
+    auto result = aggregate(sum_if, {nullable_values, makeCondition(1000, 2)});
+    /// The odd numbers are never NULL.
+    ASSERT_EQ(valuesOf(result).getInt(0), 250000);
+
+    /// The Nullable condition.
+    auto condition_type = makeNullable(uint8_type);
+    auto condition = condition_type->createColumn();
+    for (size_t i = 0; i < 1000; ++i) {
+        if (i % 3 == 0)
+            condition->insert(Null());
+        else
+            condition->insert(UInt64(1));
+    }
+    ColumnPtr nullable_condition = std::move(condition);
+    auto count_if = getFunction("countIf", {condition_type});
+    AggregateState state(count_if);
+    state.addBatch({nullable_condition});
+    ASSERT_EQ(valuesOf(state.result()).getUInt(0), 666);
+}
+
+TEST(AggregateFunctionCombinatorTest, distinct_test) {
+    std::vector<Int64> values;
+    for (Int64 i = 0; i < 3000; ++i) values.push_back(i % 100);
+    auto column = makeColumn(values);
+
+    auto sum_distinct = getFunction("sumDistinct", {int64_type});
+    ASSERT_EQ(sum_distinct->getName(), "sumDistinct");
+    ASSERT_EQ(aggregate(sum_distinct, {column})->getInt(0), 4950);
+
+    /// The rows of two arguments are distinct together, and the nested uniq sees the same
+    /// tuples as the plain one.
+    std::vector<Int64> other;
+    for (Int64 i = 0; i < 3000; ++i) other.push_back(i % 3);
+    ColumnPtr other_column = makeColumn(other);
+    auto uniq_distinct = getFunction("uniqDistinct", {int64_type, int64_type});
+    auto uniq = getFunction("uniq", {int64_type, int64_type});
+    ASSERT_EQ(aggregate(uniq_distinct, {column, other_column})->getUInt(0),
+              aggregate(uniq, {column, other_column})->getUInt(0));
+
+    auto strings = ColumnString::create();
+    for (Int64 value : values) {
+        std::string text = "value" + std::to_string(value % 7);
+        strings->insertData(text.data(), text.size());
+    }
+    ColumnPtr string_column = std::move(strings);
+    auto string_type = std::make_shared<DataTypeString>();
+    ASSERT_EQ(aggregate(getFunction("countDistinct", {string_type}), {string_column})->getUInt(0),
+              7);
+    ASSERT_EQ(aggregate(getFunction("maxDistinct", {string_type}), {string_column})
+                      ->getDataAt(0)
+                      .toString(),
+              "value6");
+
+    /// Merge and serialize the sets.
+    AggregateState first(sum_distinct);
+    first.addBatch({column->cut(0, 1500)});
+    AggregateState second(sum_distinct);
+    second.addBatch({makeColumn({50, 150, 150, 250})});
+    sum_distinct->merge(first.place, second.place, &first.arena);
+    ASSERT_EQ(first.result()->getInt(0), 4950 + 150 + 250);
+
+    PaddedPODArray<char> buffer;
+    VectorBufferWriter<PaddedPODArray<char>> writer(buffer);
+    sum_distinct->serialize(first.place, writer);
+    AggregateState copy(sum_distinct);
+    BufferReadable reader(StringRef(buffer.data(), buffer.size()));
+    sum_distinct->deserialize(copy.place, reader, &copy.arena);
+    ASSERT_TRUE(reader.eof());
+    ASSERT_EQ(copy.result()->getInt(0), 4950 + 150 + 250);
+
+    /// Distinct and If together.
+    auto sum_distinct_if = getFunction("sumDistinctIf", {int64_type, uint8_type});
+    ASSERT_EQ(sum_distinct_if->getName(), "sumDistinctIf");
+    ASSERT_EQ(aggregate(sum_distinct_if, {column, makeCondition(3000, 2)})->getInt(0), 2450);
+}
+
+TEST(AggregateFunctionCombinatorTest, state_merge_test) {
+    auto values = makeSequence(10000);
+    for (const char* name : {"sum", "count", "min", "max", "avg", "uniq", "quantileExact"}) {
+        DataTypes types {int64_type};
+        if (std::string(name) == "count") types.clear();
+        Columns columns;
+        if (!types.empty()) columns.push_back(values);
+        auto state_function = getFunction(std::string(name) + "State", types);
+        ASSERT_TRUE(state_function->isState());
+
+        /// Every part of the values is aggregated into a state of its own.
+        auto state_type = state_function->getReturnType();
+        auto states = state_type->createColumn();
+        AggregateState whole(getFunction(name, types));
+        for (size_t begin = 0; begin < values->size(); begin += 1000) {
+            AggregateState part(state_function);
+            Columns part_columns;
+            for (const auto& column : columns) part_columns.push_back(column->cut(begin, 1000));
+            if (part_columns.empty()) {
+                for (size_t i = 0; i < 1000; ++i)
+                    state_function->add(part.place, nullptr, i, &part.arena);
+            } else {
+                part.addBatch(part_columns);
+            }
+            state_function->insertResultInto(part.place, *states);
+        }
+        if (columns.empty()) {
+            for (size_t i = 0; i < values->size(); ++i)
+                whole.function->add(whole.place, nullptr, i, &whole.arena);
+        } else {
+            whole.addBatch(columns);
+        }
+
+        auto merge_function = getFunction(std::string(name) + "Merge", {state_type});
+        ASSERT_EQ(merge_function->getName(), std::string(name) + "Merge");
+        ColumnPtr states_column = std::move(states);
+        ASSERT_EQ(aggregate(merge_function, {states_column})->getDataAt(0),
+                  whole.result()->getDataAt(0))
+                << name;
+    }
+}
+
+TEST(AggregateFunctionCombinatorTest, state_type_test) {
+    auto state_function = getFunction("quantilesExactState", {int64_type}, {0.5, 0.9});
+    auto state_type = state_function->getReturnType();
+    ASSERT_EQ(state_type->getName(), "AggregateFunction(quantilesExact(0.5, 0.9), Int64)");
+
+    AggregateState state(state_function);
+    state.addBatch({makeSequence(100)});
+    auto merge_function = getFunction("quantilesExactMerge", {state_type}, {0.5, 0.9});
+    ASSERT_EQ(aggregate(merge_function, {state.result()})->getDataAt(0).toString(), "[51, 91]");
+    ASSERT_ANY_THROW(getFunction("quantilesExactMerge", {state_type}, {0.5}));
+
+    /// The temporary states are not kept in the arena of the state.
+    auto count_state_function = getFunction("countState", {});
+    auto count_states = count_state_function->getReturnType()->createColumn();
+    for (size_t i = 0; i < 1000; ++i) {
+        AggregateState part(count_state_function);
+        for (size_t row = 0; row < 100; ++row)
+            count_state_function->add(part.place, nullptr, row, &part.arena);
+        count_state_function->insertResultInto(part.place, *count_states);
+    }
+    ColumnPtr count_states_column = std::move(count_states);
+    AggregateState count_merge(
+            getFunction("countMerge", {count_state_function->getReturnType()}));
+    size_t arena_size = count_merge.arena.size();
+    count_merge.addRows({count_states_column});
+    count_merge.addBatch({count_states_column});
+    ASSERT_EQ(count_merge.result()->getUInt(0), 200000);
+    ASSERT_EQ(count_merge.arena.size(), arena_size);
+
+    /// The default is the empty state.
+    auto count_state_type = getFunction("countState", {})->getReturnType();
+    auto states = count_state_type->createColumn();
+    states->insert(count_state_type->getDefault());
+    ColumnPtr states_column = std::move(states);
+    ASSERT_EQ(aggregate(getFunction("countMerge", {count_state_type}), {states_column})->getUInt(0),
+              0);
+
+    ASSERT_ANY_THROW(getFunction("sumMerge", {int64_type}));
+    auto min_state_type = getFunction("minState", {int64_type})->getReturnType();
+    ASSERT_ANY_THROW(getFunction("sumMerge", {min_state_type}));
+}
+
+TEST(AggregateFunctionCombinatorTest, unknown_test) {
+    ASSERT_ANY_THROW(getFunction("unknownIf", {int64_type, uint8_type}));
+    ASSERT_ANY_THROW(getFunction("If", {uint8_type}));
+    ASSERT_ANY_THROW(getFunction("sumUnknown", {int64_type}));
+}
+
+/// Returns the nested function itself. Its name ends with the name of If.
+class AggregateFunctionCombinatorOrIf final : public IAggregateFunctionCombinator {
+public:
+    String getName() const override { return "OrIf"; }
+
+    AggregateFunctionPtr transformAggregateFunction(const AggregateFunctionPtr& nested_function,
+                                                    const DataTypes&,
+                                                    const Array&) const override {
+        return nested_function;
+    }
+};
+
+TEST(AggregateFunctionCombinatorTest, overlapping_suffix_test) {
+    AggregateFunctionSimpleFactory::instance().registerCombinator(
+            std::make_shared<AggregateFunctionCombinatorOrIf>());
+    /// sumOrIf is sum with OrIf, not sumOr with If.
+    ASSERT_EQ(getFunction("sumOrIf", {int64_type})->getName(), "sum");
+    ASSERT_EQ(getFunction("sumIf", {int64_type, uint8_type})->getName(), "sumIf");
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
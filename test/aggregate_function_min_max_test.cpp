@@ -0,0 +1,179 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/arena.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// Aggregates column in three ways: row by row, by batches of different sizes, and by
+/// two halves that are merged. Checks that they agree and returns the result.
+Field aggregate(const std::string& name, const DataTypePtr& type, const IColumn& column) {
+    auto function = AggregateFunctionSimpleFactory::instance().get(name, {type}, {});
+    Arena arena;
+    AggregateDataPtr places[4];
+    for (auto& place : places) {
+        place = arena.alignedAlloc(function->sizeOfData(), function->alignOfData());
+        function->create(place);
+    }
+    const IColumn* columns[] = {&column};
+    for (size_t i = 0; i < column.size(); ++i) function->add(places[0], columns, i, &arena);
+
+    std::mt19937_64 rng(column.size());
+    for (size_t begin = 0; begin < column.size();) {
+        size_t length = std::min<size_t>(rng() % 100, column.size() - begin);
+        auto part = column.cut(begin, length);
+        const IColumn* part_columns[] = {part.get()};
+        function->addBatchSinglePlace(length, places[begin < column.size() / 2 ? 1 : 2],
+                                      part_columns, &arena);
+        begin += length;
+    }
+    function->merge(places[3], places[1], &arena);
+    function->merge(places[3], places[2], &arena);
+
+    auto result = function->getReturnType()->createColumn();
+    for (auto place : {places[0], places[3]}) function->insertResultInto(place, *result);
+    for (auto place : places) function->destroy(place);
+    EXPECT_EQ((*result)[0], (*result)[1]) << name;
+    return (*result)[0];
+}
+
+} // namespace
+
+TEST(AggregateFunctionMinMaxTest, numeric_test) {
+    std::mt19937_64 rng(1);
+    auto column = ColumnInt32::create();
+    for (size_t i = 0; i < 1000; ++i) column->insertValue(Int32(rng() % 2000) - 1000);
+    const auto& data = column->getData();
+    auto type = std::make_shared<DataTypeInt32>();
+
+    ASSERT_EQ(aggregate("min", type, *column),
+              Field(Int64(*std::min_element(data.begin(), data.end()))));
+    ASSERT_EQ(aggregate("max", type, *column),
+              Field(Int64(*std::max_element(data.begin(), data.end()))));
+    ASSERT_EQ(aggregate("any", type, *column), Field(Int64(data[0])));
+    ASSERT_EQ(aggregate("anyLast", type, *column), Field(Int64(data.back())));
+
+    Int64 sum = 0;
+    for (auto value : data) sum += value;
+    ASSERT_DOUBLE_EQ(aggregate("avg", type, *column).get<Float64>(), Float64(sum) / data.size());
+}
+
+TEST(AggregateFunctionMinMaxTest, nullable_test) {
+    std::mt19937_64 rng(2);
+    auto type = makeNullable(std::make_shared<DataTypeFloat64>());
+    auto column = type->createColumn();
+    Float64 min = 1e9, max = -1e9, sum = 0, first = 0, last = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < 1000; ++i) {
+        if (rng() % 3 == 0) {
+            column->insert(Null());
+            continue;
+        }
+        Float64 value = Float64(rng() % 1000) / 4;
+        column->insert(value);
+        min = std::min(min, value);
+        max = std::max(max, value);
+        if (!count) first = value;
+        last = value;
+        sum += value;
+        ++count;
+    }
+
+    ASSERT_EQ(aggregate("min", type, *column), Field(min));
+    ASSERT_EQ(aggregate("max", type, *column), Field(max));
+    ASSERT_EQ(aggregate("any", type, *column), Field(first));
+    ASSERT_EQ(aggregate("anyLast", type, *column), Field(last));
+    ASSERT_DOUBLE_EQ(aggregate("avg", type, *column).get<Float64>(), sum / count);
+
+    /// Only NULLs.
+    auto nulls = type->createColumn();
+    for (size_t i = 0; i < 10; ++i) nulls->insert(Null());
+    for (const auto* name : {"min", "max", "any", "anyLast", "avg"})
+        ASSERT_TRUE(aggregate(name, type, *nulls).isNull()) << name;
+}
+
+TEST(AggregateFunctionMinMaxTest, decimal_test) {
+    auto type = std::make_shared<DataTypeDecimal<Decimal64>>(18, 2);
+    auto column = type->createColumn();
+    auto& data = assert_cast<ColumnDecimal<Decimal64>&>(*column).getData();
+    for (Int64 value : {250, -125, 1000, 75}) data.push_back(Decimal64(value));
+
+    ASSERT_EQ(aggregate("min", type, *column), Field(DecimalField<Decimal64>(-125, 2)));
+    ASSERT_EQ(aggregate("max", type, *column), Field(DecimalField<Decimal64>(1000, 2)));
+    ASSERT_EQ(aggregate("anyLast", type, *column), Field(DecimalField<Decimal64>(75, 2)));
+    ASSERT_EQ(aggregate("avg", type, *column), Field(DecimalField<Decimal128>(300, 2)));
+}
+
+TEST(AggregateFunctionMinMaxTest, string_test) {
+    std::mt19937_64 rng(3);
+    auto type = std::make_shared<DataTypeString>();
+    auto column = ColumnString::create();
+    std::vector<std::string> strings;
+    for (size_t i = 0; i < 1000; ++i) {
+        strings.push_back(std::string(rng() % 50, 'a' + rng() % 26));
+        column->insertData(strings.back().data(), strings.back().size());
+    }
+
+    ASSERT_EQ(aggregate("min", type, *column),
+              Field(*std::min_element(strings.begin(), strings.end())));
+    ASSERT_EQ(aggregate("max", type, *column),
+              Field(*std::max_element(strings.begin(), strings.end())));
+    ASSERT_EQ(aggregate("any", type, *column), Field(strings.front()));
+    ASSERT_EQ(aggregate("anyLast", type, *column), Field(strings.back()));
+
+    /// The values are kept in the Arena and a longer value reallocates them.
+    auto function = AggregateFunctionSimpleFactory::instance().get("anyLast", {type}, {});
+    ASSERT_TRUE(function->allocatesMemoryInArena());
+    Arena arena;
+    AggregateDataPtr place = arena.alignedAlloc(function->sizeOfData(), function->alignOfData());
+    function->create(place);
+    auto values = ColumnString::create();
+    for (size_t size = 0; size < 1000; ++size) {
+        std::string value(size, 'x');
+        values->insertData(value.data(), value.size());
+    }
+    const IColumn* columns[] = {values.get()};
+    size_t arena_size = arena.size();
+    for (size_t i = 0; i < values->size(); ++i) function->add(place, columns, i, &arena);
+    ASSERT_LT(arena.size() - arena_size, 64 * 1024);
+
+    auto result = type->createColumn();
+    function->insertResultInto(place, *result);
+    ASSERT_EQ(result->getDataAt(0).size, 999);
+    function->destroy(place);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,191 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_quantile.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_types_number.h"
+
+#include "aggregate_function_test_helpers.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+AggregateFunctionPtr getFunction(const std::string& name, const DataTypePtr& type,
+                                 const Array& levels) {
+    return AggregateFunctionSimpleFactory::instance().get(name, {type}, levels);
+}
+
+/// Adds the column to a state by rows, and by batches to two states that are merged.
+/// Checks that the results are the same and returns the merged state.
+std::unique_ptr<AggregateState> aggregate(const AggregateFunctionPtr& function,
+                                          const IColumn& column) {
+    AggregateState by_rows(function);
+    const IColumn* columns[] = {&column};
+    for (size_t i = 0; i < column.size(); ++i)
+        function->add(by_rows.place, columns, i, &by_rows.arena);
+
+    auto by_batches = std::make_unique<AggregateState>(function);
+    AggregateState half(function);
+    for (size_t begin = 0; begin < column.size(); begin += 1000) {
+        size_t length = std::min<size_t>(1000, column.size() - begin);
+        auto part = column.cut(begin, length);
+        (begin < column.size() / 2 ? *by_batches : half).addBatch({part});
+    }
+    function->merge(by_batches->place, half.place, &by_batches->arena);
+    return by_batches;
+}
+
+/// The numbers 1..rows in a random order.
+ColumnPtr makeShuffledColumn(size_t rows) {
+    std::vector<Int64> values(rows);
+    std::iota(values.begin(), values.end(), 1);
+    std::shuffle(values.begin(), values.end(), std::mt19937_64(1));
+    auto column = ColumnInt64::create();
+    column->getData().assign(values.begin(), values.end());
+    return column;
+}
+
+DataTypePtr int64_type = std::make_shared<DataTypeInt64>();
+
+} // namespace
+
+TEST(AggregateFunctionQuantileTest, exact_test) {
+    ColumnPtr column = makeShuffledColumn(1000);
+
+    auto median = getFunction("quantileExact", int64_type, {});
+    ASSERT_EQ(median->getReturnType()->getName(), "Int64");
+    ASSERT_EQ(aggregate(median, *column)->result()->getInt(0), 501);
+
+    auto many = getFunction("quantilesExact", int64_type, {0.1, 0.99, 0.5, 0.0, 1.0});
+    ASSERT_EQ(aggregate(many, *column)->resultString(), "[101, 991, 501, 1, 1000]");
+
+    AggregateState empty(median);
+    ASSERT_EQ(empty.result()->getInt(0), 0);
+}
+
+TEST(AggregateFunctionQuantileTest, tdigest_test) {
+    const size_t rows = 1000000;
+    ColumnPtr column = makeShuffledColumn(rows);
+    auto function = getFunction("quantilesTDigest", int64_type, {0.5, 0.95, 0.99, 0.999});
+    auto state = aggregate(function, *column);
+
+    std::vector<Float64> levels {0.5, 0.95, 0.99, 0.999};
+    std::vector<Float64> result(levels.size());
+    std::vector<size_t> indices {0, 1, 2, 3};
+    const auto& data = *reinterpret_cast<const QuantileTDigest<Int64>*>(state->place);
+    data.getMany(levels.data(), indices.data(), levels.size(), result.data());
+    for (size_t i = 0; i < levels.size(); ++i) {
+        /// The error is much smaller near the ends.
+        Float64 error = std::max(std::min(levels[i], 1 - levels[i]) * 0.01, 0.0001) * rows;
+        ASSERT_NEAR(result[i], levels[i] * rows, error) << levels[i];
+    }
+    ASSERT_LT(data.centroids.size(), 2000);
+
+    auto single = getFunction("quantileTDigest", int64_type, {0.99});
+    ASSERT_NEAR(aggregate(single, *column)->result()->getFloat64(0), 0.99 * rows, 0.001 * rows);
+    ASSERT_TRUE(std::isnan(AggregateState(single).result()->getFloat64(0)));
+}
+
+TEST(AggregateFunctionQuantileTest, reservoir_test) {
+    const size_t rows = 1000000;
+    ColumnPtr column = makeShuffledColumn(rows);
+    auto function = getFunction("quantile", int64_type, {0.95});
+    ASSERT_EQ(function->getReturnType()->getName(), "Float64");
+
+    /// A uniform sample of 8192 values has the error of 0.95 about 0.0025.
+    auto state = aggregate(function, *column);
+    ASSERT_NEAR(state->result()->getFloat64(0), 0.95 * rows, 0.01 * rows);
+    const auto& data = *reinterpret_cast<const QuantileReservoirSampler<Int64>*>(state->place);
+    ASSERT_EQ(data.samples.size(), QuantileReservoirSampler<Int64>::sample_count);
+    ASSERT_EQ(data.total, rows);
+
+    /// The values that are not sampled are exact.
+    auto small = makeShuffledColumn(101);
+    ASSERT_EQ(aggregate(getFunction("quantiles", int64_type, {0.0, 0.5, 0.25, 1.0}), *small)
+                      ->resultString(),
+              "[1, 51, 26, 101]");
+}
+
+TEST(AggregateFunctionQuantileTest, nullable_test) {
+    auto type = makeNullable(int64_type);
+    auto column = type->createColumn();
+    for (Int64 i = 1; i <= 3000; ++i) {
+        if (i % 3 == 0)
+            column->insert(Null());
+        else
+            column->insert(i);
+    }
+    /// 2000 values that are not NULL, the median is the 1000th of them.
+    for (const char* name : {"quantileExact", "quantileTDigest", "quantile"}) {
+        auto function = getFunction(name, type, {0.5});
+        auto result = aggregate(function, *column)->result();
+        const auto& nested = assert_cast<const ColumnNullable&>(*result).getNestedColumn();
+        ASSERT_NEAR(nested.getFloat64(0), 1501, 20) << name;
+    }
+}
+
+TEST(AggregateFunctionQuantileTest, serialize_test) {
+    ColumnPtr column = makeShuffledColumn(100000);
+    for (const char* name : {"quantilesExact", "quantilesTDigest", "quantiles"}) {
+        auto function = getFunction(name, int64_type, {0.01, 0.5, 0.99});
+        AggregateState state(function);
+        state.addBatch({column});
+
+        PaddedPODArray<char> buffer;
+        VectorBufferWriter<PaddedPODArray<char>> writer(buffer);
+        function->serialize(state.place, writer);
+
+        AggregateState copy(function);
+        BufferReadable reader(StringRef(buffer.data(), buffer.size()));
+        function->deserialize(copy.place, reader, &copy.arena);
+        ASSERT_TRUE(reader.eof());
+        ASSERT_EQ(copy.resultString(), state.resultString()) << name;
+
+        /// A merged copy of the serialized state is the same as the state added twice.
+        AggregateState twice(function);
+        twice.addBatch({column});
+        twice.addBatch({column});
+        function->merge(copy.place, state.place, &copy.arena);
+        if (std::string(name) == "quantilesExact") {
+            ASSERT_EQ(copy.resultString(), twice.resultString());
+        }
+    }
+}
+
+TEST(AggregateFunctionQuantileTest, parameters_test) {
+    ASSERT_ANY_THROW(getFunction("quantileExact", int64_type, {1.5}));
+    ASSERT_ANY_THROW(getFunction("quantile", int64_type, {0.5, 0.9}));
+    ASSERT_ANY_THROW(getFunction("quantilesTDigest", int64_type, {}));
+    ASSERT_ANY_THROW(getFunction("quantile", makeNullable(int64_type), {-1.0}));
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,69 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/arena.h"
+
+namespace doris::vectorized {
+
+/// A state of an aggregate function in tests, destroyed at the end of the scope.
+struct AggregateState {
+    AggregateFunctionPtr function;
+    Arena arena;
+    AggregateDataPtr place;
+
+    explicit AggregateState(AggregateFunctionPtr function_) : function(std::move(function_)) {
+        place = arena.alignedAlloc(function->sizeOfData(), function->alignOfData());
+        function->create(place);
+    }
+    ~AggregateState() { function->destroy(place); }
+
+    void addBatch(const Columns& columns) {
+        std::vector<const IColumn*> raw_columns;
+        for (const auto& column : columns) raw_columns.push_back(column.get());
+        function->addBatchSinglePlace(columns[0]->size(), place, raw_columns.data(), &arena);
+    }
+
+    void addRows(const Columns& columns) {
+        std::vector<const IColumn*> raw_columns;
+        for (const auto& column : columns) raw_columns.push_back(column.get());
+        for (size_t i = 0; i < columns[0]->size(); ++i)
+            function->add(place, raw_columns.data(), i, &arena);
+    }
+
+    ColumnPtr result() const {
+        auto column = function->getReturnType()->createColumn();
+        function->insertResultInto(place, *column);
+        return column;
+    }
+
+    /// The result as a string, of the nested column if the result is Nullable.
+    std::string resultString() const {
+        ColumnPtr column = result();
+        const IColumn* res = column.get();
+        if (res->isNullable()) res = &assert_cast<const ColumnNullable&>(*res).getNestedColumn();
+        return res->getDataAt(0).toString();
+    }
+};
+
+} // namespace doris::vectorized
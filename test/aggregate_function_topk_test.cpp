@@ -0,0 +1,210 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_topk.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+
+#include "aggregate_function_test_helpers.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+AggregateFunctionPtr getTopK(const DataTypes& types, UInt64 threshold) {
+    const char* name = types.size() == 2 ? "topKWeighted" : "topK";
+    return AggregateFunctionSimpleFactory::instance().get(name, types, {threshold});
+}
+
+/// Adds the columns by rows, and by batches to two states that are merged.
+/// Checks that the results are the same and returns it.
+std::string topK(const DataTypes& types, UInt64 threshold, const Columns& columns) {
+    auto function = getTopK(types, threshold);
+    std::vector<const IColumn*> raw_columns;
+    for (const auto& column : columns) raw_columns.push_back(column.get());
+    size_t rows = columns[0]->size();
+
+    AggregateState by_rows(function);
+    for (size_t i = 0; i < rows; ++i)
+        function->add(by_rows.place, raw_columns.data(), i, &by_rows.arena);
+
+    AggregateState by_batches(function);
+    AggregateState half(function);
+    for (size_t begin = 0; begin < rows; begin += 4096) {
+        size_t length = std::min<size_t>(4096, rows - begin);
+        Columns parts;
+        std::vector<const IColumn*> raw_parts;
+        for (const auto& column : columns) {
+            parts.push_back(column->cut(begin, length));
+            raw_parts.push_back(parts.back().get());
+        }
+        auto& state = begin < rows / 2 ? by_batches : half;
+        function->addBatchSinglePlace(length, state.place, raw_parts.data(), &state.arena);
+    }
+    function->merge(by_batches.place, half.place, &by_batches.arena);
+
+    EXPECT_EQ(by_rows.resultString(), by_batches.resultString());
+    return by_rows.resultString();
+}
+
+/// The value i repeats (7 - i) * 1000 times for i in [1, 5], and 2000 other values are unique.
+/// Every value with the count more than 22000 / 15 is in the state of topK(5).
+std::vector<Int64> makeValues() {
+    std::vector<Int64> values;
+    for (Int64 i = 1; i <= 5; ++i) values.insert(values.end(), (7 - i) * 1000, i);
+    for (Int64 i = 0; i < 2000; ++i) values.push_back(1000 + i);
+    std::shuffle(values.begin(), values.end(), std::mt19937_64(1));
+    return values;
+}
+
+/// The keys with the same remainder of 4 have the same hash in SpaceSaving.
+struct CollidingKey {
+    UInt64 value;
+};
+
+} // namespace
+
+template <>
+struct SpaceSavingKeyTraits<CollidingKey> {
+    using KeyRef = CollidingKey;
+
+    static UInt64 hash(CollidingKey key) { return key.value % 4; }
+    static bool equals(const CollidingKey& stored, CollidingKey key) {
+        return stored.value == key.value;
+    }
+    static void assign(CollidingKey& stored, CollidingKey key) { stored = key; }
+};
+
+TEST(AggregateFunctionTopKTest, hash_collision_test) {
+    SpaceSaving<CollidingKey> counters(8);
+    for (UInt64 round = 0; round < 3; ++round)
+        for (UInt64 value = 0; value < 8; ++value) counters.insert({value}, value + 1);
+    ASSERT_EQ(counters.size(), 8);
+
+    /// The keys take the counters of the keys with the same hash.
+    for (UInt64 value = 100; value < 104; ++value) counters.insert({value}, 100);
+    ASSERT_EQ(counters.size(), 8);
+
+    std::vector<std::pair<UInt64, UInt64>> top;
+    counters.forEachTop(8, [&](const auto& counter) {
+        top.emplace_back(counter.key.value, counter.count);
+    });
+    std::sort(top.begin(), top.end());
+    std::vector<std::pair<UInt64, UInt64>> expected {{4, 15}, {5, 18}, {6, 21}, {7, 24},
+                                                     {100, 103}, {101, 106}, {102, 109},
+                                                     {103, 112}};
+    ASSERT_EQ(top, expected);
+}
+
+TEST(AggregateFunctionTopKTest, numeric_test) {
+    auto column = ColumnInt64::create();
+    for (Int64 value : makeValues()) column->insertValue(value);
+    DataTypes types {std::make_shared<DataTypeInt64>()};
+    ASSERT_EQ(topK(types, 5, {std::move(column)}), "[1, 2, 3, 4, 5]");
+
+    /// The runs of equal values.
+    auto sorted = ColumnInt64::create();
+    for (Int64 i = 0; i < 5000; ++i) sorted->insertValue(0);
+    for (Int64 i = 0; i < 500; ++i) sorted->insertValue(i / 100 + 1);
+    ASSERT_EQ(topK(types, 1, {std::move(sorted)}), "[0]");
+}
+
+TEST(AggregateFunctionTopKTest, string_test) {
+    auto column = ColumnString::create();
+    for (Int64 value : makeValues()) {
+        std::string text = value == 3 ? "it's" : "value" + std::to_string(value);
+        column->insertData(text.data(), text.size());
+    }
+    DataTypes types {std::make_shared<DataTypeString>()};
+    ASSERT_EQ(topK(types, 3, {std::move(column)}), "['value1', 'value2', 'it\\'s']");
+}
+
+TEST(AggregateFunctionTopKTest, weighted_test) {
+    auto keys = ColumnString::create();
+    auto weights = ColumnUInt32::create();
+    auto add = [&](const std::string& key, UInt32 weight) {
+        keys->insertData(key.data(), key.size());
+        weights->insertValue(weight);
+    };
+    for (size_t i = 0; i < 50; ++i) add("b", 1);
+    add("a", 100);
+    add("c", 30);
+    add("c", 30);
+    DataTypes types {std::make_shared<DataTypeString>(), std::make_shared<DataTypeUInt32>()};
+    ASSERT_EQ(topK(types, 2, {std::move(keys), std::move(weights)}), "['a', 'c']");
+}
+
+TEST(AggregateFunctionTopKTest, nullable_test) {
+    auto type = makeNullable(std::make_shared<DataTypeInt32>());
+    auto column = type->createColumn();
+    for (size_t i = 0; i < 3000; ++i) {
+        if (i % 2)
+            column->insert(Null());
+        else
+            column->insert(Int64(i % 3 ? 7 : 8));
+    }
+    ASSERT_EQ(topK({type}, 10, {std::move(column)}), "[7, 8]");
+}
+
+TEST(AggregateFunctionTopKTest, serialize_test) {
+    auto column = ColumnInt64::create();
+    for (Int64 value : makeValues()) column->insertValue(value);
+    auto function = getTopK({std::make_shared<DataTypeInt64>()}, 5);
+    AggregateState state(function);
+    const IColumn* columns[] = {column.get()};
+    function->addBatchSinglePlace(column->size(), state.place, columns, &state.arena);
+
+    /// The state has at most 15 counters however many values are added.
+    PaddedPODArray<char> buffer;
+    VectorBufferWriter<PaddedPODArray<char>> writer(buffer);
+    function->serialize(state.place, writer);
+    ASSERT_EQ(buffer.size(), 8 + 15 * (8 + 8 + 8));
+
+    AggregateState copy(function);
+    BufferReadable reader(StringRef(buffer.data(), buffer.size()));
+    function->deserialize(copy.place, reader, &copy.arena);
+    ASSERT_TRUE(reader.eof());
+    ASSERT_EQ(copy.resultString(), "[1, 2, 3, 4, 5]");
+
+    BufferReadable truncated(StringRef(buffer.data(), buffer.size() - 1));
+    AggregateState broken(function);
+    ASSERT_ANY_THROW(function->deserialize(broken.place, truncated, &broken.arena));
+}
+
+TEST(AggregateFunctionTopKTest, parameters_test) {
+    DataTypes types {std::make_shared<DataTypeInt64>()};
+    ASSERT_ANY_THROW(getTopK(types, 0));
+    ASSERT_ANY_THROW(getTopK({types[0], std::make_shared<DataTypeString>()}, 10));
+    ASSERT_ANY_THROW(getTopK({std::make_shared<DataTypeString>(), types[0]}, 10));
+    ASSERT_EQ(AggregateFunctionSimpleFactory::instance().get("topK", types, {})->getName(), "topK");
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,170 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_uniq.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+
+#include "aggregate_function_test_helpers.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+AggregateFunctionPtr getUniq(const DataTypes& types) {
+    return AggregateFunctionSimpleFactory::instance().get("uniq", types, {});
+}
+
+/// Adds the columns row by row, by batches, and by two states that are merged.
+/// Checks that they agree and returns the result.
+UInt64 uniq(const DataTypes& types, const Columns& columns) {
+    std::vector<const IColumn*> raw_columns;
+    for (const auto& column : columns) raw_columns.push_back(column.get());
+    size_t rows = columns[0]->size();
+
+    AggregateState by_rows(getUniq(types));
+    for (size_t i = 0; i < rows; ++i)
+        by_rows.function->add(by_rows.place, raw_columns.data(), i, &by_rows.arena);
+
+    AggregateState by_batches(getUniq(types));
+    AggregateState half(getUniq(types));
+    for (size_t begin = 0; begin < rows; begin += 1000) {
+        size_t length = std::min<size_t>(1000, rows - begin);
+        Columns parts;
+        std::vector<const IColumn*> raw_parts;
+        for (const auto& column : columns) {
+            parts.push_back(column->cut(begin, length));
+            raw_parts.push_back(parts.back().get());
+        }
+        auto& state = begin < rows / 2 ? by_batches : half;
+        state.function->addBatchSinglePlace(length, state.place, raw_parts.data(), &state.arena);
+    }
+    by_batches.function->merge(by_batches.place, half.place, &by_batches.arena);
+
+    EXPECT_EQ(by_rows.result()->get64(0), by_batches.result()->get64(0));
+    return by_rows.result()->get64(0);
+}
+
+ColumnPtr makeUInt64Column(size_t rows, size_t distinct, std::mt19937_64& rng) {
+    auto column = ColumnUInt64::create();
+    for (size_t i = 0; i < rows; ++i) column->insertValue(rng() % distinct * 7919);
+    return column;
+}
+
+} // namespace
+
+TEST(AggregateFunctionUniqTest, exact_test) {
+    std::mt19937_64 rng(1);
+    DataTypes types {std::make_shared<DataTypeUInt64>()};
+    for (size_t distinct : {1, 10, 16, 17, 96}) {
+        ColumnPtr column = makeUInt64Column(5000, distinct, rng);
+        ASSERT_EQ(uniq(types, {column}), distinct);
+    }
+    ASSERT_EQ(uniq(types, {ColumnUInt64::create()}), 0);
+}
+
+TEST(AggregateFunctionUniqTest, hll_test) {
+    std::mt19937_64 rng(2);
+    DataTypes types {std::make_shared<DataTypeUInt64>()};
+    for (size_t distinct : {200, 5000, 100000}) {
+        ColumnPtr column = makeUInt64Column(200000, distinct, rng);
+        size_t exact = 0;
+        {
+            const auto& data = assert_cast<const ColumnUInt64&>(*column).getData();
+            std::vector<UInt64> values(data.begin(), data.end());
+            std::sort(values.begin(), values.end());
+            exact = std::unique(values.begin(), values.end()) - values.begin();
+        }
+        ASSERT_NEAR(double(uniq(types, {column})), double(exact), exact * 0.05) << distinct;
+    }
+
+    /// The state stays small however many values are added.
+    ASSERT_LE(getUniq(types)->sizeOfData(), 256);
+}
+
+TEST(AggregateFunctionUniqTest, string_test) {
+    DataTypes types {std::make_shared<DataTypeString>(), std::make_shared<DataTypeInt32>()};
+    auto strings = ColumnString::create();
+    auto numbers = ColumnInt32::create();
+    for (size_t i = 0; i < 3000; ++i) {
+        std::string value = "value" + std::to_string(i % 10);
+        strings->insertData(value.data(), value.size());
+        numbers->insertValue(i % 6);
+    }
+    /// The pairs repeat every 30 rows, and (a, b) is not the same as (b, a).
+    ASSERT_EQ(uniq(types, {std::move(strings), std::move(numbers)}), 30);
+    ASSERT_EQ(uniq({types[1], types[1]}, {ColumnInt32::create(100, 1)->getPtr(),
+                                         ColumnInt32::create(100, 2)->getPtr()}),
+              1);
+}
+
+TEST(AggregateFunctionUniqTest, nullable_test) {
+    auto type = makeNullable(std::make_shared<DataTypeInt32>());
+    auto column = type->createColumn();
+    for (size_t i = 0; i < 3000; ++i) {
+        if (i % 3)
+            column->insert(Int64(i % 50));
+        else
+            column->insert(Null());
+    }
+    ASSERT_EQ(uniq({type}, {std::move(column)}), 50);
+}
+
+TEST(AggregateFunctionUniqTest, serialize_test) {
+    std::mt19937_64 rng(3);
+    DataTypes types {std::make_shared<DataTypeUInt64>()};
+    for (size_t distinct : {10, 50, 100000}) {
+        ColumnPtr column = makeUInt64Column(200000, distinct, rng);
+        const IColumn* columns[] = {column.get()};
+        AggregateState state(getUniq(types));
+        state.function->addBatchSinglePlace(column->size(), state.place, columns, &state.arena);
+
+        PaddedPODArray<char> buffer;
+        VectorBufferWriter<PaddedPODArray<char>> writer(buffer);
+        state.function->serialize(state.place, writer);
+        if (distinct > AggregateFunctionUniqData::set_capacity)
+            ASSERT_EQ(buffer.size(), 1 + AggregateFunctionUniqData::num_registers);
+        else
+            ASSERT_EQ(buffer.size(), 1 + 4 + distinct * 8);
+
+        AggregateState copy(getUniq(types));
+        BufferReadable reader(StringRef(buffer.data(), buffer.size()));
+        copy.function->deserialize(copy.place, reader, &copy.arena);
+        ASSERT_TRUE(reader.eof());
+        ASSERT_EQ(copy.result()->get64(0), state.result()->get64(0));
+
+        BufferReadable truncated(StringRef(buffer.data(), buffer.size() - 1));
+        AggregateState broken(getUniq(types));
+        ASSERT_ANY_THROW(broken.function->deserialize(broken.place, truncated, &broken.arena));
+    }
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "vec/common/allocation_profiler.h"
+#include "vec/common/allocator.h"
+#include "vec/common/arena.h"
+#include "vec/common/pod_array.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+struct Sums {
+    UInt64 live_samples = 0;
+    UInt64 live_sampled_bytes = 0;
+    UInt64 live_estimated_bytes = 0;
+    UInt64 total_samples = 0;
+};
+
+Sums sumCallSites() {
+    Sums res;
+    for (const auto& call_site : AllocationProfiler::getCallSites()) {
+        res.live_samples += call_site.live_samples;
+        res.live_sampled_bytes += call_site.live_sampled_bytes;
+        res.live_estimated_bytes += call_site.live_estimated_bytes;
+        res.total_samples += call_site.total_samples;
+    }
+    return res;
+}
+
+} // namespace
+
+TEST(AllocationProfilerTest, stopped_test) {
+    ASSERT_FALSE(AllocationProfiler::isRunning());
+    PaddedPODArray<UInt64> array;
+    for (size_t i = 0; i < 100000; ++i) array.push_back(i);
+    ASSERT_TRUE(AllocationProfiler::getCallSites().empty());
+}
+
+TEST(AllocationProfilerTest, every_allocation_test) {
+    /// Every allocation is sampled.
+    AllocationProfiler::start(1);
+    {
+        Allocator<false> allocator;
+        void* buf = allocator.alloc(1000);
+        auto sums = sumCallSites();
+        ASSERT_EQ(sums.live_samples, 1);
+        ASSERT_EQ(sums.live_sampled_bytes, 1000);
+        ASSERT_EQ(sums.live_estimated_bytes, 1000);
+
+        /// The sample moves to the new buffer, whether it grows or shrinks.
+        buf = allocator.realloc(buf, 1000, 100000);
+        sums = sumCallSites();
+        ASSERT_EQ(sums.live_samples, 1);
+        ASSERT_EQ(sums.live_sampled_bytes, 100000);
+        ASSERT_EQ(sums.live_estimated_bytes, 100000);
+        ASSERT_EQ(sums.total_samples, 1);
+
+        buf = allocator.realloc(buf, 100000, 10);
+        sums = sumCallSites();
+        ASSERT_EQ(sums.live_samples, 1);
+        ASSERT_EQ(sums.live_sampled_bytes, 10);
+        ASSERT_EQ(sums.total_samples, 1);
+
+        allocator.free(buf, 10);
+        sums = sumCallSites();
+        ASSERT_EQ(sums.live_samples, 0);
+        ASSERT_EQ(sums.live_sampled_bytes, 0);
+        ASSERT_EQ(sums.total_samples, 1);
+    }
+    {
+        Arena arena(4096);
+        for (size_t i = 0; i < 100; ++i) arena.alloc(4096);
+        /// Chunks of Arena are allocated with Allocator.
+        ASSERT_GE(sumCallSites().live_sampled_bytes, 100 * 4096);
+    }
+    ASSERT_EQ(sumCallSites().live_samples, 0);
+
+    auto profile = AllocationProfiler::dumpHeapProfile();
+    ASSERT_EQ(profile.find("heap profile: 0: 0 ["), 0);
+    ASSERT_NE(profile.find("@ heap_v2/1\n"), std::string::npos);
+    ASSERT_NE(profile.find("\nMAPPED_LIBRARIES:\n"), std::string::npos);
+    std::cout << AllocationProfiler::toString(1);
+
+    AllocationProfiler::stop();
+    ASSERT_TRUE(AllocationProfiler::getCallSites().empty());
+}
+
+TEST(AllocationProfilerTest, estimation_test) {
+    constexpr size_t allocations = 4000;
+    constexpr size_t size = 4096;
+
+    AllocationProfiler::start(64 * 1024);
+    Allocator<false> allocator;
+    std::vector<void*> buffers;
+    for (size_t i = 0; i < allocations; ++i) buffers.push_back(allocator.alloc(size));
+
+    auto sums = sumCallSites();
+    std::cout << "sampled " << sums.live_samples << " of " << allocations
+              << " allocations, estimated " << sums.live_estimated_bytes << " of "
+              << allocations * size << " bytes" << std::endl;
+    ASSERT_GT(sums.live_samples, 0);
+    ASSERT_LT(sums.live_samples, allocations / 2);
+    ASSERT_GT(sums.live_estimated_bytes, allocations * size * 0.7);
+    ASSERT_LT(sums.live_estimated_bytes, allocations * size * 1.3);
+
+    for (void* buf : buffers) allocator.free(buf, size);
+    ASSERT_EQ(sumCallSites().live_estimated_bytes, 0);
+    AllocationProfiler::stop();
+}
+
+TEST(AllocationProfilerTest, shrink_test) {
+    /// A not sampled buffer which only shrinks is never sampled, a sampled one stays sampled.
+    AllocationProfiler::start(1 << 30);
+    Allocator<false> allocator;
+    void* buf = allocator.alloc(1 << 12);
+    buf = allocator.realloc(buf, 1 << 12, 1 << 10);
+    ASSERT_EQ(sumCallSites().total_samples, 0);
+    allocator.free(buf, 1 << 10);
+
+    AllocationProfiler::start(1);
+    buf = allocator.alloc(1 << 20);
+    for (size_t size = 1 << 20; size > 16; size /= 2) {
+        buf = allocator.realloc(buf, size, size / 2);
+        ASSERT_EQ(sumCallSites().live_samples, 1);
+    }
+    ASSERT_EQ(sumCallSites().live_sampled_bytes, 16);
+    allocator.free(buf, 16);
+    ASSERT_EQ(sumCallSites().live_samples, 0);
+    AllocationProfiler::stop();
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
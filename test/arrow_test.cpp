@@ -0,0 +1,303 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/formats/arrow_c_data.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+Block makeBlock(size_t rows) {
+    auto i8 = ColumnInt8::create();
+    auto u16 = ColumnUInt16::create();
+    auto i64 = ColumnInt64::create();
+    auto f64 = ColumnFloat64::create();
+    auto d32_type = createDecimal(9, 2);
+    auto d64_type = createDecimal(18, 4);
+    auto d128_type = createDecimal(30, 5);
+    auto d32 = d32_type->createColumn();
+    auto d64 = d64_type->createColumn();
+    auto d128 = d128_type->createColumn();
+    auto s = ColumnString::create();
+    auto ns = ColumnNullable::create(ColumnString::create(), ColumnUInt8::create());
+    auto ni = ColumnNullable::create(ColumnInt32::create(), ColumnUInt8::create());
+    for (size_t i = 0; i < rows; ++i) {
+        i8->insert(Int64(i % 200) - 100);
+        u16->insert(UInt64(i * 7));
+        i64->insert(Int64(i * 1000003));
+        f64->insert(i * 0.25);
+        d32->insert(DecimalField<Decimal32>(Decimal32(Int32(i) * 3), 2));
+        d64->insert(DecimalField<Decimal64>(Decimal64(Int64(i) * -5), 4));
+        d128->insert(DecimalField<Decimal128>(Decimal128(Int128(i) << 70), 5));
+        auto str = std::string(i % 5, 'a' + i % 26);
+        s->insertData(str.data(), str.size());
+        if (i % 3 == 0)
+            ns->insert(Null());
+        else
+            ns->insert(Field(str.data(), str.size()));
+        if (i % 4 == 1)
+            ni->insert(Null());
+        else
+            ni->insert(Int64(i));
+    }
+    auto constant = ColumnConst::create(ColumnInt32::create(1, 42), rows);
+    return Block({{std::move(i8), std::make_shared<DataTypeInt8>(), "i8"},
+                  {std::move(u16), std::make_shared<DataTypeUInt16>(), "u16"},
+                  {std::move(i64), std::make_shared<DataTypeInt64>(), "i64"},
+                  {std::move(f64), std::make_shared<DataTypeFloat64>(), "f64"},
+                  {std::move(d32), d32_type, "d32"},
+                  {std::move(d64), d64_type, "d64"},
+                  {std::move(d128), d128_type, "d128"},
+                  {std::move(s), std::make_shared<DataTypeString>(), "s"},
+                  {std::move(ns), makeNullable(std::make_shared<DataTypeString>()), "ns"},
+                  {std::move(ni), makeNullable(std::make_shared<DataTypeInt32>()), "ni"},
+                  {std::move(constant), std::make_shared<DataTypeInt32>(), "c"}});
+}
+
+void checkEquals(const Block& actual, const Block& expected) {
+    ASSERT_EQ(actual.columns(), expected.columns());
+    ASSERT_EQ(actual.rows(), expected.rows());
+    for (size_t i = 0; i < actual.columns(); ++i) {
+        const auto& column = actual.getByPosition(i);
+        const auto& expected_column = expected.getByPosition(i);
+        ASSERT_EQ(column.name, expected_column.name);
+        ASSERT_TRUE(column.type->equals(*expected_column.type)) << column.type->getName();
+        for (size_t row = 0; row < actual.rows(); ++row)
+            ASSERT_EQ((*column.column)[row], (*expected_column.column)[row])
+                    << column.name << " " << row;
+    }
+}
+
+int releases = 0;
+
+void countRelease(ArrowArray* array) {
+    ++releases;
+    for (Int64 i = 0; i < array->n_children; ++i) array->children[i]->release = nullptr;
+    array->release = nullptr;
+}
+
+} // namespace
+
+TEST(ArrowTest, bitmap_test) {
+    std::mt19937 rng(42);
+    for (size_t size = 0; size < 100; ++size) {
+        std::vector<UInt8> null_map(size);
+        for (auto& is_null : null_map) is_null = rng() % 3 == 0;
+        std::vector<UInt8> bitmap((size + 7) / 8);
+        nullMapToValidityBitmap(null_map.data(), size, bitmap.data());
+        for (size_t i = 0; i < size; ++i)
+            ASSERT_EQ((bitmap[i / 8] >> (i % 8)) & 1, !null_map[i]) << size << " " << i;
+
+        for (size_t offset : {0, 3, 8, 13}) {
+            if (offset > size) continue;
+            std::vector<UInt8> res(size - offset);
+            validityBitmapToNullMap(bitmap.data(), offset, size - offset, res.data());
+            for (size_t i = 0; i < res.size(); ++i)
+                ASSERT_EQ(res[i], null_map[offset + i]) << size << " " << offset << " " << i;
+        }
+    }
+}
+
+TEST(ArrowTest, roundtrip_test) {
+    Block block = makeBlock(100);
+    ArrowSchema schema;
+    ArrowArray array;
+    exportArrowBlock(block, &schema, &array);
+
+    ASSERT_STREQ(schema.format, "+s");
+    ASSERT_EQ(schema.n_children, 11);
+    ASSERT_EQ(array.length, 100);
+    std::vector<String> formats;
+    for (Int64 i = 0; i < schema.n_children; ++i) formats.push_back(schema.children[i]->format);
+    ASSERT_EQ(formats, (std::vector<String> {"c", "S", "l", "g", "d:9,2", "d:18,4", "d:30,5", "U",
+                                             "U", "i", "i"}));
+    ASSERT_EQ(schema.children[8]->flags, ARROW_FLAG_NULLABLE);
+    ASSERT_EQ(schema.children[7]->flags, 0);
+    ASSERT_EQ(array.children[8]->null_count, 34);
+    ASSERT_EQ(array.children[9]->null_count, 25);
+    ASSERT_EQ(array.children[2]->buffers[0], nullptr);
+
+    /// Numbers are shared.
+    ASSERT_EQ(array.children[2]->buffers[1], block.getByName("i64").column->getRawData().data);
+    ASSERT_EQ(array.children[6]->buffers[1], block.getByName("d128").column->getRawData().data);
+
+    /// Strings do not have terminating zeros.
+    const auto* offsets = static_cast<const Int64*>(array.children[7]->buffers[1]);
+    ASSERT_EQ(offsets[0], 0);
+    ASSERT_EQ(offsets[3], 0 + 1 + 2);
+    ASSERT_EQ(memcmp(array.children[7]->buffers[2], "bcc", 3), 0);
+
+    /// The buffers come from PaddedPODArray, so they have the padding for zero copy.
+    Block imported = importArrowBlock(&array, &schema, {true});
+    ASSERT_EQ(array.release, nullptr);
+    schema.release(&schema);
+    ASSERT_EQ(schema.release, nullptr);
+
+    Block expected = block;
+    expected.getByName("c").column = expected.getByName("c").column->convertToFullColumnIfConst();
+    checkEquals(imported, expected);
+
+    const auto& i64 = assert_cast<const ColumnInt64&>(*imported.getByName("i64").column);
+    ASSERT_TRUE(i64.isBorrowed());
+    ASSERT_EQ(static_cast<const void*>(i64.getData().data()),
+              block.getByName("i64").column->getRawData().data);
+    const auto& ni = assert_cast<const ColumnNullable&>(*imported.getByName("ni").column);
+    ASSERT_TRUE(assert_cast<const ColumnInt32&>(ni.getNestedColumn()).isBorrowed());
+
+    /// Without zero copy.
+    exportArrowBlock(block, &schema, &array);
+    Block copied = importArrowBlock(&array, &schema);
+    schema.release(&schema);
+    checkEquals(copied, expected);
+    ASSERT_FALSE(assert_cast<const ColumnInt64&>(*copied.getByName("i64").column).isBorrowed());
+}
+
+TEST(ArrowTest, lifetime_test) {
+    ArrowSchema schema;
+    ArrowArray array;
+    const void* exported_data;
+    {
+        Block block = makeBlock(10);
+        exportArrowBlock(block, &schema, &array);
+        exported_data = array.children[2]->buffers[1];
+
+        /// The column is shared with the array, so changing it makes a copy.
+        auto i64 = std::move(*block.getByName("i64").column).mutate();
+        assert_cast<ColumnInt64&>(*i64).getData()[0] = -1;
+        ASSERT_NE(static_cast<const void*>(i64->getRawData().data), exported_data);
+    }
+    ASSERT_EQ(static_cast<const Int64*>(exported_data)[0], 0);
+    ASSERT_EQ(static_cast<const Int64*>(exported_data)[9], 9 * 1000003);
+
+    Block imported = importArrowBlock(&array, &schema, {true});
+    schema.release(&schema);
+    {
+        /// The imported column is changed, the array keeps its data.
+        auto i64 = std::move(*imported.getByName("i64").column).mutate();
+        assert_cast<ColumnInt64&>(*i64).getData()[1] = -1;
+        ASSERT_FALSE(assert_cast<ColumnInt64&>(*i64).isBorrowed());
+        ASSERT_EQ(static_cast<const Int64*>(exported_data)[1], 1000003);
+        imported.getByName("i64").column = std::move(i64);
+    }
+    ASSERT_EQ(imported.getByName("i64").column->getInt(1), -1);
+    ASSERT_EQ(imported.getByName("i64").column->getInt(2), 2 * 1000003);
+}
+
+TEST(ArrowTest, import_test) {
+    /// Four rows of which the struct array uses the last three.
+    alignas(64) static const Int32 string_offsets[16] = {0, 1, 3, 3, 6};
+    alignas(64) static const char chars[32] = "abcdef";
+    alignas(64) static const UInt8 bools[16] = {0b1010};
+    alignas(64) static const UInt8 validity[16] = {0b1011};
+    alignas(64) static const Int128 decimals[8] = {100, -250, 12345, 1};
+    alignas(64) static const Int32 ints[16] = {10, 20, 30, 40};
+
+    const void* string_buffers[] = {nullptr, string_offsets, chars};
+    const void* bool_buffers[] = {validity, bools};
+    const void* decimal_buffers[] = {nullptr, decimals};
+    const void* int_buffers[] = {validity, ints};
+
+    ArrowSchema string_schema {"u", "s", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema bool_schema {"b", "b", nullptr, ARROW_FLAG_NULLABLE, 0, nullptr,
+                             nullptr, nullptr, nullptr};
+    ArrowSchema decimal_schema {"d:10,2", "d", nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    ArrowSchema int_schema {"i", "i", nullptr, ARROW_FLAG_NULLABLE, 0, nullptr,
+                            nullptr, nullptr, nullptr};
+    ArrowSchema* child_schemas[] = {&string_schema, &bool_schema, &decimal_schema, &int_schema};
+    ArrowSchema schema {"+s", "", nullptr, 0, 4, child_schemas, nullptr, nullptr, nullptr};
+
+    ArrowArray string_array {4, 0, 0, 3, 0, string_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray bool_array {4, 1, 0, 2, 0, bool_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray decimal_array {4, 0, 0, 2, 0, decimal_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray int_array {4, 1, 0, 2, 0, int_buffers, nullptr, nullptr, nullptr, nullptr};
+    ArrowArray* child_arrays[] = {&string_array, &bool_array, &decimal_array, &int_array};
+    const void* struct_buffers[] = {nullptr};
+    ArrowArray array {3, 0, 1, 1, 4, struct_buffers, child_arrays, nullptr, countRelease, nullptr};
+
+    releases = 0;
+    {
+        Block block = importArrowBlock(&array, &schema);
+        ASSERT_EQ(array.release, nullptr);
+        ASSERT_EQ(block.rows(), 3);
+        ASSERT_TRUE(block.getByName("s").type->equals(DataTypeString()));
+        ASSERT_TRUE(block.getByName("b").type->equals(
+                *makeNullable(std::make_shared<DataTypeUInt8>())));
+        ASSERT_TRUE(block.getByName("d").type->equals(*createDecimal(10, 2)));
+        ASSERT_TRUE(block.getByName("i").type->equals(
+                *makeNullable(std::make_shared<DataTypeInt32>())));
+
+        const auto& s = *block.getByName("s").column;
+        ASSERT_EQ(s.getDataAt(0).toString(), "bc");
+        ASSERT_EQ(s.getDataAt(1).toString(), "");
+        ASSERT_EQ(s.getDataAt(2).toString(), "def");
+
+        const auto& b = *block.getByName("b").column;
+        ASSERT_EQ(b[0], Field(UInt64(1)));
+        ASSERT_TRUE(b[1].isNull());
+        ASSERT_EQ(b[2], Field(UInt64(1)));
+
+        const auto& d = *block.getByName("d").column;
+        ASSERT_EQ(d[0], Field(DecimalField<Decimal64>(Decimal64(-250), 2)));
+        ASSERT_EQ(d[2], Field(DecimalField<Decimal64>(Decimal64(1), 2)));
+
+        const auto& i = *block.getByName("i").column;
+        ASSERT_EQ(i[0], Field(Int64(20)));
+        ASSERT_TRUE(i[1].isNull());
+        ASSERT_EQ(i[2], Field(Int64(40)));
+
+        /// The buffers are not padded, so they are copied and the array is released at once.
+        ASSERT_EQ(releases, 1);
+        ASSERT_FALSE(assert_cast<const ColumnInt32&>(
+                             assert_cast<const ColumnNullable&>(i).getNestedColumn())
+                             .isBorrowed());
+    }
+    ASSERT_EQ(releases, 1);
+
+    /// The array is released on errors too.
+    array.release = countRelease;
+    int_schema.format = "tdD";
+    ASSERT_THROW(importArrowBlock(&array, &schema), Exception);
+    ASSERT_EQ(releases, 2);
+
+    array.release = countRelease;
+    int_schema.format = "i";
+    array.null_count = 1;
+    ASSERT_THROW(importArrowBlock(&array, &schema), Exception);
+    ASSERT_EQ(releases, 3);
+    ASSERT_THROW(importArrowBlock(&array, &schema), Exception);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
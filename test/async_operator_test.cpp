@@ -0,0 +1,259 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/async_operator.h"
+#include "vec/exec/async_scheduler.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+extern const int CANNOT_READ_ALL_DATA;
+}
+
+namespace {
+
+Block makeHeader() {
+    return Block({{ColumnVector<Int64>::create(), std::make_shared<DataTypeInt64>(), "x"}});
+}
+
+/// Writes the values [first, first + count) as Int64 rows.
+void writeValues(int fd, Int64 first, size_t count) {
+    std::vector<Int64> values;
+    for (size_t i = 0; i < count; ++i) values.push_back(first + i);
+    const char* pos = reinterpret_cast<const char*>(values.data());
+    size_t size = values.size() * sizeof(Int64);
+    while (size) {
+        ssize_t res = write(fd, pos, size);
+        if (res < 0) {
+            /// The reader switched the pipe to non-blocking mode.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        pos += res;
+        size -= res;
+    }
+}
+
+/// Calls the function for every block.
+class CallbackTransform : public IBlockTransform {
+public:
+    explicit CallbackTransform(std::function<void(Block&)> callback_)
+            : callback(std::move(callback_)) {}
+    String getName() const override { return "Callback"; }
+    void transform(Block& block, size_t) override { callback(block); }
+
+private:
+    std::function<void(Block&)> callback;
+};
+
+Int64 sumOf(const Block& block) {
+    Int64 sum = 0;
+    for (auto value : assert_cast<const ColumnVector<Int64>&>(*block.getByPosition(0).column)
+                              .getData())
+        sum += value;
+    return sum;
+}
+
+} // namespace
+
+TEST(AsyncOperatorTest, pipe_source_test) {
+    constexpr size_t rows = 100000;
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+
+    WorkStealingThreadPool pool(2);
+    AsyncScheduler scheduler(pool);
+
+    std::atomic<Int64> sum{0};
+    std::atomic<size_t> blocks{0};
+    auto source = std::make_shared<AsyncFdSource>(fds[0], makeHeader(), 1000);
+    auto sink = std::make_shared<CallbackTransform>([&](Block& block) {
+        sum += sumOf(block);
+        ++blocks;
+        block.clear();
+    });
+
+    /// The writer is slower than the reader: the source suspends on the empty pipe.
+    std::thread writer([&] {
+        for (size_t i = 0; i < rows; i += 10000) {
+            writeValues(fds[1], i, 10000);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        close(fds[1]);
+    });
+    scheduler.execute({std::make_shared<AsyncTransformOperator>(source, sink)});
+    writer.join();
+    close(fds[0]);
+
+    ASSERT_EQ(sum.load(), Int64(rows * (rows - 1) / 2));
+    ASSERT_GE(blocks.load(), rows / 1000);
+}
+
+TEST(AsyncOperatorTest, many_operators_test) {
+    /// Much more operators than threads, all of them waiting for their pipes.
+    constexpr size_t num_operators = 200;
+    constexpr size_t rounds = 5;
+    constexpr size_t rows_per_round = 100;
+
+    WorkStealingThreadPool pool(2);
+    AsyncScheduler scheduler(pool);
+
+    std::vector<std::array<int, 2>> pipes(num_operators);
+    std::vector<Int64> sums(num_operators);
+    std::vector<AsyncOperatorPtr> roots;
+    for (size_t i = 0; i < num_operators; ++i) {
+        ASSERT_EQ(pipe(pipes[i].data()), 0);
+        auto source = std::make_shared<AsyncFdSource>(pipes[i][0], makeHeader(), 64);
+        auto sink = std::make_shared<CallbackTransform>(
+                [&, i](Block& block) { sums[i] += sumOf(block); });
+        roots.push_back(std::make_shared<AsyncTransformOperator>(source, sink));
+    }
+
+    std::thread writer([&] {
+        for (size_t round = 0; round < rounds; ++round) {
+            for (size_t i = 0; i < num_operators; ++i)
+                writeValues(pipes[i][1], round * rows_per_round, rows_per_round);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (auto& fds : pipes) close(fds[1]);
+    });
+    scheduler.execute(roots);
+    writer.join();
+
+    constexpr size_t total = rounds * rows_per_round;
+    for (size_t i = 0; i < num_operators; ++i) {
+        close(pipes[i][0]);
+        ASSERT_EQ(sums[i], Int64(total * (total - 1) / 2));
+    }
+}
+
+TEST(AsyncOperatorTest, file_prefetch_test) {
+    constexpr size_t rows = 200000;
+    char path[] = "/tmp/async_operator_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    unlink(path);
+    writeValues(fd, 0, rows);
+    ASSERT_EQ(lseek(fd, 0, SEEK_SET), 0);
+
+    WorkStealingThreadPool pool(4);
+    AsyncScheduler scheduler(pool);
+
+    auto sum = AggregateFunctionSimpleFactory::instance().get(
+            "sum", {std::make_shared<DataTypeInt64>()}, {});
+    auto aggregate = std::make_shared<PartialAggregateTransform>(
+            std::vector<AggregateFunctionPtr> {sum}, std::vector<ColumnNumbers> {{0}},
+            pool.getNumberOfThreads());
+    auto source = std::make_shared<AsyncFdSource>(fd, makeHeader(), 4096);
+    auto prefetch = std::make_shared<AsyncPrefetchOperator>(source, 4);
+    scheduler.execute({std::make_shared<AsyncTransformOperator>(prefetch, aggregate)});
+    close(fd);
+
+    Block result = aggregate->finalize();
+    ASSERT_EQ(result.getByPosition(0).column->getInt(0), Int64(rows * (rows - 1) / 2));
+}
+
+TEST(AsyncOperatorTest, exception_test) {
+    WorkStealingThreadPool pool(2);
+    AsyncScheduler scheduler(pool);
+
+    {
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+        writeValues(fds[1], 0, 100);
+        close(fds[1]);
+
+        auto source = std::make_shared<AsyncFdSource>(fds[0], makeHeader(), 10);
+        auto failing = std::make_shared<CallbackTransform>([](Block&) {
+            throw Exception("Transform failed", ErrorCodes::LOGICAL_ERROR);
+        });
+        /// Through the prefetch the exception goes from the producer task to the consumer.
+        auto prefetch = std::make_shared<AsyncPrefetchOperator>(
+                std::make_shared<AsyncTransformOperator>(source, failing));
+        try {
+            scheduler.execute({prefetch});
+            FAIL() << "Expected an exception";
+        } catch (const Exception& e) {
+            ASSERT_EQ(e.code(), ErrorCodes::LOGICAL_ERROR);
+        }
+        close(fds[0]);
+    }
+
+    {
+        /// Half of a row at the end.
+        int fds[2];
+        ASSERT_EQ(pipe(fds), 0);
+        writeValues(fds[1], 0, 10);
+        ASSERT_EQ(write(fds[1], "abcd", 4), 4);
+        close(fds[1]);
+
+        auto source = std::make_shared<AsyncFdSource>(fds[0], makeHeader(), 100);
+        try {
+            scheduler.execute({source});
+            FAIL() << "Expected an exception";
+        } catch (const Exception& e) {
+            ASSERT_EQ(e.code(), ErrorCodes::CANNOT_READ_ALL_DATA);
+        }
+        close(fds[0]);
+    }
+}
+
+/// Returns Finished after the first block of the child and drops the child.
+class FirstBlockOperator : public IAsyncOperator {
+public:
+    explicit FirstBlockOperator(AsyncOperatorPtr child_) : child(std::move(child_)) {}
+    String getName() const override { return "FirstBlock"; }
+
+    PollStatus poll(Block& block, AsyncContext& context) override {
+        auto status = child->poll(block, context);
+        if (status != PollStatus::Ready || block.rows() == 0) return status;
+        child.reset();
+        return PollStatus::Finished;
+    }
+
+private:
+    AsyncOperatorPtr child;
+};
+
+TEST(AsyncOperatorTest, cancel_prefetch_test) {
+    WorkStealingThreadPool pool(2);
+    AsyncScheduler scheduler(pool);
+
+    /// The pipe stays open and empty after the first block, so the producer of the prefetch
+    /// waits for it in the poller when the prefetch is dropped.
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    writeValues(fds[1], 0, 10);
+    auto source = std::make_shared<AsyncFdSource>(fds[0], makeHeader(), 10);
+    std::weak_ptr<IAsyncOperator> weak_source = source;
+    auto prefetch = std::make_shared<AsyncPrefetchOperator>(std::move(source));
+    scheduler.execute({std::make_shared<FirstBlockOperator>(std::move(prefetch))});
+
+    /// The producer task is woken up, finishes and removes the descriptor from the poller.
+    for (size_t i = 0; i < 1000 && !weak_source.expired(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_TRUE(weak_source.expired());
+    close(fds[0]);
+    close(fds[1]);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
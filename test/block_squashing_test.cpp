@@ -0,0 +1,253 @@
+#include <atomic>
+#include <iostream>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/async_scheduler.h"
+#include "vec/exec/block_squashing.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// A block of (x Int64, s String) with x in [first, first + rows).
+Block makeBlock(size_t first, size_t rows) {
+    auto x = ColumnVector<Int64>::create();
+    auto s = ColumnString::create();
+    for (size_t i = first; i < first + rows; ++i) {
+        x->getData().push_back(i);
+        auto str = std::to_string(i);
+        s->insertData(str.data(), str.size());
+    }
+    return Block({{std::move(x), std::make_shared<DataTypeInt64>(), "x"},
+                  {std::move(s), std::make_shared<DataTypeString>(), "s"}});
+}
+
+/// Checks that the blocks continue each other from expected.
+void checkSequence(const Block& block, size_t& expected) {
+    for (size_t row = 0; row < block.rows(); ++row, ++expected) {
+        ASSERT_EQ(block.getByPosition(0).column->getInt(row), Int64(expected));
+        ASSERT_EQ(block.getByPosition(1).column->getDataAt(row).toString(),
+                  std::to_string(expected));
+    }
+}
+
+/// Returns blocks of the given sizes.
+class SizesSource : public IAsyncOperator {
+public:
+    explicit SizesSource(std::vector<size_t> sizes_) : sizes(std::move(sizes_)) {}
+    String getName() const override { return "Sizes"; }
+    PollStatus poll(Block& block, AsyncContext&) override {
+        if (next == sizes.size()) return PollStatus::Finished;
+        block = makeBlock(first, sizes[next]);
+        first += sizes[next++];
+        return PollStatus::Ready;
+    }
+
+private:
+    std::vector<size_t> sizes;
+    size_t next = 0;
+    size_t first = 0;
+};
+
+/// Collects the blocks of the child.
+class CollectingSink : public IAsyncOperator {
+public:
+    explicit CollectingSink(AsyncOperatorPtr child_) : child(std::move(child_)) {}
+    String getName() const override { return "Collecting"; }
+    PollStatus poll(Block& block, AsyncContext& context) override {
+        auto status = child->poll(block, context);
+        if (status == PollStatus::Ready) blocks.push_back(std::move(block));
+        return status;
+    }
+
+    std::vector<Block> blocks;
+
+private:
+    AsyncOperatorPtr child;
+};
+
+} // namespace
+
+TEST(BlockSquashingTest, squasher_test) {
+    BlockSquasher squasher(100, 1 << 20);
+    size_t expected = 0;
+    size_t first = 0;
+
+    /// Small blocks are accumulated up to the target.
+    std::vector<Block> results;
+    for (size_t i = 0; i < 25; ++i) {
+        Block res = squasher.add(makeBlock(first, 7));
+        first += 7;
+        if (res) results.push_back(std::move(res));
+    }
+    ASSERT_EQ(results.size(), 1);
+    ASSERT_EQ(results[0].rows(), 105);
+
+    /// A big block returns what was accumulated, and itself is returned as is by the next call.
+    Block big = makeBlock(first, 500);
+    const IColumn* big_column = big.getByPosition(0).column.get();
+    Block res = squasher.add(std::move(big));
+    first += 500;
+    ASSERT_EQ(res.rows(), 175 - 105);
+    results.push_back(std::move(res));
+    res = squasher.add(makeBlock(first, 3));
+    first += 3;
+    ASSERT_EQ(res.rows(), 500);
+    ASSERT_EQ(res.getByPosition(0).column.get(), big_column);
+    results.push_back(std::move(res));
+
+    res = squasher.add(makeBlock(first, 200));
+    first += 200;
+    ASSERT_EQ(res.rows(), 3);
+    results.push_back(std::move(res));
+    res = squasher.add(makeBlock(first, 5));
+    first += 5;
+    ASSERT_EQ(res.rows(), 200);
+    results.push_back(std::move(res));
+
+    ASSERT_FALSE(squasher.add(Block()));
+    res = squasher.flush();
+    ASSERT_EQ(res.rows(), 5);
+    results.push_back(std::move(res));
+    ASSERT_FALSE(squasher.flush());
+
+    /// A big block is passed as is when nothing is accumulated.
+    res = squasher.add(makeBlock(first, 200));
+    first += 200;
+    ASSERT_EQ(res.rows(), 200);
+    results.push_back(std::move(res));
+
+    /// A pending big block is returned by flush.
+    ASSERT_FALSE(squasher.add(makeBlock(first, 5)));
+    first += 5;
+    res = squasher.add(makeBlock(first, 300));
+    first += 300;
+    ASSERT_EQ(res.rows(), 5);
+    results.push_back(std::move(res));
+    res = squasher.flush();
+    ASSERT_EQ(res.rows(), 300);
+    results.push_back(std::move(res));
+    ASSERT_FALSE(squasher.flush());
+
+    for (const auto& block : results) checkSequence(block, expected);
+    ASSERT_EQ(expected, first);
+}
+
+TEST(BlockSquashingTest, squasher_bytes_test) {
+    Block sample = makeBlock(0, 10);
+    BlockSquasher squasher(1000000, sample.bytes() * 3);
+    for (size_t i = 0; i < 2; ++i) ASSERT_FALSE(squasher.add(makeBlock(i * 10, 10)));
+    Block res = squasher.add(makeBlock(20, 10));
+    ASSERT_EQ(res.rows(), 30);
+}
+
+TEST(BlockSquashingTest, splitter_test) {
+    BlockSplitter splitter;
+    Block piece;
+    ASSERT_FALSE(splitter.next(piece, 100));
+
+    splitter.setBlock(makeBlock(0, 1040));
+    std::vector<size_t> sizes;
+    size_t expected = 0;
+    while (splitter.next(piece, 100)) {
+        sizes.push_back(piece.rows());
+        checkSequence(piece, expected);
+    }
+    /// The tail of 40 rows is attached to the last piece.
+    ASSERT_EQ(sizes, std::vector<size_t>({100, 100, 100, 100, 100, 100, 100, 100, 100, 140}));
+
+    /// A small block is passed as is.
+    splitter.setBlock(makeBlock(0, 120));
+    ASSERT_TRUE(splitter.next(piece, 100));
+    ASSERT_EQ(piece.rows(), 120);
+    ASSERT_FALSE(splitter.next(piece, 100));
+}
+
+TEST(BlockSquashingTest, adaptive_size_test) {
+    BlockSizeSettings settings;
+    settings.min_rows = 256;
+    settings.max_rows = 1 << 20;
+    settings.initial_rows = 1024;
+    settings.max_bytes = 1ULL << 40;
+    AdaptiveBlockSize size(settings);
+
+    /// A model of a consumer: fixed cost per block, and rows get slower beyond 16K rows,
+    /// when the block does not fit into the cache. The best size is 16K.
+    auto cost = [](size_t rows) -> UInt64 {
+        UInt64 nanoseconds = 20000 + rows;
+        if (rows > 16384) nanoseconds += (rows - 16384) * 4;
+        return nanoseconds;
+    };
+    for (size_t i = 0; i < 2000; ++i) {
+        size_t rows = size.getRows();
+        size.update(rows, rows * 8, cost(rows));
+    }
+    ASSERT_GE(size.getRows(), 8192);
+    ASSERT_LE(size.getRows(), 32768);
+
+    /// The bytes limit caps the rows by the average size of a row.
+    settings.max_bytes = 8 * 2000;
+    settings.adaptive = false;
+    AdaptiveBlockSize limited(settings);
+    ASSERT_EQ(limited.getRows(), 1024);
+    limited.update(100, 800, 1000);
+    ASSERT_EQ(limited.getRows(), 1024);
+    settings.max_bytes = 8 * 500;
+    AdaptiveBlockSize small(settings);
+    small.update(100, 800, 1000);
+    ASSERT_EQ(small.getRows(), 500);
+}
+
+TEST(BlockSquashingTest, operators_test) {
+    WorkStealingThreadPool pool(2);
+    AsyncScheduler scheduler(pool);
+
+    BlockSizeSettings settings;
+    settings.min_rows = 100;
+    settings.max_rows = 100;
+    settings.initial_rows = 100;
+
+    std::vector<size_t> sizes;
+    size_t total = 0;
+    for (size_t i = 0; i < 300; ++i) {
+        sizes.push_back(i % 50 == 0 ? 1000 : i % 7);
+        total += sizes.back();
+    }
+
+    auto squashing = std::make_shared<CollectingSink>(std::make_shared<AsyncSquashingOperator>(
+            std::make_shared<SizesSource>(sizes), settings));
+    auto splitting = std::make_shared<CollectingSink>(std::make_shared<AsyncSplittingOperator>(
+            std::make_shared<SizesSource>(sizes), settings));
+    scheduler.execute({squashing, splitting});
+
+    size_t expected = 0;
+    for (size_t i = 0; i < squashing->blocks.size(); ++i) {
+        const auto& block = squashing->blocks[i];
+        /// Only the last block, or the rest before a big block, is smaller than the target.
+        if (i + 1 != squashing->blocks.size() && squashing->blocks[i + 1].rows() < 1000) {
+            ASSERT_GE(block.rows(), 100);
+        }
+        checkSequence(block, expected);
+    }
+    ASSERT_EQ(expected, total);
+
+    expected = 0;
+    for (const auto& block : splitting->blocks) {
+        ASSERT_LE(block.rows(), 150);
+        checkSequence(block, expected);
+    }
+    ASSERT_EQ(expected, total);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,5 +1,11 @@
 #include "vec/core/block.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
 #include "vec/data_types/data_types_number.h"
 
 #include "vec/core/block_info.h"
@@ -27,6 +33,180 @@ TEST(BlockTest, BlockBasicTest) {
     ColumnWithTypeAndName type_and_name(vec->getPtr(), data_type, "echo");
     Block block({type_and_name});
 }
+
+TEST(BlockTest, FilterBlockTest) {
+    DataTypePtr data_type(std::make_shared<DataTypeInt32>());
+    DataTypePtr filter_type(std::make_shared<DataTypeUInt8>());
+
+    auto make_block = [&](std::vector<UInt8> filter_values) {
+        Block block;
+        for (int c = 0; c < 3; ++c) {
+            auto column = ColumnVector<Int32>::create();
+            for (int i = 0; i < 4; ++i) column->insert(c * 10 + i);
+            block.insert({std::move(column), data_type, "c" + std::to_string(c)});
+        }
+        auto filter = ColumnVector<UInt8>::create();
+        for (auto value : filter_values) filter->insert(value);
+        block.insert({std::move(filter), filter_type, "filter"});
+        block.insert({ColumnVector<Int32>::create(4), data_type, "tmp"});
+        return block;
+    };
+
+    Block block = make_block({1, 0, 0, 1});
+    Block::filter_block(&block, 3, 2);
+    ASSERT_EQ(block.columns(), 2);
+    ASSERT_EQ(block.rows(), 2);
+    ASSERT_EQ(block.getByPosition(1).column->getInt(0), 10);
+    ASSERT_EQ(block.getByPosition(1).column->getInt(1), 13);
+
+    Block empty = make_block({0, 0, 0, 0});
+    Block::filter_block(&empty, 3, 3);
+    ASSERT_EQ(empty.columns(), 3);
+    for (size_t i = 0; i < empty.columns(); ++i)
+        ASSERT_EQ(empty.getByPosition(i).column->size(), 0);
+}
+
+TEST(BlockTest, CutBlockTest) {
+    DataTypePtr int_type(std::make_shared<DataTypeInt64>());
+    DataTypePtr decimal_type = createDecimal(18, 2);
+    DataTypePtr string_type(std::make_shared<DataTypeString>());
+    DataTypePtr nullable_type = makeNullable(string_type);
+
+    auto ints = ColumnVector<Int64>::create();
+    auto decimals = decimal_type->createColumn();
+    auto strings = ColumnString::create();
+    auto nullables = nullable_type->createColumn();
+    for (int i = 0; i < 100; ++i) {
+        ints->insert(Int64(i));
+        decimals->insert(DecimalField<Decimal64>(Decimal64(i * 3), 2));
+        String str(i % 7, 'a' + i % 26);
+        strings->insertData(str.data(), str.size());
+        if (i % 3 == 0)
+            nullables->insertDefault();
+        else
+            nullables->insertData(str.data(), str.size());
+    }
+    Block block({{std::move(ints), int_type, "i"},
+                 {std::move(decimals), decimal_type, "d"},
+                 {std::move(strings), string_type, "s"},
+                 {std::move(nullables), nullable_type, "n"}});
+
+    auto check = [&](const Block& piece, size_t offset) {
+        for (size_t i = 0; i < piece.columns(); ++i)
+            for (size_t row = 0; row < piece.rows(); ++row)
+                ASSERT_EQ((*piece.getByPosition(i).column)[row],
+                          (*block.getByPosition(i).column)[offset + row]);
+    };
+
+    for (size_t offset : {0, 1, 37, 99, 100}) {
+        size_t length = std::min<size_t>(25, 100 - offset);
+        Block piece = block.cut(offset, length);
+        ASSERT_EQ(piece.rows(), length);
+        check(piece, offset);
+    }
+    ASSERT_THROW(block.cut(90, 11), Exception);
+
+    /// Only a large part of a numeric column is shared, not copied.
+    {
+        auto big_ints = ColumnInt64::create();
+        for (Int64 i = 0; i < 65536; ++i) big_ints->insert(i);
+        auto big_strings = ColumnString::create();
+        for (size_t i = 0; i < 65536; ++i) big_strings->insertData("a", 1);
+
+        ColumnPtr view = big_ints->cut(10, 4096);
+        const auto& view_ints = assert_cast<const ColumnInt64&>(*view);
+        ASSERT_TRUE(view_ints.isBorrowed());
+        const ColumnInt64& source_ints = *big_ints;
+        ASSERT_EQ(view_ints.getData().data(), source_ints.getData().data() + 10);
+
+        ASSERT_FALSE(assert_cast<const ColumnInt64&>(*big_ints->cut(10, 100)).isBorrowed());
+        ASSERT_FALSE(assert_cast<const ColumnInt64&>(*big_ints->cut(10, 2048)).isBorrowed());
+        ASSERT_FALSE(assert_cast<const ColumnString&>(*big_strings->cut(10, 32768)).isBorrowed());
+    }
+
+    Block piece = block.cut(10, 20);
+
+    /// The source is copied if it is changed while a piece uses its data.
+    for (size_t i = 0; i < block.columns(); ++i) {
+        auto& column = block.getByPosition(i).column;
+        auto mutable_column = std::move(*column).mutate();
+        mutable_column->insertDefault();
+        column = std::move(mutable_column);
+    }
+    ASSERT_EQ(block.rows(), 101);
+    check(piece, 10);
+
+    /// A piece makes a private copy when it is changed.
+    for (size_t i = 0; i < piece.columns(); ++i) {
+        auto& column = piece.getByPosition(i).column;
+        auto mutable_column = std::move(*column).mutate();
+        mutable_column->insertFrom(*block.getByPosition(i).column, 30);
+        column = std::move(mutable_column);
+    }
+    ASSERT_EQ(piece.rows(), 21);
+    ASSERT_FALSE(assert_cast<const ColumnInt64&>(*piece.getByPosition(0).column).isBorrowed());
+    check(piece, 10);
+
+    /// A piece outlives the block.
+    piece = block.cut(50, 10);
+    Block expected = block.cloneEmpty();
+    {
+        MutableColumns columns = expected.mutateColumns();
+        for (size_t i = 0; i < columns.size(); ++i)
+            columns[i]->insertRangeFrom(*block.getByPosition(i).column, 50, 10);
+        expected.setColumns(std::move(columns));
+    }
+    block.clear();
+    for (size_t i = 0; i < piece.columns(); ++i)
+        for (size_t row = 0; row < piece.rows(); ++row)
+            ASSERT_EQ((*piece.getByPosition(i).column)[row],
+                      (*expected.getByPosition(i).column)[row]);
+}
+
+TEST(BlockTest, CutMutableSourceTest) {
+    auto ints = ColumnVector<Int64>::create();
+    auto strings = ColumnString::create();
+    auto append = [&](size_t rows) {
+        for (size_t i = 0; i < rows; ++i) {
+            String str = std::to_string(ints->size());
+            ints->insert(Int64(ints->size()));
+            strings->insertData(str.data(), str.size());
+        }
+    };
+    auto check = [](const ColumnPtr& int_piece, const ColumnPtr& string_piece, size_t offset) {
+        for (size_t row = 0; row < int_piece->size(); ++row) {
+            ASSERT_EQ(int_piece->getInt(row), Int64(offset + row));
+            ASSERT_EQ(string_piece->getDataAt(row).toString(), std::to_string(offset + row));
+        }
+    };
+
+    /// The source is still changed through its MutablePtr while the pieces use its data.
+    append(4096);
+    ColumnPtr int_piece = ints->cut(2, 4000);
+    ColumnPtr string_piece = strings->cut(2, 4000);
+    ASSERT_TRUE(assert_cast<const ColumnInt64&>(*int_piece).isBorrowed());
+    append(100000);
+    check(int_piece, string_piece, 2);
+
+    ColumnPtr next_int_piece = ints->cut(50000, 10000);
+    ColumnPtr next_string_piece = strings->cut(50000, 10000);
+    ASSERT_TRUE(assert_cast<const ColumnInt64&>(*next_int_piece).isBorrowed());
+    append(100000);
+    ints->popBack(10);
+    strings->popBack(10);
+    check(int_piece, string_piece, 2);
+    check(next_int_piece, next_string_piece, 50000);
+    ASSERT_EQ(ints->size(), 204086);
+    ASSERT_EQ(strings->getDataAt(204085).toString(), "204085");
+
+    /// Without pieces, the source is changed in place again.
+    int_piece.reset();
+    next_int_piece.reset();
+    ints->reserve(ints->size() + 1);
+    const Int64* data = ints->getData().data();
+    ints->insertDefault();
+    ASSERT_EQ(ints->getData().data(), data);
+}
 } // namespace DB
 
 int main(int argc, char** argv) {
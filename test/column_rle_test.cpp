@@ -0,0 +1,309 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/columns/column_rle.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/query_profile.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/block_transform.h"
+#include "vec/functions/function_cast.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// 1000 rows in runs of 1 to 100 equal values.
+template <typename F>
+void fillRuns(std::mt19937_64& rng, F&& insert_run) {
+    for (size_t rows = 0, run = 0; rows < 1000; rows += run) {
+        run = std::min(size_t(rng() % 100 + 1), 1000 - rows);
+        insert_run(run);
+    }
+}
+
+ColumnPtr makeInt64Column(std::mt19937_64& rng) {
+    auto column = ColumnInt64::create();
+    fillRuns(rng, [&](size_t run) {
+        column->getData().resize_fill(column->size() + run, Int64(rng() % 10));
+    });
+    return column;
+}
+
+ColumnPtr makeStringColumn(std::mt19937_64& rng) {
+    auto column = ColumnString::create();
+    fillRuns(rng, [&](size_t run) {
+        std::string str = std::to_string(rng() % 10);
+        for (size_t i = 0; i < run; ++i) column->insertData(str.data(), str.size());
+    });
+    return column;
+}
+
+ColumnPtr makeNullableColumn(std::mt19937_64& rng) {
+    auto column = makeNullable(std::make_shared<DataTypeInt32>())->createColumn();
+    fillRuns(rng, [&](size_t run) {
+        Field value = rng() % 3 == 0 ? Field(Null()) : Field(Int64(rng() % 10));
+        for (size_t i = 0; i < run; ++i) column->insert(value);
+    });
+    return column;
+}
+
+void assertColumnsEqual(const IColumn& expected, const IColumn& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) ASSERT_EQ(expected[i], actual[i]) << i;
+}
+
+/// Checks the operations of a run-length encoded column against the same operations
+/// of the full column.
+void checkRLE(const ColumnPtr& full, std::mt19937_64& rng) {
+    ColumnPtr rle = ColumnRLE::createFromFull(*full);
+    ASSERT_TRUE(rle->isRLE());
+    ASSERT_LT(rle->byteSize(), full->byteSize() / 4);
+    assertColumnsEqual(*full, *rle);
+    assertColumnsEqual(*full, *rle->convertToFullColumnIfRLE());
+
+    IColumn::Filter filter(full->size());
+    for (auto& value : filter) value = rng() % 2;
+    assertColumnsEqual(*full->filter(filter, -1), *rle->filter(filter, -1));
+
+    IColumn::Permutation perm(full->size());
+    IColumn::Permutation32 perm32(full->size());
+    for (size_t i = 0; i < perm.size(); ++i) perm32[i] = perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), rng);
+    std::shuffle(perm32.begin(), perm32.end(), rng);
+    assertColumnsEqual(*full->permute(perm, 0), *rle->permute(perm, 0));
+    assertColumnsEqual(*full->permute(perm32, 100), *rle->permute(perm32, 100));
+
+    for (size_t limit : {0, 10}) {
+        for (bool reverse : {false, true}) {
+            rle->getPermutation(reverse, limit, 1, perm32);
+            full->getPermutation(reverse, limit, 1, perm);
+            ColumnPtr sorted = full->permute(perm, limit);
+            ColumnPtr rle_sorted = rle->permute(perm32, limit);
+            assertColumnsEqual(*sorted, *rle_sorted);
+            /// Sorted rows of a run stay together.
+            if (!limit) {
+                ASSERT_LE(rle_sorted->byteSize(), rle->byteSize());
+            }
+        }
+    }
+
+    assertColumnsEqual(*full->cut(123, 456), *rle->cut(123, 456));
+    assertColumnsEqual(*full->cloneResized(10), *rle->cloneResized(10));
+    assertColumnsEqual(*full->cloneResized(2000), *rle->cloneResized(2000));
+
+    IColumn::Offsets offsets(full->size());
+    for (size_t i = 0, offset = 0; i < offsets.size(); ++i) offsets[i] = offset += rng() % 3;
+    assertColumnsEqual(*full->replicate(offsets), *rle->replicate(offsets));
+
+    /// Insert ranges from run-length encoded and from full columns.
+    auto full_copy = full->cloneEmpty();
+    auto rle_copy = ColumnRLE::create(full->cloneEmpty());
+    for (size_t start = 0; start < full->size(); start += 100) {
+        full_copy->insertRangeFrom(*full, start, 100);
+        rle_copy->insertRangeFrom(start % 200 ? *rle : *full, start, 100);
+    }
+    full_copy->insertFrom(*full, 7);
+    rle_copy->insertFrom(*rle, 7);
+    full_copy->insertDefault();
+    rle_copy->insertDefault();
+    assertColumnsEqual(*full_copy, *rle_copy);
+    ASSERT_LT(rle_copy->byteSize(), full_copy->byteSize() / 4);
+
+    full_copy->popBack(500);
+    rle_copy->popBack(500);
+    assertColumnsEqual(*full_copy, *rle_copy);
+
+    Field full_min, full_max, rle_min, rle_max;
+    full->getExtremes(full_min, full_max);
+    rle->getExtremes(rle_min, rle_max);
+    ASSERT_EQ(full_min, rle_min);
+    ASSERT_EQ(full_max, rle_max);
+}
+
+size_t execute(Block& block, const FunctionBasePtr& function, const ColumnNumbers& arguments) {
+    block.insert({nullptr, function->getReturnType(), function->getName()});
+    function->execute(block, arguments, block.columns() - 1, block.rows());
+    return block.columns() - 1;
+}
+
+size_t execute(Block& block, const std::string& name, const ColumnNumbers& arguments) {
+    ColumnsWithTypeAndName columns;
+    for (auto position : arguments) columns.push_back(block.getByPosition(position));
+    return execute(block, SimpleFunctionFactory::instance().get_function(name, columns),
+                   arguments);
+}
+
+/// The number of the row in the block: the result in a row depends on the other rows.
+class FunctionRowNumber : public IFunction {
+public:
+    String getName() const override { return "rowNumber"; }
+    size_t getNumberOfArguments() const override { return 1; }
+
+    DataTypePtr getReturnTypeImpl(const DataTypes& /*arguments*/) const override {
+        return std::make_shared<DataTypeUInt64>();
+    }
+
+    void executeImpl(Block& block, const ColumnNumbers& /*arguments*/, size_t result,
+                     size_t input_rows_count) override {
+        auto column = ColumnUInt64::create();
+        for (size_t i = 0; i < input_rows_count; ++i) column->insertValue(i);
+        block.getByPosition(result).column = std::move(column);
+    }
+};
+
+} // namespace
+
+TEST(ColumnRLETest, int64_test) {
+    std::mt19937_64 rng(1);
+    checkRLE(makeInt64Column(rng), rng);
+}
+
+TEST(ColumnRLETest, string_test) {
+    std::mt19937_64 rng(2);
+    checkRLE(makeStringColumn(rng), rng);
+}
+
+TEST(ColumnRLETest, nullable_test) {
+    std::mt19937_64 rng(3);
+    checkRLE(makeNullableColumn(rng), rng);
+}
+
+TEST(ColumnRLETest, convert_test) {
+    std::mt19937_64 rng(4);
+    ColumnPtr full = makeInt64Column(rng);
+    ASSERT_TRUE(ColumnRLE::convertToRLEIfWorthIt(full)->isRLE());
+    ASSERT_FALSE(ColumnRLE::convertToRLEIfWorthIt(full, 500)->isRLE());
+
+    auto column = ColumnInt64::create();
+    for (Int64 i = 0; i < 1000; ++i) column->insertValue(i);
+    ASSERT_EQ(ColumnRLE::convertToRLEIfWorthIt(column->getPtr()).get(), column.get());
+
+    auto single_run = ColumnRLE::createFromFull(*ColumnInt64::create(1000, 5));
+    ASSERT_EQ(assert_cast<const ColumnRLE&>(*single_run).getNumberOfRuns(), 1);
+    ASSERT_EQ(ColumnRLE::createFromFull(*ColumnInt64::create())->size(), 0);
+}
+
+TEST(ColumnRLETest, function_test) {
+    std::mt19937_64 rng(5);
+    ColumnPtr full = makeInt64Column(rng);
+    ColumnPtr rle = ColumnRLE::createFromFull(*full);
+    auto int64_type = std::make_shared<DataTypeInt64>();
+    Block block({{rle, int64_type, "rle"},
+                 {int64_type->createColumnConst(full->size(), Int64(3)), int64_type, "three"},
+                 {full, int64_type, "full"}});
+
+    QueryProfile profile("query");
+    {
+        QueryProfile::Scope scope(profile);
+
+        /// Arithmetic and comparison are computed once per run.
+        size_t sum = execute(block, "add", {0, 1});
+        const auto& sum_column = *block.getByPosition(sum).column;
+        ASSERT_TRUE(sum_column.isRLE());
+        ASSERT_EQ(assert_cast<const ColumnRLE&>(sum_column).getEndsPtr().get(),
+                  assert_cast<const ColumnRLE&>(*rle).getEndsPtr().get());
+        for (size_t i = 0; i < full->size(); ++i)
+            ASSERT_EQ(sum_column[i], Field(full->getInt(i) + 3));
+
+        size_t less = execute(block, "lt", {0, sum});
+        ASSERT_TRUE(block.getByPosition(less).column->isRLE());
+        for (size_t i = 0; i < full->size(); ++i)
+            ASSERT_EQ(block.getByPosition(less).column->getUInt(i), 1);
+
+        /// A full argument needs full columns.
+        size_t diff = execute(block, "subtract", {0, 2});
+        ASSERT_FALSE(block.getByPosition(diff).column->isRLE());
+        for (size_t i = 0; i < full->size(); ++i)
+            ASSERT_EQ(block.getByPosition(diff).column->getInt(i), 0);
+    }
+
+    auto snapshot = profile.snapshot();
+    ASSERT_EQ(snapshot.children.size(), 3);
+    for (const auto& function : snapshot.children)
+        ASSERT_EQ(function.rle_default_rows, function.name == "subtract" ? 0 : 1000);
+
+    /// CAST keeps the runs.
+    auto type_name = ColumnString::create();
+    type_name->insertData("Float64", 7);
+    block.insert({ColumnConst::create(std::move(type_name), full->size()),
+                  std::make_shared<DataTypeString>(), "type"});
+    ColumnNumbers cast_arguments {0, block.columns() - 1};
+    auto cast = FunctionBuilderCast::create()->build(
+            {block.getByPosition(0), block.getByPosition(block.columns() - 1)});
+    size_t float_result = execute(block, cast, cast_arguments);
+    const auto& float_column = *block.getByPosition(float_result).column;
+    ASSERT_TRUE(float_column.isRLE());
+    for (size_t i = 0; i < full->size(); ++i)
+        ASSERT_EQ(float_column.getFloat64(i), Float64(full->getInt(i)));
+
+    /// A function that does not opt in is executed on the full columns.
+    auto row_number = std::make_shared<DefaultFunctionBuilder>(
+            std::make_shared<FunctionRowNumber>());
+    size_t numbers = execute(block, row_number->build({block.getByPosition(0)}), {0});
+    ASSERT_FALSE(block.getByPosition(numbers).column->isRLE());
+    for (size_t i = 0; i < full->size(); ++i)
+        ASSERT_EQ(block.getByPosition(numbers).column->getUInt(i), i);
+}
+
+TEST(ColumnRLETest, aggregate_test) {
+    std::mt19937_64 rng(6);
+    ColumnPtr full = makeInt64Column(rng);
+    ColumnPtr nullable = makeNullableColumn(rng);
+    auto int64_type = std::make_shared<DataTypeInt64>();
+    auto nullable_type = makeNullable(std::make_shared<DataTypeInt32>());
+    auto& factory = AggregateFunctionSimpleFactory::instance();
+    auto sum = factory.get("sum", {int64_type}, {});
+    auto nullable_sum = factory.get("sum", {nullable_type}, {});
+    auto count = factory.get("count", {nullable_type}, {});
+    PartialAggregateTransform aggregate({sum, nullable_sum, count}, {{0}, {1}, {1}}, 1);
+    Block block({{ColumnRLE::createFromFull(*full), int64_type, "rle"},
+                 {ColumnRLE::createFromFull(*nullable), nullable_type, "nullable"}});
+    aggregate.transform(block, 0);
+
+    Int64 expected_sum = 0;
+    Int64 expected_nullable_sum = 0;
+    UInt64 expected_count = 0;
+    for (size_t i = 0; i < full->size(); ++i) {
+        expected_sum += full->getInt(i);
+        if (!nullable->isNullAt(i)) {
+            expected_nullable_sum += nullable->get64(i);
+            ++expected_count;
+        }
+    }
+    Block result = aggregate.finalize();
+    ASSERT_EQ(result.getByPosition(0).column->getInt(0), expected_sum);
+    ASSERT_EQ((*result.getByPosition(1).column)[0], Field(expected_nullable_sum));
+    ASSERT_EQ(result.getByPosition(2).column->get64(0), expected_count);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
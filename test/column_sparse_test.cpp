@@ -0,0 +1,253 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/columns/column_sparse.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/query_profile.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/block_transform.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// 1000 rows, about 5% of them are not default.
+ColumnPtr makeInt64Column(std::mt19937_64& rng) {
+    auto column = ColumnInt64::create();
+    for (size_t i = 0; i < 1000; ++i)
+        column->insertValue(rng() % 20 == 0 ? Int64(rng() % 100) - 50 : 0);
+    return column;
+}
+
+ColumnPtr makeStringColumn(std::mt19937_64& rng) {
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string str = rng() % 20 == 0 ? std::to_string(rng() % 100) : "";
+        column->insertData(str.data(), str.size());
+    }
+    return column;
+}
+
+ColumnPtr makeNullableColumn(std::mt19937_64& rng) {
+    auto column = makeNullable(std::make_shared<DataTypeInt32>())->createColumn();
+    for (size_t i = 0; i < 1000; ++i) {
+        if (rng() % 20 == 0)
+            column->insert(Int64(rng() % 100));
+        else
+            column->insert(Null());
+    }
+    return column;
+}
+
+void assertColumnsEqual(const IColumn& expected, const IColumn& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) ASSERT_EQ(expected[i], actual[i]) << i;
+}
+
+/// Checks the operations of a sparse column against the same operations of the full column.
+void checkSparse(const ColumnPtr& full, std::mt19937_64& rng) {
+    ColumnPtr sparse = ColumnSparse::createFromFull(*full);
+    ASSERT_TRUE(sparse->isSparse());
+    ASSERT_LT(sparse->byteSize(), full->byteSize() / 4);
+    assertColumnsEqual(*full, *sparse);
+    assertColumnsEqual(*full, *sparse->convertToFullColumnIfSparse());
+
+    IColumn::Filter filter(full->size());
+    for (auto& value : filter) value = rng() % 2;
+    assertColumnsEqual(*full->filter(filter, -1), *sparse->filter(filter, -1));
+
+    IColumn::Permutation perm(full->size());
+    IColumn::Permutation32 perm32(full->size());
+    for (size_t i = 0; i < perm.size(); ++i) perm32[i] = perm[i] = i;
+    std::shuffle(perm.begin(), perm.end(), rng);
+    std::shuffle(perm32.begin(), perm32.end(), rng);
+    assertColumnsEqual(*full->permute(perm, 0), *sparse->permute(perm, 0));
+    assertColumnsEqual(*full->permute(perm32, 100), *sparse->permute(perm32, 100));
+
+    for (size_t limit : {0, 10}) {
+        for (bool reverse : {false, true}) {
+            sparse->getPermutation(reverse, limit, 1, perm32);
+            full->getPermutation(reverse, limit, 1, perm);
+            ColumnPtr sorted = full->permute(perm, limit);
+            ColumnPtr sparse_sorted = sparse->permute(perm32, limit);
+            ASSERT_TRUE(sparse_sorted->isSparse());
+            assertColumnsEqual(*sorted, *sparse_sorted);
+        }
+    }
+
+    assertColumnsEqual(*full->cut(123, 456), *sparse->cut(123, 456));
+    assertColumnsEqual(*full->cloneResized(10), *sparse->cloneResized(10));
+    assertColumnsEqual(*full->cloneResized(2000), *sparse->cloneResized(2000));
+
+    IColumn::Offsets offsets(full->size());
+    for (size_t i = 0, offset = 0; i < offsets.size(); ++i) offsets[i] = offset += rng() % 3;
+    assertColumnsEqual(*full->replicate(offsets), *sparse->replicate(offsets));
+
+    /// Insert ranges from sparse and from full columns.
+    auto full_copy = full->cloneEmpty();
+    auto sparse_copy = ColumnSparse::create(full->cloneEmpty());
+    for (size_t start = 0; start < full->size(); start += 100) {
+        full_copy->insertRangeFrom(*full, start, 100);
+        sparse_copy->insertRangeFrom(start % 200 ? *sparse : *full, start, 100);
+    }
+    full_copy->insertFrom(*full, 7);
+    sparse_copy->insertFrom(*sparse, 7);
+    full_copy->insertDefault();
+    sparse_copy->insertDefault();
+    assertColumnsEqual(*full_copy, *sparse_copy);
+    ASSERT_LT(sparse_copy->byteSize(), full_copy->byteSize() / 4);
+
+    full_copy->popBack(500);
+    sparse_copy->popBack(500);
+    assertColumnsEqual(*full_copy, *sparse_copy);
+
+    Field full_min, full_max, sparse_min, sparse_max;
+    full->getExtremes(full_min, full_max);
+    sparse->getExtremes(sparse_min, sparse_max);
+    ASSERT_EQ(full_min, sparse_min);
+    ASSERT_EQ(full_max, sparse_max);
+}
+
+size_t execute(Block& block, const std::string& name, const ColumnNumbers& arguments) {
+    ColumnsWithTypeAndName columns;
+    for (auto position : arguments) columns.push_back(block.getByPosition(position));
+    auto function = SimpleFunctionFactory::instance().get_function(name, columns);
+    block.insert({nullptr, function->getReturnType(), name});
+    function->execute(block, arguments, block.columns() - 1, block.rows());
+    return block.columns() - 1;
+}
+
+} // namespace
+
+TEST(ColumnSparseTest, int64_test) {
+    std::mt19937_64 rng(1);
+    checkSparse(makeInt64Column(rng), rng);
+}
+
+TEST(ColumnSparseTest, string_test) {
+    std::mt19937_64 rng(2);
+    checkSparse(makeStringColumn(rng), rng);
+}
+
+TEST(ColumnSparseTest, nullable_test) {
+    std::mt19937_64 rng(3);
+    checkSparse(makeNullableColumn(rng), rng);
+}
+
+TEST(ColumnSparseTest, convert_test) {
+    std::mt19937_64 rng(4);
+    ColumnPtr full = makeInt64Column(rng);
+    ASSERT_TRUE(ColumnSparse::convertToSparseIfWorthIt(full)->isSparse());
+    ASSERT_FALSE(ColumnSparse::convertToSparseIfWorthIt(full, 0.99)->isSparse());
+
+    auto dense = ColumnInt64::create(1000, 1);
+    ASSERT_EQ(ColumnSparse::convertToSparseIfWorthIt(dense->getPtr()).get(), dense.get());
+}
+
+TEST(ColumnSparseTest, function_test) {
+    std::mt19937_64 rng(5);
+    ColumnPtr full = makeInt64Column(rng);
+    ColumnPtr nullable = makeNullableColumn(rng);
+    auto int64_type = std::make_shared<DataTypeInt64>();
+    auto nullable_type = makeNullable(std::make_shared<DataTypeInt32>());
+    Block block({{ColumnSparse::createFromFull(*full), int64_type, "sparse"},
+                 {int64_type->createColumnConst(full->size(), Int64(3)), int64_type, "three"},
+                 {full, int64_type, "full"},
+                 {ColumnSparse::createFromFull(*nullable), nullable_type, "nullable"},
+                 {int64_type->createColumnConst(full->size(), Int64(0)), int64_type, "zero"}});
+
+    QueryProfile profile("query");
+    {
+        QueryProfile::Scope scope(profile);
+
+        /// The result keeps the offsets and has 0 + 3 as the common value.
+        size_t sum = execute(block, "add", {0, 1});
+        const auto& sum_column = *block.getByPosition(sum).column;
+        ASSERT_TRUE(sum_column.isSparse());
+        ASSERT_EQ(sum_column[1], Field(Int64(3)));
+        ASSERT_EQ(assert_cast<const ColumnSparse&>(sum_column).getOffsetsPtr().get(),
+                  assert_cast<const ColumnSparse&>(*block.getByPosition(0).column)
+                          .getOffsetsPtr()
+                          .get());
+        for (size_t i = 0; i < full->size(); ++i)
+            ASSERT_EQ(sum_column[i], Field(full->getInt(i) + 3));
+
+        /// Two not constant arguments need full columns.
+        size_t diff = execute(block, "subtract", {0, 2});
+        ASSERT_FALSE(block.getByPosition(diff).column->isSparse());
+        for (size_t i = 0; i < full->size(); ++i)
+            ASSERT_EQ((*block.getByPosition(diff).column)[i], Field(Int64(0)));
+
+        /// The listed rows of the result equal the common value, so the result is full.
+        size_t product = execute(block, "multiply", {0, 4});
+        ASSERT_FALSE(block.getByPosition(product).column->isSparse());
+        for (size_t i = 0; i < full->size(); ++i)
+            ASSERT_EQ((*block.getByPosition(product).column)[i], Field(Int64(0)));
+
+        size_t nullable_sum = execute(block, "add", {3, 1});
+        const auto& nullable_sum_column = *block.getByPosition(nullable_sum).column;
+        ASSERT_TRUE(nullable_sum_column.isSparse());
+        for (size_t i = 0; i < nullable->size(); ++i) {
+            if (nullable->isNullAt(i))
+                ASSERT_TRUE(nullable_sum_column.isNullAt(i));
+            else
+                ASSERT_EQ(nullable_sum_column[i], Field(Int64(nullable->get64(i)) + 3));
+        }
+    }
+
+    auto snapshot = profile.snapshot();
+    ASSERT_EQ(snapshot.children.size(), 3);
+    for (const auto& function : snapshot.children) {
+        if (function.name == "add")
+            ASSERT_EQ(function.sparse_default_rows, 2000);
+        else if (function.name == "multiply")
+            ASSERT_EQ(function.sparse_default_rows, 1000);
+        else
+            ASSERT_EQ(function.sparse_default_rows, 0);
+    }
+}
+
+TEST(ColumnSparseTest, aggregate_test) {
+    std::mt19937_64 rng(6);
+    ColumnPtr full = makeInt64Column(rng);
+    auto int64_type = std::make_shared<DataTypeInt64>();
+    auto sum = AggregateFunctionSimpleFactory::instance().get("sum", {int64_type}, {});
+    PartialAggregateTransform aggregate({sum}, {{0}}, 1);
+    Block block({{ColumnSparse::createFromFull(*full), int64_type, "sparse"}});
+    aggregate.transform(block, 0);
+
+    Int64 expected = 0;
+    for (size_t i = 0; i < full->size(); ++i) expected += full->getInt(i);
+    ASSERT_EQ(aggregate.finalize().getByPosition(0).column->getInt(0), expected);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,279 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/formats/key_condition.h"
+#include "vec/formats/segment_reader.h"
+#include "vec/formats/segment_writer.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// (t Int64, x Nullable(Int32), f Float64)
+Block makeHeader() {
+    auto x_type = makeNullable(std::make_shared<DataTypeInt32>());
+    return Block({{ColumnVector<Int64>::create(), std::make_shared<DataTypeInt64>(), "t"},
+                  {x_type->createColumn(), x_type, "x"},
+                  {ColumnVector<Float64>::create(), std::make_shared<DataTypeFloat64>(), "f"}});
+}
+
+KeyCondition::ColumnRange columnRange(const Field& min, const Field& max, bool has_nulls = false) {
+    KeyCondition::ColumnRange range;
+    range.range = FieldRange(min, true, max, true);
+    range.has_nulls = has_nulls;
+    return range;
+}
+
+KeyCondition::ColumnRange allNulls() {
+    KeyCondition::ColumnRange range;
+    range.has_nulls = true;
+    range.has_values = false;
+    return range;
+}
+
+} // namespace
+
+TEST(KeyConditionTest, range_test) {
+    FieldRange closed(Int64(10), true, Int64(20), true);
+    ASSERT_TRUE(closed.contains(UInt64(10)));
+    ASSERT_TRUE(closed.contains(Float64(19.5)));
+    ASSERT_FALSE(closed.contains(Int64(21)));
+
+    ASSERT_TRUE(closed.intersectsRange(FieldRange::createRightBounded(Int64(10), true)));
+    ASSERT_FALSE(closed.intersectsRange(FieldRange::createRightBounded(Int64(10), false)));
+    ASSERT_FALSE(closed.intersectsRange(FieldRange::createLeftBounded(UInt64(20), false)));
+    ASSERT_TRUE(closed.intersectsRange(FieldRange()));
+
+    ASSERT_TRUE(FieldRange::createLeftBounded(Int64(10), true).containsRange(closed));
+    ASSERT_FALSE(FieldRange::createLeftBounded(Int64(10), false).containsRange(closed));
+    ASSERT_TRUE(closed.containsRange(FieldRange(Int64(15))));
+    ASSERT_FALSE(closed.containsRange(FieldRange()));
+
+    FieldRange swapped = closed;
+    swapped.swapLeftAndRight();
+    ASSERT_EQ(swapped.left, Field(Int64(20)));
+    ASSERT_EQ(swapped.right, Field(Int64(10)));
+}
+
+TEST(KeyConditionTest, atoms_test) {
+    Block header = makeHeader();
+    std::vector<KeyCondition::ColumnRange> ranges {columnRange(Int64(100), Int64(199)),
+                                                   columnRange(Int64(-5), Int64(5), true),
+                                                   columnRange(Float64(1.5), Float64(3.5))};
+
+    auto check = [&](auto&& build) {
+        KeyCondition condition(header);
+        build(condition);
+        return condition.checkInRanges(ranges);
+    };
+
+    auto mask = check([](KeyCondition& c) { c.addComparison("lt", "t", Int64(100)); });
+    ASSERT_FALSE(mask.can_be_true);
+    ASSERT_TRUE(mask.can_be_false);
+
+    mask = check([](KeyCondition& c) { c.addComparison("ge", "t", UInt64(100)); });
+    ASSERT_TRUE(mask.can_be_true);
+    ASSERT_FALSE(mask.can_be_false);
+
+    mask = check([](KeyCondition& c) { c.addComparison("gt", "t", Int64(150)); });
+    ASSERT_TRUE(mask.can_be_true);
+    ASSERT_TRUE(mask.can_be_false);
+
+    mask = check([](KeyCondition& c) { c.addComparison("eq", "t", Int64(200)); });
+    ASSERT_FALSE(mask.can_be_true);
+
+    mask = check([](KeyCondition& c) { c.addComparison("le", "f", Float64(1.5)); });
+    ASSERT_TRUE(mask.can_be_true);
+
+    mask = check([](KeyCondition& c) { c.addIn("t", {Int64(50), Int64(250), Null()}); });
+    ASSERT_FALSE(mask.can_be_true);
+    mask = check([](KeyCondition& c) { c.addIn("t", {Int64(250), Int64(150)}); });
+    ASSERT_TRUE(mask.can_be_true);
+    ASSERT_TRUE(mask.can_be_false);
+
+    /// Nulls: the values match, but the null rows do not.
+    mask = check([](KeyCondition& c) { c.addComparison("le", "x", Int64(5)); });
+    ASSERT_TRUE(mask.can_be_true);
+    ASSERT_TRUE(mask.can_be_false);
+
+    ranges[1] = allNulls();
+    mask = check([](KeyCondition& c) { c.addComparison("le", "x", Int64(5)); });
+    ASSERT_FALSE(mask.can_be_true);
+    mask = check([](KeyCondition& c) {
+        c.addComparison("le", "x", Int64(5));
+        c.addNot();
+    });
+    ASSERT_TRUE(mask.can_be_true);
+
+    ranges[0] = columnRange(Int64(100), Int64(100));
+    mask = check([](KeyCondition& c) { c.addComparison("ne", "t", Int64(100)); });
+    ASSERT_FALSE(mask.can_be_true);
+    ASSERT_TRUE(mask.can_be_false);
+    mask = check([](KeyCondition& c) { c.addIn("t", {Int64(100)}); });
+    ASSERT_FALSE(mask.can_be_false);
+
+    ASSERT_THROW(check([](KeyCondition& c) { c.addComparison("like", "t", Int64(1)); }),
+                 Exception);
+    ASSERT_THROW(check([](KeyCondition& c) { c.addComparison("lt", "y", Int64(1)); }),
+                 Exception);
+}
+
+TEST(KeyConditionTest, logical_test) {
+    Block header = makeHeader();
+    std::vector<KeyCondition::ColumnRange> ranges {columnRange(Int64(100), Int64(199)),
+                                                   columnRange(Int64(0), Int64(0)),
+                                                   columnRange(Float64(0), Float64(1))};
+
+    /// t >= 150 AND NOT t < 300: false everywhere here.
+    KeyCondition a(header);
+    a.addComparison("ge", "t", Int64(150));
+    a.addComparison("lt", "t", Int64(300));
+    a.addNot();
+    a.addAnd();
+    ASSERT_FALSE(a.checkInRanges(ranges).can_be_true);
+
+    /// unknown AND t < 100: false everywhere here.
+    KeyCondition b(header);
+    b.addUnknown();
+    b.addComparison("lt", "t", Int64(100));
+    b.addAnd();
+    ASSERT_FALSE(b.checkInRanges(ranges).can_be_true);
+    ASSERT_FALSE(b.alwaysUnknownOrTrue());
+
+    /// unknown OR t < 100: anything.
+    KeyCondition c(header);
+    c.addUnknown();
+    c.addComparison("lt", "t", Int64(100));
+    c.addOr();
+    ASSERT_TRUE(c.checkInRanges(ranges).can_be_true);
+    ASSERT_TRUE(c.alwaysUnknownOrTrue());
+    ASSERT_EQ(c.getUsedColumns(), std::vector<size_t> {0});
+
+    /// t < 100 OR x = 0: true everywhere here.
+    KeyCondition d(header);
+    d.addComparison("lt", "t", Int64(100));
+    d.addComparison("eq", "x", Int64(0));
+    d.addOr();
+    auto mask = d.checkInRanges(ranges);
+    ASSERT_TRUE(mask.can_be_true);
+    ASSERT_FALSE(mask.can_be_false);
+    ASSERT_EQ(d.getUsedColumns(), (std::vector<size_t> {0, 1}));
+
+    KeyCondition empty(header);
+    ASSERT_TRUE(empty.checkInRanges(ranges).can_be_true);
+    ASSERT_TRUE(empty.alwaysUnknownOrTrue());
+
+    KeyCondition invalid(header);
+    invalid.addComparison("lt", "t", Int64(100));
+    invalid.addAnd();
+    ASSERT_THROW(invalid.checkInRanges(ranges), Exception);
+}
+
+TEST(KeyConditionTest, monotonic_chain_test) {
+    Block header = makeHeader();
+    auto f_type = header.getByName("f").type;
+    std::vector<KeyCondition::ColumnRange> ranges {columnRange(Int64(0), Int64(0)),
+                                                   columnRange(Int64(0), Int64(0)),
+                                                   columnRange(Float64(1.5), Float64(3.5))};
+
+    /// CAST(f AS Int8) is in [1, 3] here.
+    KeyCondition in_range(header);
+    in_range.addComparison("eq", "f", Int64(10), {KeyCondition::makeCast(f_type, "Int8")});
+    ASSERT_FALSE(in_range.checkInRanges(ranges).can_be_true);
+
+    KeyCondition ge(header);
+    ge.addComparison("ge", "f", Int64(1), {KeyCondition::makeCast(f_type, "Int8")});
+    ASSERT_FALSE(ge.checkInRanges(ranges).can_be_false);
+
+    /// Outside of the range of Int8 the cast is not monotonic, nothing is known.
+    ranges[2] = columnRange(Float64(100), Float64(300));
+    auto mask = in_range.checkInRanges(ranges);
+    ASSERT_TRUE(mask.can_be_true);
+    ASSERT_TRUE(mask.can_be_false);
+
+    /// The chain must start from the type of the column.
+    KeyCondition wrong(header);
+    ASSERT_THROW(wrong.addComparison("eq", "t", Int64(1), {KeyCondition::makeCast(f_type, "Int8")}),
+                 Exception);
+}
+
+TEST(KeyConditionTest, segment_granules_test) {
+    auto path = "/tmp/key_condition_test_" + std::to_string(getpid());
+    Block header = makeHeader();
+    {
+        /// Time-sorted data: t = 1000 + row, x is null in the first 1000 rows.
+        SegmentWriter writer(path, header, {100, 8});
+        Block block = header.cloneEmpty();
+        auto columns = block.mutateColumns();
+        for (size_t row = 0; row < 10000; ++row) {
+            columns[0]->insert(Int64(1000 + row));
+            if (row < 1000)
+                columns[1]->insert(Null());
+            else
+                columns[1]->insert(Int64(row % 7));
+            columns[2]->insert(Float64(row));
+        }
+        block.setColumns(std::move(columns));
+        writer.write(block);
+        writer.finish();
+    }
+
+    SegmentReader reader(path);
+    ASSERT_EQ(reader.getNumberOfGranules(), 100);
+
+    KeyCondition time_range(reader.getHeader());
+    time_range.addComparison("ge", "t", Int64(3000));
+    time_range.addComparison("lt", "t", Int64(3550));
+    time_range.addAnd();
+    auto granules = reader.selectGranules(time_range);
+    ASSERT_EQ(granules, (SegmentReader::GranuleRanges {{20, 6}}));
+
+    Block block = reader.readGranules({"t"}, granules[0].first, granules[0].second);
+    ASSERT_EQ(block.getByPosition(0).column->getInt(0), 3000);
+    ASSERT_EQ(block.rows(), 600);
+
+    /// Two disjoint ranges and a condition on the nullable column.
+    KeyCondition two_ranges(reader.getHeader());
+    two_ranges.addComparison("lt", "t", Int64(1150));
+    two_ranges.addComparison("ge", "t", Int64(10950));
+    two_ranges.addOr();
+    ASSERT_EQ(reader.selectGranules(two_ranges),
+              (SegmentReader::GranuleRanges {{0, 2}, {99, 1}}));
+
+    KeyCondition not_null(reader.getHeader());
+    not_null.addComparison("ge", "x", Int64(0));
+    ASSERT_EQ(reader.selectGranules(not_null), (SegmentReader::GranuleRanges {{10, 90}}));
+
+    KeyCondition unknown(reader.getHeader());
+    unknown.addUnknown();
+    ASSERT_EQ(reader.selectGranules(unknown), (SegmentReader::GranuleRanges {{0, 100}}));
+
+    unlink(path.c_str());
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
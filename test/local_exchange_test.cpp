@@ -0,0 +1,248 @@
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/block_queue.h"
+#include "vec/exec/local_exchange.h"
+#include "vec/exec/pipeline_executor.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// A block of (key Int64, value Int64) with keys [first, first + rows) modulo num_keys.
+Block makeBlock(size_t first, size_t rows, size_t num_keys = 1000) {
+    auto key = ColumnVector<Int64>::create();
+    auto value = ColumnVector<Int64>::create();
+    for (size_t i = first; i < first + rows; ++i) {
+        key->getData().push_back(i % num_keys);
+        value->getData().push_back(i);
+    }
+    return Block({{std::move(key), std::make_shared<DataTypeInt64>(), "key"},
+                  {std::move(value), std::make_shared<DataTypeInt64>(), "value"}});
+}
+
+Int64 getValue(const Block& block, size_t column, size_t row) {
+    return block.getByPosition(column).column->getInt(row);
+}
+
+} // namespace
+
+TEST(BlockQueueTest, order_test) {
+    BlockQueue queue(4, 1 << 20);
+    for (size_t i = 0; i < 4; ++i) {
+        Block block = makeBlock(i, 1);
+        ASSERT_TRUE(queue.tryPush(block));
+        ASSERT_FALSE(block);
+    }
+    ASSERT_EQ(queue.size(), 4);
+
+    Block block = makeBlock(4, 1);
+    ASSERT_FALSE(queue.tryPush(block));
+    ASSERT_TRUE(block);
+
+    for (size_t i = 0; i < 4; ++i) {
+        Block res;
+        ASSERT_TRUE(queue.tryPop(res));
+        ASSERT_EQ(getValue(res, 1, 0), Int64(i));
+    }
+    Block res;
+    ASSERT_FALSE(queue.tryPop(res));
+    ASSERT_EQ(queue.bytes(), 0);
+}
+
+TEST(BlockQueueTest, bytes_limit_test) {
+    Block small = makeBlock(0, 10);
+    size_t block_bytes = small.bytes();
+    BlockQueue queue(16, block_bytes * 2);
+
+    for (size_t i = 0; i < 2; ++i) {
+        Block block = makeBlock(0, 10);
+        ASSERT_TRUE(queue.tryPush(block));
+    }
+    ASSERT_EQ(queue.bytes(), block_bytes * 2);
+    ASSERT_FALSE(queue.tryPush(small));
+
+    Block res;
+    ASSERT_TRUE(queue.tryPop(res));
+    ASSERT_TRUE(queue.tryPush(small));
+
+    /// A block larger than the limit gets into the empty queue only.
+    Block big = makeBlock(0, 1000);
+    ASSERT_FALSE(queue.tryPush(big));
+    while (queue.tryPop(res)) {
+    }
+    ASSERT_TRUE(queue.tryPush(big));
+    ASSERT_EQ(queue.size(), 1);
+}
+
+TEST(BlockQueueTest, finish_test) {
+    BlockQueue queue(2, 1 << 20);
+    ASSERT_TRUE(queue.push(makeBlock(0, 1)));
+    ASSERT_TRUE(queue.push(makeBlock(1, 1)));
+
+    /// The producer waits for room until the consumer finishes the queue.
+    std::thread producer([&] { ASSERT_FALSE(queue.push(makeBlock(2, 1))); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    queue.finish();
+    producer.join();
+
+    Block res;
+    ASSERT_TRUE(queue.pop(res));
+    ASSERT_TRUE(queue.pop(res));
+    ASSERT_FALSE(queue.pop(res));
+}
+
+TEST(BlockQueueTest, mpmc_test) {
+    constexpr size_t num_producers = 4;
+    constexpr size_t num_consumers = 4;
+    constexpr size_t blocks_per_producer = 2000;
+
+    BlockQueue queue(8, 1 << 20);
+    std::atomic<size_t> active_producers{num_producers};
+    std::atomic<Int64> sum{0};
+    std::atomic<size_t> popped{0};
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_producers; ++i) {
+        threads.emplace_back([&, i] {
+            for (size_t j = 0; j < blocks_per_producer; ++j)
+                ASSERT_TRUE(queue.push(makeBlock(i * blocks_per_producer + j, 1)));
+            if (active_producers.fetch_sub(1) == 1) queue.finish();
+        });
+    }
+    for (size_t i = 0; i < num_consumers; ++i) {
+        threads.emplace_back([&] {
+            Block block;
+            while (queue.pop(block)) {
+                sum += getValue(block, 1, 0);
+                ++popped;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    constexpr size_t total = num_producers * blocks_per_producer;
+    ASSERT_EQ(popped.load(), total);
+    ASSERT_EQ(sum.load(), Int64(total * (total - 1) / 2));
+    ASSERT_EQ(queue.bytes(), 0);
+}
+
+TEST(LocalExchangeTest, partition_test) {
+    constexpr size_t num_producers = 3;
+    constexpr size_t num_consumers = 4;
+    constexpr size_t blocks_per_producer = 50;
+    constexpr size_t rows = 1000;
+
+    LocalExchangeSettings settings;
+    settings.max_blocks_per_consumer = 2;
+    settings.batch_rows = 700;
+    LocalExchange exchange(num_producers, num_consumers, {0}, settings);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_producers; ++i) {
+        threads.emplace_back([&, i] {
+            auto& producer = exchange.getProducer(i);
+            for (size_t j = 0; j < blocks_per_producer; ++j)
+                producer.push(makeBlock((i * blocks_per_producer + j) * rows, rows, 997));
+            producer.finish();
+        });
+    }
+
+    std::vector<std::set<Int64>> keys(num_consumers);
+    std::vector<std::set<Int64>> values(num_consumers);
+    std::vector<size_t> small_blocks(num_consumers);
+    for (size_t i = 0; i < num_consumers; ++i) {
+        threads.emplace_back([&, i] {
+            Block block;
+            while (exchange.pop(i, block)) {
+                if (block.rows() < settings.batch_rows) ++small_blocks[i];
+                for (size_t row = 0; row < block.rows(); ++row) {
+                    keys[i].insert(getValue(block, 0, row));
+                    values[i].insert(getValue(block, 1, row));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    /// Every key goes to one consumer, every row is delivered once.
+    std::map<Int64, size_t> consumer_of_key;
+    size_t total_rows = 0;
+    for (size_t i = 0; i < num_consumers; ++i) {
+        ASSERT_FALSE(keys[i].empty());
+        for (auto key : keys[i]) ASSERT_TRUE(consumer_of_key.emplace(key, i).second);
+        total_rows += values[i].size();
+        /// Only the flush of each producer at the end may be smaller than a batch.
+        ASSERT_LE(small_blocks[i], num_producers);
+    }
+    ASSERT_EQ(consumer_of_key.size(), 997);
+    ASSERT_EQ(total_rows, num_producers * blocks_per_producer * rows);
+}
+
+TEST(LocalExchangeTest, round_robin_test) {
+    LocalExchangeSettings settings;
+    settings.batch_rows = 0;
+    LocalExchange exchange(1, 2, {}, settings);
+
+    auto& producer = exchange.getProducer(0);
+    for (size_t i = 0; i < 4; ++i) producer.push(makeBlock(i * 10, 10));
+    producer.finish();
+
+    for (size_t i = 0; i < 2; ++i) {
+        Block block;
+        ASSERT_TRUE(exchange.pop(i, block));
+        ASSERT_EQ(getValue(block, 1, 0), Int64(i * 10));
+        ASSERT_TRUE(exchange.pop(i, block));
+        ASSERT_EQ(getValue(block, 1, 0), Int64((i + 2) * 10));
+        ASSERT_FALSE(exchange.pop(i, block));
+    }
+}
+
+TEST(LocalExchangeTest, pipeline_sink_test) {
+    constexpr size_t num_threads = 4;
+    constexpr size_t blocks = 20;
+    constexpr size_t rows = 5000;
+
+    WorkStealingThreadPool pool(num_threads);
+    LocalExchange exchange(num_threads, 2, {0});
+    auto sink = std::make_shared<ExchangeSinkTransform>(exchange);
+
+    /// Consumers run outside of the pool: the sink waits for them when the queues are full.
+    std::atomic<size_t> consumed_rows{0};
+    std::vector<std::thread> consumers;
+    for (size_t i = 0; i < exchange.getNumberOfConsumers(); ++i) {
+        consumers.emplace_back([&, i] {
+            Block block;
+            while (exchange.pop(i, block)) consumed_rows += block.rows();
+        });
+    }
+
+    auto next = std::make_shared<size_t>(0);
+    PipelineExecutor executor(
+            pool,
+            [=]() -> Block {
+                if (*next == blocks) return {};
+                return makeBlock(rows * (*next)++, rows);
+            },
+            {sink});
+    executor.execute();
+    sink->finish();
+    for (auto& consumer : consumers) consumer.join();
+
+    ASSERT_EQ(consumed_rows.load(), blocks * rows);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
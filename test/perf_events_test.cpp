@@ -0,0 +1,76 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/perf_events.h"
+#include "vec/common/query_profile.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+UInt64 work() {
+    auto column = ColumnVector<UInt64>::create();
+    for (size_t i = 0; i < 100000; ++i) column->insert(castToNearestFieldType(UInt64(i)));
+    UInt64 sum = 0;
+    for (auto value : column->getData()) sum += value * value;
+    return sum;
+}
+
+} // namespace
+
+TEST(PerfEventsTest, read_test) {
+    auto& perf_events = PerfEvents::threadInstance();
+    auto before = perf_events.read();
+    ASSERT_NE(work(), 0);
+    auto after = perf_events.read();
+
+    if (!perf_events.isAvailable()) {
+        std::cout << "perf events are not available, values are zero" << std::endl;
+        ASSERT_EQ(before.cycles, 0);
+        ASSERT_EQ(after.cycles, 0);
+        ASSERT_EQ(after.instructions, 0);
+        return;
+    }
+    ASSERT_GT(after.cycles, before.cycles);
+}
+
+TEST(PerfEventsTest, profile_test) {
+    QueryProfile profile("query");
+    {
+        QueryProfile::Scope scope(profile);
+        ProfileNodeHandle node;
+        QueryProfile::OperatorScope operator_scope(node, "Work", 0);
+        PerfEventsScope perf_events_scope;
+        {
+            /// Nested scope of the same operator must not count twice.
+            PerfEventsScope nested_scope;
+            ASSERT_NE(work(), 0);
+        }
+    }
+
+    auto snapshot = profile.snapshot();
+    std::cout << snapshot.toString();
+    ASSERT_EQ(snapshot.children.size(), 1);
+    const auto& node = snapshot.children[0];
+    if (!PerfEvents::threadInstance().isAvailable()) {
+        ASSERT_EQ(node.cycles, 0);
+        ASSERT_EQ(node.instructions, 0);
+        return;
+    }
+    ASSERT_GT(node.cycles, 0);
+    ASSERT_GT(node.instructions, 0);
+}
+
+TEST(PerfEventsTest, disabled_test) {
+    ASSERT_EQ(QueryProfile::current(), nullptr);
+    PerfEventsScope perf_events_scope;
+    ASSERT_NE(work(), 0);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+/// Checks that the 32-bit and the 64-bit permutations sort the column in the same way.
+void checkPermutations(const IColumn& column) {
+    for (bool reverse : {false, true}) {
+        for (int hint : {-1, 1}) {
+            for (size_t limit : {size_t(0), size_t(1), size_t(10), column.size()}) {
+                IColumn::Permutation perm;
+                IColumn::Permutation32 perm32;
+                column.getPermutation(reverse, limit, hint, perm);
+                column.getPermutation(reverse, limit, hint, perm32);
+                ASSERT_EQ(perm.size(), column.size());
+                ASSERT_EQ(perm32.size(), column.size());
+
+                ColumnPtr sorted = column.permute(perm, limit);
+                ColumnPtr sorted32 = column.permute(perm32, limit);
+                size_t rows = limit ? std::min(limit, column.size()) : column.size();
+                ASSERT_EQ(sorted->size(), rows);
+                ASSERT_EQ(sorted32->size(), rows);
+                for (size_t i = 0; i < rows; ++i) {
+                    ASSERT_EQ(sorted->compareAt(i, i, *sorted32, hint), 0);
+                    if (i > 0) {
+                        int cmp = sorted32->compareAt(i - 1, i, *sorted32, hint);
+                        ASSERT_TRUE(reverse ? cmp >= 0 : cmp <= 0);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(PermutationTest, vector_test) {
+    std::mt19937_64 rng(1);
+    /// Small columns are sorted with comparisons, large ones with radix sort.
+    for (size_t size : {0, 1, 100, 5000}) {
+        auto i64 = ColumnInt64::create();
+        auto u8 = ColumnUInt8::create();
+        auto f64 = ColumnFloat64::create();
+        for (size_t i = 0; i < size; ++i) {
+            i64->insertValue(Int64(rng()));
+            u8->insertValue(UInt8(rng()));
+            f64->insertValue(rng() % 10 == 0 ? std::nan("") : Float64(Int64(rng())) / 3);
+        }
+        checkPermutations(*i64);
+        checkPermutations(*u8);
+        checkPermutations(*f64);
+    }
+}
+
+TEST(PermutationTest, decimal_test) {
+    std::mt19937_64 rng(2);
+    auto column = ColumnDecimal<Decimal64>::create(0, 4);
+    for (size_t i = 0; i < 1000; ++i) column->getData().push_back(Int64(rng() % 100000));
+    checkPermutations(*column);
+    ASSERT_EQ(column->permute(IColumn::Permutation32{2, 0}, 2)->getName(), column->getName());
+}
+
+TEST(PermutationTest, string_test) {
+    std::mt19937_64 rng(3);
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string str;
+        for (size_t j = rng() % 20; j > 0; --j) str += char('a' + rng() % 3);
+        column->insertData(str.data(), str.size());
+    }
+    checkPermutations(*column);
+}
+
+TEST(PermutationTest, nullable_test) {
+    std::mt19937_64 rng(4);
+    auto type = makeNullable(std::make_shared<DataTypeInt32>());
+    auto column = type->createColumn();
+    for (size_t i = 0; i < 1000; ++i) {
+        if (rng() % 4 == 0)
+            column->insert(Null());
+        else
+            column->insert(Int64(rng() % 100));
+    }
+    checkPermutations(*column);
+}
+
+TEST(PermutationTest, const_test) {
+    auto column = ColumnConst::create(ColumnInt32::create(1, 7), 100);
+    checkPermutations(*column);
+
+    IColumn::Permutation32 perm(10);
+    ASSERT_THROW(column->permute(perm, 20), Exception);
+    ASSERT_EQ(column->permute(perm, 10)->size(), 10);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
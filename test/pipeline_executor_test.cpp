@@ -0,0 +1,232 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/query_trace.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/exec/pipeline_executor.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int LOGICAL_ERROR;
+}
+
+namespace {
+
+/// Blocks of (x Int64, x % 3 == 0 UInt8) for x in [0, blocks * rows).
+PipelineExecutor::Source makeSource(size_t blocks, size_t rows,
+                                    std::atomic<size_t>* pulled = nullptr) {
+    auto next = std::make_shared<size_t>(0);
+    return [=]() -> Block {
+        if (*next == blocks) return {};
+        auto x = ColumnVector<Int64>::create();
+        auto flag = ColumnVector<UInt8>::create();
+        for (size_t i = 0; i < rows; ++i) {
+            Int64 value = *next * rows + i;
+            x->getData().push_back(value);
+            flag->getData().push_back(value % 3 == 0);
+        }
+        ++*next;
+        if (pulled) ++*pulled;
+        return Block({{std::move(x), std::make_shared<DataTypeInt64>(), "x"},
+                      {std::move(flag), std::make_shared<DataTypeUInt8>(), "flag"}});
+    };
+}
+
+/// Calls the function for every morsel.
+class CallbackTransform : public IBlockTransform {
+public:
+    explicit CallbackTransform(std::function<void(Block&)> callback_)
+            : callback(std::move(callback_)) {}
+    String getName() const override { return "Callback"; }
+    void transform(Block& block, size_t) override { callback(block); }
+
+private:
+    std::function<void(Block&)> callback;
+};
+
+} // namespace
+
+TEST(WorkStealingThreadPoolTest, schedule_test) {
+    std::atomic<size_t> counter{0};
+    {
+        WorkStealingThreadPool pool(4);
+        ASSERT_EQ(pool.getNumberOfThreads(), 4);
+        ASSERT_FALSE(pool.getCurrentWorker().has_value());
+        for (size_t i = 0; i < 10000; ++i) pool.schedule([&] { ++counter; });
+    }
+    ASSERT_EQ(counter, 10000);
+}
+
+TEST(WorkStealingThreadPoolTest, nested_schedule_test) {
+    std::atomic<size_t> counter{0};
+    std::atomic<size_t> not_in_worker{0};
+    {
+        /// Outlives the jobs, which are finished by the destructor of the pool.
+        std::function<void(size_t)> fan_out;
+        WorkStealingThreadPool pool(4);
+        fan_out = [&](size_t depth) {
+            ++counter;
+            if (!pool.getCurrentWorker() || *pool.getCurrentWorker() >= 4) ++not_in_worker;
+            if (depth == 0) return;
+            /// From a worker: to its own deque, others steal.
+            for (size_t i = 0; i < 4; ++i) pool.schedule([&, depth] { fan_out(depth - 1); });
+        };
+        pool.schedule([&] { fan_out(5); }, 0);
+    }
+    /// 1 + 4 + 16 + 64 + 256 + 1024
+    ASSERT_EQ(counter, 1365);
+    ASSERT_EQ(not_in_worker, 0);
+}
+
+TEST(PipelineExecutorTest, aggregate_test) {
+    WorkStealingThreadPool pool(4);
+    auto int64 = std::make_shared<DataTypeInt64>();
+    auto add = SimpleFunctionFactory::instance().get_function(
+            "add", {{nullptr, int64, "x"}, {nullptr, int64, "x"}});
+    auto sum = AggregateFunctionSimpleFactory::instance().get("sum", {add->getReturnType()}, {});
+    auto count = AggregateFunctionSimpleFactory::instance().get("count", {}, {});
+    auto aggregate = std::make_shared<PartialAggregateTransform>(
+            std::vector<AggregateFunctionPtr> {sum, count}, std::vector<ColumnNumbers> {{1}, {}},
+            pool.getNumberOfThreads());
+
+    PipelineSettings settings;
+    settings.morsel_rows = 1000;
+    PipelineExecutor executor(pool, makeSource(10, 9000),
+                              {std::make_shared<FilterTransform>(1, 1),
+                               std::make_shared<ExpressionTransform>(add, ColumnNumbers {0, 0}),
+                               aggregate},
+                              settings);
+    executor.execute();
+    ASSERT_EQ(executor.getProcessedRows(), 90000);
+
+    Int64 expected_sum = 0;
+    UInt64 expected_count = 0;
+    for (Int64 x = 0; x < 90000; x += 3) {
+        expected_sum += 2 * x;
+        ++expected_count;
+    }
+    Block result = aggregate->finalize();
+    ASSERT_EQ(result.rows(), 1);
+    ASSERT_EQ(result.getByPosition(0).column->getInt(0), expected_sum);
+    ASSERT_EQ(result.getByPosition(1).column->get64(0), expected_count);
+}
+
+TEST(PipelineExecutorTest, backpressure_test) {
+    WorkStealingThreadPool pool(4);
+    std::atomic<size_t> pulled{0};
+    std::atomic<size_t> done{0};
+    std::atomic<size_t> max_in_flight{0};
+
+    PipelineSettings settings;
+    settings.morsel_rows = 100;
+    settings.max_morsels_in_flight = 3;
+    auto source = makeSource(50, 100, &pulled);
+    PipelineExecutor executor(
+            pool,
+            [&] {
+                auto block = source();
+                size_t in_flight = pulled - done;
+                size_t prev = max_in_flight.load();
+                while (in_flight > prev && !max_in_flight.compare_exchange_weak(prev, in_flight))
+                    ;
+                return block;
+            },
+            {std::make_shared<CallbackTransform>([&](Block&) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                ++done;
+            })},
+            settings);
+    executor.execute();
+    ASSERT_EQ(done, 50);
+    ASSERT_LE(max_in_flight, 3);
+}
+
+TEST(PipelineExecutorTest, cancel_test) {
+    WorkStealingThreadPool pool(2);
+    std::atomic<size_t> morsels{0};
+    PipelineSettings settings;
+    settings.morsel_rows = 100;
+    std::unique_ptr<PipelineExecutor> executor;
+    auto cancel_at_fifth = std::make_shared<CallbackTransform>([&](Block&) {
+        if (++morsels == 5) executor->cancel();
+    });
+    executor = std::make_unique<PipelineExecutor>(pool, makeSource(100, 100),
+                                                  BlockTransforms {cancel_at_fifth}, settings);
+    executor->execute();
+    ASSERT_TRUE(executor->isCancelled());
+    ASSERT_LT(executor->getProcessedRows(), 100 * 100);
+}
+
+TEST(PipelineExecutorTest, exception_test) {
+    WorkStealingThreadPool pool(2);
+    std::atomic<size_t> morsels{0};
+    PipelineExecutor executor(pool, makeSource(100, 100),
+                              {std::make_shared<CallbackTransform>([&](Block&) {
+                                  if (++morsels == 10)
+                                      throw Exception("Test", ErrorCodes::LOGICAL_ERROR);
+                              })});
+    ASSERT_THROW(executor.execute(), Exception);
+    ASSERT_TRUE(executor.isCancelled());
+}
+
+TEST(PipelineExecutorTest, profile_test) {
+    WorkStealingThreadPool pool(4);
+    auto int64 = std::make_shared<DataTypeInt64>();
+    auto add = SimpleFunctionFactory::instance().get_function(
+            "add", {{nullptr, int64, "x"}, {nullptr, int64, "x"}});
+    PipelineSettings settings;
+    settings.morsel_rows = 1000;
+
+    QueryProfile profile("query");
+    QueryTrace trace("query");
+    {
+        QueryProfile::Scope profile_scope(profile);
+        QueryTrace::Scope trace_scope(trace);
+        PipelineExecutor executor(
+                pool, makeSource(10, 9000),
+                {std::make_shared<ExpressionTransform>(add, ColumnNumbers {0, 0})}, settings);
+        executor.execute();
+    }
+    ASSERT_EQ(QueryProfile::current(), nullptr);
+    ASSERT_EQ(QueryTrace::current(), nullptr);
+
+    /// Morsels are processed only in the pool, so everything here comes from its threads.
+    auto snapshot = profile.snapshot();
+    ASSERT_EQ(snapshot.children.size(), 1);
+    ASSERT_EQ(snapshot.children[0].name, "add");
+    ASSERT_EQ(snapshot.children[0].calls, 90);
+    ASSERT_EQ(snapshot.children[0].rows_in, 90000);
+    ASSERT_NE(trace.toChromeTrace().find("PipelineExecutor::processMorsel"), std::string::npos);
+}
+
+TEST(PipelineExecutorTest, const_argument_test) {
+    auto int64 = std::make_shared<DataTypeInt64>();
+    auto sum = AggregateFunctionSimpleFactory::instance().get("sum", {int64}, {});
+    PartialAggregateTransform aggregate({sum}, {{0}}, 1);
+    Block block({{int64->createColumnConst(100, Int64(3)), int64, "x"}});
+    aggregate.transform(block, 0);
+    ASSERT_EQ(aggregate.finalize().getByPosition(0).column->getInt(0), 300);
+}
+
+TEST(PipelineExecutorTest, empty_source_test) {
+    WorkStealingThreadPool pool(2);
+    PipelineExecutor executor(pool, makeSource(0, 100), {});
+    executor.execute();
+    ASSERT_EQ(executor.getProcessedRows(), 0);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
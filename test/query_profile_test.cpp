@@ -0,0 +1,127 @@
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/query_profile.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+Block makeBlock(size_t rows) {
+    auto a = ColumnVector<Int32>::create();
+    auto b = ColumnVector<Int32>::create();
+    auto null_map = ColumnUInt8::create();
+    for (size_t i = 0; i < rows; ++i) {
+        a->insert(castToNearestFieldType(Int32(i)));
+        b->insert(castToNearestFieldType(Int32(i * 2)));
+        null_map->insert(castToNearestFieldType(UInt8(i % 2)));
+    }
+    DataTypePtr int32(std::make_shared<DataTypeInt32>());
+    return Block({{std::move(a), int32, "a"},
+                  {ColumnNullable::create(std::move(b), std::move(null_map)), makeNullable(int32),
+                   "b"},
+                  {int32->createColumnConst(rows, Int64(-5)), int32, "c"}});
+}
+
+size_t execute(Block& block, const std::string& name, const ColumnNumbers& arguments) {
+    ColumnsWithTypeAndName columns;
+    for (auto position : arguments) columns.push_back(block.getByPosition(position));
+    auto function = SimpleFunctionFactory::instance().get_function(name, columns);
+    block.insert({nullptr, function->getReturnType(), name});
+    function->execute(block, arguments, block.columns() - 1, block.rows());
+    return block.columns() - 1;
+}
+
+} // namespace
+
+TEST(QueryProfileTest, disabled_test) {
+    ASSERT_EQ(QueryProfile::current(), nullptr);
+    Block block = makeBlock(10);
+    execute(block, "add", {0, 0});
+    ASSERT_EQ(QueryProfile::current(), nullptr);
+    ASSERT_EQ(QueryProfile::currentCounters(), nullptr);
+}
+
+TEST(QueryProfileTest, function_counters_test) {
+    QueryProfile profile("query");
+    {
+        QueryProfile::Scope scope(profile);
+        ASSERT_EQ(QueryProfile::current(), &profile);
+
+        Block block = makeBlock(100);
+        ProfileNodeHandle expression_node;
+        QueryProfile::OperatorScope expression(expression_node, "Expression", block.rows());
+        execute(block, "add", {0, 0});
+        execute(block, "add", {0, 1});
+        execute(block, "abs", {2});
+        expression.setRowsOut(block.rows());
+    }
+    ASSERT_EQ(QueryProfile::current(), nullptr);
+
+    auto snapshot = profile.snapshot();
+    ASSERT_EQ(snapshot.name, "query");
+    ASSERT_EQ(snapshot.children.size(), 1);
+    const auto& expression = snapshot.children[0];
+    ASSERT_EQ(expression.name, "Expression");
+    ASSERT_EQ(expression.calls, 1);
+    ASSERT_EQ(expression.rows_in, 100);
+    ASSERT_EQ(expression.rows_out, 100);
+
+    ASSERT_EQ(expression.children.size(), 2);
+    const auto& add = expression.children[0];
+    ASSERT_EQ(add.name, "add");
+    ASSERT_EQ(add.instances, 2);
+    ASSERT_EQ(add.calls, 2);
+    ASSERT_EQ(add.rows_in, 200);
+    ASSERT_EQ(add.rows_out, 200);
+    ASSERT_EQ(add.null_default_rows, 100);
+    ASSERT_EQ(add.const_default_rows, 0);
+    ASSERT_GT(add.allocated_bytes, 0);
+
+    const auto& abs = expression.children[1];
+    ASSERT_EQ(abs.name, "abs");
+    ASSERT_EQ(abs.const_default_rows, 100);
+
+    String text = snapshot.toString();
+    ASSERT_EQ(text.rfind("query: ", 0), 0) << text;
+    ASSERT_NE(text.find("\n  Expression: "), String::npos) << text;
+    ASSERT_NE(text.find("1 calls, rows 100 -> 100"), String::npos) << text;
+    ASSERT_NE(text.find("\n    add (x2): "), String::npos) << text;
+    ASSERT_NE(text.find("2 calls, rows 200 -> 200"), String::npos) << text;
+    ASSERT_NE(text.find("null default rows 100"), String::npos) << text;
+    ASSERT_NE(text.find("\n    abs: "), String::npos) << text;
+    ASSERT_NE(text.find("const default rows 100"), String::npos) << text;
+}
+
+TEST(QueryProfileTest, multithread_test) {
+    QueryProfile profile("query");
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            QueryProfile::Scope scope(profile);
+            Block block = makeBlock(10);
+            for (size_t j = 0; j < 100; ++j) execute(block, "add", {0, 0});
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    auto snapshot = profile.snapshot();
+    ASSERT_EQ(snapshot.children.size(), 1);
+    ASSERT_EQ(snapshot.children[0].instances, 400);
+    ASSERT_EQ(snapshot.children[0].calls, 400);
+    ASSERT_EQ(snapshot.children[0].rows_in, 4000);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
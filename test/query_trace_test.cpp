@@ -0,0 +1,103 @@
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "vec/common/arena.h"
+#include "vec/common/hash_table/hash_map.h"
+#include "vec/common/query_trace.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+void fillHashMap(size_t keys) {
+    HashMap<UInt64, UInt64> map;
+    for (UInt64 key = 0; key < keys; ++key) {
+        HashMap<UInt64, UInt64>::LookupResult it;
+        bool inserted;
+        map.emplace(key, it, inserted);
+    }
+}
+
+size_t countEvents(const QueryTrace& trace, const std::string& name) {
+    auto json = trace.toChromeTrace();
+    std::string pattern = "\"name\":\"" + name + "\"";
+    size_t res = 0;
+    for (size_t pos = json.find(pattern); pos != std::string::npos;
+         pos = json.find(pattern, pos + 1))
+        ++res;
+    return res;
+}
+
+} // namespace
+
+TEST(QueryTraceTest, disabled_test) {
+    ASSERT_EQ(QueryTrace::currentBuffer(), nullptr);
+    TraceScope trace_scope("Nothing");
+    fillHashMap(1000);
+    ASSERT_EQ(QueryTrace::currentBuffer(), nullptr);
+}
+
+TEST(QueryTraceTest, events_test) {
+    QueryTrace trace("query");
+    {
+        QueryTrace::Scope scope(trace);
+        ASSERT_NE(QueryTrace::currentBuffer(), nullptr);
+        TraceScope trace_scope("Work", 42);
+        fillHashMap(10000);
+        Arena arena(4096);
+        for (size_t i = 0; i < 100; ++i) arena.alloc(4096);
+    }
+    ASSERT_EQ(QueryTrace::currentBuffer(), nullptr);
+
+    auto json = trace.toChromeTrace();
+    std::cout << json.substr(0, 1000) << std::endl;
+    ASSERT_EQ(json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0);
+    ASSERT_NE(json.find("\"args\":{\"name\":\"query\"}"), std::string::npos);
+    ASSERT_NE(json.find("\"args\":{\"value\":42}"), std::string::npos);
+    ASSERT_EQ(countEvents(trace, "Work"), 1);
+    /// 10000 keys need 256 -> 1024 -> 4096 -> 16384 cells at least.
+    ASSERT_GE(countEvents(trace, "HashTable::resize"), 3);
+    ASSERT_GE(countEvents(trace, "Arena::addChunk"), 5);
+}
+
+TEST(QueryTraceTest, ring_buffer_test) {
+    QueryTrace trace("query", 5);
+    {
+        QueryTrace::Scope scope(trace);
+        for (size_t i = 0; i < 20; ++i) TraceScope trace_scope("Event", i);
+    }
+    /// Capacity is rounded up to 8, the last 8 events are kept.
+    ASSERT_EQ(countEvents(trace, "Event"), 8);
+    auto json = trace.toChromeTrace();
+    ASSERT_NE(json.find("\"overwritten_events\":12"), std::string::npos);
+    ASSERT_EQ(json.find("\"args\":{\"value\":11}"), std::string::npos);
+    ASSERT_NE(json.find("\"args\":{\"value\":12}"), std::string::npos);
+    ASSERT_NE(json.find("\"args\":{\"value\":19}"), std::string::npos);
+}
+
+TEST(QueryTraceTest, multithread_test) {
+    QueryTrace trace("query");
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            QueryTrace::Scope scope(trace);
+            for (size_t j = 0; j < 10; ++j) TraceScope trace_scope("Block");
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    ASSERT_EQ(countEvents(trace, "Block"), 40);
+    ASSERT_EQ(countEvents(trace, "thread_name"), 4);
+    auto json = trace.toChromeTrace();
+    for (size_t tid = 1; tid <= 4; ++tid)
+        ASSERT_NE(json.find("\"tid\":" + std::to_string(tid)), std::string::npos);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
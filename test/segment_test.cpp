@@ -0,0 +1,363 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector_helper.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/formats/segment_reader.h"
+#include "vec/formats/segment_writer.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+String tempPath(const String& name) {
+    return "/tmp/segment_test_" + std::to_string(getpid()) + "_" + name;
+}
+
+/// (x Int64, f Float64, d Decimal(18, 4), s String, ns Nullable(String), ni Nullable(Int32))
+/// for rows [first, first + rows). Every third row of ns and every fifth row of ni are null.
+Block makeBlock(size_t first, size_t rows) {
+    auto x = ColumnVector<Int64>::create();
+    auto f = ColumnVector<Float64>::create();
+    auto decimal_type = createDecimal(18, 4);
+    auto d = decimal_type->createColumn();
+    auto s = ColumnString::create();
+    auto ns = ColumnNullable::create(ColumnString::create(), ColumnUInt8::create());
+    auto ni = ColumnNullable::create(ColumnVector<Int32>::create(), ColumnUInt8::create());
+    for (size_t i = first; i < first + rows; ++i) {
+        x->getData().push_back(i);
+        f->getData().push_back(i * 0.5);
+        d->insert(DecimalField<Decimal64>(Decimal64(Int64(i) * 3), 4));
+        auto str = "value_" + std::to_string(i);
+        s->insertData(str.data(), str.size());
+        if (i % 3 == 0)
+            ns->insertDefault(), ns->getNullMapData().back() = 1;
+        else
+            ns->insert(Field(str.data(), str.size()));
+        if (i % 5 == 0)
+            ni->insertDefault(), ni->getNullMapData().back() = 1;
+        else
+            ni->insert(Int64(i));
+    }
+    return Block({{std::move(x), std::make_shared<DataTypeInt64>(), "x"},
+                  {std::move(f), std::make_shared<DataTypeFloat64>(), "f"},
+                  {std::move(d), decimal_type, "d"},
+                  {std::move(s), std::make_shared<DataTypeString>(), "s"},
+                  {std::move(ns), makeNullable(std::make_shared<DataTypeString>()), "ns"},
+                  {std::move(ni), makeNullable(std::make_shared<DataTypeInt32>()), "ni"}});
+}
+
+void checkRows(const Block& actual, const Block& expected, size_t first) {
+    for (size_t i = 0; i < actual.columns(); ++i) {
+        const auto& column = actual.getByPosition(i);
+        const auto& expected_column = expected.getByName(column.name);
+        ASSERT_TRUE(column.type->equals(*expected_column.type)) << column.name;
+        for (size_t row = 0; row < actual.rows(); ++row)
+            ASSERT_EQ((*column.column)[row], (*expected_column.column)[first + row])
+                    << column.name << " " << row;
+    }
+}
+
+} // namespace
+
+TEST(SegmentTest, roundtrip_test) {
+    auto path = tempPath("roundtrip");
+    Block expected = makeBlock(0, 1000);
+    {
+        /// Small granules and stripes so that the data spans several stripes.
+        SegmentWriter writer(path, expected, {64, 3});
+        for (size_t first = 0; first < 1000; first += 77)
+            writer.write(makeBlock(first, std::min<size_t>(77, 1000 - first)));
+        writer.finish();
+    }
+
+    SegmentReader reader(path);
+    ASSERT_EQ(reader.getRows(), 1000);
+    ASSERT_EQ(reader.getNumberOfGranules(), 16);
+    ASSERT_EQ(reader.getGranuleFirstRow(15), 960);
+    ASSERT_EQ(reader.getGranuleRows(15), 40);
+    ASSERT_EQ(reader.getHeader().dumpStructure(), expected.cloneEmpty().dumpStructure());
+
+    Block all = reader.read(expected.getNames(), 0, 1000);
+    ASSERT_EQ(all.rows(), 1000);
+    checkRows(all, expected, 0);
+
+    /// A subset of columns in another order and a range crossing stripes.
+    Block part = reader.read({"ns", "x"}, 150, 300);
+    ASSERT_EQ(part.rows(), 300);
+    ASSERT_EQ(part.getByPosition(0).name, "ns");
+    checkRows(part, expected, 150);
+
+    Block granules = reader.readGranules({"s", "ni"}, 2, 4);
+    ASSERT_EQ(granules.rows(), 256);
+    checkRows(granules, expected, 128);
+
+    ASSERT_EQ(reader.read({"x"}, 1000, 0).rows(), 0);
+    ASSERT_THROW(reader.read({"x"}, 990, 20), Exception);
+    ASSERT_THROW(reader.read({"missing"}, 0, 10), Exception);
+
+    unlink(path.c_str());
+}
+
+TEST(SegmentTest, zone_map_test) {
+    auto path = tempPath("zone_map");
+    auto ni_type = makeNullable(std::make_shared<DataTypeInt32>());
+    Block header({{ColumnVector<Int64>::create(), std::make_shared<DataTypeInt64>(), "x"},
+                  {ColumnString::create(), std::make_shared<DataTypeString>(), "s"},
+                  {ni_type->createColumn(), ni_type, "ni"}});
+    {
+        SegmentWriter writer(path, header, {10, 2});
+        for (size_t row = 0; row < 25; ++row) {
+            Block block = header.cloneEmpty();
+            auto columns = block.mutateColumns();
+            columns[0]->insert(Int64(100 - row));
+            auto str = std::to_string(row % 10);
+            columns[1]->insertData(str.data(), str.size());
+            /// The second granule is all null.
+            if (row >= 10 && row < 20)
+                columns[2]->insert(Null());
+            else
+                columns[2]->insert(Int64(row));
+            block.setColumns(std::move(columns));
+            writer.write(block);
+        }
+        writer.finish();
+    }
+
+    SegmentReader reader(path);
+    ASSERT_EQ(reader.getNumberOfGranules(), 3);
+
+    auto x = reader.getZoneMap(0, 1);
+    ASSERT_TRUE(x.has_min_max);
+    ASSERT_EQ(x.min, Field(Int64(81)));
+    ASSERT_EQ(x.max, Field(Int64(90)));
+    ASSERT_EQ(x.null_count, 0);
+
+    auto s = reader.getZoneMap(1, 2);
+    ASSERT_EQ(s.min.get<String>(), "0");
+    ASSERT_EQ(s.max.get<String>(), "4");
+
+    auto ni = reader.getZoneMap(2, 1);
+    ASSERT_FALSE(ni.has_min_max);
+    ASSERT_EQ(ni.null_count, 10);
+    ni = reader.getZoneMap(2, 2);
+    ASSERT_TRUE(ni.has_min_max);
+    ASSERT_EQ(ni.min, Field(Int64(20)));
+    ASSERT_EQ(ni.max, Field(Int64(24)));
+
+    ASSERT_THROW(reader.getZoneMap(3, 0), Exception);
+    unlink(path.c_str());
+}
+
+TEST(SegmentTest, long_string_zone_map_test) {
+    auto path = tempPath("long_string_zone_map");
+    Block header({{ColumnString::create(), std::make_shared<DataTypeString>(), "s"}});
+    constexpr size_t max_size = Segment::max_zone_map_string_size;
+    String low(max_size * 2, 'a');
+    String high = String(max_size - 2, 'b') + "\xff\xff" + String(max_size, 'c');
+    String all_ff(max_size * 2, '\xff');
+    {
+        SegmentWriter writer(path, header, {2, 2});
+        for (const auto* str : {&low, &high, &all_ff, &low}) {
+            Block block = header.cloneEmpty();
+            auto columns = block.mutateColumns();
+            columns[0]->insertData(str->data(), str->size());
+            block.setColumns(std::move(columns));
+            writer.write(block);
+        }
+        writer.finish();
+    }
+
+    SegmentReader reader(path);
+    /// The min is cut, the max is cut before the 0xFF bytes and its last byte is incremented.
+    auto zone_map = reader.getZoneMap(0, 0);
+    ASSERT_EQ(zone_map.min.get<String>(), String(max_size, 'a'));
+    ASSERT_EQ(zone_map.max.get<String>(), String(max_size - 3, 'b') + "c");
+    ASSERT_LT(zone_map.min.get<String>(), low);
+    ASSERT_GT(zone_map.max.get<String>(), high);
+
+    /// A max of only 0xFF bytes cannot be rounded up and is kept as is.
+    zone_map = reader.getZoneMap(0, 1);
+    ASSERT_EQ(zone_map.min.get<String>(), String(max_size, 'a'));
+    ASSERT_EQ(zone_map.max.get<String>(), all_ff);
+    unlink(path.c_str());
+}
+
+TEST(SegmentTest, const_column_test) {
+    auto path = tempPath("const");
+    auto type = std::make_shared<DataTypeInt64>();
+    Block header({{type->createColumn(), type, "c"}});
+    {
+        SegmentWriter writer(path, header, {16, 4});
+        auto value = ColumnVector<Int64>::create();
+        value->insert(Int64(42));
+        writer.write(Block({{ColumnConst::create(std::move(value), 50), type, "c"}}));
+        writer.finish();
+    }
+
+    SegmentReader reader(path);
+    Block block = reader.read({"c"}, 0, 50);
+    ASSERT_EQ(block.rows(), 50);
+    for (size_t row = 0; row < 50; ++row)
+        ASSERT_EQ(block.getByPosition(0).column->getInt(row), 42);
+    unlink(path.c_str());
+}
+
+TEST(SegmentTest, rle_test) {
+    auto path = tempPath("rle");
+    auto type = std::make_shared<DataTypeInt64>();
+    auto day = ColumnVector<Int64>::create();
+    auto x = ColumnVector<Int64>::create();
+    for (Int64 i = 0; i < 1000; ++i) {
+        day->insertValue(i / 100);
+        x->insertValue(i);
+    }
+    Block expected({{std::move(day), type, "day"}, {std::move(x), type, "x"}});
+    {
+        SegmentWriter writer(path, expected, {64, 4});
+        writer.write(expected);
+        writer.finish();
+    }
+
+    SegmentReaderSettings settings;
+    settings.rle_min_run_length = 16;
+    SegmentReader reader(path, settings);
+    Block block = reader.read({"day", "x"}, 150, 700);
+    ASSERT_TRUE(block.getByName("day").column->isRLE());
+    ASSERT_FALSE(block.getByName("x").column->isRLE());
+    for (size_t row = 0; row < 700; ++row) {
+        ASSERT_EQ(block.getByName("day").column->getInt(row), Int64(row + 150) / 100);
+        ASSERT_EQ(block.getByName("x").column->getInt(row), Int64(row + 150));
+    }
+    ASSERT_FALSE(SegmentReader(path).read({"day"}, 0, 1000).getByName("day").column->isRLE());
+    unlink(path.c_str());
+}
+
+TEST(SegmentTest, zero_copy_test) {
+    auto path = tempPath("zero_copy");
+    Block expected = makeBlock(0, 1000);
+    {
+        /// Stripes of 256 rows.
+        SegmentWriter writer(path, expected, {64, 4});
+        writer.write(expected);
+        writer.finish();
+    }
+
+    auto is_borrowed = [](const Block& block, const String& name) {
+        const IColumn* column = block.getByName(name).column.get();
+        if (const auto* nullable = typeid_cast<const ColumnNullable*>(column)) {
+            if (!nullable->getNullMapColumn().isBorrowed()) return false;
+            column = &nullable->getNestedColumn();
+        }
+        if (const auto* string = typeid_cast<const ColumnString*>(column))
+            return string->isBorrowed();
+        return static_cast<const ColumnVectorHelper*>(column)->isBorrowed();
+    };
+
+    Block first_stripe;
+    {
+        SegmentReader reader(path, {true});
+        first_stripe = reader.readGranules(expected.getNames(), 0, 4);
+        checkRows(first_stripe, expected, 0);
+        for (const auto& name : expected.getNames()) ASSERT_TRUE(is_borrowed(first_stripe, name));
+
+        /// Strings are copied when the granules do not start a stripe.
+        Block middle = reader.readGranules(expected.getNames(), 5, 2);
+        checkRows(middle, expected, 320);
+        ASSERT_TRUE(is_borrowed(middle, "x"));
+        ASSERT_TRUE(is_borrowed(middle, "d"));
+        ASSERT_FALSE(is_borrowed(middle, "s"));
+
+        /// Several stripes are copied.
+        Block crossing = reader.readGranules({"x", "s"}, 2, 4);
+        checkRows(crossing, expected, 128);
+        ASSERT_FALSE(is_borrowed(crossing, "x"));
+
+        Block copied = SegmentReader(path).readGranules({"x"}, 0, 4);
+        ASSERT_FALSE(is_borrowed(copied, "x"));
+    }
+
+    /// The columns outlive the reader.
+    checkRows(first_stripe, expected, 0);
+
+    /// Changing a column makes a copy and does not change the file.
+    auto x = std::move(*first_stripe.getByName("x").column).mutate();
+    auto& x_data = assert_cast<ColumnVector<Int64>&>(*x).getData();
+    x_data[0] = -1;
+    ASSERT_FALSE(assert_cast<ColumnVector<Int64>&>(*x).isBorrowed());
+    x->insert(Int64(1000));
+    ASSERT_EQ(x->size(), 257);
+    ASSERT_EQ((*x)[0], Field(Int64(-1)));
+    ASSERT_EQ((*x)[255], Field(Int64(255)));
+
+    auto s = std::move(*first_stripe.getByName("s").column).mutate();
+    s->insertData("new", 3);
+    ASSERT_FALSE(assert_cast<ColumnString&>(*s).isBorrowed());
+    ASSERT_EQ(s->size(), 257);
+    ASSERT_EQ(s->getDataAt(255).toString(), "value_255");
+    ASSERT_EQ(s->getDataAt(256).toString(), "new");
+
+    SegmentReader reader(path, {true});
+    Block again = reader.readGranules({"x", "s"}, 0, 4);
+    checkRows(again, expected, 0);
+    unlink(path.c_str());
+}
+
+TEST(SegmentTest, corrupted_test) {
+    auto path = tempPath("corrupted");
+    {
+        std::ofstream out(path);
+        out << "this is not a segment at all";
+    }
+    ASSERT_THROW(SegmentReader reader(path), Exception);
+
+    Block block = makeBlock(0, 10);
+    {
+        SegmentWriter writer(path, block);
+        writer.write(block);
+        writer.finish();
+    }
+    {
+        SegmentReader reader(path);
+        ASSERT_EQ(reader.getRows(), 10);
+    }
+    /// The trailer is lost.
+    truncate(path.c_str(), 100);
+    ASSERT_THROW(SegmentReader reader(path), Exception);
+    unlink(path.c_str());
+    ASSERT_THROW(SegmentReader reader(path), Exception);
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
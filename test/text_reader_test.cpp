@@ -0,0 +1,307 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <random>
+
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/typeid_cast.h"
+#include "vec/common/work_stealing_thread_pool.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/formats/text_reader.h"
+
+namespace doris::vectorized {
+
+namespace ErrorCodes {
+extern const int INCORRECT_NUMBER_OF_COLUMNS;
+extern const int CANNOT_PARSE_QUOTED_STRING;
+extern const int CANNOT_PARSE_NUMBER;
+extern const int DECIMAL_OVERFLOW;
+} // namespace ErrorCodes
+
+namespace {
+
+Block makeHeader() {
+    auto i32_type = std::make_shared<DataTypeInt32>();
+    auto ns_type = makeNullable(std::make_shared<DataTypeString>());
+    auto f64_type = std::make_shared<DataTypeFloat64>();
+    auto d32_type = createDecimal(9, 2);
+    auto s_type = std::make_shared<DataTypeString>();
+    auto ni_type = makeNullable(std::make_shared<DataTypeInt64>());
+    return Block({{i32_type->createColumn(), i32_type, "i32"},
+                  {ns_type->createColumn(), ns_type, "ns"},
+                  {f64_type->createColumn(), f64_type, "f64"},
+                  {d32_type->createColumn(), d32_type, "d32"},
+                  {s_type->createColumn(), s_type, "s"},
+                  {ni_type->createColumn(), ni_type, "ni"}});
+}
+
+Blocks parse(const TextReader& reader, const std::string& text) {
+    Blocks res;
+    reader.parse(text.data(), text.data() + text.size(), res);
+    return res;
+}
+
+const IColumn& column(const Block& block, size_t i) {
+    return *block.getByPosition(i).column;
+}
+
+Int32 getInt32(const Block& block, size_t row) {
+    return assert_cast<const ColumnInt32&>(column(block, 0)).getData()[row];
+}
+
+std::string getString(const Block& block, size_t i, size_t row) {
+    const IColumn* col = &column(block, i);
+    if (const auto* nullable = typeid_cast<const ColumnNullable*>(col)) {
+        if (nullable->isNullAt(row)) return "NULL";
+        col = &nullable->getNestedColumn();
+    }
+    return col->getDataAt(row).toString();
+}
+
+Float64 getFloat64(const Block& block, size_t row) {
+    return assert_cast<const ColumnFloat64&>(column(block, 2)).getData()[row];
+}
+
+Int32 getDecimal(const Block& block, size_t row) {
+    return assert_cast<const ColumnDecimal<Decimal32>&>(column(block, 3)).getData()[row].value;
+}
+
+/// Checks that the blocks have equal values, compared by the string representation.
+void assertBlocksEqual(const Blocks& lhs, const Blocks& rhs) {
+    auto flatten = [](const Blocks& blocks) {
+        std::vector<std::string> res;
+        for (const auto& block : blocks)
+            for (size_t row = 0; row < block.rows(); ++row)
+                for (size_t i = 0; i < block.columns(); ++i) {
+                    Field field;
+                    column(block, i).get(row, field);
+                    res.push_back(field.isNull() ? "NULL" : getString(block, i, row));
+                }
+        return res;
+    };
+    ASSERT_EQ(flatten(lhs), flatten(rhs));
+}
+
+} // namespace
+
+TEST(TextReaderTest, csv_test) {
+    TextReader reader(makeHeader(), {});
+    std::string text =
+            "1,abc,1.5,12.34,plain,7\n"
+            "-2,\"a,b\",-0.25,-1,\"say \"\"hi\"\"\",\\N\r\n"
+            "+3,\"multi\nline\",1e3,0.5,\"\",\n"
+            "4,,,,,\"-9\"\r\n"
+            "5,\\N,2,\"3.10\",x,10";
+    Blocks blocks = parse(reader, text);
+    ASSERT_EQ(blocks.size(), 1);
+    const Block& block = blocks[0];
+    ASSERT_EQ(block.rows(), 5);
+
+    ASSERT_EQ(getInt32(block, 0), 1);
+    ASSERT_EQ(getInt32(block, 1), -2);
+    ASSERT_EQ(getInt32(block, 2), 3);
+    ASSERT_EQ(getInt32(block, 4), 5);
+
+    ASSERT_EQ(getString(block, 1, 0), "abc");
+    ASSERT_EQ(getString(block, 1, 1), "a,b");
+    ASSERT_EQ(getString(block, 1, 2), "multi\nline");
+    ASSERT_EQ(getString(block, 1, 3), "NULL");
+    ASSERT_EQ(getString(block, 1, 4), "NULL");
+
+    ASSERT_EQ(getFloat64(block, 0), 1.5);
+    ASSERT_EQ(getFloat64(block, 1), -0.25);
+    ASSERT_EQ(getFloat64(block, 2), 1000);
+    ASSERT_EQ(getFloat64(block, 3), 0);
+
+    ASSERT_EQ(getDecimal(block, 0), 1234);
+    ASSERT_EQ(getDecimal(block, 1), -100);
+    ASSERT_EQ(getDecimal(block, 2), 50);
+    ASSERT_EQ(getDecimal(block, 3), 0);
+    ASSERT_EQ(getDecimal(block, 4), 310);
+
+    ASSERT_EQ(getString(block, 4, 0), "plain");
+    ASSERT_EQ(getString(block, 4, 1), "say \"hi\"");
+    ASSERT_EQ(getString(block, 4, 2), "");
+    ASSERT_EQ(getString(block, 4, 3), "");
+    ASSERT_EQ(getString(block, 4, 4), "x");
+
+    const auto& ni = assert_cast<const ColumnNullable&>(column(block, 5));
+    const auto& ni_values = assert_cast<const ColumnInt64&>(ni.getNestedColumn()).getData();
+    ASSERT_FALSE(ni.isNullAt(0));
+    ASSERT_EQ(ni_values[0], 7);
+    ASSERT_TRUE(ni.isNullAt(1));
+    ASSERT_TRUE(ni.isNullAt(2));
+    ASSERT_EQ(ni_values[3], -9);
+    ASSERT_EQ(ni_values[4], 10);
+}
+
+TEST(TextReaderTest, tsv_test) {
+    TextReaderSettings settings;
+    settings.format = TextReaderSettings::Format::TSV;
+    settings.max_block_rows = 2;
+    TextReader reader(makeHeader(), settings);
+    std::string text =
+            "1\ta\\tb\\nc\t0.5\t1\t\"quoted\"\t\\N\n"
+            "2\t\\N\t1\t2.5\tback\\\\slash\t3\n"
+            "3\t\t2\t3\t\\'x\\0\t\n";
+    Blocks blocks = parse(reader, text);
+    ASSERT_EQ(blocks.size(), 2);
+    ASSERT_EQ(blocks[0].rows(), 2);
+    ASSERT_EQ(blocks[1].rows(), 1);
+
+    ASSERT_EQ(getString(blocks[0], 1, 0), "a\tb\nc");
+    ASSERT_EQ(getString(blocks[0], 1, 1), "NULL");
+    ASSERT_EQ(getString(blocks[1], 1, 0), "");
+    ASSERT_EQ(getString(blocks[0], 4, 0), "\"quoted\"");
+    ASSERT_EQ(getString(blocks[0], 4, 1), "back\\slash");
+    ASSERT_EQ(getString(blocks[1], 4, 0), std::string("'x\0", 3));
+    ASSERT_EQ(getDecimal(blocks[0], 1), 250);
+    ASSERT_EQ(getInt32(blocks[1], 0), 3);
+    ASSERT_EQ(getString(blocks[0], 5, 0), "NULL");
+    /// An empty field is the default value in TSV, not NULL.
+    ASSERT_FALSE(assert_cast<const ColumnNullable&>(column(blocks[1], 5)).isNullAt(0));
+}
+
+TEST(TextReaderTest, delimiter_test) {
+    TextReaderSettings settings;
+    settings.delimiter = ';';
+    TextReader reader(makeHeader(), settings);
+    Blocks blocks = parse(reader, "1;\"a;b,c\";2;3;,;4\n");
+    ASSERT_EQ(blocks.size(), 1);
+    ASSERT_EQ(getString(blocks[0], 1, 0), "a;b,c");
+    ASSERT_EQ(getString(blocks[0], 4, 0), ",");
+
+    settings.delimiter = '"';
+    ASSERT_THROW(TextReader(makeHeader(), settings), Exception);
+}
+
+TEST(TextReaderTest, error_test) {
+    TextReader reader(makeHeader(), {});
+    auto parse_error = [&](const std::string& text) {
+        try {
+            parse(reader, text);
+        } catch (const Exception& e) {
+            return e.code();
+        }
+        return 0;
+    };
+    ASSERT_EQ(parse_error("1,a,1,1,a\n"), ErrorCodes::INCORRECT_NUMBER_OF_COLUMNS);
+    ASSERT_EQ(parse_error("1,a,1,1,a,1,1\n"), ErrorCodes::INCORRECT_NUMBER_OF_COLUMNS);
+    ASSERT_EQ(parse_error("1,a,1,1,a,1\n2,a"), ErrorCodes::INCORRECT_NUMBER_OF_COLUMNS);
+    ASSERT_EQ(parse_error("x,a,1,1,a,1\n"), ErrorCodes::CANNOT_PARSE_NUMBER);
+    ASSERT_EQ(parse_error("1,a,1.5x,1,a,1\n"), ErrorCodes::CANNOT_PARSE_NUMBER);
+    ASSERT_EQ(parse_error("99999999999,a,1,1,a,1\n"), ErrorCodes::CANNOT_PARSE_NUMBER);
+    ASSERT_EQ(parse_error("1,a,1,1.234,a,1\n"), ErrorCodes::CANNOT_PARSE_NUMBER);
+    ASSERT_EQ(parse_error("1,a,1,12345678901,a,1\n"), ErrorCodes::DECIMAL_OVERFLOW);
+    /// Decimal(9, 2) has 7 digits before the point.
+    ASSERT_EQ(parse_error("1,a,1,12345678,a,1\n"), ErrorCodes::DECIMAL_OVERFLOW);
+    ASSERT_EQ(parse_error("1,a,1,-12345678,a,1\n"), ErrorCodes::DECIMAL_OVERFLOW);
+    ASSERT_EQ(parse_error("1,a,1,9999999.99,a,1\n"), 0);
+    ASSERT_EQ(parse_error("1,a,1,-9999999.99,a,1\n"), 0);
+    ASSERT_EQ(parse_error("1,a,1,0009999999.99,a,1\n"), 0);
+    ASSERT_EQ(parse_error("1,\"a,1,1,a,1\n"), ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+    ASSERT_EQ(parse_error("1,a\"b\",1,1,a,1\n"), ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+    ASSERT_EQ(parse_error("1,\"a\"b,1,1,a,1\n"), ErrorCodes::CANNOT_PARSE_QUOTED_STRING);
+    ASSERT_EQ(parse_error("1,a,1,1.230,a,1\n"), 0);
+
+    ASSERT_THROW(TextReader(Block(), {}), Exception);
+}
+
+TEST(TextReaderTest, file_test) {
+    std::mt19937 rng(42);
+    std::string text = "i32,ns,f64,d32,s,ni\n";
+    for (size_t row = 0; row < 5000; ++row) {
+        text += std::to_string(Int32(rng())) + ",";
+        switch (rng() % 4) {
+        case 0:
+            text += "\\N";
+            break;
+        case 1:
+            text += "\"quoted,\"\"x\"\"\nnext line\"";
+            break;
+        case 2:
+            text += std::string(rng() % 30, 'a' + rng() % 26);
+            break;
+        default:
+            break;
+        }
+        text += "," + std::to_string(rng() % 1000 * 0.125) + ",";
+        text += std::to_string(rng() % 100000) + "." + std::to_string(rng() % 10) + ",";
+        text += "\"" + std::string(rng() % 3 * 2, '"') + "\",";
+        text += std::to_string(Int64(rng()) - (1LL << 31));
+        text += rng() % 2 ? "\n" : "\r\n";
+    }
+
+    std::string path = testing::TempDir() + "text_reader_test.csv";
+    std::ofstream(path, std::ios::binary) << text;
+
+    TextReaderSettings settings;
+    settings.with_names = true;
+    settings.max_block_rows = 1000;
+    TextReader whole_reader(makeHeader(), settings);
+    Blocks expected = whole_reader.readFile(path);
+    size_t rows = 0;
+    for (const auto& block : expected) rows += block.rows();
+    ASSERT_EQ(rows, 5000);
+
+    settings.chunk_bytes = 1000;
+    TextReader reader(makeHeader(), settings);
+    size_t header_size = text.find('\n') + 1;
+    auto chunks = reader.splitIntoChunks(text.data() + header_size, text.data() + text.size());
+    ASSERT_GT(chunks.size(), 100);
+    size_t chunk_begin = 0;
+    for (const auto& [begin, end] : chunks) {
+        ASSERT_EQ(begin, chunk_begin);
+        ASSERT_EQ(text[header_size + end - 1], '\n');
+        chunk_begin = end;
+    }
+    ASSERT_EQ(header_size + chunk_begin, text.size());
+
+    assertBlocksEqual(reader.readFile(path), expected);
+    WorkStealingThreadPool pool(4);
+    assertBlocksEqual(reader.readFile(path, &pool), expected);
+
+    /// From the only worker of a pool, the caller parses the chunks itself.
+    WorkStealingThreadPool single_pool(1);
+    std::promise<Blocks> from_worker;
+    single_pool.schedule([&] { from_worker.set_value(reader.readFile(path, &single_pool)); });
+    assertBlocksEqual(from_worker.get_future().get(), expected);
+
+    std::ofstream(path, std::ios::binary) << text << "1,a,b";
+    ASSERT_THROW(reader.readFile(path, &pool), Exception);
+    unlink(path.c_str());
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,186 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/data_types/data_types_decimal.h"
+#include "vec/data_types/data_types_number.h"
+#include "vec/formats/text_reader.h"
+#include "vec/formats/text_writer.h"
+
+namespace doris::vectorized {
+
+using namespace std::string_literals;
+
+namespace {
+
+Block makeBlock() {
+    auto i32_type = std::make_shared<DataTypeInt32>();
+    auto ns_type = makeNullable(std::make_shared<DataTypeString>());
+    auto f64_type = std::make_shared<DataTypeFloat64>();
+    auto d64_type = createDecimal(18, 3);
+    auto u8_type = std::make_shared<DataTypeUInt8>();
+    auto i32 = i32_type->createColumn();
+    auto ns = ns_type->createColumn();
+    auto f64 = f64_type->createColumn();
+    auto d64 = d64_type->createColumn();
+    auto u8 = u8_type->createColumn();
+
+    i32->insert(Int64(-2147483648LL));
+    ns->insert(Field("a,\"b\"\tc\\d\ne", 11));
+    f64->insert(0.1);
+    d64->insert(DecimalField<Decimal64>(Decimal64(-1005), 3));
+    u8->insert(UInt64(255));
+
+    i32->insert(Int64(7));
+    ns->insert(Null());
+    f64->insert(-1e300);
+    d64->insert(DecimalField<Decimal64>(Decimal64(42000), 3));
+    u8->insert(UInt64(0));
+
+    i32->insert(Int64(0));
+    ns->insert(Field(std::string("\x01\0", 2).data(), 2));
+    f64->insert(std::nan(""));
+    d64->insert(DecimalField<Decimal64>(Decimal64(5), 3));
+    u8->insert(UInt64(1));
+
+    return Block({{std::move(i32), i32_type, "i32"},
+                  {std::move(ns), ns_type, "ns"},
+                  {std::move(f64), f64_type, "f64"},
+                  {std::move(d64), d64_type, "d\"64"},
+                  {std::move(u8), u8_type, "u8"}});
+}
+
+std::string writeToString(const Blocks& blocks, const TextWriterSettings& settings) {
+    std::string path = testing::TempDir() + "text_writer_test.txt";
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    EXPECT_NE(fd, -1);
+    TextWriter writer(fd, blocks.at(0), settings);
+    for (const auto& block : blocks) writer.write(block);
+    writer.flush();
+    size_t bytes = writer.bytesWritten();
+    close(fd);
+
+    std::stringstream res;
+    res << std::ifstream(path, std::ios::binary).rdbuf();
+    unlink(path.c_str());
+    EXPECT_EQ(res.str().size(), bytes);
+    return res.str();
+}
+
+} // namespace
+
+TEST(TextWriterTest, csv_test) {
+    TextWriterSettings settings;
+    settings.with_names = true;
+    ASSERT_EQ(writeToString({makeBlock()}, settings),
+              "\"i32\",\"ns\",\"f64\",\"d\"\"64\",\"u8\"\n"
+              "-2147483648,\"a,\"\"b\"\"\tc\\d\ne\",0.1,-1.005,255\n"
+              "7,\\N,-1e+300,42.000,0\n"
+              "0,\"\x01\0\",nan,0.005,1\n"s);
+}
+
+TEST(TextWriterTest, tsv_test) {
+    TextWriterSettings settings;
+    settings.format = TextWriterSettings::Format::TSV;
+    ASSERT_EQ(writeToString({makeBlock()}, settings),
+              "-2147483648\ta,\"b\"\\tc\\\\d\\ne\t0.1\t-1.005\t255\n"
+              "7\t\\N\t-1e+300\t42.000\t0\n"
+              "0\t\x01\\0\tnan\t0.005\t1\n");
+}
+
+TEST(TextWriterTest, json_test) {
+    TextWriterSettings settings;
+    settings.format = TextWriterSettings::Format::JSONEachRow;
+    ASSERT_EQ(writeToString({makeBlock()}, settings),
+              "{\"i32\":-2147483648,\"ns\":\"a,\\\"b\\\"\\tc\\\\d\\ne\",\"f64\":0.1,"
+              "\"d\\\"64\":-1.005,\"u8\":255}\n"
+              "{\"i32\":7,\"ns\":null,\"f64\":-1e+300,\"d\\\"64\":42.000,\"u8\":0}\n"
+              "{\"i32\":0,\"ns\":\"\\u0001\\u0000\",\"f64\":null,\"d\\\"64\":0.005,\"u8\":1}\n");
+}
+
+TEST(TextWriterTest, roundtrip_test) {
+    std::mt19937_64 rng(7);
+    auto i64_type = std::make_shared<DataTypeInt64>();
+    auto s_type = std::make_shared<DataTypeString>();
+    auto nf_type = makeNullable(std::make_shared<DataTypeFloat32>());
+    auto d128_type = createDecimal(38, 10);
+    Blocks blocks;
+    for (size_t block = 0; block < 10; ++block) {
+        auto i64 = i64_type->createColumn();
+        auto s = s_type->createColumn();
+        auto nf = nf_type->createColumn();
+        auto d128 = d128_type->createColumn();
+        for (size_t row = 0; row < 1000; ++row) {
+            i64->insert(Int64(rng()));
+            std::string str;
+            for (size_t i = rng() % 40; i > 0; --i) str += char(rng() % 128);
+            s->insert(Field(str.data(), str.size()));
+            if (rng() % 5 == 0)
+                nf->insert(Null());
+            else
+                nf->insert(Float64(Float32(Int64(rng()) * 1e-10)));
+            Int128 value = (Int128(Int64(rng())) << 40) + Int128(rng() % (1ULL << 40));
+            d128->insert(DecimalField<Decimal128>(Decimal128(value), 10));
+        }
+        blocks.push_back(Block({{std::move(i64), i64_type, "i64"},
+                                {std::move(s), s_type, "s"},
+                                {std::move(nf), nf_type, "nf"},
+                                {std::move(d128), d128_type, "d128"}}));
+    }
+
+    for (auto format : {TextWriterSettings::Format::CSV, TextWriterSettings::Format::TSV}) {
+        TextWriterSettings settings;
+        settings.format = format;
+        settings.buffer_size = 4096;
+        std::string text = writeToString(blocks, settings);
+
+        TextReaderSettings reader_settings;
+        reader_settings.format = format == TextWriterSettings::Format::CSV
+                                         ? TextReaderSettings::Format::CSV
+                                         : TextReaderSettings::Format::TSV;
+        reader_settings.max_block_rows = 1000;
+        Blocks read;
+        TextReader(blocks[0], reader_settings).parse(text.data(), text.data() + text.size(), read);
+        ASSERT_EQ(read.size(), blocks.size());
+        for (size_t i = 0; i < blocks.size(); ++i)
+            for (size_t j = 0; j < blocks[i].columns(); ++j)
+                for (size_t row = 0; row < blocks[i].rows(); ++row)
+                    ASSERT_EQ((*blocks[i].getByPosition(j).column)[row],
+                              (*read[i].getByPosition(j).column)[row]);
+    }
+}
+
+} // namespace doris::vectorized
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}